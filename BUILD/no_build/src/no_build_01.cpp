@@ -0,0 +1,12 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// distance from line to line doesn't make sense
+	Line2d li1,li2;
+	auto d = li1.distTo(li2);
+}
+
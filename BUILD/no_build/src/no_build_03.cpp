@@ -0,0 +1,12 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// no such thing as an orthogonal line to a point !
+	Point2d pt;
+	auto li = pt.getOrthogLine( GivenCoord::X, 2 );
+}
+
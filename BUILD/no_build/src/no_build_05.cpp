@@ -0,0 +1,13 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// no such thing as a angle between a line and a point
+	Point2d pt;
+	Line2d li;
+	auto li2 = pt.getAngle( li );
+}
+
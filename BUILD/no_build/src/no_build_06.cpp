@@ -0,0 +1,13 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// argument needs to be arithmetic
+
+	Point2d pt;
+	Homogr H(pt);
+}
+
@@ -0,0 +1,15 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// no intersection between a point and a polyline
+
+	CPolyline pl;
+	Point2d pt;
+	auto i = pt.intersects( pl );
+
+}
+
@@ -0,0 +1,14 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// homography * FRect does NOT produce a FRect !
+
+	FRect rect;
+	Homogr H;
+	FRect rect2 = H * rect;
+}
+
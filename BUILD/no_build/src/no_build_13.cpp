@@ -0,0 +1,17 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// make sure that draw() free function fails if something not drawable is passed
+
+img::Image<img::SvgImage> im;
+
+Homogr h;
+draw( im, h );
+
+
+}
+
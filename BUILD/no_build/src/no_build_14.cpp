@@ -0,0 +1,13 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// cannot use a Line2d in a getBB( pair of objects)
+	Line2d li;
+	FRect rect;
+	auto bb = getBB( li, rect );
+}
+
@@ -0,0 +1,12 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Polyline: cannot create a polyline from a non-container argument
+
+	CPolyline op(3.14);
+}
+
@@ -0,0 +1,13 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Polyline: cannot create an open polyline as a RCP
+
+	OPolyline op(4,5);
+
+}
+
@@ -0,0 +1,16 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// make sure that translate() requires numeric values
+
+	Circle c1;
+	FRect r;
+	r.translate( c1, 3 );
+
+
+}
+
@@ -0,0 +1,13 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// build a RCP, requires an integral type as second argument
+	CPolyline( 3., 3.14 );
+
+
+}
+
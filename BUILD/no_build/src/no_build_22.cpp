@@ -0,0 +1,14 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// set a RCP, requires an integral type as second argument
+	CPolyline cpol;
+	cpol.set( 3., 3.14 );
+
+
+}
+
@@ -0,0 +1,14 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Constructor requires numerical arguments
+	bool b;
+	Segment s( b, 3 );
+
+
+}
+
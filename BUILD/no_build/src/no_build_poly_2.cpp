@@ -0,0 +1,14 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Polyline: cannot create an Open polyline from a rectangle
+// (because we can't know where to open it)
+
+	FRect rect;
+	OPolyline op(rect);
+}
+
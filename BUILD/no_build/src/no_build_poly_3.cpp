@@ -0,0 +1,15 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Polyline: cannot set an Open polyline from a rectangle
+// (because we can't know where to open it)
+
+	FRect rect;
+	OPolyline op;
+	op.set(rect);
+}
+
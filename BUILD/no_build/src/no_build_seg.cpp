@@ -0,0 +1,14 @@
+#include "../../../homog2d.hpp"
+
+using namespace h2d;
+
+int main()
+{
+
+// Cant build a OSegment from a Segment
+	Segment s;
+	OSegment s2(s);
+
+
+}
+
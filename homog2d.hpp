@@ -34,9 +34,15 @@ See https://github.com/skramm/homog2d
 #include <array>
 #include <set>
 #include <list>
+#include <deque>
 #include <vector>
 #include <map>
 #include <stack>
+#include <queue>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <random>
 #include <iomanip>
 #include <cassert>
 #include <sstream>
@@ -45,6 +51,7 @@ See https://github.com/skramm/homog2d
 #include <limits>
 #include <cstdint> // required for uint8_t
 #include <memory>  // required for std::unique_ptr
+#include <atomic>
 
 #ifdef HOMOG2D_USE_SVG_IMPORT
 	#define HOMOG2D_ENABLE_VRTP
@@ -222,12 +229,6 @@ See https://github.com/skramm/homog2d
 #endif
 ///////////////////////////////////////
 
-/// Max number of iterations for "Point inside Polygon" algorithm.
-/// May be adjusted, see manual
-#ifndef HOMOG2D_MAXITER_PIP
-	#define HOMOG2D_MAXITER_PIP 5
-#endif
-
 #define HOMOG2D_VERSION "2.13.1"
 
 // some MS environments seem to lack Pi definition, even if _USE_MATH_DEFINES is defined
@@ -309,6 +310,7 @@ struct T_Ellipse  {};
 namespace detail {
 
 	template<typename FPT> class Matrix_;
+	template<typename FPT> class BatchTransform;
 
 	/// Helper class for Root (Point/Line) type, used as a trick to allow partial specialization of member functions
 	template<typename> struct BaseHelper {};
@@ -362,6 +364,7 @@ namespace detail {
 /// Holds base classes, not part of API
 namespace base {
 	template<typename PLT,typename FPT> class PolylineBase;
+	template<typename PLT,typename FPT> class PolylineSoA;
 	template<typename LP, typename FPT> class LPBase;
 	template<typename SV, typename FPT> class SegVec;
 }
@@ -404,6 +407,11 @@ using CPolyline_ = base::PolylineBase<typ::IsClosed,T>;
 template<typename T>
 using OPolyline_ = base::PolylineBase<typ::IsOpen,T>;
 
+template<typename T>
+using CPolylineSoA_ = base::PolylineSoA<typ::IsClosed,T>;
+template<typename T>
+using OPolylineSoA_ = base::PolylineSoA<typ::IsOpen,T>;
+
 
 #ifdef HOMOG2D_ENABLE_VRTP
 /// A variant type, holding all possible types. Used to achieve runtime polymorphism
@@ -1688,6 +1696,37 @@ template<int T1,int T2> struct IsBigNumType<ttmath::Big<T1,T2>> : std::true_type
 
 } // namespace trait
 
+//------------------------------------------------------------------
+/// Kind of planar transformation of a homography, see Hmatrix_::kind()
+/**
+Ordered from the most specific to the most general one.
+All but \c Projective have (0,0,1) as last row.
+*/
+enum class HKind: uint8_t
+{
+	Rigid,       ///< rotation and translation (and mirroring): lengths are kept
+	Similarity,  ///< rigid, plus an isotropic scaling: lengths are scaled by the same factor
+	Affine,      ///< general 2x2 linear part, plus translation: parallelism is kept
+	Projective   ///< general case
+};
+
+/// Returns stringified version of \ref HKind
+inline
+const char*
+getString( HKind k )
+{
+	const char* s=0;
+	switch( k )
+	{
+		case HKind::Rigid:      s="Rigid";      break;
+		case HKind::Similarity: s="Similarity"; break;
+		case HKind::Affine:     s="Affine";     break;
+		case HKind::Projective: s="Projective"; break;
+		assert(0);
+	}
+	return s;
+}
+
 //------------------------------------------------------------------
 /// A 2D homography, defining a planar transformation
 /**
@@ -1703,7 +1742,10 @@ To add an affine or rigid transformation to the current one, you can use:
 
 To return to unit transformation, use init()
 
-Implemented as a 3x3 matrix
+Implemented as a 3x3 matrix.
+The kind of transformation (see HKind) is kept along with the matrix, so that faster computations
+can be done when it is not projective.
+It is set by the above functions, and detected from the values otherwise (see kind()).
 
 Templated by Floating-Point Type (FPT) and by type M (typ::IsEpipmat or typ::IsHomogr)
  */
@@ -1784,13 +1826,12 @@ Thus some assert can get triggered elsewhere.
 		normalize();
 	}
 
-/// Copy-constructor
+/// Copy-constructor. The cached values are copied too
 	Hmatrix_( const Hmatrix_<M,FPT>& other )
-		: detail::Matrix_<FPT>( other)
-		, _hasChanged   ( true )
-		, _hmt          (  nullptr )
+		: detail::Matrix_<FPT>( other )
+		, _kind( other._kind.load( std::memory_order_relaxed ) )
 	{
-		detail::Matrix_<FPT>::getRaw() = other.getRaw();
+		p_copyCache( other );
 	}
 
 #ifdef HOMOG2D_USE_OPENCV
@@ -1807,19 +1848,93 @@ Thus some assert can get triggered elsewhere.
 	Hmatrix_& operator = ( const Hmatrix_<M,FPT>& other )
 	{
 		if( this != &other )
+		{
 			detail::Matrix_<FPT>::getRaw() = other.getRaw();
-		_hasChanged = true;
+			detail::Matrix_<FPT>::_isNormalized = other._isNormalized;
+			_kind.store( other._kind.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+			p_copyCache( other );
+		}
 		return *this;
 	}
 
-/// Inverse matrix
+/// Inverse matrix. Closed-form if the transformation is not projective
 	Hmatrix_& inverse()
 	{
-		detail::Matrix_<FPT>::inverse();
-		normalize();
+		if( kind() == HKind::Projective )
+		{
+			detail::Matrix_<FPT>::inverse();
+			normalize();
+			p_resetCache();
+			return *this;
+		}
+		auto& mat = detail::Matrix_<FPT>::_mdata;
+		HOMOG2D_INUMTYPE a = mat[0][0], b = mat[0][1], tx = mat[0][2];
+		HOMOG2D_INUMTYPE c = mat[1][0], d = mat[1][1], ty = mat[1][2];
+		auto det = a * d - b * c;
+		if( homog2d_abs(det) < thr::nullDeter() )
+			HOMOG2D_THROW_ERROR_1( "matrix is not invertible, det=" << std::scientific << homog2d_abs(det) );
+		mat[0][0] =  d / det;
+		mat[0][1] = -b / det;
+		mat[1][0] = -c / det;
+		mat[1][1] =  a / det;
+		mat[0][2] = -( mat[0][0] * tx + mat[0][1] * ty );
+		mat[1][2] = -( mat[1][0] * tx + mat[1][1] * ty );
+		p_resetCache();                   // kind is unchanged
 		return *this;
 	}
 
+/// Transpose matrix
+	Hmatrix_& transpose()
+	{
+		detail::Matrix_<FPT>::transpose();
+		p_resetCache();
+		p_unknownKind();
+		return *this;
+	}
+
+/// Returns the kind of transformation, see HKind
+/**
+Set by the setXxx() and addXxx() member functions, and kept when combining or inverting matrices.
+Otherwise (matrix filled with values), it is detected from these:
+a non-projective matrix must have (0,0,1) as last row, once normalized.
+*/
+	HKind kind() const
+	{
+		auto k = _kind.load( std::memory_order_relaxed );
+		if( k == s_unknownKind )
+		{
+			k = static_cast<int>( p_detectKind() );
+			_kind.store( k, std::memory_order_relaxed );
+		}
+		return static_cast<HKind>( k );
+	}
+
+/// \name Element access (these hide the base class functions, as the kind of matrix may change)
+///@{
+	using detail::Matrix_<FPT>::value;
+	using detail::Matrix_<FPT>::getRaw;
+
+	template<typename T>
+	void set( size_t r, size_t c, T v )
+	{
+		detail::Matrix_<FPT>::set( r, c, v );
+		p_resetCache();
+		p_unknownKind();
+	}
+	FPT& value( size_t r, size_t c )
+	{
+		p_resetCache();
+		p_unknownKind();
+		return detail::Matrix_<FPT>::value( r, c );
+	}
+	detail::matrix_t<FPT>& getRaw()
+	{
+		p_resetCache();
+		p_unknownKind();
+		return detail::Matrix_<FPT>::getRaw();
+	}
+///@}
+
 #if 0
 /// Setter \warning No normalization is done, as this can be done
 /// several times to store values, we therefore must not normalize in between
@@ -1835,7 +1950,7 @@ Thus some assert can get triggered elsewhere.
 		#endif
 		_data[r][c] = v;
 		_isNormalized = false;
-		_hasChanged = true;
+		p_resetCache();
 	}
 
 /// Getter
@@ -1854,6 +1969,8 @@ Thus some assert can get triggered elsewhere.
 	void init()
 	{
 		impl_mat_init0( detail::BaseHelper<M>() );
+		p_resetCache();
+		p_setKind( HKind::Rigid );
 	}
 
 /// \name Adding/assigning a transformation
@@ -1880,7 +1997,8 @@ Thus some assert can get triggered elsewhere.
 		mat[0][2] = tx;
 		mat[1][2] = ty;
 		detail::Matrix_<FPT>::_isNormalized = true;
-		_hasChanged = true;
+		p_resetCache();
+		p_setKind( HKind::Rigid );
 		return *this;
 	}
 /// Adds a rotation with an angle \c theta (radians) to the matrix
@@ -1904,7 +2022,8 @@ Thus some assert can get triggered elsewhere.
 		mat[1][0] = std::sin(theta);
 		mat[0][1] = -mat[1][0];
 		detail::Matrix_<FPT>::_isNormalized = true;
-		_hasChanged = true;
+		p_resetCache();
+		p_setKind( HKind::Rigid );
 		return *this;
 	}
 /// Adds the same scale factor to the matrix
@@ -1923,7 +2042,7 @@ Thus some assert can get triggered elsewhere.
 		Hmatrix_ out;
 		out.setScale( kx, ky );
 		*this = out * *this;
-		_hasChanged = true;
+		p_resetCache();
 		return *this;
 	}
 /// Sets the matrix as a scaling transformation (same on two axis)
@@ -1944,7 +2063,11 @@ Thus some assert can get triggered elsewhere.
 		mat[0][0] = kx;
 		mat[1][1] = ky;
 		detail::Matrix_<FPT>::_isNormalized = true;
-		_hasChanged = true;
+		p_resetCache();
+		if( homog2d_abs( mat[0][0] ) != homog2d_abs( mat[1][1] ) )
+			p_setKind( HKind::Affine );
+		else
+			p_setKind( homog2d_abs( mat[0][0] ) == 1. ? HKind::Rigid : HKind::Similarity );
 		return *this;
 	}
 ///@}
@@ -1952,49 +2075,96 @@ Thus some assert can get triggered elsewhere.
 	template<typename T>
 	void applyTo( T& ) const;
 
+	template<typename T>
+	void applyTo( T*, T*, size_t ) const;
+
+	template<typename T1,typename T2>
+	void applyTo( const T1*, const T1*, T2*, T2*, size_t ) const;
+
 #ifdef HOMOG2D_USE_OPENCV
 	void copyTo( cv::Mat&, int type=CV_64F ) const;
 	Hmatrix_& operator = ( const cv::Mat& );
 #endif
 
 /// Homography normalisation
-/// (const because flag \c _hasChanged declared as \c mutable)
+/**
+Const because this does not change the transformation (and the data is declared as \c mutable).
+This is the only const member function that is not thread-safe.
+*/
 	void normalize() const
 	{
 		detail::Matrix_<FPT>::p_normalizeMat(2,2);
-		_hasChanged = true;
+		auto k = _kind.load( std::memory_order_relaxed );
+		if( k == s_unknownKind || k == static_cast<int>( HKind::Projective ) ) // else, last row is already (0,0,1)
+			p_unknownKind();
+	}
+
+/// Computes the values that are otherwise computed on first use (kind of transformation and
+/// inverse transposed matrix, used to transform lines)
+/**
+Const member functions can be called concurrently from several threads, but the first use may then
+compute these values more than once. Calling this before sharing the object avoids that.
+These values are kept when copying the object.
+*/
+	void precompute() const
+	{
+		kind();
+		detail::Matrix_<FPT> tmp;
+		p_getInvTransp( tmp );
 	}
 
 	void buildFrom4Points( const std::vector<Point2d_<FPT>>&, const std::vector<Point2d_<FPT>>&, int method=1 );
 
-/// Matrix multiplication, call the base class product
+	template<typename CONT1,typename CONT2>
+	void buildFromPoints( const CONT1&, const CONT2& );
+
+/// Matrix multiplication, call the base class product (or only multiplies the upper 2x3 parts if not projective)
 	friend Hmatrix_ operator * ( const Hmatrix_& h1, const Hmatrix_& h2 )
 	{
 		Hmatrix_ out;
-		detail::product( out, static_cast<detail::Matrix_<FPT>>(h1), static_cast<detail::Matrix_<FPT>>(h2) ) ;
-		out.normalize();
-		out._hasChanged = true;
+		auto k1 = h1.kind();
+		auto k2 = h2.kind();
+		if( k1 == HKind::Projective || k2 == HKind::Projective )
+		{
+			detail::product( out, static_cast<detail::Matrix_<FPT>>(h1), static_cast<detail::Matrix_<FPT>>(h2) ) ;
+			out.p_unknownKind();
+			out.normalize();
+			return out;
+		}
+		const auto& m1 = h1._mdata;
+		const auto& m2 = h2._mdata;
+		auto& mo = out._mdata;
+		for( int i=0; i<2; i++ )
+		{
+			for( int j=0; j<3; j++ )
+				mo[i][j] = static_cast<HOMOG2D_INUMTYPE>( m1[i][0] ) * m2[0][j]
+					+ static_cast<HOMOG2D_INUMTYPE>( m1[i][1] ) * m2[1][j];
+			mo[i][2] += m1[i][2];
+		}
+		out._isNormalized = true;
+		out.p_setKind( std::max( k1, k2 ) );
 		return out;
 	}
 
-/// Comparison operator. Does normalization if required
+/// Comparison operator. Does normalization if required (on copies, so the objects are not modified)
 /**
 This does an absolute comparison of all matrix elements, one by one,
 and if one differs more than the threshold, it will return false
 */
 	bool operator == ( const Hmatrix_& h ) const
 	{
-		auto& data = detail::Matrix_<FPT>::_mdata;
-
-		if( !detail::Matrix_<FPT>::isNormalized() )
-			normalize();
-		if( !h.isNormalized() )
-			h.normalize();
+		Hmatrix_ h1( *this );
+		Hmatrix_ h2( h );
+		if( !h1.isNormalized() )
+			h1.normalize();
+		if( !h2.isNormalized() )
+			h2.normalize();
 
+		const auto& data = h1._mdata;
 		for( int i=0; i<3; i++ )
 			for( int j=0; j<3; j++ )
 				if( std::fabs(
-					static_cast<HOMOG2D_INUMTYPE>( data[i][j] ) - h.value(i,j) )
+					static_cast<HOMOG2D_INUMTYPE>( data[i][j] ) - h2._mdata[i][j] )
 					>= thr::nullDeter()
 				)
 					return false;
@@ -2030,12 +2200,97 @@ private:
 		detail::Matrix_<FPT>::_isNormalized = true;
 	}
 
+	void p_setKind( HKind k ) const
+	{
+		_kind.store( static_cast<int>( k ), std::memory_order_relaxed );
+	}
+	void p_unknownKind() const
+	{
+		_kind.store( s_unknownKind, std::memory_order_relaxed );
+	}
+
+/// To be called after any change of the matrix
+	void p_resetCache()
+	{
+		_hmtState.store( CacheState::Empty, std::memory_order_relaxed );
+	}
+
+	void p_copyCache( const Hmatrix_& other )
+	{
+		if( other._hmtState.load( std::memory_order_acquire ) == CacheState::Ready )
+		{
+			_hmt = other._hmt;
+			_hmtState.store( CacheState::Ready, std::memory_order_release );
+		}
+		else
+			_hmtState.store( CacheState::Empty, std::memory_order_relaxed );
+	}
+
+/// Returns \f$ H^{-T} \f$, computed on first call (thread-safe, lock-free)
+/**
+The first thread that gets to store the computed matrix does so, others use their own copy, stored in \c tmp.
+Once stored, the cached matrix is only read.
+*/
+	const detail::Matrix_<FPT>& p_getInvTransp( detail::Matrix_<FPT>& tmp ) const
+	{
+		auto state = _hmtState.load( std::memory_order_acquire );
+		if( state == CacheState::Ready )
+			return _hmt;
+
+		Hmatrix_ hit( *this );
+		hit.inverse();
+		hit.transpose();
+		if(
+			state == CacheState::Empty
+			&& _hmtState.compare_exchange_strong( state, CacheState::Busy, std::memory_order_acquire )
+		)
+		{
+			_hmt = hit;
+			_hmtState.store( CacheState::Ready, std::memory_order_release );
+			return _hmt;
+		}
+		tmp = hit;
+		return tmp;
+	}
+
+/// Detects the kind of transformation from the matrix values, see kind()
+/**
+The similarity tests are done up to a threshold, relative to the values of the linear part.
+A matrix that is "nearly" a similarity will be considered as affine, which is always correct.
+*/
+	HKind p_detectKind() const
+	{
+		const auto& mat = detail::Matrix_<FPT>::_mdata;
+		if( mat[2][0] != 0. || mat[2][1] != 0. || mat[2][2] != 1. )
+			return HKind::Projective;
+
+		HOMOG2D_INUMTYPE a = mat[0][0], b = mat[0][1];
+		HOMOG2D_INUMTYPE c = mat[1][0], d = mat[1][1];
+		auto eps = thr::nullDeter() * ( homog2d_abs(a) + homog2d_abs(b) + homog2d_abs(c) + homog2d_abs(d) );
+		bool isSim =
+			( homog2d_abs( a - d ) <= eps && homog2d_abs( b + c ) <= eps )  // rotation
+			||
+			( homog2d_abs( a + d ) <= eps && homog2d_abs( b - c ) <= eps ); // mirroring
+		if( !isSim )
+			return HKind::Affine;
+		if( homog2d_abs( homog2d_abs( a * d - b * c ) - 1. ) <= eps )
+			return HKind::Rigid;
+		return HKind::Similarity;
+	}
+
 //////////////////////////
 //      DATA SECTION    //
 //////////////////////////
 private:
-	mutable bool _hasChanged   = true;
-	mutable std::unique_ptr<detail::Matrix_<FPT>> _hmt; ///< used to store \f$ H^{-1} \f$, but only if required
+	enum class CacheState: uint8_t { Empty, Busy, Ready };
+	static constexpr int s_unknownKind = -1;
+
+// the atomic values must not be stored in the tail padding of the matrices, as this may be read when copying them
+	alignas( alignof( detail::Matrix_<FPT> ) )
+	mutable std::atomic<int>        _kind{ s_unknownKind };           ///< value of HKind, or \c s_unknownKind if it must be detected from values
+	mutable detail::Matrix_<FPT>    _hmt;                             ///< used to store \f$ H^{-T} \f$, but only if required
+	alignas( alignof( detail::Matrix_<FPT> ) )
+	mutable std::atomic<CacheState> _hmtState{ CacheState::Empty };   ///< state of \c _hmt
 
 	friend std::ostream& operator << ( std::ostream& f, const Hmatrix_& h )
 	{
@@ -2089,6 +2344,10 @@ template<typename T> struct HasArea<base::PolylineBase<typename typ::IsClosed,T>
 template<typename T> struct PolIsClosed                                              : std::false_type {};
 template<typename T> struct PolIsClosed<base::PolylineBase<typename typ::IsClosed,T>>: std::true_type  {};
 
+/// Traits class, true for both open and closed polylines
+template<typename T>              struct IsPolyline                           : std::false_type {};
+template<typename T1,typename T2> struct IsPolyline<base::PolylineBase<T1,T2>>: std::true_type  {};
+
 
 /// Traits class used in operator * ( const Hmatrix_<typ::IsHomogr,FPT>& h, const Cont& vin ),
 /// used to detect if container is valid
@@ -2097,6 +2356,11 @@ template <typename T,std::size_t N> struct IsContainer<std::array<T,N>>    : std
 template <typename... Ts>           struct IsContainer<std::vector<Ts...>> : std::true_type {};
 template <typename... Ts>           struct IsContainer<std::list<Ts...  >> : std::true_type {};
 
+/// Traits class used to detect if container \c T is a \c std::list
+/** (because storage is not contiguous, see operator * ( const Hmatrix_&, const Cont& ) ) */
+template <typename T>           struct IsList                    : std::false_type {};
+template <typename... Ts>       struct IsList<std::list<Ts...>>  : std::true_type {};
+
 /// Traits class used to detect if container \c T is a \c std::array
 /** (because allocation is different, see \ref alloc() ) */
 template <typename T>           struct IsArray                   : std::false_type {};
@@ -3816,6 +4080,8 @@ private:
 	friend void
 	detail::product( base::LPBase<T1,FPT1>&, const detail::Matrix_<FPT2>&, const base::LPBase<T2,FPT1>& );
 
+	template<typename T1> friend class detail::BatchTransform;
+
 	template<typename T1,typename T2>
 	friend Line2d_<T1>
 	priv::getOrthogonalLine_B2( const Point2d_<T2>&, const Line2d_<T1>& );
@@ -4687,6 +4953,256 @@ ptIsInside( const Point2d_<FPT1>& pt, const Point2d_<FPT2>& p00, const Point2d_<
 	return false;
 }
 
+//------------------------------------------------------------------
+/// Built-in homography estimation from point correspondences, see detail::computeHomogrDLT()
+namespace dlt {
+
+/// 9x9 matrix, used for the triangular factor of the DLT system
+using Mat9 = std::array<std::array<HOMOG2D_INUMTYPE,9>,9>;
+
+/// Similarity used for Hartley normalisation: \f$ x' = s (x - c_x) \f$, \f$ y' = s (y - c_y) \f$
+struct NormTransf
+{
+	HOMOG2D_INUMTYPE _cx = 0.;
+	HOMOG2D_INUMTYPE _cy = 0.;
+	HOMOG2D_INUMTYPE _s  = 1.;
+};
+
+//------------------------------------------------------------------
+/// Computes the Hartley normalisation of the \c n points <code>pts[idx(i)]</code>:
+/// centroid moved to the origin, and average distance to the origin equal to \f$ \sqrt{2} \f$
+/**
+Returns false if all the points are the same (or not finite).
+*/
+template<typename FPT,typename IDX>
+bool
+getNormTransf( const Point2d_<FPT>* pts, const IDX& idx, size_t n, NormTransf& nt )
+{
+	HOMOG2D_INUMTYPE cx = 0.;
+	HOMOG2D_INUMTYPE cy = 0.;
+	for( size_t i=0; i<n; i++ )
+	{
+		const auto& pt = pts[idx(i)];
+		cx += pt.getX();
+		cy += pt.getY();
+	}
+	cx /= n;
+	cy /= n;
+
+	HOMOG2D_INUMTYPE sumDist = 0.;
+	for( size_t i=0; i<n; i++ )
+	{
+		const auto& pt = pts[idx(i)];
+		HOMOG2D_INUMTYPE dx = pt.getX() - cx;
+		HOMOG2D_INUMTYPE dy = pt.getY() - cy;
+		sumDist += homog2d_sqrt( dx*dx + dy*dy );
+	}
+	if( !( sumDist > thr::nullDistance() ) )   // also catches NaN
+		return false;
+
+	nt._cx = cx;
+	nt._cy = cy;
+	nt._s  = homog2d_sqrt( static_cast<HOMOG2D_INUMTYPE>(2.) ) * n / sumDist;
+	return true;
+}
+
+//------------------------------------------------------------------
+/// Adds row \c row to the upper triangular matrix \c R, using Givens rotations
+/**
+Thus, after adding all the rows of matrix A, we have \f$ A = Q R \f$, without ever storing A or Q.
+Working on R instead of \f$ A^T A \f$ avoids squaring the condition number.
+*/
+inline
+void
+addRow( Mat9& R, std::array<HOMOG2D_INUMTYPE,9>& row )
+{
+	for( size_t k=0; k<9; k++ )
+	{
+		if( row[k] == 0. )
+			continue;
+		auto r = homog2d_sqrt( R[k][k]*R[k][k] + row[k]*row[k] );
+		auto c = R[k][k] / r;
+		auto sn = row[k] / r;
+		R[k][k] = r;
+		row[k]  = 0.;
+		for( size_t j=k+1; j<9; j++ )
+		{
+			auto rkj = R[k][j];
+			R[k][j] =  c * rkj + sn * row[j];
+			row[j]  = -sn * rkj + c * row[j];
+		}
+	}
+}
+
+//------------------------------------------------------------------
+/// Computes the right singular vector of \c R associated to its smallest singular value,
+/// using the one-sided Jacobi method
+/**
+Columns of R are rotated until they are orthogonal, the rotations are accumulated in V.
+Then, the column norms are the singular values, and the columns of V are the right singular vectors.
+
+Returns false if the smallest singular value is not unique (rank of R less than 8), in which case
+the solution is undefined.
+*/
+inline
+bool
+getNullVector( Mat9& R, std::array<HOMOG2D_INUMTYPE,9>& vout )
+{
+	Mat9 V{};
+	for( size_t i=0; i<9; i++ )
+		V[i][i] = 1.;
+
+	HOMOG2D_INUMTYPE frob2 = 0.;     // squared Frobenius norm, unchanged by the rotations
+	for( const auto& li: R )
+		for( const auto& e: li )
+			frob2 += e * e;
+
+	const HOMOG2D_INUMTYPE tol = 1E-15;
+	bool done = false;
+	for( int sweep=0; sweep<60 && !done; sweep++ )
+	{
+		done = true;
+		for( size_t p=0; p<8; p++ )
+			for( size_t q=p+1; q<9; q++ )
+			{
+				HOMOG2D_INUMTYPE alpha = 0., beta = 0., gamma = 0.;
+				for( size_t i=0; i<9; i++ )
+				{
+					alpha += R[i][p] * R[i][p];
+					beta  += R[i][q] * R[i][q];
+					gamma += R[i][p] * R[i][q];
+				}
+				if(
+					homog2d_abs(gamma) <= tol * homog2d_sqrt( alpha*beta )
+					|| homog2d_abs(gamma) <= tol * frob2                  // for null columns
+				)
+					continue;
+				done = false;
+				auto zeta = ( beta - alpha ) / ( 2. * gamma );
+				auto t = ( zeta < 0. ? -1. : 1. ) / ( homog2d_abs(zeta) + homog2d_sqrt( 1. + zeta*zeta ) );
+				auto c = 1. / homog2d_sqrt( 1. + t*t );
+				auto sn = c * t;
+				for( size_t i=0; i<9; i++ )
+				{
+					auto rp = R[i][p];
+					R[i][p] = c * rp - sn * R[i][q];
+					R[i][q] = sn * rp + c * R[i][q];
+					auto vp = V[i][p];
+					V[i][p] = c * vp - sn * V[i][q];
+					V[i][q] = sn * vp + c * V[i][q];
+				}
+			}
+	}
+
+	std::array<HOMOG2D_INUMTYPE,9> sv2;   // squared singular values
+	for( size_t j=0; j<9; j++ )
+	{
+		sv2[j] = 0.;
+		for( size_t i=0; i<9; i++ )
+			sv2[j] += R[i][j] * R[i][j];
+	}
+	size_t iMin = 0, iMax = 0;
+	for( size_t j=1; j<9; j++ )
+	{
+		if( sv2[j] < sv2[iMin] ) iMin = j;
+		if( sv2[j] > sv2[iMax] ) iMax = j;
+	}
+	for( size_t j=0; j<9; j++ )                      // check that the second smallest is not null
+		if( j != iMin && sv2[j] <= thr::nullDenom() * thr::nullDenom() * sv2[iMax] )
+			return false;
+
+	for( size_t i=0; i<9; i++ )
+		vout[i] = V[i][iMin];
+	return true;
+}
+
+} // namespace dlt
+
+//------------------------------------------------------------------
+/// Computes the homography mapping points <code>src[idx(i)]</code> to <code>dst[idx(i)]</code>,
+/// for \c i in [0, \c n), \c n >= 4, using the normalized Direct Linear Transform algorithm
+/**
+- points are first normalized (Hartley normalisation), separately for each set
+- each correspondence brings two rows to the 2n x 9 matrix A, the solution is the vector \c h minimizing
+\f$ \| A h \| \f$ with \f$ \| h \| = 1 \f$, that is the right singular vector of A associated to its smallest singular value
+- A is never stored: it is reduced on the fly to a 9x9 triangular matrix R (see dlt::addRow()), then the
+singular vector is computed on R (see dlt::getNullVector())
+
+Thus, no memory allocation occurs, and the cost is linear with \c n.
+
+Does not throw, returns false if the configuration is degenerate (coincident or collinear points, ...).
+The functor \c idx maps [0, \c n) to the indexes of the points to use, so that a subset of the points can be used.
+
+See R. Hartley, A. Zisserman, "Multiple View Geometry in Computer Vision", 2nd ed., algorithm 4.2.
+*/
+template<typename FPT1,typename FPT2,typename FPT3,typename IDX>
+bool
+computeHomogrDLT(
+	const Point2d_<FPT1>* src,  ///< source points
+	const Point2d_<FPT2>* dst,  ///< destination points
+	const IDX&            idx,  ///< functor giving the indexes of the points to use
+	size_t                n,    ///< nb of points used
+	Homogr_<FPT3>&        H     ///< output homography (unchanged if false is returned)
+)
+{
+	if( n < 4 )
+		return false;
+	dlt::NormTransf n1, n2;
+	if( !dlt::getNormTransf( src, idx, n, n1 ) || !dlt::getNormTransf( dst, idx, n, n2 ) )
+		return false;
+
+	dlt::Mat9 R{};
+	for( size_t i=0; i<n; i++ )
+	{
+		const auto& p1 = src[idx(i)];
+		const auto& p2 = dst[idx(i)];
+		HOMOG2D_INUMTYPE x = ( p1.getX() - n1._cx ) * n1._s;
+		HOMOG2D_INUMTYPE y = ( p1.getY() - n1._cy ) * n1._s;
+		HOMOG2D_INUMTYPE u = ( p2.getX() - n2._cx ) * n2._s;
+		HOMOG2D_INUMTYPE v = ( p2.getY() - n2._cy ) * n2._s;
+
+		std::array<HOMOG2D_INUMTYPE,9> row1{ -x, -y, -1., 0., 0., 0., u*x, u*y, u };
+		std::array<HOMOG2D_INUMTYPE,9> row2{ 0., 0., 0., -x, -y, -1., v*x, v*y, v };
+		dlt::addRow( R, row1 );
+		dlt::addRow( R, row2 );
+	}
+
+	std::array<HOMOG2D_INUMTYPE,9> h;
+	if( !dlt::getNullVector( R, h ) )
+		return false;
+
+// check that the normalized solution is not singular (h has a unit norm)
+	auto det = h[0] * ( h[4]*h[8] - h[5]*h[7] )
+		- h[1] * ( h[3]*h[8] - h[5]*h[6] )
+		+ h[2] * ( h[3]*h[7] - h[4]*h[6] );
+	if( homog2d_abs(det) < thr::nullDenom() )
+		return false;
+
+// denormalisation: H = T2^-1 Hn T1, with T = [ s 0 -s.cx ; 0 s -s.cy ; 0 0 1 ]
+	std::array<std::array<HOMOG2D_INUMTYPE,3>,3> m;
+	for( size_t r=0; r<3; r++ )                     // m = Hn T1
+	{
+		m[r][0] = h[r*3] * n1._s;
+		m[r][1] = h[r*3+1] * n1._s;
+		m[r][2] = h[r*3+2] - n1._s * ( h[r*3] * n1._cx + h[r*3+1] * n1._cy );
+	}
+	for( size_t c=0; c<3; c++ )                     // m = T2^-1 m
+	{
+		m[0][c] = m[0][c] / n2._s + n2._cx * m[2][c];
+		m[1][c] = m[1][c] / n2._s + n2._cy * m[2][c];
+	}
+
+	HOMOG2D_INUMTYPE sum = 0.;                      // (required for normalisation)
+	for( const auto& li: m )
+		for( const auto& e: li )
+			sum += homog2d_abs(e);
+	if( homog2d_abs( m[2][2] ) < thr::nullDenom() * sum )
+		return false;
+
+	H = Homogr_<FPT3>( m );
+	return true;
+}
+
 #ifdef HOMOG2D_USE_EIGEN
 ///  Build Homography from 2 sets of 4 points, using Eigen
 /**
@@ -4772,7 +5288,7 @@ Homogr_<FPT>
 buildFrom4Points(
 	const std::vector<Point2d_<FPT>>& vpt1,     ///< source points
 	const std::vector<Point2d_<FPT>>& vpt2,     ///< destination points
-	int                               method=1  ///< 0: Eigen, 1: Opencv
+	int                               method=1  ///< 0: Eigen, 1: Opencv, 2: built-in
 )
 {
 	Homogr_<FPT> H;
@@ -4780,13 +5296,28 @@ buildFrom4Points(
 	return H;
 }
 
+//------------------------------------------------------------------
+/// Build Homography from 2 sets of at least 4 points (free function)
+/// \sa Homogr_::buildFromPoints()
+template<typename CONT1,typename CONT2>
+auto
+buildFromPoints(
+	const CONT1& src,     ///< source points
+	const CONT2& dst      ///< destination points
+)
+{
+	Homogr_<typename CONT1::value_type::FType> H;
+	H.buildFromPoints( src, dst );
+	return H;
+}
+
 //------------------------------------------------------------------
 /// Build Homography from 2 sets of 4 points
 /**
-- Requires either Eigen or Opencv
-- we build a 8x8 matrix A and a 8x1 vector B, and get the solution from X = A^-1 B
+- with Eigen or Opencv, we build a 8x8 matrix A and a 8x1 vector B, and get the solution from X = A^-1 B
 - see this for details:
 https://skramm.lautre.net/files/misc/Kramm_compute_H_from_4pts.pdf
+- if the requested library is not available, the built-in solver is used (see buildFromPoints())
 
 \sa free function: h2d::buildFrom4Points()
 
@@ -4797,47 +5328,432 @@ void
 Hmatrix_<M,FPT>::buildFrom4Points(
 	const std::vector<Point2d_<FPT>>& vpt1,   ///< source points
 	const std::vector<Point2d_<FPT>>& vpt2,   ///< destination points
-	int                               method  ///< 0: Eigen, 1: Opencv (default)
+	int                               method  ///< 0: Eigen, 1: Opencv (default), 2: built-in
 )
 {
 	if( vpt1.size() != 4 )
 		HOMOG2D_THROW_ERROR_1( "invalid vector size for source points, should be 4, value=" << vpt1.size() );
 	if( vpt2.size() != 4 )
 		HOMOG2D_THROW_ERROR_1( "invalid vector size for dest points, should be 4, value=" << vpt2.size() );
-	assert( method == 0 || method == 1 );
+	assert( method >= 0 && method <= 2 );
 
+#ifdef HOMOG2D_USE_EIGEN
 	if( method == 0 )
 	{
-#ifdef HOMOG2D_USE_EIGEN
 		*this = detail::buildFrom4Points_Eigen( vpt1, vpt2 );
-#else
-		throw std::runtime_error( "Unable, build without Eigen support" );
-#endif
+		return;
 	}
-	else
-	{
+#endif
 #ifdef HOMOG2D_USE_OPENCV
+	if( method == 1 )
+	{
 		*this = detail::buildFrom4Points_Opencv( vpt1, vpt2 );
-#else
-		throw std::runtime_error( "Unable, build without Opencv support" );
-#endif
+		return;
 	}
+#endif
+	buildFromPoints( vpt1, vpt2 );
 }
 
-/// Point related to a OSegment
-///\sa SegVec::getPointSide()
-enum class PointSide: uint8_t
+//------------------------------------------------------------------
+/// Build Homography from 2 sets of at least 4 points (built-in, no external library required)
+/**
+- Containers must be \c std::vector or \c std::array of points, of same size
+- with more than 4 points, the result minimizes an algebraic error (least squares solution)
+- uses the normalized DLT algorithm, see detail::computeHomogrDLT() (no memory allocation)
+- throws if the configuration is degenerate (coincident points, three collinear points out of four, ...)
+
+\sa free function: h2d::buildFromPoints()
+*/
+template<typename M,typename FPT>
+template<typename CONT1,typename CONT2>
+void
+Hmatrix_<M,FPT>::buildFromPoints(
+	const CONT1& src,   ///< source points
+	const CONT2& dst    ///< destination points
+)
 {
-	Left,Right,Neither
+	static_assert( std::is_same_v<M,typ::IsHomogr>, "Invalid: only for homographies" );
+	static_assert(
+		trait::IsPoint<typename CONT1::value_type>::value && trait::IsPoint<typename CONT2::value_type>::value,
+		"Containers must hold points"
+	);
+	static_assert(
+		!trait::IsList<CONT1>::value && !trait::IsList<CONT2>::value,
+		"Containers must be std::vector or std::array"
+	);
+#ifndef HOMOG2D_NOCHECKS
+	if( src.size() != dst.size() )
+		HOMOG2D_THROW_ERROR_1( "source and dest points sets have different sizes: " << src.size() << " and " << dst.size() );
+	if( src.size() < 4 )
+		HOMOG2D_THROW_ERROR_1( "invalid number of points, should be at least 4, value=" << src.size() );
+#endif
+	Hmatrix_ H;
+	if( !detail::computeHomogrDLT( src.data(), dst.data(), [](size_t i){ return i; }, src.size(), H ) )
+		HOMOG2D_THROW_ERROR_1( "unable to compute homography, degenerate configuration of points" );
+	*this = H;
+}
+
+//------------------------------------------------------------------
+/// Parameters for buildFromPointsRansac()
+struct RansacParams
+{
+/// Maximum distance between a transformed source point and its destination point, for the pair to be an inlier
+	HOMOG2D_INUMTYPE _threshold = 3.;
+/// Required probability of having drawn at least one sample holding only inliers, used to stop early
+	HOMOG2D_INUMTYPE _confidence = 0.99;
+/// Maximum number of hypotheses (random samples of 4 pairs)
+	size_t _maxIter = 2000;
+/// Number of threads (0: \c std::thread::hardware_concurrency() )
+	size_t _nbThreads = 0;
+/// If true, each new best hypothesis is refined using its inliers (LO-RANSAC)
+	bool _localOptim = true;
+/// Seed of the random generators (results are reproducible only with one thread)
+	unsigned _seed = 0;
 };
 
-inline
-const char*
-getString( PointSide t )
+//------------------------------------------------------------------
+/// Returned by buildFromPointsRansac()
+template<typename FPT>
+struct RansacResult
 {
-	const char* s=0;
-	switch( t )
-	{
+	Homogr_<FPT>      _H;               ///< the homography
+	std::vector<bool> _inliers;         ///< inlier mask, same size as the input sets
+	size_t            _nbInliers = 0;   ///< number of \c true values in \c _inliers
+	size_t            _nbIter    = 0;   ///< number of hypotheses that were evaluated
+};
+
+namespace priv {
+/// Private stuff for buildFromPointsRansac()
+namespace ransac {
+
+//------------------------------------------------------------------
+/// Points stored as "Structure of Arrays", so the scoring kernel can get vectorized
+struct Data
+{
+	std::vector<HOMOG2D_INUMTYPE> _x1, _y1, _x2, _y2;
+
+	template<typename FPT1,typename FPT2>
+	Data( const std::vector<Point2d_<FPT1>>& src, const std::vector<Point2d_<FPT2>>& dst )
+		: _x1( src.size() ), _y1( src.size() ), _x2( src.size() ), _y2( src.size() )
+	{
+		for( size_t i=0; i<src.size(); i++ )
+		{
+			_x1[i] = src[i].getX();
+			_y1[i] = src[i].getY();
+			_x2[i] = dst[i].getX();
+			_y2[i] = dst[i].getY();
+		}
+	}
+	size_t size() const { return _x1.size(); }
+};
+
+/// The 9 values of a homography
+using Hvalues = std::array<HOMOG2D_INUMTYPE,9>;
+
+template<typename FPT>
+Hvalues
+getValues( const Homogr_<FPT>& H )
+{
+	Hvalues h;
+	for( int i=0; i<9; i++ )
+		h[i] = H.value( i/3, i%3 );
+	return h;
+}
+
+//------------------------------------------------------------------
+/// Batched reprojection error kernel: returns the MSAC score of \c h (lower is better) and its number of inliers
+/**
+The score is the sum over all the pairs of the squared distances between transformed source point and destination point,
+each one truncated to \c thr2 (so outliers all have the same cost).
+The loop has no branches (points going to infinity get the cost \c thr2), so it gets vectorized.
+*/
+inline
+HOMOG2D_INUMTYPE
+score( const Hvalues& h, const Data& data, HOMOG2D_INUMTYPE thr2, size_t& nbInliers )
+{
+	const auto h0 = h[0], h1 = h[1], h2 = h[2];
+	const auto h3 = h[3], h4 = h[4], h5 = h[5];
+	const auto h6 = h[6], h7 = h[7], h8 = h[8];
+	const auto* x1 = data._x1.data();
+	const auto* y1 = data._y1.data();
+	const auto* x2 = data._x2.data();
+	const auto* y2 = data._y2.data();
+
+	HOMOG2D_INUMTYPE sum = 0.;
+	size_t nb = 0;
+	for( size_t i=0; i<data.size(); i++ )
+	{
+		HOMOG2D_INUMTYPE iw = 1. / ( h6 * x1[i] + h7 * y1[i] + h8 );
+		HOMOG2D_INUMTYPE dx = ( h0 * x1[i] + h1 * y1[i] + h2 ) * iw - x2[i];
+		HOMOG2D_INUMTYPE dy = ( h3 * x1[i] + h4 * y1[i] + h5 ) * iw - y2[i];
+		HOMOG2D_INUMTYPE e2 = dx*dx + dy*dy;
+		bool isIn = ( e2 < thr2 );            // false if NaN
+		nb  += isIn;
+		sum += isIn ? e2 : thr2;
+	}
+	nbInliers = nb;
+	return sum;
+}
+
+/// Stores in \c vidx the indexes of the inliers of \c h
+inline
+void
+getInliers( const Hvalues& h, const Data& data, HOMOG2D_INUMTYPE thr2, std::vector<size_t>& vidx )
+{
+	vidx.clear();
+	for( size_t i=0; i<data.size(); i++ )
+	{
+		HOMOG2D_INUMTYPE iw = 1. / ( h[6] * data._x1[i] + h[7] * data._y1[i] + h[8] );
+		HOMOG2D_INUMTYPE dx = ( h[0] * data._x1[i] + h[1] * data._y1[i] + h[2] ) * iw - data._x2[i];
+		HOMOG2D_INUMTYPE dy = ( h[3] * data._x1[i] + h[4] * data._y1[i] + h[5] ) * iw - data._y2[i];
+		if( dx*dx + dy*dy < thr2 )
+			vidx.push_back( i );
+	}
+}
+
+//------------------------------------------------------------------
+/// Number of iterations required to draw at least once a sample of 4 inliers, with probability \c conf,
+/// given the inlier ratio \c w
+inline
+size_t
+getNbIter( HOMOG2D_INUMTYPE w, HOMOG2D_INUMTYPE conf, size_t maxIter )
+{
+	auto w4 = w * w * w * w;
+	if( w4 >= 1. )
+		return 1;
+	auto den = std::log( 1. - w4 );
+	if( !( den < 0. ) )                     // w4 too small
+		return maxIter;
+	auto nb = std::ceil( std::log( 1. - conf ) / den );
+	return nb < static_cast<HOMOG2D_INUMTYPE>( maxIter ) ? std::max( size_t(1), static_cast<size_t>( nb ) ) : maxIter;
+}
+
+//------------------------------------------------------------------
+/// Best hypothesis found so far, shared by the threads
+struct Best
+{
+	std::mutex          _mtx;
+	Hvalues             _h;
+	HOMOG2D_INUMTYPE    _score;
+	size_t              _nbInliers = 0;
+	bool                _found = false;
+	std::atomic<size_t> _iter{ 0 };     ///< counter of drawn samples
+	std::atomic<size_t> _maxIter;       ///< required number of samples, lowered as better hypotheses are found
+	std::atomic<size_t> _nbEval{ 0 };   ///< number of hypotheses actually evaluated
+
+	Best( HOMOG2D_INUMTYPE scoreInit, size_t maxIter )
+		: _score( scoreInit ), _maxIter( maxIter )
+	{}
+};
+
+//------------------------------------------------------------------
+/// Local optimisation: refit the homography on its inliers, as long as the score gets better (LO-RANSAC)
+template<typename FPT1,typename FPT2>
+void
+localOptim(
+	const std::vector<Point2d_<FPT1>>& src,
+	const std::vector<Point2d_<FPT2>>& dst,
+	const Data&                        data,
+	HOMOG2D_INUMTYPE                   thr2,
+	Hvalues&                           h,
+	HOMOG2D_INUMTYPE&                  sc,
+	size_t&                            nbInliers,
+	std::vector<size_t>&               vidx     ///< buffer
+)
+{
+	for( int i=0; i<5; i++ )
+	{
+		getInliers( h, data, thr2, vidx );
+		Homogr_<HOMOG2D_INUMTYPE> H;
+		if( !detail::computeHomogrDLT( src.data(), dst.data(), [&vidx](size_t j){ return vidx[j]; }, vidx.size(), H ) )
+			return;
+		auto h2 = getValues( H );
+		size_t nb2;
+		auto sc2 = score( h2, data, thr2, nb2 );
+		if( !( sc2 < sc ) )
+			return;
+		h  = h2;
+		sc = sc2;
+		nbInliers = nb2;
+	}
+}
+
+//------------------------------------------------------------------
+/// Hypotheses generation and scoring, run by each thread
+template<typename FPT1,typename FPT2>
+void
+worker(
+	const std::vector<Point2d_<FPT1>>& src,
+	const std::vector<Point2d_<FPT2>>& dst,
+	const Data&                        data,
+	const RansacParams&                params,
+	unsigned                           seed,
+	Best&                              best
+)
+{
+	const auto n = data.size();
+	const auto thr2 = params._threshold * params._threshold;
+	std::mt19937 rng( seed );
+	std::uniform_int_distribution<size_t> distrib( 0, n-1 );
+	std::array<size_t,4> sample;
+	std::vector<size_t> vidx;
+
+	HOMOG2D_INUMTYPE bestScore;
+	{
+		std::lock_guard<std::mutex> lock( best._mtx );
+		bestScore = best._score;
+	}
+
+	while( best._iter.fetch_add( 1, std::memory_order_relaxed ) < best._maxIter.load( std::memory_order_relaxed ) )
+	{
+		for( size_t i=0; i<4; i++ )               // draw 4 different indexes
+		{
+			bool isNew;
+			do
+			{
+				sample[i] = distrib( rng );
+				isNew = true;
+				for( size_t j=0; j<i; j++ )
+					isNew = isNew && ( sample[j] != sample[i] );
+			}
+			while( !isNew );
+		}
+
+		Homogr_<HOMOG2D_INUMTYPE> H;
+		if( !detail::computeHomogrDLT( src.data(), dst.data(), [&sample](size_t i){ return sample[i]; }, 4, H ) )
+			continue;
+		best._nbEval.fetch_add( 1, std::memory_order_relaxed );
+
+		auto h = getValues( H );
+		size_t nbInliers;
+		auto sc = score( h, data, thr2, nbInliers );
+		if( !( sc < bestScore ) || nbInliers < 4 )
+			continue;
+
+		if( params._localOptim )
+			localOptim( src, dst, data, thr2, h, sc, nbInliers, vidx );
+
+		std::lock_guard<std::mutex> lock( best._mtx );
+		if( sc < best._score )
+		{
+			best._h         = h;
+			best._score     = sc;
+			best._nbInliers = nbInliers;
+			best._found     = true;
+			auto nbIter = getNbIter( static_cast<HOMOG2D_INUMTYPE>( nbInliers ) / n, params._confidence, params._maxIter );
+			if( nbIter < best._maxIter.load( std::memory_order_relaxed ) )
+				best._maxIter.store( nbIter, std::memory_order_relaxed );
+		}
+		bestScore = best._score;
+	}
+}
+
+} // namespace ransac
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Robust estimation of the homography mapping points \c src to points \c dst, when some pairs are wrong (outliers)
+/**
+- RANSAC: random samples of 4 pairs of points are drawn, the homography computed from each of them
+(see detail::computeHomogrDLT()) is scored on all the pairs, and the best one is kept
+- the score is the MSAC one: sum of the squared transfer errors \f$ \| H p_{src} - p_{dst} \|^2 \f$, each one truncated to
+the squared threshold (see priv::ransac::score())
+- the number of samples drawn is adapted to the best inlier ratio found so far, so that the probability of having drawn
+at least one sample holding only inliers is \c params._confidence (within the limit of \c params._maxIter)
+- if \c params._localOptim is true, each new best hypothesis is refined using its inliers (LO-RANSAC)
+- hypotheses are generated and scored concurrently by \c params._nbThreads threads
+- the final homography is computed from all the inliers of the best hypothesis
+
+Throws if the sets have different sizes or hold less than 4 points, or if no homography could be computed.
+\sa RansacParams, RansacResult
+*/
+template<typename FPT1,typename FPT2>
+RansacResult<FPT1>
+buildFromPointsRansac(
+	const std::vector<Point2d_<FPT1>>& src,                     ///< source points
+	const std::vector<Point2d_<FPT2>>& dst,                     ///< destination points
+	const RansacParams&                params=RansacParams()    ///< parameters
+)
+{
+#ifndef HOMOG2D_NOCHECKS
+	if( src.size() != dst.size() )
+		HOMOG2D_THROW_ERROR_1( "source and dest points sets have different sizes: " << src.size() << " and " << dst.size() );
+	if( src.size() < 4 )
+		HOMOG2D_THROW_ERROR_1( "invalid number of points, should be at least 4, value=" << src.size() );
+	if( params._threshold <= 0. )
+		HOMOG2D_THROW_ERROR_1( "invalid threshold value: " << params._threshold );
+#endif
+	priv::ransac::Data data( src, dst );
+	const auto thr2 = params._threshold * params._threshold;
+	priv::ransac::Best best( thr2 * src.size(), params._maxIter );
+
+	size_t nbThreads = params._nbThreads;
+	if( nbThreads == 0 )
+		nbThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	if( nbThreads == 1 )
+		priv::ransac::worker( src, dst, data, params, params._seed, best );
+	else
+	{
+		std::vector<std::future<void>> vfut;
+		for( size_t t=0; t<nbThreads; t++ )
+			vfut.push_back(
+				std::async(
+					std::launch::async,
+					[&src,&dst,&data,&params,&best,t]     // lambda
+					()
+					{
+						priv::ransac::worker( src, dst, data, params, params._seed + static_cast<unsigned>(t), best );
+					}
+				)
+			);
+		for( auto& fut: vfut )
+			fut.get();
+	}
+	if( !best._found )
+		HOMOG2D_THROW_ERROR_1( "unable to compute homography, no valid hypothesis found" );
+
+// final fit on all the inliers
+	std::vector<size_t> vidx;
+	priv::ransac::getInliers( best._h, data, thr2, vidx );
+	Homogr_<HOMOG2D_INUMTYPE> H;
+	if( detail::computeHomogrDLT( src.data(), dst.data(), [&vidx](size_t j){ return vidx[j]; }, vidx.size(), H ) )
+	{
+		auto h = priv::ransac::getValues( H );
+		size_t nb;
+		if( priv::ransac::score( h, data, thr2, nb ) < best._score )
+		{
+			best._h = h;
+			priv::ransac::getInliers( best._h, data, thr2, vidx );
+		}
+	}
+
+	RansacResult<FPT1> res;
+	std::array<std::array<HOMOG2D_INUMTYPE,3>,3> m;
+	for( int i=0; i<9; i++ )
+		m[i/3][i%3] = best._h[i];
+	res._H = Homogr_<FPT1>( m );
+	res._inliers.resize( src.size(), false );
+	for( auto i: vidx )
+		res._inliers[i] = true;
+	res._nbInliers = vidx.size();
+	res._nbIter    = best._nbEval.load();
+	return res;
+}
+
+/// Point related to a OSegment
+///\sa SegVec::getPointSide()
+enum class PointSide: uint8_t
+{
+	Left,Right,Neither
+};
+
+inline
+const char*
+getString( PointSide t )
+{
+	const char* s=0;
+	switch( t )
+	{
 		case PointSide::Left:    s="Left";    break;
 		case PointSide::Right:   s="Right";   break;
 		case PointSide::Neither: s="Neither"; break;
@@ -4846,6 +5762,198 @@ getString( PointSide t )
 	return s;
 }
 
+namespace priv {
+/// Clipping against an axis-aligned rectangle
+namespace clip {
+
+/// Axis-aligned clipping window
+struct Window
+{
+	HOMOG2D_INUMTYPE _xmin, _ymin, _xmax, _ymax;
+
+	template<typename FPT>
+	explicit Window( const FRect_<FPT>& rect )
+	{
+		auto pts = rect.getPts();
+		_xmin = pts.first.getX();
+		_ymin = pts.first.getY();
+		_xmax = pts.second.getX();
+		_ymax = pts.second.getY();
+	}
+};
+
+//------------------------------------------------------------------
+/// Liang-Barsky clipping of segment (x0,y0)-(x0+dx,y0+dy)
+/**
+Returns false if the segment lies outside, or touches the window on a single point.
+Otherwise, the clipped segment goes from parameter \c t0 to \c t1 (with 0 <= t0 < t1 <= 1).
+*/
+inline
+bool
+liangBarsky(
+	HOMOG2D_INUMTYPE x0, HOMOG2D_INUMTYPE y0,
+	HOMOG2D_INUMTYPE dx, HOMOG2D_INUMTYPE dy,
+	const Window&    win,
+	HOMOG2D_INUMTYPE& t0, HOMOG2D_INUMTYPE& t1
+)
+{
+	t0 = 0.;
+	t1 = 1.;
+	auto clipT = [&t0,&t1]            // lambda
+		( HOMOG2D_INUMTYPE p, HOMOG2D_INUMTYPE q )
+		{
+			if( p == 0. )
+				return q >= 0.;
+			auto r = q / p;
+			if( p < 0. )
+			{
+				if( r > t1 )
+					return false;
+				if( r > t0 )
+					t0 = r;
+			}
+			else
+			{
+				if( r < t0 )
+					return false;
+				if( r < t1 )
+					t1 = r;
+			}
+			return true;
+		};
+	return
+		clipT( -dx, x0 - win._xmin ) && clipT( dx, win._xmax - x0 )
+		&&
+		clipT( -dy, y0 - win._ymin ) && clipT( dy, win._ymax - y0 )
+		&&
+		t0 < t1;
+}
+
+//------------------------------------------------------------------
+/// Streaming Sutherland-Hodgman clipping of a polygon
+/**
+The points go one at a time through the 4 stages (one for each border of the window),
+so no intermediate polygon is stored: the only memory used is the output vector.
+
+Usage: call addPoint() for each point, then close().
+*/
+template<typename FPT>
+class SHClipper
+{
+private:
+	struct Stage
+	{
+		bool             _hasFirst = false;
+		HOMOG2D_INUMTYPE _firstX = 0., _firstY = 0.;
+		HOMOG2D_INUMTYPE _prevX  = 0., _prevY  = 0.;
+	};
+
+	const Window&               _win;
+	std::array<Stage,4>         _stages;
+	std::vector<Point2d_<FPT>>& _out;
+
+/// Stages: 0:left, 1:right, 2:bottom, 3:top
+	bool p_isInside( size_t k, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
+	{
+		switch( k )
+		{
+			case 0:  return x >= _win._xmin;
+			case 1:  return x <= _win._xmax;
+			case 2:  return y >= _win._ymin;
+			default: return y <= _win._ymax;
+		}
+	}
+
+/// Intersection of segment with border \c k, always computed from the inside point, for consistency
+	void p_intersect(
+		size_t k,
+		HOMOG2D_INUMTYPE x1, HOMOG2D_INUMTYPE y1, // inside point
+		HOMOG2D_INUMTYPE x2, HOMOG2D_INUMTYPE y2,
+		HOMOG2D_INUMTYPE& x, HOMOG2D_INUMTYPE& y
+	) const
+	{
+		if( k < 2 )
+		{
+			x = ( k == 0 ? _win._xmin : _win._xmax );
+			y = y1 + ( y2 - y1 ) * ( x - x1 ) / ( x2 - x1 );
+		}
+		else
+		{
+			y = ( k == 2 ? _win._ymin : _win._ymax );
+			x = x1 + ( x2 - x1 ) * ( y - y1 ) / ( y2 - y1 );
+		}
+	}
+
+/// Processes edge (prev,pt) on stage \c k
+	void p_edge( size_t k, HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
+	{
+		bool prevIn = p_isInside( k, px, py );
+		bool curIn  = p_isInside( k, x, y );
+		if( prevIn != curIn )
+		{
+			HOMOG2D_INUMTYPE ix, iy;
+			if( prevIn )
+				p_intersect( k, px, py, x, y, ix, iy );
+			else
+				p_intersect( k, x, y, px, py, ix, iy );
+			p_push( k+1, ix, iy );
+		}
+		if( curIn )
+			p_push( k+1, x, y );
+	}
+
+	void p_push( size_t k, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
+	{
+		if( k == 4 )
+		{
+			Point2d_<FPT> pt( x, y );
+			if( _out.empty() || _out.back() != pt )
+				_out.push_back( pt );
+			return;
+		}
+		auto& st = _stages[k];
+		if( !st._hasFirst )
+		{
+			st._hasFirst = true;
+			st._firstX = x;
+			st._firstY = y;
+			if( p_isInside( k, x, y ) )
+				p_push( k+1, x, y );
+		}
+		else
+			p_edge( k, st._prevX, st._prevY, x, y );
+		st._prevX = x;
+		st._prevY = y;
+	}
+
+public:
+	SHClipper( const Window& win, std::vector<Point2d_<FPT>>& out )
+		: _win(win), _out(out)
+	{}
+
+	template<typename FPT2>
+	void addPoint( const Point2d_<FPT2>& pt )
+	{
+		p_push( 0, pt.getX(), pt.getY() );
+	}
+
+/// Processes the closing edge of each stage, in order
+	void close()
+	{
+		for( size_t k=0; k<4; k++ )
+		{
+			const auto& st = _stages[k];
+			if( st._hasFirst )
+				p_edge( k, st._prevX, st._prevY, st._firstX, st._firstY );
+		}
+		while( _out.size() > 1 && _out.front() == _out.back() )
+			_out.pop_back();
+	}
+};
+
+} // namespace clip
+} // namespace priv
+
 
 
 namespace base {
@@ -5182,7 +6290,7 @@ Requires both points inside AND no intersections
 		if( !p_bothPtsAreInside( cpoly ) )
 			return false;
 
-		for( auto poly_seg: cpoly.getSegs() )
+		for( const auto& poly_seg: cpoly.getSegsView() )
 			if( poly_seg.intersects( *this )() )
 				return false;
 		return true;
@@ -5332,6 +6440,9 @@ public:
 	}
 ///@}
 
+	template<typename FPT2>
+	std::pair<bool,SegVec<SV,FPT>> clip( const FRect_<FPT2>& ) const;
+
 	template<typename U,typename V>
 	friend std::ostream&
 	operator << ( std::ostream&, const SegVec<U,V>& );
@@ -5343,6 +6454,36 @@ public:
 
 }; // class SegVec
 
+//------------------------------------------------------------------
+/// Clips the segment/vector against the rectangle \c rect, using the Liang-Barsky algorithm
+/**
+Returns a pair: the first element is false if the segment lies outside the rectangle (or touches it on a single point),
+else the second element holds the part of the segment that is inside.
+For oriented segments, the orientation is kept.
+
+\sa clip( const T&, const FRect_& )
+*/
+template<typename SV,typename FPT>
+template<typename FPT2>
+std::pair<bool,SegVec<SV,FPT>>
+SegVec<SV,FPT>::clip( const FRect_<FPT2>& rect ) const
+{
+	priv::clip::Window win( rect );
+	HOMOG2D_INUMTYPE x0 = _ptS1.getX();
+	HOMOG2D_INUMTYPE y0 = _ptS1.getY();
+	HOMOG2D_INUMTYPE dx = _ptS2.getX() - x0;
+	HOMOG2D_INUMTYPE dy = _ptS2.getY() - y0;
+	HOMOG2D_INUMTYPE t0, t1;
+	if( !priv::clip::liangBarsky( x0, y0, dx, dy, win, t0, t1 ) )
+		return std::make_pair( false, *this );
+
+	auto p1 = ( t0 == 0. ? _ptS1 : Point2d_<FPT>( x0 + t0*dx, y0 + t0*dy ) );
+	auto p2 = ( t1 == 1. ? _ptS2 : Point2d_<FPT>( x0 + t1*dx, y0 + t1*dy ) );
+	if( p1 == p2 )
+		return std::make_pair( false, *this );
+	return std::make_pair( true, SegVec<SV,FPT>( p1, p2 ) );
+}
+
 //------------------------------------------------------------------
 /// Returns a pair of segments/vectors split by the middle
 template<typename SV,typename FPT>
@@ -5858,7 +6999,7 @@ template<typename T>
 class ValueFlag
 {
 private:
-	T    _value;
+	T    _value{};
 	bool _valIsCorrect = false;
 public:
 	ValueFlag() = default;
@@ -5874,4867 +7015,10021 @@ public:
 
 
 //------------------------------------------------------------------
-/// Holds attribute of a Polyline, allows storage of last computed value through the use of ValueFlag
-struct PolylineAttribs
-{
-	priv::ValueFlag<HOMOG2D_INUMTYPE> _length;
-	priv::ValueFlag<HOMOG2D_INUMTYPE> _area;
-	priv::ValueFlag<bool>             _isSimplePolyg;
-	priv::ValueFlag<Point2d_<HOMOG2D_INUMTYPE>> _centroid;
-
-	void setBad()
-	{
-		_length.setBad();
-		_area.setBad();
-		_isSimplePolyg.setBad();
-		_centroid.setBad();
-	}
-};
-
-//------------------------------------------------------------------
-/// Returns the bounding box of points in vector/list/array of points \c vpts (free function)
+/// Bounding Volume Hierarchy over the segments of a polyline, used to speed up intersection queries
 /**
-\todo This loops twice on the points. Maybe some improvement here.
+Built lazily on first query, and stored along with the other attributes of the polyline
+(see PolylineAttribs), so it gets invalidated in the same way.
+
+Segment \c i is the one between point \c i and point \c i+1 (or point 0 for the last
+segment of a closed polyline).
+Top-down build, splitting on the median of segment centers along the largest dimension.
 */
-template<
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
-PointPair_<typename T::value_type::FType>
-getBB_Points( const T& vpts )
+class SegBVH
 {
-	HOMOG2D_START;
-	using FPT = typename T::value_type::FType;
-	HOMOG2D_DEBUG_ASSERT( static_cast<bool>(vpts.size()), "cannot run with no points" );
+public:
+/// Axis-aligned box
+	struct Box
+	{
+		HOMOG2D_INUMTYPE _xmin = 0.;
+		HOMOG2D_INUMTYPE _ymin = 0.;
+		HOMOG2D_INUMTYPE _xmax = 0.;
+		HOMOG2D_INUMTYPE _ymax = 0.;
 
-	auto mm_x = std::minmax_element(
-		std::begin( vpts ),
-		std::end( vpts ),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		Box() = default;
+		template<typename FPT1,typename FPT2>
+		Box( const Point2d_<FPT1>& p1, const Point2d_<FPT2>& p2 )
 		{
-			return pt1.getX() < pt2.getX();
+			HOMOG2D_INUMTYPE x1 = p1.getX();
+			HOMOG2D_INUMTYPE y1 = p1.getY();
+			HOMOG2D_INUMTYPE x2 = p2.getX();
+			HOMOG2D_INUMTYPE y2 = p2.getY();
+			_xmin = std::min( x1, x2 );
+			_xmax = std::max( x1, x2 );
+			_ymin = std::min( y1, y2 );
+			_ymax = std::max( y1, y2 );
 		}
-	);
-	auto mm_y = std::minmax_element(
-		std::begin( vpts ),
-		std::end( vpts ),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		void add( const Box& other )
 		{
-			return pt1.getY() < pt2.getY();
+			_xmin = std::min( _xmin, other._xmin );
+			_ymin = std::min( _ymin, other._ymin );
+			_xmax = std::max( _xmax, other._xmax );
+			_ymax = std::max( _ymax, other._ymax );
 		}
-	);
+		bool overlaps( const Box& other, HOMOG2D_INUMTYPE margin ) const
+		{
+			return !(
+				_xmin > other._xmax + margin || other._xmin > _xmax + margin
+				||
+				_ymin > other._ymax + margin || other._ymin > _ymax + margin
+			);
+		}
+		HOMOG2D_INUMTYPE size() const
+		{
+			return std::max( _xmax - _xmin, _ymax - _ymin );
+		}
+/// Returns an empty box, that overlaps nothing
+		static Box empty()
+		{
+			Box box;
+			box._xmin = box._ymin =  std::numeric_limits<HOMOG2D_INUMTYPE>::max();
+			box._xmax = box._ymax = -std::numeric_limits<HOMOG2D_INUMTYPE>::max();
+			return box;
+		}
+	};
 
-	auto p1 = Point2d_<HOMOG2D_INUMTYPE>( mm_x.first->getX(),   mm_y.first->getY()  );
-	auto p2 = Point2d_<HOMOG2D_INUMTYPE>( mm_x.second->getX(),  mm_y.second->getY() );
+private:
+	struct Node
+	{
+		Box    _box;
+		size_t _first = 0;  ///< leaf: index of first element in \c _segIdx, inner node: index of first child (second is next one)
+		size_t _count = 0;  ///< nb of segments if leaf, 0 for inner nodes
+	};
 
-#ifndef HOMOG2D_NOCHECKS
-	if( p1.distTo( p2 ) < thr::nullDistance() )
-		HOMOG2D_THROW_ERROR_1(
-			"unable to compute bounding box of set, identical points:\n -p1:"<< p1 << "\n -p2:" << p2
-		);
-	if( shareCommonCoord( p1, p2 ) )
-		HOMOG2D_THROW_ERROR_1(
-			"unable to compute bounding box of set, points share common coordinate:\n -p1:"
-			<< p1 << "\n -p2:" << p2
-		);
-#endif // HOMOG2D_NOCHECKS
+	static constexpr size_t s_leafSize = 4;
 
-	return std::make_pair( p1, p2 );
-}
+	std::vector<Node>   _nodes;
+	std::vector<size_t> _segIdx;
+	std::vector<Box>    _segBox;
+	std::vector<size_t> _parent;   ///< parent of each node, only built if needed by setBox()
+	std::vector<size_t> _leafOf;   ///< leaf holding each segment, only built if needed by setBox()
+	HOMOG2D_INUMTYPE    _maxSegLength = 0.;
+	bool                _isValid = false;
 
-//------------------------------------------------------------------
-/// Returns the bounding box of segments in vector/list/array of points \c vsegs
-template<
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
-FRect_<typename T::value_type::FType>
-getBB_Segments( const T& vsegs )
-{
-	HOMOG2D_START;
-	using FPT = typename T::value_type::FType;
+public:
+	bool isValid() const { return _isValid; }
 
-	HOMOG2D_DEBUG_ASSERT( vsegs.size(), "cannot compute bounding box of empty set of segments" );
-	std::vector<Point2d_<FPT>> vpts( vsegs.size()*2 );
-	auto it = vpts.begin();
-	for( const auto& seg: vsegs )
+	void clear()
 	{
-		auto ppts = seg.getPts();
-		*it++ = ppts.first;
-		*it++ = ppts.second;
+		_nodes.clear();
+		_segIdx.clear();
+		_segBox.clear();
+		_parent.clear();
+		_leafOf.clear();
+		_maxSegLength = 0.;
+		_isValid = false;
 	}
-	return FRect_<typename T::value_type::FType>( getBB_Points( vpts ) );
-}
-
-/// get BB for a set of FRect_ objects
-/// \todo same as getBB_Segments() ???
-template<typename FPT>
-auto
-getBB_FRect( const std::vector<FRect_<FPT>>& v_rects )
-{
-	HOMOG2D_START;
-	HOMOG2D_DEBUG_ASSERT( v_rects.size(), "cannot compute bounding box of empty set of rectangles" );
 
-	std::vector<Point2d_<FPT>> vpts( v_rects.size()*2 );
-	auto it = vpts.begin();
-	for( const auto& seg: v_rects )
+/// Build hierarchy from the polyline points
+	template<typename FPT>
+	void build( const std::vector<Point2d_<FPT>>& pts, bool isClosed )
 	{
-		auto ppts = seg.getPts();
-		*it++ = ppts.first;
-		*it++ = ppts.second;
+		clear();
+		size_t nbs = 0;
+		if( pts.size() > 1 )
+			nbs = ( isClosed ? pts.size() : pts.size()-1 );
+
+		_segBox.resize( nbs );
+		_segIdx.resize( nbs );
+		std::iota( _segIdx.begin(), _segIdx.end(), 0 );
+		for( size_t i=0; i<nbs; i++ )
+		{
+			const auto& p1 = pts[i];
+			const auto& p2 = pts[ i+1==pts.size() ? 0 : i+1 ];
+			_segBox[i] = Box( p1, p2 );
+			_maxSegLength = std::max( _maxSegLength, static_cast<HOMOG2D_INUMTYPE>( p1.distTo(p2) ) );
+		}
+		if( nbs )
+		{
+			_nodes.reserve( 2 * nbs / s_leafSize + 1 );
+			_nodes.emplace_back();
+			p_build( 0, 0, nbs );
+		}
+		_isValid = true;
 	}
-	return FRect_<FPT>( getBB_Points( vpts ) );
-}
 
-/// Private helper function for base::PolylineBase::getSegs() and base::PolylineBase::getOSegs()
-template<typename ST,typename PLT, typename FPT> // Segment Type, PolyLine Type, Floating Point Type
-std::vector<ST>
-p_getSegs( const base::PolylineBase<PLT,FPT>& pl, const ST& )
-{
-	auto siz = pl.size();
-	if( siz < 2 ) // nothing to return
-		return std::vector<ST>();
+/// Build hierarchy on the points themselves (zero-length segments), see priv::simplifyVW()
+	template<typename FPT>
+	void buildPoints( const std::vector<Point2d_<FPT>>& pts )
+	{
+		clear();
+		_segBox.resize( pts.size() );
+		_segIdx.resize( pts.size() );
+		std::iota( _segIdx.begin(), _segIdx.end(), 0 );
+		for( size_t i=0; i<pts.size(); i++ )
+			_segBox[i] = Box( pts[i], pts[i] );
+		if( !pts.empty() )
+		{
+			_nodes.reserve( 2 * pts.size() / s_leafSize + 1 );
+			_nodes.emplace_back();
+			p_build( 0, 0, pts.size() );
+		}
+		_isValid = true;
+	}
 
-	std::vector<ST> out;
-	out.reserve( siz );
-	for( size_t i=0; i<siz-1; i++ )
+/// Box holding all the segments (undefined if empty)
+	const Box& getRootBox() const
 	{
-		const auto& pt1 = pl.getPoint(i);
-		const auto& pt2 = pl.getPoint(i+1);
-		out.emplace_back( ST(pt1,pt2) );
+		HOMOG2D_DEBUG_ASSERT( !_nodes.empty(), "empty hierarchy" );
+		return _nodes[0]._box;
 	}
-	if constexpr( std::is_same_v<PLT,typ::IsClosed> )
-		out.push_back( ST(pl.getPoint(siz-1), pl.getPoint(0) ) );
-	return out;
-}
 
-} // namespace priv
+/// Tolerance added to the boxes when pruning
+/**
+The intersection tests accept a point as lying on a segment if the sum of the distances to both
+segment points differs from the segment length by less than thr::nullDistance().
+Such a point can be at a distance up to \f$ \sqrt{\epsilon . L} \f$ from the segment, so this is
+used as a margin, so that the pruning never discards a candidate that the brute force would accept.
+*/
+	HOMOG2D_INUMTYPE margin( HOMOG2D_INUMTYPE otherSize ) const
+	{
+		return thr::nullDistance() + homog2d_sqrt( thr::nullDistance() * ( _maxSegLength + otherSize ) );
+	}
 
-// Forward declaration
-template<typename FPT1,typename FPT2>
-CPolyline_<FPT1>
-operator * ( const Homogr_<FPT2>&, const FRect_<FPT1>& );
+/// Calls \c func for all the segments whose box overlaps \c qbox (with margin \c margin)
+	template<typename FUNC>
+	void query( const Box& qbox, HOMOG2D_INUMTYPE margin, FUNC func ) const
+	{
+		p_traverse(
+			[&]( const Box& box ){ return box.overlaps( qbox, margin ); },
+			func
+		);
+	}
 
-// Forward declaration
-///  \todo 20230215: check if this has to be moved in the 'base' namespace. Can it be called **without**
-/// `using namespace std;`. This was the case for the streaming operator...
-template<typename FPT1,typename FPT2,typename PLT2>
-auto
-operator * ( const Homogr_<FPT2>&, const base::PolylineBase<PLT2,FPT1>& ) -> base::PolylineBase<PLT2,FPT1>;
+/// Calls \c func for all the segments whose box is crossed by line \c li
+	template<typename FPT,typename FUNC>
+	void query( const Line2d_<FPT>& li, FUNC func ) const
+	{
+		const auto& arr = li.get();
+		HOMOG2D_INUMTYPE a = arr[0];
+		HOMOG2D_INUMTYPE b = arr[1];
+		HOMOG2D_INUMTYPE c = arr[2];
+		auto norm = std::hypot( a, b );
+		a /= norm;
+		b /= norm;
+		c /= norm;
+		auto marg = margin( 0. );
+		p_traverse(
+			[&]( const Box& box )
+			{
+				auto d1 = a * box._xmin + b * box._ymin + c;
+				auto d2 = a * box._xmax + b * box._ymin + c;
+				auto d3 = a * box._xmin + b * box._ymax + c;
+				auto d4 = a * box._xmax + b * box._ymax + c;
+				if( d1 > marg && d2 > marg && d3 > marg && d4 > marg )
+					return false;
+				if( d1 < -marg && d2 < -marg && d3 < -marg && d4 < -marg )
+					return false;
+				return true;
+			},
+			func
+		);
+	}
 
+/// Calls \c func for all the segments whose box fulfills \c pred
+/**
+\c pred is also used to prune the hierarchy, so it must be true for a box if it is true for one of the boxes it holds.
+*/
+	template<typename PRED,typename FUNC>
+	void queryIf( PRED pred, FUNC func ) const
+	{
+		p_traverse( pred, func );
+	}
 
-//------------------------------------------------------------------
-/// Parameters for base::PolylineBase::getOffsetPoly()
+/// Changes the box of segment \c seg and updates the boxes of the hierarchy, O(log n)
 /**
-(Unused at present)
+Used when the segments change after the build, see priv::SimplifIndex.
+The tree is not rebuilt, so the queries stay correct but may get slower if the boxes grow a lot.
+An empty box (see Box::empty()) removes the segment from the queries.
+\c length is the length of the new segment, needed for the margin.
 */
-struct OffsetPolyParams
-{
-	bool _angleSplit = false;
+	void setBox( size_t seg, const Box& box, HOMOG2D_INUMTYPE length )
+	{
+		if( _leafOf.empty() )
+			p_buildLinks();
+		HOMOG2D_DEBUG_ASSERT( _leafOf.at(seg) < _nodes.size(), "segment not in the hierarchy" );
+		_segBox.at(seg) = box;
+		_maxSegLength = std::max( _maxSegLength, length );
+
+		auto idx = _leafOf[seg];
+		auto& leaf = _nodes[idx];
+		leaf._box = Box::empty();
+		for( size_t i=leaf._first; i<leaf._first+leaf._count; i++ )
+			leaf._box.add( _segBox[ _segIdx[i] ] );
+		while( idx != 0 )
+		{
+			idx = _parent[idx];
+			auto& node = _nodes[idx];
+			node._box = _nodes[node._first]._box;
+			node._box.add( _nodes[node._first+1]._box );
+		}
+	}
+
+private:
+	void p_buildLinks()
+	{
+		_parent.assign( _nodes.size(), 0 );
+		_leafOf.assign( _segBox.size(), _nodes.size() );
+		for( size_t idx=0; idx<_nodes.size(); idx++ )
+		{
+			const auto& node = _nodes[idx];
+			if( node._count )
+				for( size_t i=node._first; i<node._first+node._count; i++ )
+					_leafOf[ _segIdx[i] ] = idx;
+			else
+				_parent[node._first] = _parent[node._first+1] = idx;
+		}
+	}
+
+	void p_build( size_t nodeIdx, size_t begin, size_t end )
+	{
+		Box box = _segBox[ _segIdx[begin] ];
+		for( size_t i=begin+1; i<end; i++ )
+			box.add( _segBox[ _segIdx[i] ] );
+		_nodes[nodeIdx]._box = box;
+
+		if( end - begin <= s_leafSize )
+		{
+			_nodes[nodeIdx]._first = begin;
+			_nodes[nodeIdx]._count = end - begin;
+			return;
+		}
+
+		bool splitX = ( box._xmax - box._xmin >= box._ymax - box._ymin );
+		auto mid = begin + (end - begin) / 2;
+		std::nth_element(
+			_segIdx.begin() + begin,
+			_segIdx.begin() + mid,
+			_segIdx.begin() + end,
+			[&]                     // lambda
+			( size_t i1, size_t i2 )
+			{
+				const auto& b1 = _segBox[i1];
+				const auto& b2 = _segBox[i2];
+				if( splitX )
+					return b1._xmin + b1._xmax < b2._xmin + b2._xmax;
+				return b1._ymin + b1._ymax < b2._ymin + b2._ymax;
+			}
+		);
+		auto child = _nodes.size();
+		_nodes[nodeIdx]._first = child;  // do not keep a reference on the node,
+		_nodes.emplace_back();           // as the vector can get reallocated
+		_nodes.emplace_back();
+		p_build( child,   begin, mid );
+		p_build( child+1, mid,   end );
+	}
+
+/// Depth-first traversal, with a fixed-size stack (depth is logarithmic due to the median split)
+	template<typename PRED,typename FUNC>
+	void p_traverse( PRED pred, FUNC func ) const
+	{
+		if( _nodes.empty() )
+			return;
+		std::array<size_t,128> stack;
+		size_t top = 0;
+		stack[top++] = 0;
+		while( top )
+		{
+			const auto& node = _nodes[ stack[--top] ];
+			if( !pred( node._box ) )
+				continue;
+			if( node._count )
+			{
+				for( size_t i=node._first; i<node._first+node._count; i++ )
+					if( pred( _segBox[ _segIdx[i] ] ) )
+						func( _segIdx[i] );
+			}
+			else
+			{
+				stack[top++] = node._first+1;
+				stack[top++] = node._first;
+			}
+		}
+	}
 };
 
+/// Returns the box used to query the SegBVH, for a segment
+template<typename SV,typename FPT>
+SegBVH::Box
+getBVHBox( const base::SegVec<SV,FPT>& seg )
+{
+	auto ppts = seg.getPts();
+	return SegBVH::Box( ppts.first, ppts.second );
+}
+
+/// Returns the box used to query the SegBVH, for a rectangle
+template<typename FPT>
+SegBVH::Box
+getBVHBox( const FRect_<FPT>& rect )
+{
+	auto ppts = rect.getPts();
+	return SegBVH::Box( ppts.first, ppts.second );
+}
 
-namespace base {
+/// Returns the box used to query the SegBVH, for a circle
+template<typename FPT>
+SegBVH::Box
+getBVHBox( const Circle_<FPT>& cir )
+{
+	const auto& c = cir.center();
+	HOMOG2D_INUMTYPE r = cir.radius();
+	return SegBVH::Box(
+		Point2d_<HOMOG2D_INUMTYPE>( c.getX() - r, c.getY() - r ),
+		Point2d_<HOMOG2D_INUMTYPE>( c.getX() + r, c.getY() + r )
+	);
+}
 
 //------------------------------------------------------------------
-/// Polyline, will be instanciated either as \ref OPolyline_ (open polyline) or \ref CPolyline_
+/// Cumulated lengths of the segments of a polyline, used to locate a point by its curvilinear abscissa
 /**
-\warning When closed, in order to be able to compare two objects describing the same structure
-but potentially in different order, the comparison operator will proceed a sorting.<br>
-The consequence is that when adding points, if you have done a comparison before, you might not
-add point after the one you thought!
+Built lazily on first query, and stored along with the other attributes of the polyline
+(see PolylineAttribs), so it gets invalidated in the same way.
 
-template args:
- - PLT: PolyLine Type: typ::IsClosed or typ::IsOpen
- - FPT: Floating Point Type
+Value \c i is the length from point 0 to point \c i, the last one is the total length
+(so it has one more value than the number of segments).
 */
-template<typename PLT,typename FPT>
-class PolylineBase: public detail::Common<FPT>
-#ifdef HOMOG2D_ENABLE_PRTP
-, public rtp::Root
-#endif
+class ArcLengthIndex
 {
+private:
+	std::vector<HOMOG2D_INUMTYPE> _cumLength;
+
 public:
-	using FType = FPT;
-//	using PType = PLT;
-	using SType = std::conditional<std::is_same_v<PLT,typ::IsClosed>,typ::T_CPol,typ::T_OPol>;
+	bool isValid() const { return !_cumLength.empty(); }
+	void clear()         { _cumLength.clear(); }
+
+/// Build index from the polyline points
+	template<typename FPT>
+	void build( const std::vector<Point2d_<FPT>>& pts, bool isClosed )
+	{
+		size_t nbs = 0;
+		if( pts.size() > 1 )
+			nbs = ( isClosed ? pts.size() : pts.size()-1 );
+		_cumLength.resize( nbs+1 );
+		_cumLength[0] = 0.;
+		for( size_t i=0; i<nbs; i++ )
+		{
+			const auto& p1 = pts[i];
+			const auto& p2 = pts[ i+1==pts.size() ? 0 : i+1 ];
+			_cumLength[i+1] = _cumLength[i] + static_cast<HOMOG2D_INUMTYPE>( p1.distTo(p2) );
+		}
+	}
 
-	using detail::Common<FPT>::isInside;
+	size_t           nbSegs()         const { return _cumLength.size()-1; }
+	HOMOG2D_INUMTYPE total()          const { return _cumLength.back(); }
+/// Returns the curvilinear abscissa of point \c i
+	HOMOG2D_INUMTYPE at( size_t i )   const { return _cumLength[i]; }
 
-	template<typename T1,typename T2> friend class PolylineBase;
-	template<typename T1> friend class h2d::Ellipse_;
+/// Scale all the values (used when the polyline is scaled)
+	void scale( HOMOG2D_INUMTYPE k )
+	{
+		for( auto& v: _cumLength )
+			v *= k;
+	}
 
-	template<typename FPT1,typename FPT2>
-	friend CPolyline_<FPT1>
-	h2d::operator * ( const h2d::Homogr_<FPT2>&, const h2d::FRect_<FPT1>& );
+/// Returns index of the segment holding abscissa \c s (assumed to be in [0,total()]), O(log n)
+/**
+Null length segments are never returned, unless all of them are.
+*/
+	size_t findSegment( HOMOG2D_INUMTYPE s ) const
+	{
+		assert( nbSegs() > 0 );
+		auto it = std::upper_bound( _cumLength.begin()+1, _cumLength.end()-1, s );
+		auto idx = static_cast<size_t>( std::distance( _cumLength.begin(), it ) ) - 1;
+		while( idx > 0 && _cumLength[idx+1] == _cumLength[idx] )  // s == total(): skip the ending null segments
+			idx--;
+		return idx;
+	}
+};
 
-	template<typename FPT1,typename FPT2,typename PLT2>
-	friend auto
-	h2d::operator * ( const Homogr_<FPT2>&, const base::PolylineBase<PLT2,FPT1>& ) -> base::PolylineBase<PLT2,FPT1>;
+//------------------------------------------------------------------
+/// Term of the "shoelace" sum used to compute the signed area of a polygon (twice the signed area of triangle (0,pt1,pt2))
+template<typename FPT1,typename FPT2>
+HOMOG2D_INUMTYPE
+shoelaceTerm( const Point2d_<FPT1>& pt1, const Point2d_<FPT2>& pt2 )
+{
+	return static_cast<HOMOG2D_INUMTYPE>( pt1.getX() ) * pt2.getY()
+		- static_cast<HOMOG2D_INUMTYPE>( pt1.getY() ) * pt2.getX();
+}
 
-	Type type() const
+//------------------------------------------------------------------
+/// Squared distance between point (px,py) and segment (ax,ay)-(bx,by)
+inline
+HOMOG2D_INUMTYPE
+sqDistPtSeg(
+	HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py,
+	HOMOG2D_INUMTYPE ax, HOMOG2D_INUMTYPE ay,
+	HOMOG2D_INUMTYPE bx, HOMOG2D_INUMTYPE by
+)
+{
+	auto dx = bx - ax;
+	auto dy = by - ay;
+	auto ux = px - ax;
+	auto uy = py - ay;
+	auto len2 = dx*dx + dy*dy;
+	if( len2 > 0. )
 	{
-		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
-			return Type::CPolyline;
-		else
-			return Type::OPolyline;
+		auto t = std::max( static_cast<HOMOG2D_INUMTYPE>(0), std::min( static_cast<HOMOG2D_INUMTYPE>(1), ( ux*dx + uy*dy ) / len2 ) );
+		ux -= t * dx;
+		uy -= t * dy;
 	}
+	return ux*ux + uy*uy;
+}
+
+//------------------------------------------------------------------
+/// Index on a convex polygon, for O(log n) queries, see ConvexPolygon_
+/**
+Holds the coordinates of the vertices (counterclockwise, without the points that are aligned with their neighbours)
+and the angles of the edges, so that the queries can use binary searches.
 
+Also stored along with the other attributes of a polygon, once it is known to be convex (see PolylineAttribs),
+so it gets invalidated in the same way.
+*/
+class ConvexIndex
+{
 private:
-	mutable std::vector<Point2d_<FPT>> _plinevec;
-	mutable bool _plIsNormalized = false;
-	mutable priv::PolylineAttribs _attribs;    ///< Attributes. Will get stored upon computing.
+	std::vector<HOMOG2D_INUMTYPE> _vx, _vy;      ///< vertices, counterclockwise
+	std::vector<size_t>           _srcIdx;       ///< index of each vertex in the source points
+	std::vector<HOMOG2D_INUMTYPE> _angle;        ///< angle of each edge, increasing (unwrapped)
+	std::array<size_t,4>          _extremeIdx;
+	bool                          _isBuilt = false;
 
 public:
-/// \name Constructors
-///@{
-
-/// Default constructor
-	PolylineBase() = default;
+	bool isBuilt() const { return _isBuilt; }
+	size_t size() const { return _vx.size(); }
 
-/// Constructor from FRect. Enabled for "closed" type, disabled for "open" type
-	template<typename FPT2>
-	PolylineBase( const FRect_<FPT2>& rect )
+	void clear()
 	{
-		static_assert( std::is_same_v<PLT,typ::IsClosed>, "cannot build an OPolyline object from a FRect");
-		for( const auto& pt: rect.get4Pts() )
-			_plinevec.push_back( pt );
+		_vx.clear();
+		_vy.clear();
+		_srcIdx.clear();
+		_angle.clear();
+		_isBuilt = false;
 	}
 
-	template<typename FPT2>
-	PolylineBase( const Segment_<FPT2>& seg )
+/// Build from the points of a simple polygon, returns false (and stays empty) if it is degenerate or not convex
+	template<typename FPT>
+	bool build( const std::vector<Point2d_<FPT>>& pts )
 	{
-		const auto& ppts = seg.getPts();
-		p_addPoint( ppts.first );
-		p_addPoint( ppts.second );
-	}
+		clear();
+		_isBuilt = true;
+		HOMOG2D_INUMTYPE area = 0.;
+		for( size_t i=0; i<pts.size(); i++ )
+			area += priv::shoelaceTerm( pts[i], pts[ i+1==pts.size() ? 0 : i+1 ] );
+
+		std::vector<size_t> vidx;                          // counterclockwise, without aligned points
+		vidx.reserve( pts.size() );
+		auto aligned = [&]( size_t i0, size_t i1, size_t i2 )
+		{
+			const auto& p0 = pts[i0];
+			const auto& p2 = pts[i2];
+			return priv::sqDistPtSeg(
+				pts[i1].getX(), pts[i1].getY(), p0.getX(), p0.getY(), p2.getX(), p2.getY()
+			) <= thr::nullDistance() * thr::nullDistance();
+		};
+		for( size_t i=0; i<pts.size(); i++ )
+		{
+			auto idx = ( area > 0. ? i : pts.size()-1-i );
+			while( vidx.size() > 1 && aligned( vidx[vidx.size()-2], vidx.back(), idx ) )
+				vidx.pop_back();
+			vidx.push_back( idx );
+		}
+		while( vidx.size() > 2 && aligned( vidx[vidx.size()-2], vidx.back(), vidx.front() ) )
+			vidx.pop_back();
+		while( vidx.size() > 2 && aligned( vidx.back(), vidx.front(), vidx[1] ) )
+			vidx.erase( vidx.begin() );
+		if( vidx.size() < 3 )
+			return false;
 
-/// Constructor from a vector of points.
-template<
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
-	PolylineBase( const T& vec )
-	{
-		set( vec );
+		const auto n = vidx.size();
+		_vx.resize( n );
+		_vy.resize( n );
+		for( size_t i=0; i<n; i++ )
+		{
+			_vx[i] = pts[ vidx[i] ].getX();
+			_vy[i] = pts[ vidx[i] ].getY();
+		}
+		for( size_t i=0; i<n; i++ )
+			if( p_orient( i, p_next(i), p_next(p_next(i)) ) < 0. )
+			{
+				clear();
+				_isBuilt = true;
+				return false;
+			}
+		_srcIdx = std::move( vidx );
+
+		_angle.resize( n );
+		for( size_t i=0; i<n; i++ )
+		{
+			auto j = p_next( i );
+			_angle[i] = std::atan2( _vy[j] - _vy[i], _vx[j] - _vx[i] );
+			if( i != 0 )
+				while( _angle[i] < _angle[i-1] )
+					_angle[i] += 2. * M_PI;
+		}
+
+		for( auto dir: { CardDir::Bottom, CardDir::Top, CardDir::Left, CardDir::Right } )
+		{
+			bool alongX = ( dir == CardDir::Left || dir == CardDir::Right );
+			HOMOG2D_INUMTYPE sign = ( dir == CardDir::Bottom || dir == CardDir::Left ? 1. : -1. );
+			const auto& v1 = ( alongX ? _vx : _vy );
+			const auto& v2 = ( alongX ? _vy : _vx );       // used for ties, same order as getBmPoint(), etc.
+			size_t best = 0;
+			for( size_t i=1; i<n; i++ )
+				if( sign * v1[i] < sign * v1[best] || ( v1[i] == v1[best] && v2[i] < v2[best] ) )
+					best = i;
+			_extremeIdx[ static_cast<int>(dir) ] = best;
+		}
+		return true;
 	}
 
-/// Constructor that builds a regular convex polygon of \c n points at a distance \c rad, centered at (0,0).
-	template<typename FPT2,typename T>
-	PolylineBase( FPT2 rad, T n )
+/// Index in the source points of vertex \c i
+	size_t srcIdx( size_t i ) const { return _srcIdx[i]; }
+
+/// Index of the Top-most / Bottom-most / Left-most / Right-most vertex
+	size_t extremeIdx( CardDir dir ) const { return _extremeIdx[ static_cast<int>(dir) ]; }
+
+/// Returns true if point is inside, at a distance more than thr::nullDistance() from the edges
+	bool contains( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
 	{
-		set( rad, n );
+		if( size() == 0 )
+			return false;
+		const auto eps = thr::nullDistance();
+		auto isInside = [&]( size_t i )           // point is on the left of edge i, at a distance more than eps
+		{
+			auto j = p_next( i );
+			return p_orient( i, j, px, py ) > eps * homog2d_sqrt( ( _vx[j] - _vx[i] ) * ( _vx[j] - _vx[i] ) + ( _vy[j] - _vy[i] ) * ( _vy[j] - _vy[i] ) );
+		};
+		if( !isInside( 0 ) || !isInside( size()-1 ) )
+			return false;
+		return isInside( p_findSector( px, py ) );
 	}
 
-/// Copy-Constructor from Closed Polyline
-	template<typename FPT2>
-	constexpr PolylineBase( const CPolyline_<FPT2>& other )
+/// Returns index of an edge that has the point on its right side, or size() if none (point inside or on an edge)
+	size_t visibleEdge( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
 	{
-		static_assert(
-			!(std::is_same<PLT,typ::IsOpen>::value),
-			"Error, cannot build an Open Polyline from a closed one"
-		);
-		set( other._plinevec );
+		if( size() == 0 )
+			return 0;
+		if( p_orient( 0, 1, px, py ) < 0. )
+			return 0;
+		if( p_orient( size()-1, 0, px, py ) < 0. )
+			return size()-1;
+		auto i = p_findSector( px, py );
+		return p_orient( i, i+1, px, py ) < 0. ? i : size();
 	}
-/// Copy-Constructor from Open Polyline
-	template<typename FPT2>
-	PolylineBase( const OPolyline_<FPT2>& other )
+
+/// Index of farthest point in direction (dx,dy): the point where the edge angle goes past the normal direction
+	size_t support( HOMOG2D_INUMTYPE dx, HOMOG2D_INUMTYPE dy ) const
 	{
-		set( other._plinevec );
+		auto t = std::atan2( dy, dx ) + M_PI / 2.;
+		while( t < _angle[0] )
+			t += 2. * M_PI;
+		while( t >= _angle[0] + 2. * M_PI )
+			t -= 2. * M_PI;
+		auto it = std::lower_bound( _angle.begin(), _angle.end(), t );
+		return it == _angle.end() ? 0 : static_cast<size_t>( std::distance( _angle.begin(), it ) );
 	}
 
-#ifdef HOMOG2D_USE_BOOSTGEOM
-/// Constructor from a boost geometry polygon, see misc/test_files/bg_test_1.cpp
+/// Tangent points from point (px,py), given \c v, an edge visible from that point
 /**
-\note Only imports the "outer" envelope, homog2d does not handle polygons with holes
-
-Requirements: the Boost polygon must have 2-cartesian coordinates points,
-either `bg::model::point` or `bg::model::d2::point_xy`
-but the underlying numerical type is free.
-
-\note At present, the 3th template parameter (bool) (Closed or Open) is ignored, because it is unclear how
-this relates to the actual fact that last point is equal to first point.
-\todo 20230216:  add some checking that the type BPT needs to fit certain requirements
-(must have 2-dimensions, and use cartesian coordinates). Maybe we should add some Sfinae to check this.
+The visible edges are contiguous. We find a non-visible one, using the farthest point in the direction
+going from the point to the polygon (one of its two edges is not visible), then two binary searches
+on each side of edge \c v.
 */
-	template<typename BPT,bool CLKW,bool CLOSED> //
-	PolylineBase(
-		const boost::geometry::model::polygon<
-			BPT,     ///< Boost Point Type (either `bg::model::point` or `bg::model::d2::point_xy`)
-			CLKW,    ///< this one is ignored here
-			CLOSED   ///< true: closed, false: open
-		>& bgpol  ///< input boost geometry polygon
-	)
+	std::pair<size_t,size_t>
+	tangents( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py, size_t v ) const
 	{
-		const auto& outer = bgpol.outer();
-		bool isClosed = false;
-		auto ptf = outer.front();
-		auto ptb = outer.back();
-		Point2d_<HOMOG2D_INUMTYPE> pt_front( boost::geometry::get<0>(ptf), boost::geometry::get<1>(ptf) );
-		Point2d_<HOMOG2D_INUMTYPE> pt_back(  boost::geometry::get<0>(ptb), boost::geometry::get<1>(ptb) );
-/*
-this should work !!! (but doesn't...)
-		Point2d_<HOMOG2D_INUMTYPE> pt_front( outer.front() );
-		Point2d_<HOMOG2D_INUMTYPE> pt_back(  outer.back() );
-*/
-		if( pt_front == pt_back ) // means it's closed
-			isClosed = true;
+		const auto n = size();
+		auto visible = [&]( size_t i ) { return p_orient( i, p_next(i), px, py ) < 0.; };
 
-		if( isClosed && std::is_same_v<PLT,typ::IsOpen> ) // cannot build an open polyline from a closed one
-			HOMOG2D_THROW_ERROR_1( "unable to convert a closed boost::polygon into an OPolyline" );
+		auto s = support( _vx[v] - px, _vy[v] - py );
+		auto w = visible( s ) ? ( s + n - 1 ) % n : s;
+		assert( !visible( w ) );
 
-		_plinevec.reserve( outer.size() - isClosed );
-		for( auto it=outer.begin(); it!=outer.end()-isClosed; it++ )
+		size_t lo = 0, hi = ( w + n - v ) % n;    // forward search
+		while( hi - lo > 1 )
 		{
-			const auto& bgpt = *it;
-			_plinevec.emplace_back(
-				Point2d_<FPT>( boost::geometry::get<0>(bgpt), boost::geometry::get<1>(bgpt) )
-			);
+			auto mid = ( lo + hi ) / 2;
+			if( visible( ( v + mid ) % n ) )
+				lo = mid;
+			else
+				hi = mid;
 		}
-	}
-#endif
-
-///@}
-
-public:
-/// \name Attributes access
-///@{
-
-/// Returns the number of points
-	size_t size() const { return _plinevec.size(); }
+		auto last = ( v + lo + 1 ) % n;
 
-	constexpr bool isClosed() const
-	{
-		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
-			return true;
-		else
-			return false;
+		lo = 0;
+		hi = ( v + n - w ) % n;                   // backward search
+		while( hi - lo > 1 )
+		{
+			auto mid = ( lo + hi ) / 2;
+			if( visible( ( v + n - mid ) % n ) )
+				lo = mid;
+			else
+				hi = mid;
+		}
+		auto first = ( v + n - lo ) % n;
+		return std::make_pair( first, last );
 	}
 
-	HOMOG2D_INUMTYPE length()    const;
-	HOMOG2D_INUMTYPE area()      const;
-	bool             isSimple()  const;
-
-/// Returns Bounding Box of Polyline
-	auto getBB() const
+/// Returns the distance between point (px,py) and the polygon (0 if inside)
+	HOMOG2D_INUMTYPE distTo( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
 	{
-		HOMOG2D_START;
-#ifndef HOMOG2D_NOCHECKS
-		if( size() < 2 )
-			HOMOG2D_THROW_ERROR_1( "cannot compute bounding box of empty Polyline" );
-#endif
-		auto ppts = priv::getBB_Points( getPts() );
-#ifndef HOMOG2D_NOCHECKS
-		if( shareCommonCoord( ppts.first, ppts.second ) )
-			HOMOG2D_THROW_ERROR_1( "unable, points share common coordinate" );
-#endif
-		return FRect_<HOMOG2D_INUMTYPE>( ppts );
-	}
-
-	LPBase<typ::IsPoint,HOMOG2D_INUMTYPE> centroid() const;
+		auto v = visibleEdge( px, py );
+		if( v == size() )
+			return 0.;
+		auto tg = tangents( px, py, v );
 
-/// Returns the number of segments. If "closed",
-/** the last segment (going from last to first point) is counted */
-	size_t nbSegs() const
-	{
-		if( size() < 2 )
-			return 0;
-		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
-			return size();
-		else
-			return size() - 1;
+// along the visible edges, the point is first "after" the edge, then not
+		auto beyondEnd = [&]( size_t i )
+		{
+			auto j = p_next( i );
+			return ( px - _vx[j] ) * ( _vx[j] - _vx[i] ) + ( py - _vy[j] ) * ( _vy[j] - _vy[i] ) > 0.;
+		};
+		auto m = ( tg.second + size() - tg.first ) % size();   // nb of visible edges
+		size_t lo = 0, hi = m-1;
+		while( lo < hi )
+		{
+			auto mid = ( lo + hi ) / 2;
+			if( beyondEnd( ( tg.first + mid ) % size() ) )
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		auto i = ( tg.first + lo ) % size();
+		auto j = p_next( i );
+		return homog2d_sqrt( priv::sqDistPtSeg( px, py, _vx[i], _vy[i], _vx[j], _vy[j] ) );
 	}
 
-	Point2d_<FPT> getExtremePoint( CardDir ) const;
-	Point2d_<FPT> getTmPoint() const;
-	Point2d_<FPT> getBmPoint() const;
-	Point2d_<FPT> getLmPoint() const;
-	Point2d_<FPT> getRmPoint() const;
-
-	bool isConvex() const;
-
-///@}
-
-private:
-	HOMOG2D_INUMTYPE p_ComputeSignedArea() const;
-
-/// Add single point. private, because only to be used from other member functions
+/// Intersection points with line \c li (0, 1 or 2 points). No intersection if empty
 /**
-\warning This function was discarded from public API in dec. 2021, because
-this will add the new point after the previous one \b only if the object has \b not
-been normalized. This normalizing operation will happen if you do a comparison (== or !=)
+\c onVertex is set to true if a vertex lies on the line (line touching the polygon, or going through a vertex).
 */
-	template<typename FPT2>
-	void p_addPoint( const Point2d_<FPT2>& pt )
+	template<typename FPT,typename FPT2>
+	detail::IntersectM<FPT> intersects( const Line2d_<FPT2>& li, bool& onVertex ) const
 	{
-#ifndef HOMOG2D_NOCHECKS
-		if( size() )
-			if( pt == _plinevec.back() )
-				HOMOG2D_THROW_ERROR_1(
-					"cannot add a point identical to previous one: pt=" << pt << " size=" << size()
-				);
-#endif
-		_attribs.setBad();
-		_plIsNormalized=false;
-		_plinevec.push_back( pt );
-	}
+		onVertex = false;
+		detail::IntersectM<FPT> out;
+		if( size() == 0 )
+			return out;
+		const auto arr = li.get();
+		const HOMOG2D_INUMTYPE a = arr[0];
+		const HOMOG2D_INUMTYPE b = arr[1];
+		const HOMOG2D_INUMTYPE c = arr[2];
+		const auto norm = homog2d_sqrt( a*a + b*b );
+		auto dist = [&]( size_t i )                // signed distance to the line
+		{
+			return ( a * _vx[i] + b * _vy[i] + c ) / norm;
+		};
+		const auto eps = thr::nullDistance();
+		const auto n = size();
+
+		auto imax = support( a, b );
+		auto imin = support( -a, -b );
+		auto dmax = dist( imax );
+		auto dmin = dist( imin );
+		if( dmax < -eps || dmin > eps )
+			return out;
+		if( dmax <= eps || dmin >= -eps )         // line touches the polygon, at a point or along an edge
+		{
+			onVertex = true;
+			auto i0 = ( dmax <= eps ? imax : imin );
+			for( auto i: { ( i0 + n - 1 ) % n, i0, p_next(i0) } )
+				if( homog2d_abs( dist(i) ) <= eps )
+					out.add( Point2d_<FPT>( _vx[i], _vy[i] ) );
+			return out;
+		}
 
-public:
+// on each of the two chains between imin and imax, find the edge crossing the line
+		for( int sign: { +1, -1 } )
+		{
+			auto i0 = ( sign == 1 ? imin : imax );
+			auto len = ( ( sign == 1 ? imax : imin ) + n - i0 ) % n;
+			size_t lo = 0, hi = len;                // sign*dist(lo) < 0, sign*dist(hi) > 0
+			while( hi - lo > 1 )
+			{
+				auto mid = ( lo + hi ) / 2;
+				if( sign * dist( ( i0 + mid ) % n ) < 0. )
+					lo = mid;
+				else
+					hi = mid;
+			}
+			auto i = ( i0 + lo ) % n;
+			auto j = ( i0 + hi ) % n;
+			if( homog2d_abs( dist(i) ) <= eps || homog2d_abs( dist(j) ) <= eps )
+				onVertex = true;
+			auto t = dist(i) / ( dist(i) - dist(j) );
+			out.add( Point2d_<FPT>( _vx[i] + t * ( _vx[j] - _vx[i] ), _vy[i] + t * ( _vy[j] - _vy[i] ) ) );
+		}
+		return out;
+	}
 
-/// \name Data access
-///@{
+private:
+	size_t p_next( size_t i ) const { return i+1 == size() ? 0 : i+1; }
 
-/// Returns the points (reference)
-	std::vector<Point2d_<FPT>>& getPts()
+/// Cross product of (j-i) and (pt-i), >0 if point is on the left of i->j
+	HOMOG2D_INUMTYPE p_orient( size_t i, size_t j, HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
 	{
-		_attribs.setBad();  // because we send the non-const reference
-		_plIsNormalized=false;
-		return _plinevec;
+		return ( _vx[j] - _vx[i] ) * ( py - _vy[i] ) - ( _vy[j] - _vy[i] ) * ( px - _vx[i] );
 	}
-/// Returns the points (const reference)
-	const std::vector<Point2d_<FPT>>& getPts() const
+	HOMOG2D_INUMTYPE p_orient( size_t i, size_t j, size_t k ) const
 	{
-		return _plinevec;
+		return p_orient( i, j, _vx[k], _vy[k] );
 	}
 
-/// Returns (as a copy) the oriented segments of the polyline
-	std::vector<OSegment_<FPT>> getOSegs() const
+/// Index of the edge (in [1,n-2]) such that the point is in the angular sector (0,i,i+1), seen from point 0
+/**
+Requires the point not to be on the right of edges 0 and n-1
+*/
+	size_t p_findSector( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
 	{
-		return priv::p_getSegs( *this, OSegment_<FPT>() );
+		size_t lo = 1, hi = size()-1;
+		while( hi - lo > 1 )
+		{
+			auto mid = ( lo + hi ) / 2;
+			if( p_orient( 0, mid, px, py ) >= 0. )
+				lo = mid;
+			else
+				hi = mid;
+		}
+		return lo;
 	}
+};
 
-/// Returns (as a copy) the segments of the polyline
-	std::vector<Segment_<FPT>> getSegs() const
-	{
-		return priv::p_getSegs( *this, Segment_<FPT>() );
-	}
+#ifdef HOMOG2D_VECTORIZE
+/// Vectorizable and compensated reductions over the points of a polyline, used when \c HOMOG2D_VECTORIZE is defined
+/**
+- the coordinates are copied by blocks into contiguous arrays, relatively to the first point
+(so that the area and centroid computations do not lose precision with large coordinates),
+- the terms are computed with plain loops over these arrays, that the compiler can vectorize,
+- they are summed by blocks on several independent lanes, and the block sums of each lane are added with
+Kahan compensated summation.
+
+\warning The compensation is removed by the compiler if building with \c -ffast-math (or similar),
+the result is then as accurate as a plain sum of the terms.
+*/
+namespace reduc {
 
-/// Returns one point of the polyline.
-	Point2d_<FPT> getPoint( size_t idx ) const
-	{
-#ifndef HOMOG2D_NOCHECKS
-		if( idx >= size() )
-			HOMOG2D_THROW_ERROR_1( "requesting point " << idx
-				<< ", only has "  << size()
-			);
-#endif
-		return _plinevec[idx];
-	}
+constexpr size_t s_nbLanes   = 8;
+constexpr size_t s_blockSize = 256;
+static_assert( s_blockSize % s_nbLanes == 0 );
 
+/// What is computed by reduce()
+enum class Sum: uint8_t { Length, Area, Centroid };
+
+//------------------------------------------------------------------
+/// Blocked Kahan summation on \c s_nbLanes independent lanes
+class KahanLanes
+{
 private:
-/// Private helper function
-	template<typename ST>
-	ST impl_getSegment( size_t idx, const ST& ) const
-	{
-	#ifndef HOMOG2D_NOCHECKS
-		if( idx >= nbSegs() )
-			HOMOG2D_THROW_ERROR_1( "requesting segment " << idx
-				<< ", only has "  << nbSegs()
-			);
+	std::array<HOMOG2D_INUMTYPE,s_nbLanes> _sum;
+	std::array<HOMOG2D_INUMTYPE,s_nbLanes> _comp;
 
-		if( size() < 2 )
-			HOMOG2D_THROW_ERROR_1( "empty, no segment " << idx );
-	#endif
-	if constexpr( std::is_same_v<PLT,typ::IsClosed> )
-		return ST( _plinevec[idx], _plinevec[idx+1==nbSegs()?0:idx+1] );
-	else
-		return ST( _plinevec[idx], _plinevec[idx+1] );
+	static void p_add( HOMOG2D_INUMTYPE& sum, HOMOG2D_INUMTYPE& comp, HOMOG2D_INUMTYPE v )
+	{
+		auto y = v - comp;
+		auto t = sum + y;
+		comp = ( t - sum ) - y;
+		sum = t;
 	}
 
 public:
-/// Returns one oriented segment of the polyline.
-	OSegment_<FPT> getOSegment( size_t idx ) const
+	KahanLanes()
 	{
-		return impl_getSegment( idx, OSegment_<FPT>() );
+		_sum.fill( 0. );
+		_comp.fill( 0. );
 	}
 
-/// Returns one segment of the polyline.
+/// Adds a block of values
 /**
-Segment \c n is the one between point \c n and point \c n+1
+The values are first summed without compensation on each lane (so <code>s_blockSize/s_nbLanes</code> values),
+then these partial sums are added with compensation.
 */
-	Segment_<FPT> getSegment( size_t idx ) const
+	void add( const std::array<HOMOG2D_INUMTYPE,s_blockSize>& v )
 	{
-		return impl_getSegment( idx, Segment_<FPT>() );
+		std::array<HOMOG2D_INUMTYPE,s_nbLanes> part;
+		part.fill( 0. );
+		for( size_t i=0; i<s_blockSize; i+=s_nbLanes )
+			for( size_t j=0; j<s_nbLanes; j++ )
+				part[j] += v[i+j];
+		for( size_t j=0; j<s_nbLanes; j++ )
+			p_add( _sum[j], _comp[j], part[j] );
 	}
 
-	CPolyline_<FPT> convexHull() const;
-///@}
-
-public:
-/// \name Modifiers (non-const member functions)
-///@{
-
-/// Clear all (does not change the "open/close" status).
-	void clear()
+	HOMOG2D_INUMTYPE value() const
 	{
-		_plinevec.clear();
-		_plIsNormalized=false;
-		_attribs.setBad();
+		HOMOG2D_INUMTYPE sum  = 0.;
+		HOMOG2D_INUMTYPE comp = 0.;
+		for( size_t j=0; j<s_nbLanes; j++ )
+		{
+			p_add( sum, comp, _sum[j] );
+			p_add( sum, comp, -_comp[j] );
+		}
+		return sum;
 	}
+};
 
-	template<typename FPT2>
-	void rotate( Rotate, const Point2d_<FPT2>& );
-	void rotate( Rotate );
-
-/// Miminize the PolylineBase: remove all points that lie in the middle of two segments with same angle.
+//------------------------------------------------------------------
+/// Computes some sums over the segments of a polyline of \c n points, whose coordinates are given by \c getPt(i,x,y)
 /**
-For example, if we have the following points ("Open" polyline):
-(0,0)-(1,0)-(2,0)<br>
-This will be replaced by: (0,0)--(2,0)
-
-\note We cannot use the Segment_::getAngle() function because it returns a
-value in [0,PI/2], so we would'nt be able to detect a segment going
-at 180° of the previous one.
+Returns, depending on \c S:
+- Sum::Length: [0] is the sum of segment lengths (the closing segment is included only if \c isClosed is true)
+- Sum::Area: [0] is the "shoelace" sum (twice the signed area), over the closed cycle
+- Sum::Centroid: same as Sum::Area, plus in [1] and [2] the sums used to compute the centroid,
+relatively to point 0
 
-\todo 20230217: implement these:
-- https://en.wikipedia.org/wiki/Visvalingam%E2%80%93Whyatt_algorithm
-- https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
-Also use the areCollinear() function
+The other values are 0.
 */
-	void
-	minimize()
-	{
-		if( size()<3 )
-			return;
-		impl_minimizePL( detail::PlHelper<PLT>() );
-	}
+template<Sum S,typename FCT>
+std::array<HOMOG2D_INUMTYPE,3>
+reduce( size_t n, FCT getPt, bool isClosed )
+{
+	std::array<HOMOG2D_INUMTYPE,3> out{ 0., 0., 0. };
+	if( n < 2 )
+		return out;
 
-/// Translate Polyline using \c dx, \c dy
-	template<typename TX,typename TY>
-	void translate( TX dx, TY dy )
-	{
-		HOMOG2D_CHECK_IS_NUMBER( TX );
-		HOMOG2D_CHECK_IS_NUMBER( TY );
-		for( auto& pt: _plinevec )
-			pt.translate( dx, dy );
-	}
+	std::array<HOMOG2D_INUMTYPE,s_blockSize+1> vx, vy;
+	std::array<HOMOG2D_INUMTYPE,s_blockSize> t0, t1, t2;
+	std::array<KahanLanes,3> acc;
 
-/// Translate Polyline, using a pair of numerical values
-	template<typename T1, typename T2>
-	void translate( const std::pair<T1,T2>& ppt )
+	HOMOG2D_INUMTYPE x0, y0;
+	getPt( 0, x0, y0 );
+	const auto nbSegs = ( isClosed || S != Sum::Length ? n : n-1 );
+	for( size_t start=0; start<nbSegs; start+=s_blockSize )
 	{
-		translate( ppt.first, ppt.second );
+		const auto nb = std::min( s_blockSize, nbSegs-start );
+		for( size_t i=0; i<=nb; i++ )
+		{
+			auto k = start + i;
+			HOMOG2D_INUMTYPE x, y;
+			getPt( k==n ? 0 : k, x, y );
+			vx[i] = x - x0;
+			vy[i] = y - y0;
+		}
+		for( size_t i=nb+1; i<=s_blockSize; i++ )  // last block: padding with last point, so the extra terms are null
+		{
+			vx[i] = vx[nb];
+			vy[i] = vy[nb];
+		}
+// constant trip count, so these loops can be vectorized
+		if constexpr( S == Sum::Length )
+		{
+			for( size_t i=0; i<s_blockSize; i++ )
+			{
+				auto dx = vx[i+1] - vx[i];
+				auto dy = vy[i+1] - vy[i];
+				t0[i] = homog2d_sqrt( dx*dx + dy*dy );
+			}
+			acc[0].add( t0 );
+		}
+		else
+		{
+			for( size_t i=0; i<s_blockSize; i++ )
+				t0[i] = vx[i]*vy[i+1] - vy[i]*vx[i+1];
+			acc[0].add( t0 );
+			if constexpr( S == Sum::Centroid )
+			{
+				for( size_t i=0; i<s_blockSize; i++ )
+				{
+					t1[i] = ( vx[i] + vx[i+1] ) * t0[i];
+					t2[i] = ( vy[i] + vy[i+1] ) * t0[i];
+				}
+				acc[1].add( t1 );
+				acc[2].add( t2 );
+			}
+		}
 	}
+	for( size_t i=0; i<3; i++ )
+		out[i] = acc[i].value();
+	return out;
+}
 
-/// Move Polyline to new origin
-	template<typename TX,typename TY>
-	void moveTo( TX x, TY y )
-	{
-		HOMOG2D_CHECK_IS_NUMBER( TX );
-		HOMOG2D_CHECK_IS_NUMBER( TY );
-		moveTo( Point2d_<FPT>(x,y) );
-	}
+} // namespace reduc
+#endif // HOMOG2D_VECTORIZE
 
-/// Move Polyline to new origin, given by \c new_org
+//------------------------------------------------------------------
+/// Holds attribute of a Polyline, allows storage of last computed value through the use of ValueFlag
 /**
-\warning The polygon origin is NOT its center but the point No 0!
+Instead of invalidating everything on each change, the member functions below allow the
+owner to update the values that can be deduced in O(1) from the change.
+
+\note The signed area is the value of the "shoelace" sum over all the points, considered as a closed cycle,
+whatever the open/closed status of the polyline.
 */
-	template<typename T1>
-	void moveTo( const Point2d_<T1>& new_org )
+struct PolylineAttribs
+{
+	priv::ValueFlag<HOMOG2D_INUMTYPE> _length;
+	priv::ValueFlag<HOMOG2D_INUMTYPE> _signedArea;
+	priv::ValueFlag<bool>             _isSimplePolyg;
+	priv::ValueFlag<bool>             _isConvex;
+	priv::ValueFlag<Point2d_<HOMOG2D_INUMTYPE>> _centroid;
+	priv::ValueFlag<PointPair_<HOMOG2D_INUMTYPE>> _bbox;     ///< bottom-left and top-right corners
+	priv::SegBVH                      _bvh;
+	priv::ArcLengthIndex              _arcIndex;
+	priv::ConvexIndex                 _convex;   ///< only built if known to be convex, see PolylineBase::isConvex()
+
+	void setBad()
 	{
-		if( size() == 0 )
-			HOMOG2D_THROW_ERROR_1( "Invalid call, Polyline is empty" );
-		auto dx = new_org.getX() - getPoint(0).getX();
-		auto dy = new_org.getY() - getPoint(0).getY();
-		for( auto& pt: _plinevec )
-			pt.translate( dx, dy );
+		_length.setBad();
+		_signedArea.setBad();
+		_isSimplePolyg.setBad();
+		_isConvex.setBad();
+		_centroid.setBad();
+		_bbox.setBad();
+		_bvh.clear();
+		_arcIndex.clear();
+		_convex.clear();
 	}
 
-/// Set from vector/array/list of points (discards previous points)
+/// Update after all the points have been moved by an isometry \c fct
 /**
-- nb of elements must be 0 or 2 or more
+\c fct must map an axis-aligned box to an axis-aligned box (translation, rotation by a multiple of 90°, mirroring).
+Length, "simple" and "convex" status are unchanged, the signed area changes sign if \c isMirror is true.
 */
-	template<
-		typename CONT,
-		typename std::enable_if<
-			trait::IsContainer<CONT>::value,
-			CONT
-		>::type* = nullptr
-	>
-	void set( const CONT& vec )
-	{
-#ifndef HOMOG2D_NOCHECKS
-		if( vec.size() == 1 )
-			HOMOG2D_THROW_ERROR_1( "Invalid: number of points must be 0, 2 or more" );
-		if( vec.size() > 1 )
-			p_checkInputData( vec );
-#endif
-		_attribs.setBad();
-		_plIsNormalized=false;
-		_plinevec.resize( vec.size() );
-		auto it = std::begin( _plinevec );
-		for( const auto& pt: vec )   // copying one by one will allow
-			*it++ = pt;              //  type conversions (std::copy implies same FP type)
-	}
-
-	template<typename FPT1,typename FPT2,typename FPT3>
-	void setParallelogram(
-		const Point2d_<FPT1>& pt1,
-		const Point2d_<FPT2>& pt2,
-		const Point2d_<FPT3>& pt3
-	);
-
-/// Set from FRect
-	template<typename FPT2>
-	void set( const FRect_<FPT2>& rect )
+	template<typename FCT>
+	void applyIsometry( FCT fct, bool isMirror )
 	{
-		static_assert( std::is_same_v<PLT,typ::IsClosed>, "Invalid: cannot set a OPolyline from a FRect" );
-
-		CPolyline_<FPT> tmp(rect);
-		std::swap( *this, tmp );
+		if( isMirror && !_signedArea.isBad() )
+			_signedArea.set( -_signedArea.value() );
+		p_applyToPoints( fct );
 	}
 
-/// Build RCP (Regular Convex Polygon), and return distance between consecutive points
-	template<typename FPT2,typename T>
-	std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
-	set( FPT2 rad, T n );
-
-///@}
-
-private:
-/// Checks that no contiguous identical points are stored
-	template<typename CONT>
-	void p_checkInputData( const CONT& pts )
+/// Update after all the points have been scaled by \c kx, \c ky (relatively to the origin)
+/**
+The centroid is invariant to affine transforms, the length is only scaled if \c kx and \c ky are equal (in absolute value).
+*/
+	void applyScale( HOMOG2D_INUMTYPE kx, HOMOG2D_INUMTYPE ky )
 	{
-		for( auto it=pts.begin(); it!=std::prev(pts.end()); it++ )
+		if( homog2d_abs(kx) == homog2d_abs(ky) )
 		{
-			const auto& elem = *it;
-			const auto& next = *std::next(it);
-			if( elem == next )
-				HOMOG2D_THROW_ERROR_1(
-					"cannot add two consecutive identical points:\npt:"
-					<< elem << " and pt:" << next
-					<< " in set of size " << pts.size()
-				);
+			if( !_length.isBad() )
+				_length.set( _length.value() * homog2d_abs(kx) );
+			if( _arcIndex.isValid() )
+				_arcIndex.scale( homog2d_abs(kx) );
 		}
-		if( pts.front() == pts.back() )
-			HOMOG2D_THROW_ERROR_1(
-				"cannot add first point equal to last point:\npt:"
-				<< pts.front()
-				<< " in set of size " << pts.size()
-			);
+		else
+		{
+			_length.setBad();
+			_arcIndex.clear();
+		}
+		if( !_signedArea.isBad() )
+			_signedArea.set( _signedArea.value() * kx * ky );
+		p_applyToPoints(
+			[kx,ky]           // lambda
+			( const Point2d_<HOMOG2D_INUMTYPE>& pt )
+			{
+				return Point2d_<HOMOG2D_INUMTYPE>( pt.getX() * kx, pt.getY() * ky );
+			}
+		);
 	}
 
-	void impl_minimizePL( const detail::PlHelper<typ::IsOpen>& );
-	void impl_minimizePL( const detail::PlHelper<typ::IsClosed>& );
-	void p_minimizePL( PolylineBase<PLT,FPT>&, size_t istart, size_t iend );
+/// Set from the attributes \c src of a point set, after all its points have been moved by an affine transformation \c fct
+/**
+- \c det: determinant of the linear part, the signed area is scaled by this value
+- \c lenScale: scale factor of lengths for a similarity, negative value if lengths are not scaled uniformly
+- \c keepsBB: true if \c fct maps an axis-aligned box to an axis-aligned box
 
-public:
-/// \name Operators
-///@{
-	template<typename PLT2,typename FPT2>
-	bool operator == ( const PolylineBase<PLT2,FPT2>& other ) const
+The centroid is invariant to affine transforms, and so are the "simple" and "convex" status (if \c det is not null).
+*/
+	template<typename FCT>
+	void setFromAffine(
+		const PolylineAttribs& src,
+		FCT                    fct,
+		HOMOG2D_INUMTYPE       det,
+		HOMOG2D_INUMTYPE       lenScale,
+		bool                   keepsBB
+	)
 	{
-		if constexpr( std::is_same_v<PLT,PLT2> )
+		setBad();
+		_centroid      = src._centroid;
+		_isSimplePolyg = src._isSimplePolyg;
+		_isConvex      = src._isConvex;
+		if( !src._signedArea.isBad() )
+			_signedArea.set( src._signedArea.value() * det );
+		if( lenScale >= 0. )
 		{
-			if( size() != other.size() )          // for quick exit
-				return false;
-
-			p_normalizePoly();
-			other.p_normalizePoly();
-
-			auto it = other._plinevec.begin();
-			for( const auto& elem: _plinevec )
-				if( *it++ != elem )
-					return false;
-			return true;
+			if( !src._length.isBad() )
+				_length.set( src._length.value() * lenScale );
+			if( src._arcIndex.isValid() )
+			{
+				_arcIndex = src._arcIndex;
+				_arcIndex.scale( lenScale );
+			}
 		}
-		else
-			return false;
+		if( keepsBB )
+			_bbox = src._bbox;
+		p_applyToPoints( fct );
 	}
 
-	template<typename PLT2,typename FPT2>
-	bool operator != ( const PolylineBase<PLT2,FPT2>& other ) const
+/// Update after a point \c pt has been added to a point set, or has replaced another one.
+/**
+\c lengthDelta and \c areaDelta are the changes of length and of the shoelace sum (x2) due to the segments
+that were removed and added.
+The bounding box is invalidated if the point replaces \c oldPt that was on its border.
+*/
+	template<typename FPT>
+	void applyPointChange(
+		HOMOG2D_INUMTYPE         lengthDelta,
+		HOMOG2D_INUMTYPE         areaDelta,
+		const Point2d_<FPT>&     pt,
+		const Point2d_<FPT>*     oldPt,
+		bool                     isFirst
+	)
 	{
-		return !( *this == other );
+		_isSimplePolyg.setBad();
+		_isConvex.setBad();
+		_centroid.setBad();
+		_bvh.clear();
+		_arcIndex.clear();
+		_convex.clear();
+		if( !_length.isBad() )
+			_length.set( _length.value() + lengthDelta );
+		if( !_signedArea.isBad() )
+			_signedArea.set( _signedArea.value() + areaDelta / 2. );
+
+		HOMOG2D_INUMTYPE x = pt.getX();
+		HOMOG2D_INUMTYPE y = pt.getY();
+		if( isFirst )
+		{
+			_bbox.set( std::make_pair( Point2d_<HOMOG2D_INUMTYPE>( x, y ), Point2d_<HOMOG2D_INUMTYPE>( x, y ) ) );
+			return;
+		}
+		if( _bbox.isBad() )
+			return;
+		auto bb = _bbox.value();
+		if( oldPt )
+		{
+			HOMOG2D_INUMTYPE ox = oldPt->getX();
+			HOMOG2D_INUMTYPE oy = oldPt->getY();
+			if( ox == bb.first.getX() || ox == bb.second.getX() || oy == bb.first.getY() || oy == bb.second.getY() )
+			{
+				_bbox.setBad();
+				return;
+			}
+		}
+		bb.first.set(  std::min( bb.first.getX(),  x ), std::min( bb.first.getY(),  y ) );
+		bb.second.set( std::max( bb.second.getX(), x ), std::max( bb.second.getY(), y ) );
+		_bbox.set( bb );
 	}
-///@}
 
-/// Polyline intersection with Line, Segment, FRect, Circle
-	template<
-		typename T,
-		typename std::enable_if<
-			trait::IsShape<T>::value,
-			T
-		>::type* = nullptr
-	>
-	detail::IntersectM<FPT> intersects( const T& other ) const
-	{
-		detail::IntersectM<FPT> out;
-		for( const auto& pseg: getSegs() )
+private:
+	template<typename FCT>
+	void p_applyToPoints( FCT fct )
+	{
+		_bvh.clear();
+		_convex.clear();
+		if( !_centroid.isBad() )
+			_centroid.set( fct( _centroid.value() ) );
+		if( !_bbox.isBad() )
 		{
-			auto inters = pseg.intersects( other );
-			if( inters() )
-				out.add( inters.get() );
+			auto p1 = fct( _bbox.value().first );
+			auto p2 = fct( _bbox.value().second );
+			_bbox.set(
+				std::make_pair(
+					Point2d_<HOMOG2D_INUMTYPE>( std::min( p1.getX(), p2.getX() ), std::min( p1.getY(), p2.getY() ) ),
+					Point2d_<HOMOG2D_INUMTYPE>( std::max( p1.getX(), p2.getX() ), std::max( p1.getY(), p2.getY() ) )
+				)
+			);
 		}
-		return out;
 	}
+};
 
-/// Polyline isInside other primitive
+//------------------------------------------------------------------
+/// Returns the bounding box of points in vector/list/array of points \c vpts (free function)
 /**
-Sfinae should resolve for T=Circle,FRect,Ellipse but not for CPolyline
+\todo This loops twice on the points. Maybe some improvement here.
 */
-	template<
-		typename T,
-		typename std::enable_if<
-				(
-					trait::HasArea<T>::value
-					&&
-					!trait::PolIsClosed<T>::value
-				)
-				,T
-		>::type* = nullptr
-	>
-	bool
-	isInside( const T& prim ) const
-	{
-		HOMOG2D_START;
-		if( size() == 0 )
-			return false;
-		for( const auto& pt: getPts() )
-			if( !pt.isInside( prim ) )
-				return false;
-		return true;
-	}
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+PointPair_<typename T::value_type::FType>
+getBB_Points( const T& vpts )
+{
+	HOMOG2D_START;
+	using FPT = typename T::value_type::FType;
+	HOMOG2D_DEBUG_ASSERT( static_cast<bool>(vpts.size()), "cannot run with no points" );
 
-/// Polyline isInside other CPolyline
-/**
-Sfinae should resolve ONLY for CPolyline
-*/
-	template<
-		typename T,
-		typename std::enable_if<
-			trait::PolIsClosed<T>::value,T
-		>::type* = nullptr
-	>
-	bool
-	isInside( const T& cpol ) const
-	{
-		HOMOG2D_START;
-		if( size() == 0 )
-			return false;
-		for( const auto& pt: getPts() )
-			if( !pt.isInside( cpol ) )
-				return false;
-		if( intersects(cpol)() )
-			return false;
-		return true;
-	}
+	auto mm_x = std::minmax_element(
+		std::begin( vpts ),
+		std::end( vpts ),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			return pt1.getX() < pt2.getX();
+		}
+	);
+	auto mm_y = std::minmax_element(
+		std::begin( vpts ),
+		std::end( vpts ),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			return pt1.getY() < pt2.getY();
+		}
+	);
 
-	template<typename T1,typename T2>
-	friend std::ostream&
-	h2d::base::operator << ( std::ostream&, const h2d::base::PolylineBase<T1,T2>& );
+	auto p1 = Point2d_<HOMOG2D_INUMTYPE>( mm_x.first->getX(),   mm_y.first->getY()  );
+	auto p2 = Point2d_<HOMOG2D_INUMTYPE>( mm_x.second->getX(),  mm_y.second->getY() );
 
-#ifdef HOMOG2D_TEST_MODE
-/// this is only needed for testing
-	bool isNormalized() const { return _plIsNormalized; }
-#endif
+#ifndef HOMOG2D_NOCHECKS
+	if( p1.distTo( p2 ) < thr::nullDistance() )
+		HOMOG2D_THROW_ERROR_1(
+			"unable to compute bounding box of set, identical points:\n -p1:"<< p1 << "\n -p2:" << p2
+		);
+	if( shareCommonCoord( p1, p2 ) )
+		HOMOG2D_THROW_ERROR_1(
+			"unable to compute bounding box of set, points share common coordinate:\n -p1:"
+			<< p1 << "\n -p2:" << p2
+		);
+#endif // HOMOG2D_NOCHECKS
 
-private:
-	void p_normalizePoly() const;
+	return std::make_pair( p1, p2 );
+}
 
-public:
-	template<typename T>
-	PolylineBase<typ::IsClosed,FPT>
-	getOffsetPoly( T value, OffsetPolyParams p=OffsetPolyParams{} ) const;
+//------------------------------------------------------------------
+/// Returns the bounding box of segments in vector/list/array of points \c vsegs
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+FRect_<typename T::value_type::FType>
+getBB_Segments( const T& vsegs )
+{
+	HOMOG2D_START;
+	using FPT = typename T::value_type::FType;
 
-	std::vector<Line2d_<HOMOG2D_INUMTYPE>>
-	getBisectorLines() const
+	HOMOG2D_DEBUG_ASSERT( vsegs.size(), "cannot compute bounding box of empty set of segments" );
+	std::vector<Point2d_<FPT>> vpts( vsegs.size()*2 );
+	auto it = vpts.begin();
+	for( const auto& seg: vsegs )
 	{
-		 return h2d::getBisectorLines( *this );
+		auto ppts = seg.getPts();
+		*it++ = ppts.first;
+		*it++ = ppts.second;
 	}
+	return FRect_<typename T::value_type::FType>( getBB_Points( vpts ) );
+}
 
-	void draw( img::Image<img::SvgImage>&, img::DrawParams dp=img::DrawParams() ) const;
-#ifdef HOMOG2D_USE_OPENCV
-	void draw( img::Image<cv::Mat>&,       img::DrawParams dp=img::DrawParams() ) const;
-#endif
-
-}; // class PolylineBase
+/// get BB for a set of FRect_ objects
+/// \todo same as getBB_Segments() ???
+template<typename FPT>
+auto
+getBB_FRect( const std::vector<FRect_<FPT>>& v_rects )
+{
+	HOMOG2D_START;
+	HOMOG2D_DEBUG_ASSERT( v_rects.size(), "cannot compute bounding box of empty set of rectangles" );
 
+	std::vector<Point2d_<FPT>> vpts( v_rects.size()*2 );
+	auto it = vpts.begin();
+	for( const auto& seg: v_rects )
+	{
+		auto ppts = seg.getPts();
+		*it++ = ppts.first;
+		*it++ = ppts.second;
+	}
+	return FRect_<FPT>( getBB_Points( vpts ) );
+}
 
 //------------------------------------------------------------------
-/// Return an "offsetted" closed polyline, requires simple polygon (CPolyline AND no crossings) as input
+/// Lightweight view on the segments of a polyline, returned by
+/// base::PolylineBase::getSegsView() and base::PolylineBase::getOSegsView()
 /**
-On failure (for whatever reason), will return an empty CPolyline
+Segments are built on the fly from the points, no memory allocation is done.
+For closed polylines, the last segment joins the last point to the first one.
 
-- If dist>0, returns the polyline "outside" the source one
-- If dist<0, returns the polyline "inside" the source one
+\warning Holds a reference on the points of the polyline, so it must not outlive it,
+and is invalidated if the polyline is modified.
+
+\tparam ST segment type: Segment_ or OSegment_
 */
-template<typename PLT,typename FPT>
-template<typename T>
-PolylineBase<typ::IsClosed,FPT>
-PolylineBase<PLT,FPT>::getOffsetPoly( T dist, OffsetPolyParams params ) const
+template<typename ST,typename FPT>
+class SegView
 {
-	HOMOG2D_CHECK_IS_NUMBER(T);
-	auto dist0 = (HOMOG2D_INUMTYPE)dist; // casting
+private:
+	const std::vector<Point2d_<FPT>>* _pts = nullptr;
+	size_t _nbSegs = 0;
 
-	bool valid = true;
-	if( homog2d_abs(dist) < thr::nullDistance() )
-	{
-		HOMOG2D_LOG_WARNING( "Failure, distance value is null, returning empty CPolyline" );
-		valid = false;
-	}
-	if( size()<3 )
+public:
+	/// Iterator on the segments, yields segments by value
+	class Iterator
 	{
-		HOMOG2D_LOG_WARNING( "Failure, computing offsetted Polyline requires at least 3 points, returning empty CPolyline" );
-		valid = false;
-	}
-	if( !isSimple() )
+		friend class SegView;
+	private:
+		const SegView* _view = nullptr;
+		size_t         _idx = 0;
+		Iterator( const SegView* view, size_t idx ) : _view(view), _idx(idx)
+		{}
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type        = ST;
+		using difference_type   = std::ptrdiff_t;
+		using pointer           = void;
+		using reference         = ST;
+
+		Iterator() = default;
+		ST operator * () const { return (*_view)[_idx]; }
+		Iterator& operator ++ ()    { ++_idx; return *this; }
+		Iterator  operator ++ (int) { auto tmp = *this; ++_idx; return tmp; }
+		bool operator == ( const Iterator& other ) const { return _idx == other._idx; }
+		bool operator != ( const Iterator& other ) const { return _idx != other._idx; }
+	};
+
+	SegView() = default;
+	SegView( const std::vector<Point2d_<FPT>>& pts, bool isClosed )
+		: _pts( &pts )
 	{
-		HOMOG2D_LOG_WARNING( "Failure, Polyline is not a polygon, returning empty CPolyline" );
-		valid = false;
+		auto siz = pts.size();
+		if( siz > 1 )
+			_nbSegs = ( isClosed ? siz : siz-1 );
 	}
-	if( !valid )
-		return PolylineBase<typ::IsClosed,FPT>();
 
-	p_normalizePoly();
+	size_t size()  const { return _nbSegs; }
+	bool   empty() const { return _nbSegs == 0; }
 
-	size_t current = 0;
-//	bool paraLines = false;
-
-	std::vector<Point2d_<FPT>> v_out;
-	auto osegs = getOSegs();
-	auto oseg1 = osegs.at(current);
-	do
+/// Returns segment \c idx (no checking)
+	ST operator [] ( size_t idx ) const
 	{
-		auto next = (current==size()-1 ? 0 : current+1);
-
-		auto pt1 = getPoint(next);
-
-		auto oseg2 = osegs.at(next);
-
-		auto psegs1 = oseg1.getParallelSegs(homog2d_abs(dist0));
-		auto psegs2 = oseg2.getParallelSegs(homog2d_abs(dist0));
-
-		auto pseg1 = &psegs1.first;
-		auto pseg2 = &psegs2.first;
-		if( dist < 0 )
-		{
-			pseg1 = &psegs1.second;
-			pseg2 = &psegs2.second;
-		}
+		const auto& pts = *_pts;
+		return ST( pts[idx], pts[idx+1==pts.size() ? 0 : idx+1] );
+	}
+	ST front() const { return (*this)[0]; }
+	ST back()  const { return (*this)[_nbSegs-1]; }
 
-		auto li1 = pseg1->getLine();
-		auto li2 = pseg2->getLine();
-		if( !areParallel(li1,li2) )
-		{
-			auto pt_int = li1 * li2;
-			if( !params._angleSplit || getAngle(oseg1,oseg2)>0 || dist < 0 )
-			{
-				v_out.push_back( pt_int );  // add point intersection of the two lines
-			}
-			else
-			{
-				auto oseg = OSegment_<HOMOG2D_INUMTYPE>( pt1, pt_int );
-				auto dist_cut = std::min( oseg.length(), dist0 );
+	Iterator begin() const { return Iterator( this, 0 ); }
+	Iterator end()   const { return Iterator( this, _nbSegs ); }
+};
 
-				auto pt_cut = oseg.getPointAt( dist_cut );
-				auto oli = oseg.getLine().getOrthogLine( pt_cut );
+/// Private helper function for base::PolylineBase::getSegs() and base::PolylineBase::getOSegs()
+template<typename ST,typename PLT, typename FPT> // Segment Type, PolyLine Type, Floating Point Type
+std::vector<ST>
+p_getSegs( const base::PolylineBase<PLT,FPT>& pl, const ST& )
+{
+	SegView<ST,FPT> view( pl.getPts(), pl.isClosed() );
+	std::vector<ST> out;
+	out.reserve( view.size() );
+	for( const auto& seg: view )
+		out.push_back( seg );
+	return out;
+}
 
-				auto pt_cut1 = oli * li1;
-				auto pt_cut2 = oli * li2;
+} // namespace priv
 
-				v_out.push_back( pt_cut1 );
-				if( pt_cut1 != pt_cut2 )        // so we don't add two identical pts (in case they were computed as such)
-					v_out.push_back( pt_cut2 );
-			}
-		}
-//		else
-//			std::cout << "parallel!\n";
+// Forward declaration
+template<typename FPT1,typename FPT2>
+CPolyline_<FPT1>
+operator * ( const Homogr_<FPT2>&, const FRect_<FPT1>& );
 
-		current++;
-		oseg1 = oseg2;
-	}
-	while( current<size() ); //&& !paraLines );
+// Forward declaration
+///  \todo 20230215: check if this has to be moved in the 'base' namespace. Can it be called **without**
+/// `using namespace std;`. This was the case for the streaming operator...
+template<typename FPT1,typename FPT2,typename PLT2>
+auto
+operator * ( const Homogr_<FPT2>&, const base::PolylineBase<PLT2,FPT1>& ) -> base::PolylineBase<PLT2,FPT1>;
 
-	return PolylineBase<typ::IsClosed,FPT>( v_out );
-}
 
 //------------------------------------------------------------------
-/// Build a parallelogram (4 points) from 3 points
-template<typename PLT,typename FPT>
-template<typename FPT1,typename FPT2,typename FPT3>
-void
-PolylineBase<PLT,FPT>::setParallelogram(
-	const Point2d_<FPT1>& p1,
-	const Point2d_<FPT2>& p2,
-	const Point2d_<FPT3>& p3
-)
+/// Type of join added on the corners where the offsetted edges do not meet, see OffsetPolyParams
+enum class OffsetJoin: uint8_t
 {
-	static_assert( std::is_same_v<PLT,typ::IsClosed>, "Invalid: cannot set a OPolyline as a parallelogram" );
+	Miter,  ///< edges are extended up to their intersection point (see OffsetPolyParams::_miterLimit)
+	Square, ///< miter cut at the offset distance from the source point
+	Bevel,  ///< the two edges are joined by a segment
+	Round   ///< the two edges are joined by a circle arc centered on the source point
+};
 
-	Point2d_<HOMOG2D_INUMTYPE> pt1(p1);
-	Point2d_<HOMOG2D_INUMTYPE> pt2(p2);
-	Point2d_<HOMOG2D_INUMTYPE> pt3(p3);
+//------------------------------------------------------------------
+/// Parameters for base::PolylineBase::getOffsetPoly() and getOffsetPolys()
+struct OffsetPolyParams
+{
+	bool _angleSplit = false;            ///< deprecated, same as `_join = OffsetJoin::Square`
+	OffsetJoin _join = OffsetJoin::Miter;
+	HOMOG2D_INUMTYPE _miterLimit = 0.;   ///< Miter join: max ratio between miter length and offset distance, beyond a bevel join is used (0: no limit)
+	HOMOG2D_INUMTYPE _arcStep = M_PI/16.; ///< Round join: max angle (radians) between two consecutive points of the arcs
+	bool _cleanup = true;                ///< remove the self-intersections of the offsetted polygon
+};
 
-	std::vector<Point2d_<FPT>> vpts(4);
-	vpts[0] = pt1;
-	vpts[1] = pt2;
-	vpts[2] = pt3;
 
-	auto li_21 = pt1 * pt2;
-	auto li_23 = pt3 * pt2;
-	auto li_34 = li_21.getParallelLine( pt3 );
-	auto li_14 = li_23.getParallelLine( pt1 );
-	vpts[3] = li_34 * li_14;
-	set( vpts );
-}
+namespace base {
 
 //------------------------------------------------------------------
-/// Build a Regular Convex Polygon of radius \c rad with \c n points, centered at (0,0)
+/// Polyline, will be instanciated either as \ref OPolyline_ (open polyline) or \ref CPolyline_
 /**
-\return segment distance, inscribed circle radius
+\warning When closed, in order to be able to compare two objects describing the same structure
+but potentially in different order, the comparison operator will proceed a sorting.<br>
+The consequence is that when adding points, if you have done a comparison before, you might not
+add point after the one you thought!
+
+template args:
+ - PLT: PolyLine Type: typ::IsClosed or typ::IsOpen
+ - FPT: Floating Point Type
 */
 template<typename PLT,typename FPT>
-template<typename FPT2,typename T>
-std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
-PolylineBase<PLT,FPT>::set(
-	FPT2 rad,   ///< Radius
-	T    ni     ///< Nb of points
-)
+class PolylineBase: public detail::Common<FPT>
+#ifdef HOMOG2D_ENABLE_PRTP
+, public rtp::Root
+#endif
 {
-	static_assert(
-		std::is_integral<T>::value,
-		"2nd argument type must be integral type"
-	);
-	static_assert(
-		std::is_same_v<PLT,typ::IsClosed>,
-		"Cannot build a RCP as open polyline"
-	);
-
-	if( ni < 3 )
-		HOMOG2D_THROW_ERROR_1( "unable, nb of points must be > 2" );
-	if( rad <= 0  )
-		HOMOG2D_THROW_ERROR_1( "unable, radius must be > 0" );
+public:
+	using FType = FPT;
+//	using PType = PLT;
+	using SType = std::conditional<std::is_same_v<PLT,typ::IsClosed>,typ::T_CPol,typ::T_OPol>;
 
-	size_t n(ni);
-	std::vector<Point2d_<HOMOG2D_INUMTYPE>> v_pts(n);
-	auto it = std::begin( v_pts );
-	auto angle0 = (HOMOG2D_INUMTYPE)2. * M_PI / n;
+	using detail::Common<FPT>::isInside;
 
-	Point2d_<HOMOG2D_INUMTYPE> pt0( rad, 0. ); // initial point
-	HOMOG2D_INUMTYPE radius = 0.;
+	template<typename T1,typename T2> friend class PolylineBase;
+	template<typename T1,typename T2> friend class LPBase;
+	template<typename T1> friend class h2d::Ellipse_;
 
-	for( size_t i=0; i<n; i++ )
-	{
-		auto angle = angle0 * i;
-		auto x = homog2d_cos( angle );
-		auto y = homog2d_sin( angle );
+	template<typename FPT1,typename FPT2>
+	friend CPolyline_<FPT1>
+	h2d::operator * ( const h2d::Homogr_<FPT2>&, const h2d::FRect_<FPT1>& );
 
-		if( i == 1 )    // compute radius of inscribed circle
-		{
-			auto pt1 = Point2d_<HOMOG2D_INUMTYPE>( x * rad, y * rad );
-			Segment_<HOMOG2D_INUMTYPE> seg( pt0, pt1 );
-			Line2d_<HOMOG2D_INUMTYPE> li( seg.getCenter() );     // line passing through (0,0) and middle point of segment
-			auto inters_pt = seg.intersects( li ) ;              // intersection point
-			assert( inters_pt() );
-			radius = Point2d_<HOMOG2D_INUMTYPE>(0,0).distTo( inters_pt.get() );
-		}
+	template<typename FPT1,typename FPT2,typename PLT2>
+	friend auto
+	h2d::operator * ( const Homogr_<FPT2>&, const base::PolylineBase<PLT2,FPT1>& ) -> base::PolylineBase<PLT2,FPT1>;
 
-		*it = Point2d_<HOMOG2D_INUMTYPE>( x * rad, y * rad );
-		it++;
+	Type type() const
+	{
+		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+			return Type::CPolyline;
+		else
+			return Type::OPolyline;
 	}
-	*this = PolylineBase<PLT,FPT>( v_pts );
 
-	return std::make_pair(
-		getPoint(0).distTo( getPoint(1) ),
-		radius
-	);
-}
+private:
+	mutable std::vector<Point2d_<FPT>> _plinevec;
+	mutable bool _plIsNormalized = false;
+	mutable priv::PolylineAttribs _attribs;    ///< Attributes. Will get stored upon computing.
 
-} // namespace base
+public:
+/// \name Constructors
+///@{
 
+/// Default constructor
+	PolylineBase() = default;
 
-// FREE FUNCTIONS
-// (need to be here because the 5 below are being called by some member functions
-// of class PolylineBase, that is implemented further below
+/// Constructor from FRect. Enabled for "closed" type, disabled for "open" type
+	template<typename FPT2>
+	PolylineBase( const FRect_<FPT2>& rect )
+	{
+		static_assert( std::is_same_v<PLT,typ::IsClosed>, "cannot build an OPolyline object from a FRect");
+		for( const auto& pt: rect.get4Pts() )
+			_plinevec.push_back( pt );
+	}
 
-namespace priv {
+	template<typename FPT2>
+	PolylineBase( const Segment_<FPT2>& seg )
+	{
+		const auto& ppts = seg.getPts();
+		p_addPoint( ppts.first );
+		p_addPoint( ppts.second );
+	}
 
-//------------------------------------------------------------------
-/// Return iterator on Bottom-most point of container holding points
-/**
-Used by
- - getBmPoint()
- - priv::chull::getPivotPoint()
-*/
+/// Constructor from a vector of points.
 template<
 	typename T,
 	typename std::enable_if<
-		(
-			trait::IsContainer<T>::value &&
-			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
-		), T
+		trait::IsContainer<T>::value,
+		T
 	>::type* = nullptr
 >
-auto
-getBmPoint_helper( const T& t )
-{
-	using FPT = typename T::value_type::FType;
-#ifndef HOMOG2D_NOCHECKS
-	if( t.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
-#endif
+	PolylineBase( const T& vec )
+	{
+		set( vec );
+	}
 
-	return std::min_element(
-		std::begin(t),
-		std::end(t),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
-		{
-			if( pt1.getY() < pt2.getY() )
-				return true;
-			if( pt1.getY() > pt2.getY() )
-				return false;
-			return( pt1.getX() < pt2.getX() );
-		}
-	);
-}
+/// Constructor that builds a regular convex polygon of \c n points at a distance \c rad, centered at (0,0).
+	template<typename FPT2,typename T>
+	PolylineBase( FPT2 rad, T n )
+	{
+		set( rad, n );
+	}
 
-} // namespace priv
+/// Copy-Constructor from Closed Polyline
+	template<typename FPT2>
+	constexpr PolylineBase( const CPolyline_<FPT2>& other )
+	{
+		static_assert(
+			!(std::is_same<PLT,typ::IsOpen>::value),
+			"Error, cannot build an Open Polyline from a closed one"
+		);
+		set( other._plinevec );
+	}
+/// Copy-Constructor from Open Polyline
+	template<typename FPT2>
+	PolylineBase( const OPolyline_<FPT2>& other )
+	{
+		set( other._plinevec );
+	}
 
-//------------------------------------------------------------------
-/// Return Bottom-most point of container holding points
-template<
-	typename T,
-	typename std::enable_if<
-		(
-			trait::IsContainer<T>::value &&
-			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
-		), T
-	>::type* = nullptr
->
-auto
-getBmPoint( const T& t )
-{
-#ifndef HOMOG2D_NOCHECKS
-	if( t.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
-#endif
-	auto it = priv::getBmPoint_helper( t );
-	return std::make_pair(
-		*it,
-		std::distance( std::begin(t), it )
-	);
-}
+#ifdef HOMOG2D_USE_BOOSTGEOM
+/// Constructor from a boost geometry polygon, see misc/test_files/bg_test_1.cpp
+/**
+\note Only imports the "outer" envelope, homog2d does not handle polygons with holes
 
-//------------------------------------------------------------------
-/// Return Top-most point of container
-template<
-	typename T,
-	typename std::enable_if<
-		(
-			trait::IsContainer<T>::value &&
-			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
-		), T
-	>::type* = nullptr
->
-auto
-getTmPoint( const T& t )
-{
-	using FPT = typename T::value_type::FType;
+Requirements: the Boost polygon must have 2-cartesian coordinates points,
+either `bg::model::point` or `bg::model::d2::point_xy`
+but the underlying numerical type is free.
 
-#ifndef HOMOG2D_NOCHECKS
-	if( t.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
-#endif
+\note At present, the 3th template parameter (bool) (Closed or Open) is ignored, because it is unclear how
+this relates to the actual fact that last point is equal to first point.
+\todo 20230216:  add some checking that the type BPT needs to fit certain requirements
+(must have 2-dimensions, and use cartesian coordinates). Maybe we should add some Sfinae to check this.
+*/
+	template<typename BPT,bool CLKW,bool CLOSED> //
+	PolylineBase(
+		const boost::geometry::model::polygon<
+			BPT,     ///< Boost Point Type (either `bg::model::point` or `bg::model::d2::point_xy`)
+			CLKW,    ///< this one is ignored here
+			CLOSED   ///< true: closed, false: open
+		>& bgpol  ///< input boost geometry polygon
+	)
+	{
+		const auto& outer = bgpol.outer();
+		bool isClosed = false;
+		auto ptf = outer.front();
+		auto ptb = outer.back();
+		Point2d_<HOMOG2D_INUMTYPE> pt_front( boost::geometry::get<0>(ptf), boost::geometry::get<1>(ptf) );
+		Point2d_<HOMOG2D_INUMTYPE> pt_back(  boost::geometry::get<0>(ptb), boost::geometry::get<1>(ptb) );
+/*
+this should work !!! (but doesn't...)
+		Point2d_<HOMOG2D_INUMTYPE> pt_front( outer.front() );
+		Point2d_<HOMOG2D_INUMTYPE> pt_back(  outer.back() );
+*/
+		if( pt_front == pt_back ) // means it's closed
+			isClosed = true;
 
-	auto it = std::min_element(
-		std::begin(t),
-		std::end(t),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		if( isClosed && std::is_same_v<PLT,typ::IsOpen> ) // cannot build an open polyline from a closed one
+			HOMOG2D_THROW_ERROR_1( "unable to convert a closed boost::polygon into an OPolyline" );
+
+		_plinevec.reserve( outer.size() - isClosed );
+		for( auto it=outer.begin(); it!=outer.end()-isClosed; it++ )
 		{
-			if( pt1.getY() > pt2.getY() )
-				return true;
-			if( pt1.getY() < pt2.getY() )
-				return false;
-			return( pt1.getX() < pt2.getX() );
+			const auto& bgpt = *it;
+			_plinevec.emplace_back(
+				Point2d_<FPT>( boost::geometry::get<0>(bgpt), boost::geometry::get<1>(bgpt) )
+			);
 		}
-	);
-	return std::make_pair(
-		*it,
-		std::distance( std::begin(t), it )
-	);
-}
+	}
+#endif
 
-//------------------------------------------------------------------
-/// Return Left-most point of container as a pair holding:
-/**
-- first: the point
-- second: the distance (index) from begin position
-
-\todo 20250222: CHANGE RETURN TYPE! => should return an iterator, not a pair
-(so this allows usage of any non-random access container)
-*/
-template<
-	typename T,
-	typename std::enable_if<
-		(
-			trait::IsContainer<T>::value &&
-			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
-		), T
-	>::type* = nullptr
->
-auto
-getLmPoint( const T& t )
-{
-	using FPT = typename T::value_type::FType;
+///@}
 
-#ifndef HOMOG2D_NOCHECKS
-	if( t.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
-#endif
+public:
+/// \name Attributes access
+///@{
 
-	auto it = std::min_element(
-		std::begin(t),
-		std::end(t),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
-		{
-			if( pt1.getX() < pt2.getX() )
-				return true;
-			if( pt1.getX() > pt2.getX() )
-				return false;
-			return( pt1.getY() < pt2.getY() );
-		}
-	);
+/// Returns the number of points
+	size_t size() const { return _plinevec.size(); }
 
-	return std::make_pair(
-		*it,
-		std::distance( std::begin(t), it )
-	);
-}
+	constexpr bool isClosed() const
+	{
+		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+			return true;
+		else
+			return false;
+	}
 
-//------------------------------------------------------------------
-/// Return Right-most point of container holding points
-template<
-	typename T,
-	typename std::enable_if<
-		(
-			trait::IsContainer<T>::value &&
-			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
-		), T
-	>::type* = nullptr
->
-auto
-getRmPoint( const T& t )
-{
-	using FPT = typename T::value_type::FType;
+	HOMOG2D_INUMTYPE length()    const;
+	HOMOG2D_INUMTYPE area()      const;
+	bool             isSimple()  const;
 
+/// Returns Bounding Box of Polyline
+	auto getBB() const
+	{
+		HOMOG2D_START;
 #ifndef HOMOG2D_NOCHECKS
-	if( t.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+		if( size() < 2 )
+			HOMOG2D_THROW_ERROR_1( "cannot compute bounding box of empty Polyline" );
 #endif
-
-	auto it = std::min_element(
-		std::begin(t),
-		std::end(t),
-		[]                  // lambda
-		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		if( _attribs._bbox.isBad() )
 		{
-			if( pt1.getX() > pt2.getX() )
-				return true;
-			if( pt1.getX() < pt2.getX() )
-				return false;
-			return( pt1.getY() < pt2.getY() );
+			auto bb = priv::getBB_Points( getPts() );
+			_attribs._bbox.set( std::make_pair( Point2d_<HOMOG2D_INUMTYPE>( bb.first ), Point2d_<HOMOG2D_INUMTYPE>( bb.second ) ) );
 		}
-	);
-
-	return std::make_pair(
-		*it,
-		std::distance( std::begin(t), it )
-	);
-}
+		const auto& ppts = _attribs._bbox.value();
+#ifndef HOMOG2D_NOCHECKS
+		if( shareCommonCoord( ppts.first, ppts.second ) )
+			HOMOG2D_THROW_ERROR_1( "unable, points share common coordinate" );
+#endif
+		return FRect_<HOMOG2D_INUMTYPE>( ppts );
+	}
 
-//------------------------------------------------------------------
-/// Return Bottom-most point of Polyline (free function)
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-getBmPoint( const base::PolylineBase<PLT,FPT>& poly )
-{
-	return getBmPoint( poly.getPts() ).first;
-}
-/// Return Top-most point of Polyline (free function)
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-getTmPoint( const base::PolylineBase<PLT,FPT>& poly )
-{
-	return getTmPoint( poly.getPts() ).first;
-}
-/// Return Left-most point of Polyline (free function)
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-getLmPoint( const base::PolylineBase<PLT,FPT>& poly )
-{
-	return getLmPoint( poly.getPts() ).first;
-}
-/// Return Right-most point of Polyline (free function)
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-getRmPoint( const base::PolylineBase<PLT,FPT>& poly )
-{
-	return getRmPoint( poly.getPts() ).first;
-}
+	LPBase<typ::IsPoint,HOMOG2D_INUMTYPE> centroid() const;
 
-//------------------------------------------------------------------
-/// Get Top-most / Bottom-most / Left-most / Right-most point, depending on \c dir
-/// (free function)
-/**
-Type \c T can be either a Polyline (open or closed), or a container holding points, or a FRect_
-*/
-template<typename T>
-auto
-getExtremePoint( CardDir dir, const T& t )
-{
-	switch( dir )
+/// Returns the number of segments. If "closed",
+/** the last segment (going from last to first point) is counted */
+	size_t nbSegs() const
 	{
-		case CardDir::Top:    return getTmPoint(t); break;
-		case CardDir::Bottom: return getBmPoint(t); break;
-		case CardDir::Left:   return getLmPoint(t); break;
-		case CardDir::Right:  return getRmPoint(t); break;
-		default: assert(0);
+		if( size() < 2 )
+			return 0;
+		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+			return size();
+		else
+			return size() - 1;
 	}
-}
 
-namespace base {
+	Point2d_<FPT> getExtremePoint( CardDir ) const;
+	Point2d_<FPT> getTmPoint() const;
+	Point2d_<FPT> getBmPoint() const;
+	Point2d_<FPT> getLmPoint() const;
+	Point2d_<FPT> getRmPoint() const;
 
-//------------------------------------------------------------------
-/// Get Top-most / Bottom-most / Left-most / Right-most point
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-PolylineBase<PLT,FPT>::getExtremePoint( CardDir dir ) const
-{
-	return getExtremePoint( dir, *this );
-}
+	bool isConvex() const;
 
-/// Return Bottom-most point of Polyline
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-PolylineBase<PLT,FPT>::getBmPoint() const
-{
-	return h2d::getBmPoint( *this );
-}
+	template<typename T>
+	Point2d_<FPT> pointAt( T s ) const;
+	template<typename T>
+	size_t segmentAt( T s ) const;
 
-/// Return Top-most point of Polyline
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-PolylineBase<PLT,FPT>::getTmPoint() const
-{
-	return h2d::getTmPoint( *this );
-}
+///@}
 
-/// Return Left-most point of Polyline
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-PolylineBase<PLT,FPT>::getLmPoint() const
-{
-	return h2d::getLmPoint( *this );
-}
+private:
+	HOMOG2D_INUMTYPE p_ComputeSignedArea() const;
 
-/// Return Right-most point of Polyline
-template<typename PLT,typename FPT>
-Point2d_<FPT>
-PolylineBase<PLT,FPT>::getRmPoint() const
-{
-	return h2d::getRmPoint( *this );
-}
+#ifdef HOMOG2D_VECTORIZE
+/// Returns a function object giving the coordinates of a point, used for the reductions
+	auto p_getCoords() const
+	{
+		return [this]( size_t i, HOMOG2D_INUMTYPE& x, HOMOG2D_INUMTYPE& y )    // lambda
+		{
+			x = _plinevec[i].getX();
+			y = _plinevec[i].getY();
+		};
+	}
+#endif
 
-//------------------------------------------------------------------
-#ifdef HOMOG2D_PRELIMINAR
-/// TMP
-struct TMP_DebugSquare
-{
-	Line2d_<double> li0;
-	Line2d_<double> line_ortho;
-	Line2d_<double> li_L, li_R;
+/// Returns the arc-length index, builds it if needed
+	const priv::ArcLengthIndex& p_getArcIndex() const
+	{
+		if( !_attribs._arcIndex.isValid() )
+			_attribs._arcIndex.build( _plinevec, isClosed() );
+		return _attribs._arcIndex;
+	}
+	size_t p_locateAbscissa( HOMOG2D_INUMTYPE& s ) const;
+	Point2d_<FPT> p_interpolate( size_t seg, HOMOG2D_INUMTYPE s ) const;
+	void p_resample( size_t nb, HOMOG2D_INUMTYPE step );
 
-	Segment_<double> s1;
-	Segment_<double> sL,sR;
+/// Reverse order of points, only the sign of the area changes
+	void p_reversePts() const
+	{
+		std::reverse( _plinevec.begin(), _plinevec.end() );
+		_attribs._arcIndex.clear();
+		_attribs._convex.clear();
+		if( !_attribs._signedArea.isBad() )
+			_attribs._signedArea.set( -_attribs._signedArea.value() );
+	}
 
-	double dist;
-	PointPair_<double>  ppts;
-	Point2d_<double> pt_resL, pt_resR;
-};
+/// Add single point. private, because only to be used from other member functions
+/**
+\warning This function was discarded from public API in dec. 2021, because
+this will add the new point after the previous one \b only if the object has \b not
+been normalized. This normalizing operation will happen if you do a comparison (== or !=)
+*/
+	template<typename FPT2>
+	void p_addPoint( const Point2d_<FPT2>& pt )
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( size() )
+			if( pt == _plinevec.back() )
+				HOMOG2D_THROW_ERROR_1(
+					"cannot add a point identical to previous one: pt=" << pt << " size=" << size()
+				);
+#endif
+		HOMOG2D_INUMTYPE dl = 0.;
+		HOMOG2D_INUMTYPE da = 0.;
+		if( size() )  // new point is inserted between last and first one
+		{
+			const auto& pLast  = _plinevec.back();
+			const auto& pFirst = _plinevec.front();
+			Point2d_<FPT> pt2( pt );
+			da = priv::shoelaceTerm( pLast, pt2 ) + priv::shoelaceTerm( pt2, pFirst ) - priv::shoelaceTerm( pLast, pFirst );
+			dl = pLast.distTo( pt2 );
+			if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+				dl += pt2.distTo( pFirst ) - pLast.distTo( pFirst );
+		}
+		_plIsNormalized=false;
+		_plinevec.push_back( pt );
+		_attribs.applyPointChange( dl, da, _plinevec.back(), (const Point2d_<FPT>*)nullptr, size()==1 );
+	}
 
-template<typename CONT>
-auto
-buildSquare( const CONT& pts )
-{
-	TMP_DebugSquare dbg;
+public:
 
-	if( pts.size() != 4 )
-		HOMOG2D_THROW_ERROR_1( "Error, size must be = 4, current size=" << pts.size() );
-
-	if( areCollinear( pts[0], pts[1], pts[2] ) )
-		HOMOG2D_THROW_ERROR_1( "Unable, points 012 are colinear" );
-	if( areCollinear( pts[1], pts[2], pts[3] ) )
-		HOMOG2D_THROW_ERROR_1( "Unable, points 123 are colinear" );
-	if( areCollinear( pts[1], pts[0], pts[3] ) )
-		HOMOG2D_THROW_ERROR_1( "Unable, points 013 are colinear" );
-	if( areCollinear( pts[0], pts[2], pts[3] ) )
-		HOMOG2D_THROW_ERROR_1( "Unable, points 023 are colinear" );
-
-	auto pt_L = getLmPoint( pts );
-	auto pt_R = getRmPoint( pts );
-	auto pt_T = getTmPoint( pts );
-	auto pt_B = getBmPoint( pts );
-	Segment_<HOMOG2D_INUMTYPE> s1( pt_L.first, pt_R.first );
-dbg.s1 = s1;
-	auto dist = s1.length();
-dbg.dist = dist;
-
-	auto line_ortho = s1.getLine().getOrthogLine( pt_T.first );
-dbg.line_ortho = line_ortho;
+/// \name Data access
+///@{
 
-	auto ppts = line_ortho.getPoints( pt_T.first, dist );
-dbg.ppts = ppts;
-	auto d1 = ppts.first.distTo( pt_L.first );
-	auto d2 = ppts.second.distTo( pt_L.first );
+/// Returns the points (reference)
+	std::vector<Point2d_<FPT>>& getPts()
+	{
+		_attribs.setBad();  // because we send the non-const reference
+		_plIsNormalized=false;
+		return _plinevec;
+	}
+/// Returns the points (const reference)
+	const std::vector<Point2d_<FPT>>& getPts() const
+	{
+		return _plinevec;
+	}
 
-	auto goodpt = ppts.first;
-	if( d2 < d1 )
-		goodpt = ppts.second;
+/// Returns (as a copy) the oriented segments of the polyline
+	std::vector<OSegment_<FPT>> getOSegs() const
+	{
+		return priv::p_getSegs( *this, OSegment_<FPT>() );
+	}
 
-	auto li0 = goodpt * pt_B.first;
-dbg.li0 = li0;
+/// Returns (as a copy) the segments of the polyline
+	std::vector<Segment_<FPT>> getSegs() const
+	{
+		return priv::p_getSegs( *this, Segment_<FPT>() );
+	}
 
-	auto li_L = li0.getOrthogLine( pt_L.first );
-	auto li_R = li0.getOrthogLine( pt_R.first );
-dbg.li_L = li_L;
-dbg.li_R = li_R;
+/// Returns a view on the oriented segments of the polyline (no allocation)
+/// \sa priv::SegView
+	priv::SegView<OSegment_<FPT>,FPT> getOSegsView() const
+	{
+		return priv::SegView<OSegment_<FPT>,FPT>( _plinevec, isClosed() );
+	}
 
-	auto pt_resL = li_L * li0;
-	auto pt_resR = li_R * li0;
-dbg.pt_resL = pt_resL;
-dbg.pt_resR = pt_resR;
-	auto s_Top = li_L.getOrthogSegment( pt_T.first );
-	auto li_Top = s_Top.getLine();
+/// Returns a view on the segments of the polyline (no allocation)
+/// \sa priv::SegView
+	priv::SegView<Segment_<FPT>,FPT> getSegsView() const
+	{
+		return priv::SegView<Segment_<FPT>,FPT>( _plinevec, isClosed() );
+	}
 
-	auto pt_res3 = li_L * li_Top;
-	auto pt_res4 = li_R * li_Top;
+/// Returns one point of the polyline.
+	Point2d_<FPT> getPoint( size_t idx ) const
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( idx >= size() )
+			HOMOG2D_THROW_ERROR_1( "requesting point " << idx
+				<< ", only has "  << size()
+			);
+#endif
+		return _plinevec[idx];
+	}
 
-	std::vector<Point2d_<double>> vout;
-	vout.push_back( pt_resL );
-	vout.push_back( pt_res3 );
-	vout.push_back( pt_res4 );
-	vout.push_back( pt_resR );
+private:
+/// Private helper function
+	template<typename ST>
+	ST impl_getSegment( size_t idx, const ST& ) const
+	{
+	#ifndef HOMOG2D_NOCHECKS
+		if( idx >= nbSegs() )
+			HOMOG2D_THROW_ERROR_1( "requesting segment " << idx
+				<< ", only has "  << nbSegs()
+			);
 
-	return std::make_pair(
-		PolylineBase<typ::IsClosed,typename CONT::value_type::FType>( vout ),
-		dbg
-	);
-}
+		if( size() < 2 )
+			HOMOG2D_THROW_ERROR_1( "empty, no segment " << idx );
+	#endif
+	if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+		return ST( _plinevec[idx], _plinevec[idx+1==nbSegs()?0:idx+1] );
+	else
+		return ST( _plinevec[idx], _plinevec[idx+1] );
+	}
 
-template<typename T1,typename T2,typename T3,typename T4>
-PolylineBase<typ::IsClosed,T1>
-buildSquare(
-	const Point2d_<T1>& p1,
-	const Point2d_<T2>& p2,
-	const Point2d_<T3>& p3,
-	const Point2d_<T4>& p4
-)
-{
-	std::vector<Point2d_<HOMOG2D_INUMTYPE>> v(4);
-	v[0] = p1;
-	v[1] = p2;
-	v[2] = p3;
-	v[3] = p4;
-	return buildSquare( v );
-}
-#endif // HOMOG2D_PRELIMINAR
-//------------------------------------------------------------------
-/// Rotates the polyline by either 90°, 180°, 270° (-90°) at point \c refpt
-/**
-For an arbitrary angle \c alpha (rad.), you can write:
-```
-auto poly2 = Homogr(alpha) * poly;
-```
-\sa PolylineBase<PLT,FPT>::rotate( Rotate )
-*/
-template<typename PLT,typename FPT>
-template<typename FPT2>
-void
-PolylineBase<PLT,FPT>::rotate( Rotate rot, const Point2d_<FPT2>& refpt )
-{
-	translate( -refpt.getX(), -refpt.getY() );
-	this->rotate( rot );
-	translate( refpt.getX(), refpt.getY() );
-}
+public:
+/// Returns one oriented segment of the polyline.
+	OSegment_<FPT> getOSegment( size_t idx ) const
+	{
+		return impl_getSegment( idx, OSegment_<FPT>() );
+	}
 
-//------------------------------------------------------------------
-/// Rotates the polyline by either 90°, 180°, 270° (-90°) at point (0,0)
+/// Returns one segment of the polyline.
 /**
-For an arbitrary angle \c alpha (rad.), you can write:
-```
-auto poly2 = Homogr(alpha) * poly;
-```
-\sa PolylineBase<PLT,FPT>::rotate( Rotate, const Point2d_<FPT2>& )
+Segment \c n is the one between point \c n and point \c n+1
 */
-template<typename PLT,typename FPT>
-void
-PolylineBase<PLT,FPT>::rotate( Rotate rot )
-{
-	switch( rot )
+	Segment_<FPT> getSegment( size_t idx ) const
 	{
-		case Rotate::CCW:
-			for( auto& pt: getPts() )
-				pt.set( -pt.getY(), +pt.getX() );
-		break;
-		case Rotate::CW:
-			for( auto& pt: getPts() )
-				pt.set( +pt.getY(), -pt.getX() );
-		break;
-		case Rotate::Full:
-			for( auto& pt: getPts() )
-				pt.set( -pt.getX(), -pt.getY() );
-		break;
-		case Rotate::VMirror:
-			for( auto& pt: getPts() )
-				pt.set( -pt.getX(), pt.getY() );
-		break;
-		case Rotate::HMirror:
-			for( auto& pt: getPts() )
-				pt.set( pt.getX(), -pt.getY() );
-		break;
-
-		default: assert(0);
+		return impl_getSegment( idx, Segment_<FPT>() );
 	}
-}
-
-//------------------------------------------------------------------
-/// Private member function, called by PolylineBase::impl_minimizePL()
-template<typename PLT,typename FPT>
-void
-PolylineBase<PLT,FPT>::p_minimizePL( PolylineBase<PLT,FPT>& pl, size_t istart, size_t iend )
-{
-	auto nbpts = pl.size();
-// step 1: check each point to see if it is the middle point of two segments with same angle
-	std::vector<size_t> ptset;
-	for( size_t i=istart; i<iend; i++ )
-	{
-		const auto& p0 = pl._plinevec.at(i);
-		const auto& pnext = getPoint( i==nbpts-1 ? 0 : i+1 );
-		const auto& pprev = getPoint( i==0 ? nbpts-1 : i-1 );
 
-		auto vx1 = pnext.getX() - p0.getX();
-		auto vy1 = pnext.getY() - p0.getY();
-		auto vx2 = p0.getX() - pprev.getX();
-		auto vy2 = p0.getY() - pprev.getY();
-		auto a1 = std::atan2( vx1, vy1 );
-		auto a2 = std::atan2( vx2, vy2 );
+	CPolyline_<FPT> convexHull() const;
+	std::vector<std::array<size_t,3>> triangulate() const;
 
-		if( homog2d_abs(a1-a2) < thr::nullAngleValue() )
-			ptset.push_back( i );
+/// Clips the polyline against a rectangle. Returns a CPolyline_ for closed polylines,
+/// and a vector of OPolyline_ for open polylines (see impl_clip())
+	template<typename FPT2>
+	auto clip( const FRect_<FPT2>& rect ) const
+	{
+		return impl_clip( rect, detail::PlHelper<PLT>() );
 	}
+///@}
 
-	if( ptset.size() == 0 ) // if no same angle segment (=no "middle point")
-		return;             // then no change
+public:
+/// \name Modifiers (non-const member functions)
+///@{
 
-// step 2: build new Polyline without those points
-	PolylineBase<PLT,FPT> out;
-	size_t vec_idx = 0;
-	for( size_t i=0; i<nbpts; i++ )
+/// Clear all (does not change the "open/close" status).
+	void clear()
 	{
-//		HOMOG2D_LOG("ptset.size()=" << ptset.size() << " vec_idx=" << vec_idx );
-
-		if( vec_idx<ptset.size() ) // if there is more points to remove
-		{
-			if( ptset.at(vec_idx) != i )               // if regular point, add it
-				out.p_addPoint( pl._plinevec.at(i) );  //  to the output set
-			else                                       // else, we found a "middle point"
-				vec_idx++;                             // and switch to next one
-		}
-		else                                        // no more points to remove
-			out.p_addPoint( pl._plinevec.at(i) );   // so just add the point to the output set
+		_plinevec.clear();
+		_plIsNormalized=false;
+		_attribs.setBad();
 	}
-	std::swap( out, pl ); // maybe we can "move" instead?
-}
-
-template<typename PLT,typename FPT>
-void
-PolylineBase<PLT,FPT>::impl_minimizePL( const detail::PlHelper<typename typ::IsOpen>& )
-{
-	assert( size() > 2 );
-	p_minimizePL( *this, 1, size()-1 );
-}
 
-template<typename PLT,typename FPT>
-void
-PolylineBase<PLT,FPT>::impl_minimizePL( const detail::PlHelper<typename typ::IsClosed>& )
-{
-	p_minimizePL( *this, 0, size() );
-}
+	template<typename FPT2>
+	void rotate( Rotate, const Point2d_<FPT2>& );
+	void rotate( Rotate );
 
+/// Miminize the PolylineBase: remove all points that lie in the middle of two segments with same angle.
+/**
+For example, if we have the following points ("Open" polyline):
+(0,0)-(1,0)-(2,0)<br>
+This will be replaced by: (0,0)--(2,0)
 
-//------------------------------------------------------------------
-/// Returns true if object is a polygon (closed, and no segment crossing)
-template<typename PLT,typename FPT>
-bool
-PolylineBase<PLT,FPT>::isSimple() const
-{
-	if( size()<3 )       // needs at least 3 points to be a polygon
-		return false;
-	if constexpr( std::is_same_v<PLT,typ::IsOpen> ) // If open, then not a polygon
-		return false;
-	else                  // If closed, we need to check for crossings
-	{
-		if( _attribs._isSimplePolyg.isBad() )
-		{
-			auto nbs = nbSegs();
-			size_t i=0;
-			bool notDone = true;
-			bool hasIntersections = false;
-			do
-			{
-				auto seg1 = getSegment(i);
-				auto lastone = i==0?nbs-1:nbs;
-				for( auto j=i+2; j<lastone; j++ )
-					if( getSegment(j).intersects(seg1)() )
-					{
-						notDone = false;
-						hasIntersections = true;
-						break;
-					}
-				i++;
-			}
-			while( i<nbs && notDone );
-			_attribs._isSimplePolyg.set( !hasIntersections );
-		}
-		return _attribs._isSimplePolyg.value();
-	}
-}
-//------------------------------------------------------------------
-/// Returns true if polygon is convex
-/**
-This implies that:
- - the Polyline is a Polygon
- - cross product of consecutive points have same sign
- (see https://stackoverflow.com/a/1881201/193789 )
-
-\todo 20221120: as points are homogeneous, the cross product can probably be computed
-in a different way (quicker? simpler?).
-Need to check this.
+\note We cannot use the Segment_::getAngle() function because it returns a
+value in [0,PI/2], so we would'nt be able to detect a segment going
+at 180° of the previous one.
 
-\todo 20250127: use crossProduct free function with base::SegVec args
+\sa simplify()
+\sa simplifyToCount()
+\todo 20230217: use the areCollinear() function
 */
-template<typename PLT,typename FPT>
-bool
-PolylineBase<PLT,FPT>::isConvex() const
-{
-	if( !isSimple() )
-		return false;
-
-	int8_t sign = 0;
-	const auto& vpts = getPts();
-	if( vpts.size() == 3 )   // 3 pts => always convex
-		return true;
-
-	for( size_t i=0; i<vpts.size(); i++ )
+	void
+	minimize()
 	{
-		const auto& pt0 = vpts[ i==0?vpts.size()-1:i-1 ];
-		const auto& pt1 = vpts[ i ];
-		const auto& pt2 = vpts[ i==vpts.size()-1?0:i+1 ];
-		auto dx1 = pt1.getX() - pt0.getX();
-		auto dy1 = pt1.getY() - pt0.getY();
+		if( size()<3 )
+			return;
+		impl_minimizePL( detail::PlHelper<PLT>() );
+	}
 
-		auto dx2 = pt2.getX() - pt1.getX();
-		auto dy2 = pt2.getY() - pt1.getY();
+	template<typename T>
+	void simplify( T epsilon, bool keepSimple=false );
+	void simplifyToCount( size_t nbPts, bool keepSimple=false );
+	template<typename T>
+	void resample( T step );
+	void resampleToCount( size_t nbPts );
 
-		auto crossproduct = dx1*dy2 - dy1*dx2;
-		if( sign == 0 )                          // initial sign value
-			sign = (crossproduct>0 ? +1 : -1);
-		else
-			if (sign != (crossproduct>0 ? +1 : -1) )
-				return false;
+/// Translate Polyline using \c dx, \c dy
+	template<typename TX,typename TY>
+	void translate( TX dx, TY dy )
+	{
+		HOMOG2D_CHECK_IS_NUMBER( TX );
+		HOMOG2D_CHECK_IS_NUMBER( TY );
+		for( auto& pt: _plinevec )
+			pt.translate( dx, dy );
+		_attribs.applyIsometry(
+			[dx,dy]           // lambda
+			( const Point2d_<HOMOG2D_INUMTYPE>& pt )
+			{
+				return Point2d_<HOMOG2D_INUMTYPE>( pt.getX() + dx, pt.getY() + dy );
+			},
+			false
+		);
 	}
-	return true;
-}
 
-//------------------------------------------------------------------
-/// Returns length of Polyline
-template<typename PLT,typename FPT>
-HOMOG2D_INUMTYPE
-PolylineBase<PLT,FPT>::length() const
-{
-	if( _attribs._length.isBad() )
+/// Translate Polyline, using a pair of numerical values
+	template<typename T1, typename T2>
+	void translate( const std::pair<T1,T2>& ppt )
 	{
-		HOMOG2D_INUMTYPE sum = 0.;
-		for( const auto& seg: getSegs() )
-			sum += static_cast<HOMOG2D_INUMTYPE>( seg.length() );
-		_attribs._length.set( sum );
+		translate( ppt.first, ppt.second );
 	}
-	return _attribs._length.value();
-}
-
-//------------------------------------------------------------------
-/// Returns area of polygon (computed only if necessary)
-template<typename PLT,typename FPT>
-HOMOG2D_INUMTYPE
-PolylineBase<PLT,FPT>::area() const
-{
-	if( !isSimple() )  // implies that is both closed and has no intersections
-		return 0.;
-
-	if( _attribs._area.isBad() )
-		_attribs._area.set( homog2d_abs( p_ComputeSignedArea() ) );
-	return _attribs._area.value();
-}
 
-//------------------------------------------------------------------
-/// Compute and returns signed area (used in area() and in centroid() )
-template<typename PLT,typename FPT>
-HOMOG2D_INUMTYPE
-PolylineBase<PLT,FPT>::p_ComputeSignedArea() const
-{
-	HOMOG2D_INUMTYPE area = 0.;
-	for( size_t i=0; i<size(); i++ )
+/// Move Polyline to new origin
+	template<typename TX,typename TY>
+	void moveTo( TX x, TY y )
 	{
-		auto j = (i == size()-1 ? 0 : i+1);
-		auto pt1 = _plinevec[i];
-		auto pt2 = _plinevec[j];
-		area += static_cast<HOMOG2D_INUMTYPE>(pt1.getX()) * pt2.getY();
-		area -= static_cast<HOMOG2D_INUMTYPE>(pt1.getY()) * pt2.getX();
+		HOMOG2D_CHECK_IS_NUMBER( TX );
+		HOMOG2D_CHECK_IS_NUMBER( TY );
+		moveTo( Point2d_<FPT>(x,y) );
 	}
-	return area / 2.;
-}
 
-//------------------------------------------------------------------
-/// Compute centroid of polygon
+/// Move Polyline to new origin, given by \c new_org
 /**
-ref: https://en.wikipedia.org/wiki/Centroid#Of_a_polygon
-
-\warning: centroid CAN be outside of polygon!
+\warning The polygon origin is NOT its center but the point No 0!
 */
-template<typename PLT,typename FPT>
-Point2d_<HOMOG2D_INUMTYPE>
-base::PolylineBase<PLT,FPT>::centroid() const
-{
-	if( !isSimple() )
-		HOMOG2D_THROW_ERROR_1( "unable, Polyline object is not simple" );
-
-	if( _attribs._centroid.isBad() )
+	template<typename T1>
+	void moveTo( const Point2d_<T1>& new_org )
 	{
-		HOMOG2D_INUMTYPE cx = 0.;
-		HOMOG2D_INUMTYPE cy = 0.;
-		for( size_t i=0; i<size(); i++ )
-		{
-			auto j = (i == size()-1 ? 0 : i+1);
-			const auto& pt1 = _plinevec[i];
-			const auto& pt2 = _plinevec[j];
-			auto x1 = pt1.getX();
-			auto x2 = pt2.getX();
-			auto y1 = pt1.getY();
-			auto y2 = pt2.getY();
-
-			auto prod = x1*y2 - x2*y1;
-			cx += (x1+x2) * prod;
-			cy += (y1+y2) * prod;
-		}
-		auto signedArea = p_ComputeSignedArea();
-		cx /= (6. * signedArea);
-		cy /= (6. * signedArea);
-
-		auto c = Point2d_<HOMOG2D_INUMTYPE>( cx, cy );
-		_attribs._centroid.set( c );
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, Polyline is empty" );
+		auto dx = new_org.getX() - getPoint(0).getX();
+		auto dy = new_org.getY() - getPoint(0).getY();
+		translate( dx, dy );
 	}
-	return _attribs._centroid.value();
-}
 
-//------------------------------------------------------------------
-/// Normalization of CPolyline_
+/// Scale Polyline by \c k (relatively to the origin)
 /**
-Two tasks:
-- rotating so that the smallest one is first
-- for closed polylines: constant orientation
-
-\note: is \c const, although it moves the points, but all the attributes are the same
-(done by declaring the vector of points as \c mutable).
-
-Reference for the orientation:
-- http://www.faqs.org/faqs/graphics/algorithms-faq/
-Subject 2.07: How do I find the orientation of a simple polygon?
-- https://en.wikipedia.org/wiki/Curve_orientation#Orientation_of_a_simple_polygon
+Length and area are updated analytically, without being recomputed.
 */
-template<typename PLT,typename FPT>
-void
-base::PolylineBase<PLT,FPT>::p_normalizePoly() const
-{
-	if( size() == 0 )
-		return;
-
-	if( !_plIsNormalized )
+	template<typename T>
+	void scale( T k )
 	{
-		if constexpr ( std::is_same_v<PLT,typ::IsClosed> )
-		{
-			auto minpos = std::min_element( _plinevec.begin(), _plinevec.end() );
-			std::rotate( _plinevec.begin(), minpos, _plinevec.end() );
-
-			auto ptB = _plinevec[0];
-			auto ptA = _plinevec[1];
-			auto ptC = _plinevec[size()-1];
-
-			HOMOG2D_INUMTYPE xA = ptA.getX();
-			HOMOG2D_INUMTYPE xB = ptB.getX();
-			HOMOG2D_INUMTYPE xC = ptC.getX();
-			HOMOG2D_INUMTYPE yA = ptA.getY();
-			HOMOG2D_INUMTYPE yB = ptB.getY();
-			HOMOG2D_INUMTYPE yC = ptC.getY();
-
-			auto det = (xB-xA)*(yC-yA) - (xC-xA)*(yB-yA);
-			if( det < 0)
-			{
-				std::reverse( _plinevec.begin(), _plinevec.end() );
-				minpos = std::min_element( _plinevec.begin(), _plinevec.end() );
-				std::rotate( _plinevec.begin(), minpos, _plinevec.end() );
-			}
-		}
-		else
-		{
-			if( _plinevec.back() < _plinevec.front() )
-				std::reverse( _plinevec.begin(), _plinevec.end() );
-		}
-		_plIsNormalized=true;
+		HOMOG2D_CHECK_IS_NUMBER( T );
+		scale( k, k );
 	}
-}
-
-} // namespace base
 
-//------------------------------------------------------------------
-/// Rotates the rectangle by either 90°, 180°, 270° (-90°) at point \c refpt
+/// Scale Polyline by \c kx, \c ky (relatively to the origin)
 /**
-For an arbitrary angle \c alpha (rad.), you can write:
-```
-auto r2 = Homogr(alpha) * rect;
-```
-\sa FRect_<FPT>::rotate( Rotate )
-\sa h2d::rotate()
+Area is updated analytically, and also length if \c kx and \c ky are equal (in absolute value).
 */
-template<typename FPT>
-template<typename FPT2>
-void
-FRect_<FPT>::rotate( Rotate rot, const Point2d_<FPT2>& refpt )
-{
-	translate( -refpt.getX(), -refpt.getY() );
-	this->rotate( rot );
-	translate( refpt.getX(), refpt.getY() );
-}
+	template<typename TX,typename TY>
+	void scale( TX kx, TY ky )
+	{
+		HOMOG2D_CHECK_IS_NUMBER( TX );
+		HOMOG2D_CHECK_IS_NUMBER( TY );
+#ifndef HOMOG2D_NOCHECKS
+		if( homog2d_abs(kx) < thr::nullDenom() || homog2d_abs(ky) < thr::nullDenom() )
+			HOMOG2D_THROW_ERROR_1( "Invalid scale factor, kx=" << kx << " ky=" << ky );
+#endif
+		for( auto& pt: _plinevec )
+			pt.set( pt.getX() * kx, pt.getY() * ky );
+		if( kx * ky < 0 )                 // mirroring changes
+			_plIsNormalized = false;      // the orientation
+		_attribs.applyScale( kx, ky );
+	}
 
-//------------------------------------------------------------------
-/// Rotates the rectangle by either 90°, 180°, 270° (-90°) at point (0,0)
+/// Replace point \c idx by \c pt
 /**
-For an arbitrary angle \c alpha (rad.), you can write:
-```
+Length, area and bounding box are updated in O(1) time (the bounding box needs to be recomputed
+if the replaced point was on its border).
+If the polygon was known to be simple, this is checked again on the two new segments only, in O(n) time,
+so that area() (that needs it) does not have to run the full check again.
+\warning The index refers to the current order of the points, that may change if the
+polyline has been normalized (see PolylineBase::getPoint() ).
+*/
+	template<typename FPT2>
+	void replacePoint( size_t idx, const Point2d_<FPT2>& pt )
+	{
+		const auto n = size();
+#ifndef HOMOG2D_NOCHECKS
+		if( idx >= n )
+			HOMOG2D_THROW_ERROR_1( "invalid index value: idx=" << idx << ", size=" << n );
+#endif
+		auto prev = ( idx==0   ? n-1 : idx-1 );
+		auto next = ( idx==n-1 ? 0   : idx+1 );
+		const auto& pPrev = _plinevec[prev];
+		const auto& pNext = _plinevec[next];
+		Point2d_<FPT> newPt( pt );
+#ifndef HOMOG2D_NOCHECKS
+		if( newPt == pPrev || newPt == pNext )
+			HOMOG2D_THROW_ERROR_1( "cannot replace point " << idx
+				<< " with a point identical to a neighbour one: pt=" << pt );
+#endif
+		const auto oldPt = _plinevec[idx];
+		HOMOG2D_INUMTYPE da = priv::shoelaceTerm( pPrev, newPt ) + priv::shoelaceTerm( newPt, pNext )
+			- priv::shoelaceTerm( pPrev, oldPt ) - priv::shoelaceTerm( oldPt, pNext );
+		HOMOG2D_INUMTYPE dl = 0.;
+		if( isClosed() || idx != 0 )
+			dl += pPrev.distTo( newPt ) - pPrev.distTo( oldPt );
+		if( isClosed() || idx != n-1 )
+			dl += newPt.distTo( pNext ) - oldPt.distTo( pNext );
+
+		const bool wasSimple = ( isClosed() && !_attribs._isSimplePolyg.isBad() && _attribs._isSimplePolyg.value() );
+		_plinevec[idx] = newPt;
+		_plIsNormalized = false;
+		_attribs.applyPointChange( dl, da, newPt, &oldPt, false );
+		if( wasSimple )      // other segments are unchanged, so only the two new ones can cross something
+			_attribs._isSimplePolyg.set( !p_hasCrossingsAround( idx ) );
+	}
+
+/// Set from vector/array/list of points (discards previous points)
+/**
+- nb of elements must be 0 or 2 or more
+*/
+	template<
+		typename CONT,
+		typename std::enable_if<
+			trait::IsContainer<CONT>::value,
+			CONT
+		>::type* = nullptr
+	>
+	void set( const CONT& vec )
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( vec.size() == 1 )
+			HOMOG2D_THROW_ERROR_1( "Invalid: number of points must be 0, 2 or more" );
+		if( vec.size() > 1 )
+			p_checkInputData( vec );
+#endif
+		_attribs.setBad();
+		_plIsNormalized=false;
+		_plinevec.resize( vec.size() );
+		auto it = std::begin( _plinevec );
+		for( const auto& pt: vec )   // copying one by one will allow
+			*it++ = pt;              //  type conversions (std::copy implies same FP type)
+	}
+
+	template<typename FPT1,typename FPT2,typename FPT3>
+	void setParallelogram(
+		const Point2d_<FPT1>& pt1,
+		const Point2d_<FPT2>& pt2,
+		const Point2d_<FPT3>& pt3
+	);
+
+/// Set from FRect
+	template<typename FPT2>
+	void set( const FRect_<FPT2>& rect )
+	{
+		static_assert( std::is_same_v<PLT,typ::IsClosed>, "Invalid: cannot set a OPolyline from a FRect" );
+
+		CPolyline_<FPT> tmp(rect);
+		std::swap( *this, tmp );
+	}
+
+/// Build RCP (Regular Convex Polygon), and return distance between consecutive points
+	template<typename FPT2,typename T>
+	std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
+	set( FPT2 rad, T n );
+
+///@}
+
+private:
+/// Checks that no contiguous identical points are stored
+	template<typename CONT>
+	void p_checkInputData( const CONT& pts )
+	{
+		for( auto it=pts.begin(); it!=std::prev(pts.end()); it++ )
+		{
+			const auto& elem = *it;
+			const auto& next = *std::next(it);
+			if( elem == next )
+				HOMOG2D_THROW_ERROR_1(
+					"cannot add two consecutive identical points:\npt:"
+					<< elem << " and pt:" << next
+					<< " in set of size " << pts.size()
+				);
+		}
+		if( pts.front() == pts.back() )
+			HOMOG2D_THROW_ERROR_1(
+				"cannot add first point equal to last point:\npt:"
+				<< pts.front()
+				<< " in set of size " << pts.size()
+			);
+	}
+
+	bool p_hasNoCrossings() const;
+	void p_keepPoints( const std::vector<bool>& );
+	template<typename FPT2>
+	PolylineBase<typ::IsClosed,FPT>              impl_clip( const FRect_<FPT2>&, const detail::PlHelper<typ::IsClosed>& ) const;
+	template<typename FPT2>
+	std::vector<PolylineBase<typ::IsOpen,FPT>>   impl_clip( const FRect_<FPT2>&, const detail::PlHelper<typ::IsOpen>& ) const;
+	void impl_minimizePL( const detail::PlHelper<typ::IsOpen>& );
+	void impl_minimizePL( const detail::PlHelper<typ::IsClosed>& );
+	void p_minimizePL( PolylineBase<PLT,FPT>&, size_t istart, size_t iend );
+
+public:
+/// \name Operators
+///@{
+	template<typename PLT2,typename FPT2>
+	bool operator == ( const PolylineBase<PLT2,FPT2>& other ) const
+	{
+		if constexpr( std::is_same_v<PLT,PLT2> )
+		{
+			if( size() != other.size() )          // for quick exit
+				return false;
+
+			p_normalizePoly();
+			other.p_normalizePoly();
+
+			auto it = other._plinevec.begin();
+			for( const auto& elem: _plinevec )
+				if( *it++ != elem )
+					return false;
+			return true;
+		}
+		else
+			return false;
+	}
+
+	template<typename PLT2,typename FPT2>
+	bool operator != ( const PolylineBase<PLT2,FPT2>& other ) const
+	{
+		return !( *this == other );
+	}
+///@}
+
+/// Polyline intersection with Line, Segment, FRect, Circle, Polyline
+/**
+Candidate segments are selected using a hierarchy of bounding boxes (see priv::SegBVH),
+that is built on first call and kept until the polyline is modified.
+
+With a line, if the polygon is already known to be convex (see isConvex() ), this is done in O(log n),
+unless the line goes through a vertex.
+*/
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsShape<T>::value,
+			T
+		>::type* = nullptr
+	>
+	detail::IntersectM<FPT> intersects( const T& other ) const
+	{
+		detail::IntersectM<FPT> out;
+		if( nbSegs() == 0 )
+			return out;
+
+		if constexpr( std::is_same_v<T,Line2d_<typename T::FType>> )
+			if( const auto* convex = p_getConvexIndex() )
+			{
+				bool onVertex = false;
+				auto res = convex->template intersects<FPT>( other, onVertex );
+				if( !onVertex )          // else, same results as below (a vertex is found on both its segments)
+					return res;
+			}
+
+		const auto segs = getSegsView();
+		auto testSeg = [&]        // lambda
+			( size_t idx )
+			{
+				auto inters = segs[idx].intersects( other );
+				if( inters() )
+					out.add( inters.get() );
+			};
+
+		const auto& bvh = p_getBVH();
+		if constexpr( std::is_same_v<T,Line2d_<typename T::FType>> )
+			bvh.query( other, testSeg );
+		else if constexpr( trait::IsPolyline<T>::value )
+		{
+			if( other.nbSegs() == 0 )
+				return out;
+			const auto& qbox = other.p_getBVH().getRootBox();   // each candidate segment
+			bvh.query( qbox, bvh.margin( qbox.size() ), testSeg ); // will then use the hierarchy of 'other'
+		}
+		else
+		{
+			auto qbox = priv::getBVHBox( other );
+			bvh.query( qbox, bvh.margin( qbox.size() ), testSeg );
+		}
+		return out;
+	}
+
+/// Polyline isInside other primitive
+/**
+Sfinae should resolve for T=Circle,FRect,Ellipse but not for CPolyline
+*/
+	template<
+		typename T,
+		typename std::enable_if<
+				(
+					trait::HasArea<T>::value
+					&&
+					!trait::PolIsClosed<T>::value
+				)
+				,T
+		>::type* = nullptr
+	>
+	bool
+	isInside( const T& prim ) const
+	{
+		HOMOG2D_START;
+		if( size() == 0 )
+			return false;
+		for( const auto& pt: getPts() )
+			if( !pt.isInside( prim ) )
+				return false;
+		return true;
+	}
+
+/// Polyline isInside other CPolyline
+/**
+Sfinae should resolve ONLY for CPolyline
+*/
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::PolIsClosed<T>::value,T
+		>::type* = nullptr
+	>
+	bool
+	isInside( const T& cpol ) const
+	{
+		HOMOG2D_START;
+		if( size() == 0 )
+			return false;
+		for( const auto& pt: getPts() )
+			if( !pt.isInside( cpol ) )
+				return false;
+		if( intersects(cpol)() )
+			return false;
+		return true;
+	}
+
+/// Distance between point \c pt and the polyline: 0 if it is a polygon and the point is inside, distance to closest segment otherwise
+/**
+O(log n) if the polygon is already known to be convex (see isConvex() ), O(n) otherwise.
+*/
+	template<typename FPT2>
+	HOMOG2D_INUMTYPE distTo( const Point2d_<FPT2>& pt ) const
+	{
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, Polyline is empty" );
+		const HOMOG2D_INUMTYPE px = pt.getX();
+		const HOMOG2D_INUMTYPE py = pt.getY();
+		if( const auto* convex = p_getConvexIndex() )
+			return convex->distTo( px, py );
+		if( isClosed() && pt.isInside( *this ) )
+			return 0.;
+
+		auto dmin = priv::sqDistPtSeg( px, py, _plinevec[0].getX(), _plinevec[0].getY(), _plinevec[0].getX(), _plinevec[0].getY() );
+		for( size_t i=0; i<nbSegs(); i++ )
+		{
+			const auto& p1 = _plinevec[i];
+			const auto& p2 = _plinevec[ i+1==size() ? 0 : i+1 ];
+			dmin = std::min( dmin, priv::sqDistPtSeg( px, py, p1.getX(), p1.getY(), p2.getX(), p2.getY() ) );
+		}
+		return homog2d_sqrt( dmin );
+	}
+
+	template<typename T1,typename T2>
+	friend std::ostream&
+	h2d::base::operator << ( std::ostream&, const h2d::base::PolylineBase<T1,T2>& );
+
+#ifdef HOMOG2D_TEST_MODE
+/// this is only needed for testing
+	bool isNormalized() const { return _plIsNormalized; }
+
+/// Reference (brute force) implementation of isSimple(), only needed for testing
+	bool isSimpleBruteForce() const
+	{
+		if( size()<3 || !isClosed() )
+			return false;
+		return !p_hasCrossingsBruteForce();
+	}
+#endif
+
+private:
+	void p_normalizePoly() const;
+	bool p_hasCrossingsBruteForce() const;
+	bool p_hasCrossingsAround( size_t ) const;
+	bool p_isConvex() const;
+
+/// Returns the index used for the O(log n) queries if the polygon is already known to be convex, nullptr otherwise
+/**
+Convexity is not checked here (that would cost more than the queries), see isConvex().
+*/
+	const priv::ConvexIndex* p_getConvexIndex() const
+	{
+		if( _attribs._isConvex.isBad() || !_attribs._isConvex.value() )
+			return nullptr;
+		if( !_attribs._convex.isBuilt() )
+			_attribs._convex.build( _plinevec );
+		if( _attribs._convex.size() == 0 )       // degenerate
+			return nullptr;
+		return &_attribs._convex;
+	}
+
+/// Returns the segment hierarchy, builds it if needed
+	const priv::SegBVH& p_getBVH() const
+	{
+		if( !_attribs._bvh.isValid() )
+			_attribs._bvh.build( _plinevec, isClosed() );
+		return _attribs._bvh;
+	}
+
+public:
+	template<typename T>
+	PolylineBase<typ::IsClosed,FPT>
+	getOffsetPoly( T value, OffsetPolyParams p=OffsetPolyParams{} ) const;
+
+	std::vector<Line2d_<HOMOG2D_INUMTYPE>>
+	getBisectorLines() const
+	{
+		 return h2d::getBisectorLines( *this );
+	}
+
+	void draw( img::Image<img::SvgImage>&, img::DrawParams dp=img::DrawParams() ) const;
+#ifdef HOMOG2D_USE_OPENCV
+	void draw( img::Image<cv::Mat>&,       img::DrawParams dp=img::DrawParams() ) const;
+#endif
+
+}; // class PolylineBase
+
+
+//------------------------------------------------------------------
+/// Build a parallelogram (4 points) from 3 points
+template<typename PLT,typename FPT>
+template<typename FPT1,typename FPT2,typename FPT3>
+void
+PolylineBase<PLT,FPT>::setParallelogram(
+	const Point2d_<FPT1>& p1,
+	const Point2d_<FPT2>& p2,
+	const Point2d_<FPT3>& p3
+)
+{
+	static_assert( std::is_same_v<PLT,typ::IsClosed>, "Invalid: cannot set a OPolyline as a parallelogram" );
+
+	Point2d_<HOMOG2D_INUMTYPE> pt1(p1);
+	Point2d_<HOMOG2D_INUMTYPE> pt2(p2);
+	Point2d_<HOMOG2D_INUMTYPE> pt3(p3);
+
+	std::vector<Point2d_<FPT>> vpts(4);
+	vpts[0] = pt1;
+	vpts[1] = pt2;
+	vpts[2] = pt3;
+
+	auto li_21 = pt1 * pt2;
+	auto li_23 = pt3 * pt2;
+	auto li_34 = li_21.getParallelLine( pt3 );
+	auto li_14 = li_23.getParallelLine( pt1 );
+	vpts[3] = li_34 * li_14;
+	set( vpts );
+}
+
+//------------------------------------------------------------------
+/// Build a Regular Convex Polygon of radius \c rad with \c n points, centered at (0,0)
+/**
+\return segment distance, inscribed circle radius
+*/
+template<typename PLT,typename FPT>
+template<typename FPT2,typename T>
+std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
+PolylineBase<PLT,FPT>::set(
+	FPT2 rad,   ///< Radius
+	T    ni     ///< Nb of points
+)
+{
+	static_assert(
+		std::is_integral<T>::value,
+		"2nd argument type must be integral type"
+	);
+	static_assert(
+		std::is_same_v<PLT,typ::IsClosed>,
+		"Cannot build a RCP as open polyline"
+	);
+
+	if( ni < 3 )
+		HOMOG2D_THROW_ERROR_1( "unable, nb of points must be > 2" );
+	if( rad <= 0  )
+		HOMOG2D_THROW_ERROR_1( "unable, radius must be > 0" );
+
+	size_t n(ni);
+	std::vector<Point2d_<HOMOG2D_INUMTYPE>> v_pts(n);
+	auto it = std::begin( v_pts );
+	auto angle0 = (HOMOG2D_INUMTYPE)2. * M_PI / n;
+
+	Point2d_<HOMOG2D_INUMTYPE> pt0( rad, 0. ); // initial point
+	HOMOG2D_INUMTYPE radius = 0.;
+
+	for( size_t i=0; i<n; i++ )
+	{
+		auto angle = angle0 * i;
+		auto x = homog2d_cos( angle );
+		auto y = homog2d_sin( angle );
+
+		if( i == 1 )    // compute radius of inscribed circle
+		{
+			auto pt1 = Point2d_<HOMOG2D_INUMTYPE>( x * rad, y * rad );
+			Segment_<HOMOG2D_INUMTYPE> seg( pt0, pt1 );
+			Line2d_<HOMOG2D_INUMTYPE> li( seg.getCenter() );     // line passing through (0,0) and middle point of segment
+			auto inters_pt = seg.intersects( li ) ;              // intersection point
+			assert( inters_pt() );
+			radius = Point2d_<HOMOG2D_INUMTYPE>(0,0).distTo( inters_pt.get() );
+		}
+
+		*it = Point2d_<HOMOG2D_INUMTYPE>( x * rad, y * rad );
+		it++;
+	}
+	*this = PolylineBase<PLT,FPT>( v_pts );
+
+	return std::make_pair(
+		getPoint(0).distTo( getPoint(1) ),
+		radius
+	);
+}
+
+} // namespace base
+
+
+// FREE FUNCTIONS
+// (need to be here because the 5 below are being called by some member functions
+// of class PolylineBase, that is implemented further below
+
+namespace priv {
+
+//------------------------------------------------------------------
+/// Return iterator on Bottom-most point of container holding points
+/**
+Used by getBmPoint()
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			trait::IsContainer<T>::value &&
+			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
+		), T
+	>::type* = nullptr
+>
+auto
+getBmPoint_helper( const T& t )
+{
+	using FPT = typename T::value_type::FType;
+#ifndef HOMOG2D_NOCHECKS
+	if( t.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+#endif
+
+	return std::min_element(
+		std::begin(t),
+		std::end(t),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			if( pt1.getY() < pt2.getY() )
+				return true;
+			if( pt1.getY() > pt2.getY() )
+				return false;
+			return( pt1.getX() < pt2.getX() );
+		}
+	);
+}
+
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Return Bottom-most point of container holding points
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			trait::IsContainer<T>::value &&
+			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
+		), T
+	>::type* = nullptr
+>
+auto
+getBmPoint( const T& t )
+{
+#ifndef HOMOG2D_NOCHECKS
+	if( t.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+#endif
+	auto it = priv::getBmPoint_helper( t );
+	return std::make_pair(
+		*it,
+		std::distance( std::begin(t), it )
+	);
+}
+
+//------------------------------------------------------------------
+/// Return Top-most point of container
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			trait::IsContainer<T>::value &&
+			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
+		), T
+	>::type* = nullptr
+>
+auto
+getTmPoint( const T& t )
+{
+	using FPT = typename T::value_type::FType;
+
+#ifndef HOMOG2D_NOCHECKS
+	if( t.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+#endif
+
+	auto it = std::min_element(
+		std::begin(t),
+		std::end(t),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			if( pt1.getY() > pt2.getY() )
+				return true;
+			if( pt1.getY() < pt2.getY() )
+				return false;
+			return( pt1.getX() < pt2.getX() );
+		}
+	);
+	return std::make_pair(
+		*it,
+		std::distance( std::begin(t), it )
+	);
+}
+
+//------------------------------------------------------------------
+/// Return Left-most point of container as a pair holding:
+/**
+- first: the point
+- second: the distance (index) from begin position
+
+\todo 20250222: CHANGE RETURN TYPE! => should return an iterator, not a pair
+(so this allows usage of any non-random access container)
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			trait::IsContainer<T>::value &&
+			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
+		), T
+	>::type* = nullptr
+>
+auto
+getLmPoint( const T& t )
+{
+	using FPT = typename T::value_type::FType;
+
+#ifndef HOMOG2D_NOCHECKS
+	if( t.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+#endif
+
+	auto it = std::min_element(
+		std::begin(t),
+		std::end(t),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			if( pt1.getX() < pt2.getX() )
+				return true;
+			if( pt1.getX() > pt2.getX() )
+				return false;
+			return( pt1.getY() < pt2.getY() );
+		}
+	);
+
+	return std::make_pair(
+		*it,
+		std::distance( std::begin(t), it )
+	);
+}
+
+//------------------------------------------------------------------
+/// Return Right-most point of container holding points
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			trait::IsContainer<T>::value &&
+			std::is_same<typename T::value_type,Point2d_<typename T::value_type::FType>>::value
+		), T
+	>::type* = nullptr
+>
+auto
+getRmPoint( const T& t )
+{
+	using FPT = typename T::value_type::FType;
+
+#ifndef HOMOG2D_NOCHECKS
+	if( t.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid call, container is empty" );
+#endif
+
+	auto it = std::min_element(
+		std::begin(t),
+		std::end(t),
+		[]                  // lambda
+		( const Point2d_<FPT>& pt1, const Point2d_<FPT>& pt2 )
+		{
+			if( pt1.getX() > pt2.getX() )
+				return true;
+			if( pt1.getX() < pt2.getX() )
+				return false;
+			return( pt1.getY() < pt2.getY() );
+		}
+	);
+
+	return std::make_pair(
+		*it,
+		std::distance( std::begin(t), it )
+	);
+}
+
+//------------------------------------------------------------------
+/// Return Bottom-most point of Polyline (free function)
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+getBmPoint( const base::PolylineBase<PLT,FPT>& poly )
+{
+	return getBmPoint( poly.getPts() ).first;
+}
+/// Return Top-most point of Polyline (free function)
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+getTmPoint( const base::PolylineBase<PLT,FPT>& poly )
+{
+	return getTmPoint( poly.getPts() ).first;
+}
+/// Return Left-most point of Polyline (free function)
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+getLmPoint( const base::PolylineBase<PLT,FPT>& poly )
+{
+	return getLmPoint( poly.getPts() ).first;
+}
+/// Return Right-most point of Polyline (free function)
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+getRmPoint( const base::PolylineBase<PLT,FPT>& poly )
+{
+	return getRmPoint( poly.getPts() ).first;
+}
+
+//------------------------------------------------------------------
+/// Get Top-most / Bottom-most / Left-most / Right-most point, depending on \c dir
+/// (free function)
+/**
+Type \c T can be either a Polyline (open or closed), or a container holding points, or a FRect_
+*/
+template<typename T>
+auto
+getExtremePoint( CardDir dir, const T& t )
+{
+	switch( dir )
+	{
+		case CardDir::Top:    return getTmPoint(t); break;
+		case CardDir::Bottom: return getBmPoint(t); break;
+		case CardDir::Left:   return getLmPoint(t); break;
+		case CardDir::Right:  return getRmPoint(t); break;
+		default: assert(0);
+	}
+}
+
+namespace base {
+
+//------------------------------------------------------------------
+/// Get Top-most / Bottom-most / Left-most / Right-most point
+/**
+O(1) if the polygon is already known to be convex (see isConvex() ), O(n) otherwise.
+*/
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::getExtremePoint( CardDir dir ) const
+{
+	if( const auto* convex = p_getConvexIndex() )      // O(1)
+		return _plinevec[ convex->srcIdx( convex->extremeIdx( dir ) ) ];
+	return h2d::getExtremePoint( dir, *this );
+}
+
+/// Return Bottom-most point of Polyline
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::getBmPoint() const
+{
+	return h2d::getBmPoint( *this );
+}
+
+/// Return Top-most point of Polyline
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::getTmPoint() const
+{
+	return h2d::getTmPoint( *this );
+}
+
+/// Return Left-most point of Polyline
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::getLmPoint() const
+{
+	return h2d::getLmPoint( *this );
+}
+
+/// Return Right-most point of Polyline
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::getRmPoint() const
+{
+	return h2d::getRmPoint( *this );
+}
+
+//------------------------------------------------------------------
+#ifdef HOMOG2D_PRELIMINAR
+/// TMP
+struct TMP_DebugSquare
+{
+	Line2d_<double> li0;
+	Line2d_<double> line_ortho;
+	Line2d_<double> li_L, li_R;
+
+	Segment_<double> s1;
+	Segment_<double> sL,sR;
+
+	double dist;
+	PointPair_<double>  ppts;
+	Point2d_<double> pt_resL, pt_resR;
+};
+
+template<typename CONT>
+auto
+buildSquare( const CONT& pts )
+{
+	TMP_DebugSquare dbg;
+
+	if( pts.size() != 4 )
+		HOMOG2D_THROW_ERROR_1( "Error, size must be = 4, current size=" << pts.size() );
+
+	if( areCollinear( pts[0], pts[1], pts[2] ) )
+		HOMOG2D_THROW_ERROR_1( "Unable, points 012 are colinear" );
+	if( areCollinear( pts[1], pts[2], pts[3] ) )
+		HOMOG2D_THROW_ERROR_1( "Unable, points 123 are colinear" );
+	if( areCollinear( pts[1], pts[0], pts[3] ) )
+		HOMOG2D_THROW_ERROR_1( "Unable, points 013 are colinear" );
+	if( areCollinear( pts[0], pts[2], pts[3] ) )
+		HOMOG2D_THROW_ERROR_1( "Unable, points 023 are colinear" );
+
+	auto pt_L = getLmPoint( pts );
+	auto pt_R = getRmPoint( pts );
+	auto pt_T = getTmPoint( pts );
+	auto pt_B = getBmPoint( pts );
+	Segment_<HOMOG2D_INUMTYPE> s1( pt_L.first, pt_R.first );
+dbg.s1 = s1;
+	auto dist = s1.length();
+dbg.dist = dist;
+
+	auto line_ortho = s1.getLine().getOrthogLine( pt_T.first );
+dbg.line_ortho = line_ortho;
+
+	auto ppts = line_ortho.getPoints( pt_T.first, dist );
+dbg.ppts = ppts;
+	auto d1 = ppts.first.distTo( pt_L.first );
+	auto d2 = ppts.second.distTo( pt_L.first );
+
+	auto goodpt = ppts.first;
+	if( d2 < d1 )
+		goodpt = ppts.second;
+
+	auto li0 = goodpt * pt_B.first;
+dbg.li0 = li0;
+
+	auto li_L = li0.getOrthogLine( pt_L.first );
+	auto li_R = li0.getOrthogLine( pt_R.first );
+dbg.li_L = li_L;
+dbg.li_R = li_R;
+
+	auto pt_resL = li_L * li0;
+	auto pt_resR = li_R * li0;
+dbg.pt_resL = pt_resL;
+dbg.pt_resR = pt_resR;
+	auto s_Top = li_L.getOrthogSegment( pt_T.first );
+	auto li_Top = s_Top.getLine();
+
+	auto pt_res3 = li_L * li_Top;
+	auto pt_res4 = li_R * li_Top;
+
+	std::vector<Point2d_<double>> vout;
+	vout.push_back( pt_resL );
+	vout.push_back( pt_res3 );
+	vout.push_back( pt_res4 );
+	vout.push_back( pt_resR );
+
+	return std::make_pair(
+		PolylineBase<typ::IsClosed,typename CONT::value_type::FType>( vout ),
+		dbg
+	);
+}
+
+template<typename T1,typename T2,typename T3,typename T4>
+PolylineBase<typ::IsClosed,T1>
+buildSquare(
+	const Point2d_<T1>& p1,
+	const Point2d_<T2>& p2,
+	const Point2d_<T3>& p3,
+	const Point2d_<T4>& p4
+)
+{
+	std::vector<Point2d_<HOMOG2D_INUMTYPE>> v(4);
+	v[0] = p1;
+	v[1] = p2;
+	v[2] = p3;
+	v[3] = p4;
+	return buildSquare( v );
+}
+#endif // HOMOG2D_PRELIMINAR
+//------------------------------------------------------------------
+/// Rotates the polyline by either 90°, 180°, 270° (-90°) at point \c refpt
+/**
+For an arbitrary angle \c alpha (rad.), you can write:
+```
+auto poly2 = Homogr(alpha) * poly;
+```
+\sa PolylineBase<PLT,FPT>::rotate( Rotate )
+*/
+template<typename PLT,typename FPT>
+template<typename FPT2>
+void
+PolylineBase<PLT,FPT>::rotate( Rotate rot, const Point2d_<FPT2>& refpt )
+{
+	translate( -refpt.getX(), -refpt.getY() );
+	this->rotate( rot );
+	translate( refpt.getX(), refpt.getY() );
+}
+
+//------------------------------------------------------------------
+/// Rotates the polyline by either 90°, 180°, 270° (-90°) at point (0,0)
+/**
+For an arbitrary angle \c alpha (rad.), you can write:
+```
+auto poly2 = Homogr(alpha) * poly;
+```
+\sa PolylineBase<PLT,FPT>::rotate( Rotate, const Point2d_<FPT2>& )
+*/
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::rotate( Rotate rot )
+{
+	auto apply = [this]     // lambda
+		( auto fct, bool isMirror )
+		{
+			for( auto& pt: _plinevec )
+				pt = fct( pt );
+			_attribs.applyIsometry( fct, isMirror );
+			_plIsNormalized=false;
+		};
+
+	switch( rot )
+	{
+		case Rotate::CCW:
+			apply( []( const auto& pt ){ return std::decay_t<decltype(pt)>( -pt.getY(), +pt.getX() ); }, false );
+		break;
+		case Rotate::CW:
+			apply( []( const auto& pt ){ return std::decay_t<decltype(pt)>( +pt.getY(), -pt.getX() ); }, false );
+		break;
+		case Rotate::Full:
+			apply( []( const auto& pt ){ return std::decay_t<decltype(pt)>( -pt.getX(), -pt.getY() ); }, false );
+		break;
+		case Rotate::VMirror:
+			apply( []( const auto& pt ){ return std::decay_t<decltype(pt)>( -pt.getX(), pt.getY() ); }, true );
+		break;
+		case Rotate::HMirror:
+			apply( []( const auto& pt ){ return std::decay_t<decltype(pt)>( pt.getX(), -pt.getY() ); }, true );
+		break;
+
+		default: assert(0);
+	}
+}
+
+//------------------------------------------------------------------
+/// Private member function, called by PolylineBase::impl_minimizePL()
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::p_minimizePL( PolylineBase<PLT,FPT>& pl, size_t istart, size_t iend )
+{
+	auto nbpts = pl.size();
+// step 1: check each point to see if it is the middle point of two segments with same angle
+	std::vector<size_t> ptset;
+	for( size_t i=istart; i<iend; i++ )
+	{
+		const auto& p0 = pl._plinevec.at(i);
+		const auto& pnext = getPoint( i==nbpts-1 ? 0 : i+1 );
+		const auto& pprev = getPoint( i==0 ? nbpts-1 : i-1 );
+
+		auto vx1 = pnext.getX() - p0.getX();
+		auto vy1 = pnext.getY() - p0.getY();
+		auto vx2 = p0.getX() - pprev.getX();
+		auto vy2 = p0.getY() - pprev.getY();
+		auto a1 = std::atan2( vx1, vy1 );
+		auto a2 = std::atan2( vx2, vy2 );
+
+		if( homog2d_abs(a1-a2) < thr::nullAngleValue() )
+			ptset.push_back( i );
+	}
+
+	if( ptset.size() == 0 ) // if no same angle segment (=no "middle point")
+		return;             // then no change
+
+// step 2: build new Polyline without those points
+	PolylineBase<PLT,FPT> out;
+	size_t vec_idx = 0;
+	for( size_t i=0; i<nbpts; i++ )
+	{
+//		HOMOG2D_LOG("ptset.size()=" << ptset.size() << " vec_idx=" << vec_idx );
+
+		if( vec_idx<ptset.size() ) // if there is more points to remove
+		{
+			if( ptset.at(vec_idx) != i )               // if regular point, add it
+				out.p_addPoint( pl._plinevec.at(i) );  //  to the output set
+			else                                       // else, we found a "middle point"
+				vec_idx++;                             // and switch to next one
+		}
+		else                                        // no more points to remove
+			out.p_addPoint( pl._plinevec.at(i) );   // so just add the point to the output set
+	}
+	std::swap( out, pl ); // maybe we can "move" instead?
+}
+
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::impl_minimizePL( const detail::PlHelper<typename typ::IsOpen>& )
+{
+	assert( size() > 2 );
+	p_minimizePL( *this, 1, size()-1 );
+}
+
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::impl_minimizePL( const detail::PlHelper<typename typ::IsClosed>& )
+{
+	p_minimizePL( *this, 0, size() );
+}
+
+
+} // namespace base
+
+namespace priv {
+//------------------------------------------------------------------
+/// Returns true if two non-adjacent segments of the closed polyline defined by the coordinates \c vx and \c vy intersect.
+/// Shamos-Hoey sweep-line algorithm, O(n log n), used by PolylineBase::isSimple() and PolylineSoA::isSimple()
+/**
+- ref: M. Shamos, D. Hoey, "Geometric intersection problems", 1976
+- see also: https://geomalgorithms.com/a09-_intersect-3.html
+
+The sweep line moves along x. Segments are inserted in the status structure at their left point,
+and removed at their right point. As long as no intersection is found, the relative order of the segments
+in the status structure never changes, so it can be determined at insertion time with an orientation test,
+and we only need to check the segments that become neighbors.
+
+The candidate pairs are checked with SegVec::intersects(), so the result is the same as the one
+of the brute force approach (see PolylineBase::p_hasCrossingsBruteForce()).
+
+If \c isClosed is false, the points are considered as an open polyline (no segment between last and first point).
+*/
+template<typename T>
+bool
+hasCrossingsSweep( const std::vector<T>& vx, const std::vector<T>& vy, bool isClosed=true )
+{
+	const auto n = vx.size();
+	if( n < 3 )
+		return false;
+	const auto ns = ( isClosed ? n : n-1 );  // nb of segments
+	auto X = [&vx]( size_t i ) -> HOMOG2D_INUMTYPE { return vx[i]; };
+	auto Y = [&vy]( size_t i ) -> HOMOG2D_INUMTYPE { return vy[i]; };
+	auto ptLess = [&]           // lambda, lexicographic order
+		( size_t p1, size_t p2 )
+		{
+			return X(p1) < X(p2) || ( X(p1) == X(p2) && Y(p1) < Y(p2) );
+		};
+
+	auto orient = [&]           // lambda, returns -1, 0 or +1
+		( size_t pa, size_t pb, size_t pc )
+		{
+			auto val = ( X(pb) - X(pa) ) * ( Y(pc) - Y(pa) ) - ( Y(pb) - Y(pa) ) * ( X(pc) - X(pa) );
+			return ( val > 0. ) - ( val < 0. );
+		};
+
+// segment i goes from point i to point i+1, get its left and right points
+	std::vector<size_t> segL( ns ), segR( ns );
+	for( size_t i=0; i<ns; i++ )
+	{
+		auto j = ( i+1 == n ? 0 : i+1 );
+		segL[i] = ( ptLess( j, i ) ? j : i );
+		segR[i] = ( ptLess( j, i ) ? i : j );
+	}
+
+// events: 2*seg for the left point, 2*seg+1 for the right point
+	std::vector<size_t> events( 2*ns );
+	std::iota( events.begin(), events.end(), 0 );
+	std::sort(
+		events.begin(),
+		events.end(),
+		[&]                     // lambda
+		( size_t e1, size_t e2 )
+		{
+			auto p1 = ( e1%2 ? segR[e1/2] : segL[e1/2] );
+			auto p2 = ( e2%2 ? segR[e2/2] : segL[e2/2] );
+			if( ptLess( p1, p2 ) )
+				return true;
+			if( ptLess( p2, p1 ) )
+				return false;
+			if( e1%2 != e2%2 )   // same point: insertions first
+				return e1%2 == 0;
+			return e1 < e2;
+		}
+	);
+
+// "segment s1 is below segment s2", evaluated relatively to the one that was inserted first
+	auto isBelow = [&]          // lambda
+		( size_t s1, size_t s2 )
+		{
+			if( s1 == s2 )
+				return false;
+			bool swap = ptLess( segL[s1], segL[s2] );
+			auto sa = ( swap ? s2 : s1 );
+			auto sb = ( swap ? s1 : s2 );
+			auto o = orient( segL[sb], segR[sb], segL[sa] );
+			if( o == 0 )
+				o = orient( segL[sb], segR[sb], segR[sa] );
+			if( o == 0 )
+				return s1 < s2;
+			return swap ? ( o > 0 ) : ( o < 0 );
+		};
+
+	auto crosses = [&]          // lambda
+		( size_t s1, size_t s2 )
+		{
+			auto d = ( s1 > s2 ? s1 - s2 : s2 - s1 );
+			if( d == 1 || ( isClosed && d == n-1 ) )     // adjacent segments
+				return false;
+			Segment_<HOMOG2D_INUMTYPE> seg1( X(s1), Y(s1), X((s1+1)%n), Y((s1+1)%n) );
+			Segment_<HOMOG2D_INUMTYPE> seg2( X(s2), Y(s2), X((s2+1)%n), Y((s2+1)%n) );
+			return seg1.intersects( seg2 )();
+		};
+
+// Collinear overlapping segments (for example two adjacent segments folding back on each other, a "spike")
+// are not considered as crossing. They are equivalent for the ordering, so they may hide a crossing segment
+// to each other. Thus, the consecutive segments of the status structure that are collinear are handled as a "group",
+// and two neighbor groups are checked with all their segments (a group has usually a single segment).
+	auto collinear = [&]        // lambda
+		( size_t s1, size_t s2 )
+		{
+			return orient( segL[s1], segR[s1], segL[s2] ) == 0 && orient( segL[s1], segR[s1], segR[s2] ) == 0;
+		};
+
+	using Status = std::set<size_t,decltype(isBelow)>;
+	using Iter   = typename Status::iterator;
+	Status status( isBelow );
+	std::vector<Iter> where( ns );
+
+// checks the group that ends at itL (going downwards) against the group that starts at itU (going upwards)
+	auto groupsCross = [&]      // lambda
+		( Iter itL, Iter itU )
+		{
+			for( auto i1=itL; ; --i1 )
+			{
+				for( auto i2=itU; i2!=status.end(); ++i2 )
+				{
+					if( crosses( *i1, *i2 ) )
+						return true;
+					auto next = std::next(i2);
+					if( next == status.end() || !collinear( *i2, *next ) )
+						break;
+				}
+				if( i1 == status.begin() || !collinear( *i1, *std::prev(i1) ) )
+					break;
+			}
+			return false;
+		};
+
+	for( auto ev: events )
+	{
+		auto seg = ev/2;
+		if( ev%2 == 0 )       // left point: insert and check its group with the neighbor groups
+		{
+			auto it = status.insert( seg ).first;
+			where[seg] = it;
+			auto lo = it;
+			while( lo != status.begin() && collinear( *std::prev(lo), *lo ) )
+				--lo;
+			auto hi = it;
+			while( std::next(hi) != status.end() && collinear( *hi, *std::next(hi) ) )
+				++hi;
+			for( auto i2=lo; i2!=std::next(hi); ++i2 )    // inside the group
+				if( i2 != it && crosses( seg, *i2 ) )
+					return true;
+			if( lo != status.begin() && groupsCross( std::prev(lo), lo ) )
+				return true;
+			if( std::next(hi) != status.end() && groupsCross( hi, std::next(hi) ) )
+				return true;
+		}
+		else                  // right point: remove, its two neighbors become adjacent
+		{
+			auto it = where[seg];
+			auto next = std::next(it);
+			if( it != status.begin() && next != status.end() )
+				if( groupsCross( std::prev(it), next ) )
+					return true;
+			status.erase( it );
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------
+/// Returns true if two non-adjacent segments of the polyline defined by \c pts intersect, see above
+template<typename FPT>
+bool
+hasCrossingsSweep( const std::vector<Point2d_<FPT>>& pts, bool isClosed=true )
+{
+	std::vector<HOMOG2D_INUMTYPE> vx( pts.size() ), vy( pts.size() );
+	for( size_t i=0; i<pts.size(); i++ )
+	{
+		vx[i] = pts[i].getX();
+		vy[i] = pts[i].getY();
+	}
+	return hasCrossingsSweep( vx, vy, isClosed );
+}
+
+//------------------------------------------------------------------
+/// Helper class for the simplification of polylines without creating crossings, see keepNoCrossingsRDP()
+/**
+Holds the current segments of a polyline that is being simplified: segment \c u goes from kept point \c u
+to the next kept point.
+They are indexed with a SegBVH built on the original segments, whose box \c u is updated each time
+the next kept point of \c u changes (the other ones are emptied).
+As points are only added, the boxes only shrink.
+So checking a new segment only involves the current segments that are close to it, instead of checking the whole polyline.
+*/
+template<typename FPT>
+class SimplifIndex
+{
+private:
+	const std::vector<Point2d_<FPT>>& _pts;
+	std::vector<size_t> _prev, _next;   ///< links between kept points, \c _pts.size() if none
+	SegBVH              _bvh;
+
+public:
+	SimplifIndex( const std::vector<Point2d_<FPT>>& pts, const std::vector<bool>& keep, bool isClosed )
+		: _pts(pts), _prev( pts.size(), pts.size() ), _next( pts.size(), pts.size() )
+	{
+		const auto n = pts.size();
+		_bvh.build( pts, isClosed );
+		size_t first = n, last = n;
+		for( size_t i=0; i<n; i++ )
+			if( keep[i] )
+			{
+				if( last == n )
+					first = i;
+				else
+					p_link( last, i );
+				last = i;
+			}
+		if( isClosed && first != last )
+			p_link( last, first );
+
+		for( size_t u=0; u<( isClosed ? n : n-1 ); u++ )
+			if( !keep[u] )
+				_bvh.setBox( u, SegBVH::Box::empty(), 0. );
+			else
+				if( isShortcut( u ) )
+					p_setBox( u );
+	}
+
+	size_t next( size_t u ) const { return _next[u]; }
+
+/// Returns true if segment \c u replaces some original points
+	bool isShortcut( size_t u ) const
+	{
+		return _next[u] != _pts.size() && _next[u] != ( u+1 == _pts.size() ? 0 : u+1 );
+	}
+
+/// Returns a current segment that crosses segment (a,b), \c _pts.size() if none
+/**
+The segments between \c a and \c b (that would be replaced by it), and the two adjacent ones, are not considered.
+*/
+	size_t findCrossing( size_t a, size_t b ) const
+	{
+		const auto n = _pts.size();
+		if( _pts[a] == _pts[b] )              // would make a degenerate segment
+			return a;
+		Segment_<HOMOG2D_INUMTYPE> seg( _pts[a], _pts[b] );
+		SegBVH::Box box( _pts[a], _pts[b] );
+		const auto margin = _bvh.margin( box.size() );
+		size_t res = n;
+		_bvh.query(
+			box,
+			margin,
+			[&]                 // lambda
+			( size_t u )
+			{
+				if( res != n || u == _prev[a] || u == b )
+					return;
+				for( auto w=a; w!=b; w=_next[w] )   // segments between a and b
+					if( w == u )
+						return;
+				auto v = _next[u];
+				if( p_sameSide( a, b, u, v, margin ) || p_sameSide( u, v, a, b, margin ) )
+					return;
+				if( _pts[u] != _pts[v] && Segment_<HOMOG2D_INUMTYPE>( _pts[u], _pts[v] ).intersects( seg )() )
+					res = u;
+			}
+		);
+		return res;
+	}
+
+/// Splits segment \c u at point \c m
+	void split( size_t u, size_t m )
+	{
+		auto v = _next[u];
+		p_link( u, m );
+		p_link( m, v );
+		p_setBox( u );
+		p_setBox( m );
+	}
+
+private:
+/// Returns true if points \c u and \c v are both on the same side of the line through points \c a and \c b,
+/// farther than \c margin (so segments cannot intersect, used to avoid the costly SegVec::intersects())
+	bool p_sameSide( size_t a, size_t b, size_t u, size_t v, HOMOG2D_INUMTYPE margin ) const
+	{
+		HOMOG2D_INUMTYPE ax = _pts[a].getX();
+		HOMOG2D_INUMTYPE ay = _pts[a].getY();
+		HOMOG2D_INUMTYPE dx = _pts[b].getX() - ax;
+		HOMOG2D_INUMTYPE dy = _pts[b].getY() - ay;
+		auto thres = margin * std::hypot( dx, dy );
+		auto du = dx * ( _pts[u].getY() - ay ) - dy * ( _pts[u].getX() - ax );
+		auto dv = dx * ( _pts[v].getY() - ay ) - dy * ( _pts[v].getX() - ax );
+		return ( du > thres && dv > thres ) || ( du < -thres && dv < -thres );
+	}
+
+	void p_link( size_t u, size_t v )
+	{
+		_next[u] = v;
+		_prev[v] = u;
+	}
+	void p_setBox( size_t u )
+	{
+		const auto& p1 = _pts[u];
+		const auto& p2 = _pts[ _next[u] ];
+		_bvh.setBox( u, SegBVH::Box( p1, p2 ), p1.distTo( p2 ) );
+	}
+};
+
+//------------------------------------------------------------------
+/// Ramer-Douglas-Peucker simplification, returns a flag for each point, true if it is kept
+/**
+Iterative version (explicit stack instead of recursion).
+For a closed polyline, the points are split in two chains at point 0 and at the point farthest from it,
+and at least 3 points are kept.
+
+- ref: https://en.wikipedia.org/wiki/Ramer%E2%80%93Douglas%E2%80%93Peucker_algorithm
+
+\sa PolylineBase::simplify()
+*/
+template<typename FPT>
+std::vector<bool>
+simplifyRDP( const std::vector<Point2d_<FPT>>& pts, HOMOG2D_INUMTYPE epsilon, bool isClosed )
+{
+	const auto n = pts.size();
+	std::vector<bool> keep( n, true );
+	if( n < 3 )
+		return keep;
+	keep.assign( n, false );
+
+	std::vector<HOMOG2D_INUMTYPE> vx( n+1 ), vy( n+1 );  // index n stands for point 0
+	for( size_t i=0; i<n; i++ )
+	{
+		vx[i] = pts[i].getX();
+		vy[i] = pts[i].getY();
+	}
+	vx[n] = vx[0];
+	vy[n] = vy[0];
+
+	auto sqDistPtSeg = [&]      // lambda, squared distance between point i and segment (i1,i2)
+		( size_t i, size_t i1, size_t i2 )
+		{
+			return priv::sqDistPtSeg( vx[i], vy[i], vx[i1], vy[i1], vx[i2], vy[i2] );
+		};
+
+	std::vector<std::pair<size_t,size_t>> stack;
+	keep[0] = true;
+	if( isClosed )
+	{
+		size_t kFar = 1;
+		HOMOG2D_INUMTYPE dMax = 0.;
+		for( size_t i=1; i<n; i++ )
+		{
+			auto d = sqDistPtSeg( i, 0, 0 );
+			if( d > dMax )
+			{
+				dMax = d;
+				kFar = i;
+			}
+		}
+		keep[kFar] = true;
+		stack.emplace_back( 0, kFar );
+		stack.emplace_back( kFar, n );
+	}
+	else
+	{
+		keep[n-1] = true;
+		stack.emplace_back( 0, n-1 );
+	}
+
+	const auto eps2 = epsilon * epsilon;
+	while( !stack.empty() )
+	{
+		auto range = stack.back();
+		stack.pop_back();
+		if( range.second - range.first < 2 )
+			continue;
+		size_t iMax = range.first;
+		HOMOG2D_INUMTYPE dMax = -1.;
+		for( auto i=range.first+1; i<range.second; i++ )
+		{
+			auto d = sqDistPtSeg( i, range.first, range.second );
+			if( d > dMax )
+			{
+				dMax = d;
+				iMax = i;
+			}
+		}
+		if( dMax > eps2 )
+		{
+			keep[iMax] = true;
+			stack.emplace_back( range.first, iMax );
+			stack.emplace_back( iMax, range.second );
+		}
+	}
+
+	if( isClosed && std::count( keep.begin(), keep.end(), true ) < 3 )  // we need at least a triangle,
+	{                                                                      // so add the point farthest
+		auto i2 = std::distance(                                           // from the two others
+			keep.begin(),
+			std::find( keep.begin()+1, keep.end(), true )
+		);
+		size_t iMax = 1;
+		HOMOG2D_INUMTYPE dMax = -1.;
+		for( size_t i=1; i<n; i++ )
+			if( !keep[i] )
+			{
+				auto d = sqDistPtSeg( i, 0, i2 );
+				if( d > dMax )
+				{
+					dMax = d;
+					iMax = i;
+				}
+			}
+		keep[iMax] = true;
+	}
+	return keep;
+}
+
+//------------------------------------------------------------------
+/// Adds points to the ones kept by simplifyRDP(), until the segments of the result do not cross
+/**
+Each segment is checked against the other ones: if it crosses one, the segment that replaces some points
+is split at its farthest point, as in the Ramer-Douglas-Peucker algorithm.
+The source polyline must have no crossings, so two original segments never cross and this always ends.
+As points are only added, the result stays within the tolerance.
+
+Each check only involves the segments close to the checked one (see SimplifIndex),
+and only the new segments need to be checked again.
+
+- ref: A. Saalfeld, "Topologically consistent line simplification with the Douglas-Peucker algorithm", 1999
+
+\sa PolylineBase::simplify()
+*/
+template<typename FPT>
+void
+keepNoCrossingsRDP( const std::vector<Point2d_<FPT>>& pts, std::vector<bool>& keep, bool isClosed )
+{
+	const auto n = pts.size();
+	if( n < 3 )
+		return;
+	SimplifIndex<FPT> index( pts, keep, isClosed );
+
+	std::vector<size_t> stack;
+	for( size_t u=0; u<n; u++ )
+		if( keep[u] && index.next(u) != n )
+			stack.push_back( u );
+
+	while( !stack.empty() )
+	{
+		auto u = stack.back();
+		stack.pop_back();
+		auto c = index.findCrossing( u, index.next(u) );
+		if( c == n )
+			continue;
+		auto s = ( index.isShortcut( u ) ? u : c );      // segment to split
+		if( !index.isShortcut( s ) )                      // both are original segments,
+			continue;                                     // can only happen if the source has crossings
+
+		auto v = index.next( s );
+		size_t iMax = n;
+		HOMOG2D_INUMTYPE dMax = -1.;
+		for( auto i=( s+1 == n ? 0 : s+1 ); i!=v; i=( i+1 == n ? 0 : i+1 ) )
+		{
+			auto d = priv::sqDistPtSeg(
+				pts[i].getX(), pts[i].getY(),
+				pts[s].getX(), pts[s].getY(),
+				pts[v].getX(), pts[v].getY()
+			);
+			if( d > dMax )
+			{
+				dMax = d;
+				iMax = i;
+			}
+		}
+		keep[iMax] = true;
+		index.split( s, iMax );
+		stack.push_back( s );
+		stack.push_back( iMax );
+		if( s != u )
+			stack.push_back( u );
+	}
+}
+
+//------------------------------------------------------------------
+/// Visvalingam-Whyatt simplification, returns a flag for each point, true if it is kept
+/**
+Removes iteratively the point that has the smallest "effective area" (area of the triangle made
+with its two neighbours), until only \c target points remain.
+Uses a binary heap with lazy deletion, O(n log n).
+For open polylines, the two end points are always kept.
+
+If \c keepSimple is true (source polyline must have no crossings), a point is not removed if the new segment would cross another one.
+As the two replaced segments do not cross anything, this can only happen if a remaining point lies inside the triangle
+made by the point and its two neighbours, so this is checked with a SegBVH holding the remaining points,
+O(log n) per point for usual shapes.
+The point can still be removed later, once one of its neighbours has been removed.
+So the result may hold more than \c target points.
+
+- ref: M. Visvalingam, J. D. Whyatt, "Line generalisation by repeated elimination of points", 1993
+- see also: https://en.wikipedia.org/wiki/Visvalingam%E2%80%93Whyatt_algorithm
+
+\sa PolylineBase::simplifyToCount()
+*/
+template<typename FPT>
+std::vector<bool>
+simplifyVW( const std::vector<Point2d_<FPT>>& pts, size_t target, bool isClosed, bool keepSimple=false )
+{
+	const auto n = pts.size();
+	std::vector<bool> keep( n, true );
+	if( n <= target || n < 3 )
+		return keep;
+
+	std::vector<HOMOG2D_INUMTYPE> vx( n ), vy( n );
+	std::vector<size_t> prev( n ), next( n );
+	for( size_t i=0; i<n; i++ )
+	{
+		vx[i] = pts[i].getX();
+		vy[i] = pts[i].getY();
+		prev[i] = ( i==0   ? n-1 : i-1 );
+		next[i] = ( i==n-1 ? 0   : i+1 );
+	}
+	auto triArea = [&]          // lambda
+		( size_t i )
+		{
+			auto ia = prev[i];
+			auto ic = next[i];
+			auto val = ( vx[i] - vx[ia] ) * ( vy[ic] - vy[ia] ) - ( vy[i] - vy[ia] ) * ( vx[ic] - vx[ia] );
+			return homog2d_abs( val ) / 2.;
+		};
+
+	using Elem = std::pair<HOMOG2D_INUMTYPE,size_t>;
+	std::vector<HOMOG2D_INUMTYPE> area( n );
+	std::vector<Elem> vheap;
+	vheap.reserve( 3*n );         // initial points + 2 updates per removed point
+	for( size_t i=0; i<n; i++ )
+	{
+		if( !isClosed && ( i==0 || i==n-1 ) )
+			continue;
+		area[i] = triArea( i );
+		vheap.emplace_back( area[i], i );
+	}
+	std::priority_queue<Elem,std::vector<Elem>,std::greater<Elem>> heap( std::greater<Elem>(), std::move(vheap) );
+
+	SegBVH vbvh;                  // remaining points, only used if keepSimple
+	if( keepSimple )
+		vbvh.buildPoints( pts );
+	auto createsCrossing = [&]    // lambda, returns true if a remaining point lies in triangle (ip,i,in)
+		( size_t ip, size_t i, size_t in )
+		{
+			if( vx[ip] == vx[in] && vy[ip] == vy[in] )   // would make a degenerate segment
+				return true;
+			const std::array<size_t,3> tri{ ip, i, in };
+			std::array<HOMOG2D_INUMTYPE,3> len;
+			for( size_t e=0; e<3; e++ )
+				len[e] = std::hypot( vx[tri[(e+1)%3]] - vx[tri[e]], vy[tri[(e+1)%3]] - vy[tri[e]] );
+			SegBVH::Box box( pts[ip], pts[in] );
+			box.add( SegBVH::Box( pts[i], pts[i] ) );
+			const auto margin = vbvh.margin( box.size() );
+
+			auto outside = [&]    // lambda, returns true if point (x,y) is outside of half-plane \c hp (edge, side)
+				( const std::pair<size_t,int>& hp, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
+				{
+					auto a = tri[hp.first];
+					auto b = tri[(hp.first+1)%3];
+					auto c = ( vx[b] - vx[a] ) * ( y - vy[a] ) - ( vy[b] - vy[a] ) * ( x - vx[a] );
+					return hp.second * c < -margin * len[hp.first];
+				};
+
+			// the triangle is described by a set of half-planes (edge, side): its three edges,
+			// or both sides of its longest edge if it is flat, as its orientation is then unreliable
+			std::array<std::pair<size_t,int>,3> halfPlanes;
+			size_t nbHalfPlanes = 3;
+			auto val = ( vx[i] - vx[ip] ) * ( vy[in] - vy[ip] ) - ( vy[i] - vy[ip] ) * ( vx[in] - vx[ip] );
+			auto eMax = static_cast<size_t>( std::distance( len.begin(), std::max_element( len.begin(), len.end() ) ) );
+			if( homog2d_abs( val ) <= margin * len[eMax] )
+			{
+				halfPlanes[0] = std::make_pair( eMax,  1 );
+				halfPlanes[1] = std::make_pair( eMax, -1 );
+				nbHalfPlanes = 2;
+			}
+			else
+				for( size_t e=0; e<3; e++ )
+					halfPlanes[e] = std::make_pair( e, ( val > 0. ? 1 : -1 ) );
+
+			bool res = false;
+			vbvh.queryIf(
+				[&]               // lambda
+				( const SegBVH::Box& b )
+				{
+					if( !b.overlaps( box, margin ) )
+						return false;
+					for( size_t h=0; h<nbHalfPlanes; h++ )
+						if(
+							outside( halfPlanes[h], b._xmin, b._ymin ) && outside( halfPlanes[h], b._xmax, b._ymin )
+							&& outside( halfPlanes[h], b._xmin, b._ymax ) && outside( halfPlanes[h], b._xmax, b._ymax )
+						)
+							return false;
+					return true;
+				},
+				[&]               // lambda
+				( size_t k )
+				{
+					if( k != ip && k != i && k != in )
+						res = true;
+				}
+			);
+			return res;
+		};
+
+	size_t remaining = n;
+	HOMOG2D_INUMTYPE lastArea = 0.;
+	while( remaining > target && !heap.empty() )
+	{
+		auto elem = heap.top();
+		heap.pop();
+		auto i = elem.second;
+		if( !keep[i] || elem.first != area[i] )   // removed or outdated
+			continue;
+		auto ip = prev[i];
+		auto in = next[i];
+		if( keepSimple )
+		{
+			if( createsCrossing( ip, i, in ) )
+				continue;
+			vbvh.setBox( i, SegBVH::Box::empty(), 0. );
+		}
+		keep[i] = false;
+		remaining--;
+		lastArea = std::max( lastArea, elem.first );
+
+		next[ip] = in;
+		prev[in] = ip;
+		for( auto j: { ip, in } )
+			if( isClosed || ( j != 0 && j != n-1 ) )
+			{
+				area[j] = std::max( triArea( j ), lastArea );  // area must not decrease
+				heap.emplace( area[j], j );
+			}
+	}
+	return keep;
+}
+
+/// Polygon triangulation, see PolylineBase::triangulate()
+namespace triang {
+
+/// Vertex classification used by the monotone decomposition
+enum class VertexType: uint8_t { Start, End, Split, Merge, Regular };
+
+//------------------------------------------------------------------
+/// Helper class for polygon triangulation, operates on a CCW ordered set of coordinates
+/**
+Two steps:
+ -# decomposition in y-monotone polygons, using a sweep line (top to bottom), O(n.log(n))
+ -# triangulation of each monotone polygon, O(n)
+
+ref: M. de Berg et al., "Computational Geometry, Algorithms and Applications", chapter 3.
+*/
+class Triangulator
+{
+	using Triangle = std::array<size_t,3>;
+
+private:
+	std::vector<HOMOG2D_INUMTYPE> _vx, _vy;
+	size_t _n;
+	HOMOG2D_INUMTYPE _sweepY = 0.;                ///< current position of sweep line
+	std::vector<std::vector<size_t>> _adj;       ///< neighbours of each vertex (polygon edges and diagonals)
+
+public:
+	Triangulator( std::vector<HOMOG2D_INUMTYPE>&& vx, std::vector<HOMOG2D_INUMTYPE>&& vy )
+		: _vx( std::move(vx) ), _vy( std::move(vy) ), _n( _vx.size() ), _adj( _n )
+	{
+		for( size_t i=0; i<_n; i++ )
+			_adj[i] = { p_next(i), p_prev(i) };
+	}
+
+/// Returns the triangles, as triplets of vertex indexes
+	std::vector<Triangle> compute()
+	{
+		p_decompose();
+		std::vector<Triangle> out;
+		out.reserve( _n-2 );
+		for( const auto& face: p_getFaces() )
+			p_triangulateMonotone( face, out );
+		return out;
+	}
+
+private:
+	size_t p_next( size_t i ) const { return i==_n-1 ? 0 : i+1; }
+	size_t p_prev( size_t i ) const { return i==0 ? _n-1 : i-1; }
+
+/// Returns true if vertex \c a is above vertex \c b (same y: leftmost is above)
+	bool p_above( size_t a, size_t b ) const
+	{
+		if( _vy[a] != _vy[b] )
+			return _vy[a] > _vy[b];
+		if( _vx[a] != _vx[b] )
+			return _vx[a] < _vx[b];
+		return a < b;
+	}
+
+/// Cross product of (b-a) and (c-a), >0 if c is on the left of a->b
+	HOMOG2D_INUMTYPE p_orient( size_t a, size_t b, size_t c ) const
+	{
+		return ( _vx[b] - _vx[a] ) * ( _vy[c] - _vy[a] ) - ( _vy[b] - _vy[a] ) * ( _vx[c] - _vx[a] );
+	}
+
+	VertexType p_vertexType( size_t i ) const
+	{
+		auto ip = p_prev( i );
+		auto in = p_next( i );
+		bool convex = p_orient( ip, i, in ) > 0;
+		if( p_above( i, ip ) && p_above( i, in ) )
+			return convex ? VertexType::Start : VertexType::Split;
+		if( p_above( ip, i ) && p_above( in, i ) )
+			return convex ? VertexType::End : VertexType::Merge;
+		return VertexType::Regular;
+	}
+
+/// x coordinate of edge \c e (from vertex \c e to next one) on the sweep line
+	HOMOG2D_INUMTYPE p_edgeX( size_t e ) const
+	{
+		auto e2 = p_next( e );
+		auto dy = _vy[e2] - _vy[e];
+		if( dy == 0. )
+			return std::min( _vx[e], _vx[e2] );
+		return _vx[e] + ( _sweepY - _vy[e] ) * ( _vx[e2] - _vx[e] ) / dy;
+	}
+
+/// Ordering of the edges in the sweep line status (left first)
+	struct EdgeComp
+	{
+		using is_transparent = void;
+		const Triangulator* _tr;
+		bool operator()( size_t e1, size_t e2 ) const
+		{
+			auto x1 = _tr->p_edgeX( e1 );
+			auto x2 = _tr->p_edgeX( e2 );
+			if( x1 != x2 )
+				return x1 < x2;
+			return e1 < e2;
+		}
+		bool operator()( size_t e, HOMOG2D_INUMTYPE x ) const { return _tr->p_edgeX( e ) < x; }
+		bool operator()( HOMOG2D_INUMTYPE x, size_t e ) const { return x < _tr->p_edgeX( e ); }
+	};
+
+	void p_addDiagonal( size_t a, size_t b )
+	{
+		_adj[a].push_back( b );
+		_adj[b].push_back( a );
+	}
+
+/// Decomposition into y-monotone polygons, by adding diagonals
+	void p_decompose()
+	{
+		std::vector<size_t> queue( _n );
+		std::iota( queue.begin(), queue.end(), 0 );
+		std::sort(
+			queue.begin(),
+			queue.end(),
+			[this]( size_t a, size_t b ){ return p_above( a, b ); }
+		);
+
+		using Status = std::set<size_t,EdgeComp>;
+		Status status( EdgeComp{this} );
+		std::vector<typename Status::iterator> statusPos( _n, status.end() );
+		std::vector<size_t> helper( _n );
+		std::vector<VertexType> vtype( _n );
+		for( size_t i=0; i<_n; i++ )
+			vtype[i] = p_vertexType( i );
+
+		auto insertEdge = [&]( size_t e, size_t h )
+		{
+			statusPos[e] = status.insert( e ).first;
+			helper[e] = h;
+		};
+		auto removeEdge = [&]( size_t e, size_t v )
+		{
+			if( statusPos[e] == status.end() )
+				return;
+			if( vtype[ helper[e] ] == VertexType::Merge )
+				p_addDiagonal( v, helper[e] );
+			status.erase( statusPos[e] );
+			statusPos[e] = status.end();
+		};
+		auto leftEdge = [&]( size_t v ) -> size_t   // edge directly at left of vertex (_n if none, only for degenerate polygons)
+		{
+			auto it = status.lower_bound( _vx[v] );
+			return it == status.begin() ? _n : *std::prev( it );
+		};
+		auto updateLeftEdge = [&]( size_t v )
+		{
+			auto ej = leftEdge( v );
+			if( ej == _n )
+				return;
+			if( vtype[ helper[ej] ] == VertexType::Merge )
+				p_addDiagonal( v, helper[ej] );
+			helper[ej] = v;
+		};
+
+		for( auto v: queue )
+		{
+			_sweepY = _vy[v];
+			auto ep = p_prev( v );   // edge ending at v
+			switch( vtype[v] )
+			{
+				case VertexType::Start:
+					insertEdge( v, v );
+				break;
+				case VertexType::End:
+					removeEdge( ep, v );
+				break;
+				case VertexType::Split:
+				{
+					auto ej = leftEdge( v );
+					if( ej != _n )
+					{
+						p_addDiagonal( v, helper[ej] );
+						helper[ej] = v;
+					}
+					insertEdge( v, v );
+				}
+				break;
+				case VertexType::Merge:
+					removeEdge( ep, v );
+					updateLeftEdge( v );
+				break;
+				case VertexType::Regular:
+					if( p_above( ep, v ) )   // interior is on the right
+					{
+						removeEdge( ep, v );
+						insertEdge( v, v );
+					}
+					else
+						updateLeftEdge( v );
+				break;
+			}
+		}
+	}
+
+/// Returns the faces (monotone polygons) delimited by the polygon edges and the diagonals, as CCW ordered vertices
+	std::vector<std::vector<size_t>> p_getFaces()
+	{
+		std::vector<std::vector<bool>> used( _n );   // directed edge from i to _adj[i][k] already traversed
+		for( size_t i=0; i<_n; i++ )
+		{
+			auto& adj = _adj[i];
+			if( adj.size() > 2 )                      // sort neighbours by angle (CCW)
+			{
+				std::sort(
+					adj.begin(),
+					adj.end(),
+					[this,i]( size_t a, size_t b )
+					{
+						return std::atan2( _vy[a] - _vy[i], _vx[a] - _vx[i] )
+							< std::atan2( _vy[b] - _vy[i], _vx[b] - _vx[i] );
+					}
+				);
+			}
+			used[i].resize( adj.size(), false );
+			auto itp = std::find( adj.begin(), adj.end(), p_prev(i) );   // edge going outside
+			used[i][ std::distance( adj.begin(), itp ) ] = true;
+		}
+
+		std::vector<std::vector<size_t>> faces;
+		for( size_t i=0; i<_n; i++ )
+			for( size_t k=0; k<_adj[i].size(); k++ )
+			{
+				if( used[i][k] )
+					continue;
+				std::vector<size_t> face;
+				size_t u = i;
+				size_t ku = k;
+				do
+				{
+					used[u][ku] = true;
+					face.push_back( u );
+					auto v = _adj[u][ku];
+					const auto& adjv = _adj[v];
+					auto kv = static_cast<size_t>( std::distance( adjv.begin(), std::find( adjv.begin(), adjv.end(), u ) ) );
+					ku = ( kv == 0 ? adjv.size()-1 : kv-1 );   // next edge, clockwise from edge v->u
+					u = v;
+				}
+				while( u != i || ku != k );
+				faces.push_back( std::move(face) );
+			}
+		return faces;
+	}
+
+/// Add triangle, in CCW order
+	void p_addTriangle( size_t a, size_t b, size_t c, std::vector<Triangle>& out ) const
+	{
+		if( p_orient( a, b, c ) < 0 )
+			std::swap( b, c );
+		out.push_back( Triangle{ a, b, c } );
+	}
+
+/// Triangulation of a y-monotone polygon, given as CCW ordered vertices
+	void p_triangulateMonotone( const std::vector<size_t>& face, std::vector<Triangle>& out ) const
+	{
+		auto n = face.size();
+		if( n < 3 )
+			return;
+		if( n == 3 )
+		{
+			p_addTriangle( face[0], face[1], face[2], out );
+			return;
+		}
+		size_t itop = 0, ibot = 0;
+		for( size_t i=1; i<n; i++ )
+		{
+			if( p_above( face[i], face[itop] ) )
+				itop = i;
+			if( p_above( face[ibot], face[i] ) )
+				ibot = i;
+		}
+
+// merge the two chains: going CCW from top vertex, we go down the left chain
+		std::vector<std::pair<size_t,bool>> sorted;   // vertex, and "is on left chain" flag
+		sorted.reserve( n );
+		sorted.emplace_back( face[itop], true );
+		size_t il = (itop+1)%n;
+		size_t ir = (itop+n-1)%n;
+		while( il != ibot || ir != ibot )
+		{
+			if( ir == ibot || ( il != ibot && p_above( face[il], face[ir] ) ) )
+			{
+				sorted.emplace_back( face[il], true );
+				il = (il+1)%n;
+			}
+			else
+			{
+				sorted.emplace_back( face[ir], false );
+				ir = (ir+n-1)%n;
+			}
+		}
+		sorted.emplace_back( face[ibot], true );
+
+		std::vector<std::pair<size_t,bool>> stack{ sorted[0], sorted[1] };
+		for( size_t j=2; j<n-1; j++ )
+		{
+			const auto& uj = sorted[j];
+			if( uj.second != stack.back().second )
+			{
+				for( size_t i=0; i<stack.size()-1; i++ )
+					p_addTriangle( uj.first, stack[i].first, stack[i+1].first, out );
+				auto last = stack.back();
+				stack = { last, uj };
+			}
+			else
+			{
+				auto last = stack.back();
+				stack.pop_back();
+				while( !stack.empty() )
+				{
+					auto o = p_orient( uj.first, stack.back().first, last.first );
+					if( uj.second ? o <= 0. : o >= 0. )    // diagonal is not inside
+						break;
+					p_addTriangle( uj.first, last.first, stack.back().first, out );
+					last = stack.back();
+					stack.pop_back();
+				}
+				stack.push_back( last );
+				stack.push_back( uj );
+			}
+		}
+		for( size_t i=0; i<stack.size()-1; i++ )
+			p_addTriangle( sorted.back().first, stack[i].first, stack[i+1].first, out );
+	}
+};
+
+} // namespace triang
+
+//------------------------------------------------------------------
+/// Triangulation of a simple polygon, returns the triangles as triplets of indexes of the points
+/**
+\sa PolylineBase::triangulate()
+*/
+template<typename FPT>
+std::vector<std::array<size_t,3>>
+triangulatePolygon( const std::vector<Point2d_<FPT>>& pts, bool isCCW )
+{
+	auto n = pts.size();
+	std::vector<size_t> vidx;                           // index of points, CCW order, without repeated points
+	vidx.reserve( n );
+	for( size_t i=0; i<n; i++ )
+	{
+		auto j = isCCW ? i : n-1-i;
+		if( vidx.empty() || pts[j] != pts[vidx.back()] )
+			vidx.push_back( j );
+	}
+	while( vidx.size() > 1 && pts[vidx.back()] == pts[vidx.front()] )
+		vidx.pop_back();
+	if( vidx.size() < 3 )
+		return {};
+
+	std::vector<HOMOG2D_INUMTYPE> vx( vidx.size() ), vy( vidx.size() );
+	for( size_t i=0; i<vidx.size(); i++ )
+	{
+		vx[i] = pts[vidx[i]].getX();
+		vy[i] = pts[vidx[i]].getY();
+	}
+	auto out = triang::Triangulator( std::move(vx), std::move(vy) ).compute();
+	for( auto& tri: out )
+	{
+		for( auto& idx: tri )
+			idx = vidx[idx];
+		if( !isCCW )
+			std::swap( tri[1], tri[2] );     // keep same orientation as polygon
+	}
+	return out;
+}
+
+} // namespace priv
+
+namespace base {
+
+//------------------------------------------------------------------
+/// Returns true if object is a polygon (closed, and no segment crossing)
+/**
+Crossings are searched using a sweep-line algorithm, see priv::hasCrossingsSweep()
+*/
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::isSimple() const
+{
+	if( size()<3 )       // needs at least 3 points to be a polygon
+		return false;
+	if constexpr( std::is_same_v<PLT,typ::IsOpen> ) // If open, then not a polygon
+		return false;
+	else                  // If closed, we need to check for crossings
+	{
+		if( _attribs._isSimplePolyg.isBad() )
+			_attribs._isSimplePolyg.set( !priv::hasCrossingsSweep( _plinevec ) );
+		return _attribs._isSimplePolyg.value();
+	}
+}
+
+//------------------------------------------------------------------
+/// Private member function, returns true if no segments intersect (for closed ones, same as isSimple() )
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::p_hasNoCrossings() const
+{
+	if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+		return isSimple();
+	else
+		return !priv::hasCrossingsSweep( _plinevec, false );
+}
+
+//------------------------------------------------------------------
+/// Private member function, only keeps the points whose flag is true, used by simplify() and simplifyToCount()
+/**
+Two points that were not consecutive can become so: if they are equal, only one is kept.
+*/
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::p_keepPoints( const std::vector<bool>& keep )
+{
+	std::vector<Point2d_<FPT>> vout;
+	vout.reserve( std::count( keep.begin(), keep.end(), true ) );
+	for( size_t i=0; i<size(); i++ )
+		if( keep[i] )
+			if( vout.empty() || vout.back() != _plinevec[i] )
+				vout.push_back( _plinevec[i] );
+	while( vout.size() > 1 && vout.front() == vout.back() )
+		vout.pop_back();
+	if( vout.size() == 1 )
+		vout.clear();
+
+	std::swap( _plinevec, vout );
+	_plIsNormalized = false;
+	_attribs.setBad();
+}
+
+//------------------------------------------------------------------
+/// Simplify the polyline with the Ramer-Douglas-Peucker algorithm
+/**
+Removes points so that the polyline does not move more than \c epsilon from the original points.
+The end points of open polylines are always kept, closed ones will keep at least 3 points.
+
+If \c keepSimple is true and the polyline has no crossings, the result will have none either:
+points are then added back where the simplified segments cross (see priv::keepNoCrossingsRDP()),
+so the result stays within the tolerance.
+
+\sa priv::simplifyRDP()
+*/
+template<typename PLT,typename FPT>
+template<typename T>
+void
+PolylineBase<PLT,FPT>::simplify( T epsilon, bool keepSimple )
+{
+	HOMOG2D_CHECK_IS_NUMBER( T );
+	if( epsilon < 0 )
+		HOMOG2D_THROW_ERROR_1( "invalid negative value: epsilon=" << epsilon );
+	if( size() < 3 )
+		return;
+
+	auto keep = priv::simplifyRDP( _plinevec, static_cast<HOMOG2D_INUMTYPE>( epsilon ), isClosed() );
+	if( keepSimple && p_hasNoCrossings() )
+		priv::keepNoCrossingsRDP( _plinevec, keep, isClosed() );
+	p_keepPoints( keep );
+}
+
+//------------------------------------------------------------------
+/// Simplify the polyline down to \c nbPts points, with the Visvalingam-Whyatt algorithm
+/**
+The points that define the smallest triangles with their neighbours are removed first.
+The end points of open polylines are always kept.
+
+If \c keepSimple is true and the polyline has no crossings, the result will have none either:
+the points whose removal would create a crossing are kept, so the result may hold more than \c nbPts points.
+
+\sa priv::simplifyVW()
+*/
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::simplifyToCount( size_t nbPts, bool keepSimple )
+{
+	size_t nbMin = ( isClosed() ? 3 : 2 );
+	if( nbPts < nbMin )
+		HOMOG2D_THROW_ERROR_1( "invalid value: nbPts=" << nbPts << ", minimum is " << nbMin );
+	if( nbPts >= size() )
+		return;
+
+	p_keepPoints( priv::simplifyVW( _plinevec, nbPts, isClosed(), keepSimple && p_hasNoCrossings() ) );
+}
+
+//------------------------------------------------------------------
+/// Private member function, returns the segment holding curvilinear abscissa \c s, O(log n)
+/**
+For closed polylines, \c s is taken modulo the length (so it can be any value).
+For open polylines, it must be in [0,length()].
+On return, \c s holds the value that has been used.
+*/
+template<typename PLT,typename FPT>
+size_t
+PolylineBase<PLT,FPT>::p_locateAbscissa( HOMOG2D_INUMTYPE& s ) const
+{
+	if( size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "no segment, polyline has " << size() << " points" );
+
+	const auto& idx = p_getArcIndex();
+	auto len = idx.total();
+	if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+	{
+		if( len > 0. )
+		{
+			s = std::fmod( s, len );
+			if( s < 0. )
+				s += len;
+		}
+		else
+			s = 0.;
+	}
+	else
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( s < -thr::nullDistance() || s > len + thr::nullDistance() )
+			HOMOG2D_THROW_ERROR_1( "invalid abscissa value s=" << s << ", must be in [0," << len << "]" );
+#endif
+		s = std::min( std::max( s, static_cast<HOMOG2D_INUMTYPE>(0) ), len );
+	}
+	return idx.findSegment( s );
+}
+
+//------------------------------------------------------------------
+/// Private member function, returns point at abscissa \c s, that is on segment \c seg
+template<typename PLT,typename FPT>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::p_interpolate( size_t seg, HOMOG2D_INUMTYPE s ) const
+{
+	const auto& idx = p_getArcIndex();
+	const auto& p1 = _plinevec[seg];
+	const auto& p2 = _plinevec[ seg+1==size() ? 0 : seg+1 ];
+	auto segLength = idx.at(seg+1) - idx.at(seg);
+	if( segLength <= 0. )
+		return p1;
+	auto t = std::min( std::max( ( s - idx.at(seg) ) / segLength, static_cast<HOMOG2D_INUMTYPE>(0) ), static_cast<HOMOG2D_INUMTYPE>(1) );
+	HOMOG2D_INUMTYPE x1 = p1.getX();
+	HOMOG2D_INUMTYPE y1 = p1.getY();
+	return Point2d_<FPT>(
+		x1 + t * ( static_cast<HOMOG2D_INUMTYPE>( p2.getX() ) - x1 ),
+		y1 + t * ( static_cast<HOMOG2D_INUMTYPE>( p2.getY() ) - y1 )
+	);
+}
+
+//------------------------------------------------------------------
+/// Returns the point at curvilinear abscissa \c s (distance from first point, along the polyline), O(log n)
+/**
+- For open polylines, \c s must be in [0,length()], throws otherwise.
+- For closed polylines, \c s is taken modulo the length, so any value can be used (negative values go backwards).
+
+Throws if the polyline has less than 2 points.
+
+The cumulated lengths of the segments are computed on first call and stored with the other attributes,
+so each query is then done by a binary search.
+
+\sa segmentAt()
+*/
+template<typename PLT,typename FPT>
+template<typename T>
+Point2d_<FPT>
+PolylineBase<PLT,FPT>::pointAt( T s ) const
+{
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	auto s0 = static_cast<HOMOG2D_INUMTYPE>( s );
+	auto seg = p_locateAbscissa( s0 );
+	return p_interpolate( seg, s0 );
+}
+
+//------------------------------------------------------------------
+/// Returns the index of the segment holding the point at curvilinear abscissa \c s, O(log n)
+/**
+Same conventions as pointAt() for \c s.
+If the point is a vertex of the polyline, this returns the segment starting at that point
+(or the last segment, for the end point of an open polyline).
+Use getSegment() to get the segment itself.
+*/
+template<typename PLT,typename FPT>
+template<typename T>
+size_t
+PolylineBase<PLT,FPT>::segmentAt( T s ) const
+{
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	auto s0 = static_cast<HOMOG2D_INUMTYPE>( s );
+	return p_locateAbscissa( s0 );
+}
+
+//------------------------------------------------------------------
+/// Private member function, replaces points by \c nb points equally spaced by \c step, from the first point, O(n+nb)
+/**
+For open polylines, the last point is added.
+*/
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::p_resample( size_t nb, HOMOG2D_INUMTYPE step )
+{
+	const auto& idx = p_getArcIndex();
+	std::vector<Point2d_<FPT>> vout;
+	vout.reserve( nb+1 );
+	auto add = [&vout]( const Point2d_<FPT>& pt )    // lambda
+	{
+		if( vout.empty() || vout.back() != pt )
+			vout.push_back( pt );
+	};
+
+	size_t seg = 0;
+	for( size_t k=0; k<nb; k++ )
+	{
+		auto s = step * k;
+		while( seg+1 < idx.nbSegs() && idx.at(seg+1) <= s )
+			seg++;
+		add( p_interpolate( seg, s ) );
+	}
+	if( !isClosed() )
+		add( _plinevec.back() );
+	while( vout.size() > 1 && vout.front() == vout.back() )
+		vout.pop_back();
+
+	std::swap( _plinevec, vout );
+	_plIsNormalized = false;
+	_attribs.setBad();
+}
+
+//------------------------------------------------------------------
+/// Replaces the points by points equally spaced by \c step along the polyline, starting from first point, O(n)
+/**
+For open polylines, the last point is kept, so the last segment can be shorter than \c step.
+For closed polylines, so can be the one going back to the first point.
+
+Throws if \c step is not strictly positive, or if the polyline has a null length.
+
+\sa resampleToCount()
+*/
+template<typename PLT,typename FPT>
+template<typename T>
+void
+PolylineBase<PLT,FPT>::resample( T step )
+{
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	auto step0 = static_cast<HOMOG2D_INUMTYPE>( step );
+	if( step0 <= 0. )
+		HOMOG2D_THROW_ERROR_1( "invalid value: step=" << step0 << ", must be >0" );
+	if( size() < 2 )
+		return;
+	auto len = p_getArcIndex().total();
+	if( len < thr::nullDistance() )
+		HOMOG2D_THROW_ERROR_1( "unable, polyline has null length" );
+
+	auto nb = static_cast<size_t>( len / step0 ) + 1;
+	if( len - step0 * (nb-1) < thr::nullDistance() )  // would be equal to first point (closed) or last point (open)
+		nb--;
+	p_resample( nb, step0 );
+}
+
+//------------------------------------------------------------------
+/// Replaces the points by \c nbPts points equally spaced along the polyline, starting from first point, O(n)
+/**
+For open polylines, the first and last points are kept.
+
+\sa resample()
+*/
+template<typename PLT,typename FPT>
+void
+PolylineBase<PLT,FPT>::resampleToCount( size_t nbPts )
+{
+	size_t nbMin = ( isClosed() ? 3 : 2 );
+	if( nbPts < nbMin )
+		HOMOG2D_THROW_ERROR_1( "invalid value: nbPts=" << nbPts << ", minimum is " << nbMin );
+	if( size() < 2 )
+		return;
+	auto len = p_getArcIndex().total();
+	if( len < thr::nullDistance() )
+		HOMOG2D_THROW_ERROR_1( "unable, polyline has null length" );
+
+	if( isClosed() )
+		p_resample( nbPts, len / nbPts );
+	else
+		p_resample( nbPts-1, len / (nbPts-1) );
+}
+
+//------------------------------------------------------------------
+/// Clips the closed polyline against a rectangle, using the Sutherland-Hodgman algorithm, O(n)
+/**
+Returns an empty polyline if the polygon lies outside the rectangle.
+
+The points are processed as a stream, so no intermediate polygon is built.
+As usual with this algorithm, when a non-convex polygon is split into several parts by the clipping,
+these parts are joined by segments lying on the rectangle borders.
+*/
+template<typename PLT,typename FPT>
+template<typename FPT2>
+PolylineBase<typ::IsClosed,FPT>
+PolylineBase<PLT,FPT>::impl_clip( const FRect_<FPT2>& rect, const detail::PlHelper<typ::IsClosed>& ) const
+{
+	PolylineBase<typ::IsClosed,FPT> out;
+	if( size() < 3 )
+		return out;
+
+	priv::clip::Window win( rect );
+	out._plinevec.reserve( size() + 4 );
+	priv::clip::SHClipper<FPT> clipper( win, out._plinevec );
+	for( const auto& pt: _plinevec )
+		clipper.addPoint( pt );
+	clipper.close();
+
+	if( out._plinevec.size() < 3 )
+		out._plinevec.clear();
+	return out;
+}
+
+//------------------------------------------------------------------
+/// Clips the open polyline against a rectangle, using the Liang-Barsky algorithm on each segment, O(n)
+/**
+Returns the parts of the polyline that are inside the rectangle, as a vector of open polylines
+(empty if none).
+*/
+template<typename PLT,typename FPT>
+template<typename FPT2>
+std::vector<PolylineBase<typ::IsOpen,FPT>>
+PolylineBase<PLT,FPT>::impl_clip( const FRect_<FPT2>& rect, const detail::PlHelper<typ::IsOpen>& ) const
+{
+	std::vector<PolylineBase<typ::IsOpen,FPT>> vout;
+	priv::clip::Window win( rect );
+	bool isContinued = false;      // true if the last segment ended inside
+	for( size_t i=0; i<nbSegs(); i++ )
+	{
+		const auto& pt1 = _plinevec[i];
+		const auto& pt2 = _plinevec[i+1];
+		HOMOG2D_INUMTYPE x0 = pt1.getX();
+		HOMOG2D_INUMTYPE y0 = pt1.getY();
+		HOMOG2D_INUMTYPE dx = pt2.getX() - x0;
+		HOMOG2D_INUMTYPE dy = pt2.getY() - y0;
+		HOMOG2D_INUMTYPE t0, t1;
+		if( !priv::clip::liangBarsky( x0, y0, dx, dy, win, t0, t1 ) )
+		{
+			isContinued = false;
+			continue;
+		}
+		if( !isContinued || t0 > 0. )
+		{
+			vout.emplace_back();
+			vout.back()._plinevec.push_back( t0 == 0. ? pt1 : Point2d_<FPT>( x0 + t0*dx, y0 + t0*dy ) );
+		}
+		auto& vpts = vout.back()._plinevec;
+		auto pt = ( t1 == 1. ? pt2 : Point2d_<FPT>( x0 + t1*dx, y0 + t1*dy ) );
+		if( pt != vpts.back() )
+			vpts.push_back( pt );
+		else
+			if( vpts.size() == 1 )
+				vout.pop_back();
+		isContinued = ( t1 == 1. );
+	}
+	return vout;
+}
+
+//------------------------------------------------------------------
+/// Returns true if two non-adjacent segments intersect, by checking all the pairs, O(n^2).
+/// Reference implementation for isSimple(), only used for testing.
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::p_hasCrossingsBruteForce() const
+{
+	const auto segs = getSegsView();
+	auto nbs = segs.size();
+	for( size_t i=0; i<nbs; i++ )
+	{
+		auto seg1 = segs[i];
+		auto lastone = i==0?nbs-1:nbs;
+		for( auto j=i+2; j<lastone; j++ )
+			if( segs[j].intersects(seg1)() )
+				return true;
+	}
+	return false;
+}
+//------------------------------------------------------------------
+/// Returns true if one of the two segments joined at point \c idx intersects a non-adjacent segment, O(n).
+/**
+Used by replacePoint() to update the "simple" status of a polygon, same test as p_hasCrossingsBruteForce().
+*/
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::p_hasCrossingsAround( size_t idx ) const
+{
+	const auto segs = getSegsView();
+	auto nbs = segs.size();
+	for( auto i: { ( idx==0 ? nbs-1 : idx-1 ), idx } )
+	{
+		auto seg1 = segs[i];
+		for( size_t j=0; j<nbs; j++ )
+		{
+			auto d = ( i>j ? i-j : j-i );
+			if( d > 1 && d != nbs-1 )         // skip same and adjacent segments
+				if( segs[j].intersects(seg1)() )
+					return true;
+		}
+	}
+	return false;
+}
+
+//------------------------------------------------------------------
+/// Returns true if polygon is convex
+/**
+The result is stored along with the other attributes of the polyline.
+Once the polygon is known to be convex, these queries use O(log n) algorithms (see priv::ConvexIndex):
+Point2d_::isInside(), getExtremePoint(), distTo() and intersects() with a line.
+*/
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::isConvex() const
+{
+	if( _attribs._isConvex.isBad() )
+		_attribs._isConvex.set( p_isConvex() );
+	return _attribs._isConvex.value();
+}
+
+//------------------------------------------------------------------
+/// Returns true if polygon is convex, see isConvex()
+/**
+This implies that:
+ - the Polyline is a Polygon
+ - cross product of consecutive points have same sign
+ (see https://stackoverflow.com/a/1881201/193789 )
+
+\todo 20221120: as points are homogeneous, the cross product can probably be computed
+in a different way (quicker? simpler?).
+Need to check this.
+
+\todo 20250127: use crossProduct free function with base::SegVec args
+*/
+template<typename PLT,typename FPT>
+bool
+PolylineBase<PLT,FPT>::p_isConvex() const
+{
+	if( !isSimple() )
+		return false;
+
+	int8_t sign = 0;
+	const auto& vpts = getPts();
+	if( vpts.size() == 3 )   // 3 pts => always convex
+		return true;
+
+	for( size_t i=0; i<vpts.size(); i++ )
+	{
+		const auto& pt0 = vpts[ i==0?vpts.size()-1:i-1 ];
+		const auto& pt1 = vpts[ i ];
+		const auto& pt2 = vpts[ i==vpts.size()-1?0:i+1 ];
+		auto dx1 = pt1.getX() - pt0.getX();
+		auto dy1 = pt1.getY() - pt0.getY();
+
+		auto dx2 = pt2.getX() - pt1.getX();
+		auto dy2 = pt2.getY() - pt1.getY();
+
+		auto crossproduct = dx1*dy2 - dy1*dx2;
+		if( sign == 0 )                          // initial sign value
+			sign = (crossproduct>0 ? +1 : -1);
+		else
+			if (sign != (crossproduct>0 ? +1 : -1) )
+				return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------
+/// Returns length of Polyline
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineBase<PLT,FPT>::length() const
+{
+	if( _attribs._length.isBad() )
+	{
+#ifdef HOMOG2D_VECTORIZE
+		auto sum = priv::reduc::reduce<priv::reduc::Sum::Length>( size(), p_getCoords(), isClosed() )[0];
+#else
+		HOMOG2D_INUMTYPE sum = 0.;
+		for( const auto& seg: getSegsView() )
+			sum += static_cast<HOMOG2D_INUMTYPE>( seg.length() );
+#endif
+		_attribs._length.set( sum );
+	}
+	return _attribs._length.value();
+}
+
+//------------------------------------------------------------------
+/// Returns area of polygon (computed only if necessary)
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineBase<PLT,FPT>::area() const
+{
+	if( !isSimple() )  // implies that is both closed and has no intersections
+		return 0.;
+
+	return homog2d_abs( p_ComputeSignedArea() );
+}
+
+//------------------------------------------------------------------
+/// Compute and returns signed area (used in area() and in centroid() ), computed only if necessary
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineBase<PLT,FPT>::p_ComputeSignedArea() const
+{
+	if( _attribs._signedArea.isBad() )
+	{
+#ifdef HOMOG2D_VECTORIZE
+		auto area = priv::reduc::reduce<priv::reduc::Sum::Area>( size(), p_getCoords(), true )[0];
+#else
+		HOMOG2D_INUMTYPE area = 0.;
+		for( size_t i=0; i<size(); i++ )
+		{
+			auto j = (i == size()-1 ? 0 : i+1);
+			area += priv::shoelaceTerm( _plinevec[i], _plinevec[j] );
+		}
+#endif
+		_attribs._signedArea.set( area / 2. );
+	}
+	return _attribs._signedArea.value();
+}
+
+//------------------------------------------------------------------
+/// Triangulation of polygon, returns the triangles as triplets of indexes of the points (see getPts())
+/**
+- complexity: O(n.log(n)), using a decomposition into y-monotone polygons
+- a polygon of \c n points gives \c n-2 triangles (less if some points are repeated), with same orientation as the polygon
+- throws if the polygon is not simple
+
+\sa priv::triangulatePolygon()
+*/
+template<typename PLT,typename FPT>
+std::vector<std::array<size_t,3>>
+base::PolylineBase<PLT,FPT>::triangulate() const
+{
+	if( !isSimple() )
+		HOMOG2D_THROW_ERROR_1( "unable, Polyline object is not simple" );
+
+	return priv::triangulatePolygon( _plinevec, p_ComputeSignedArea() > 0. );
+}
+
+//------------------------------------------------------------------
+/// Compute centroid of polygon
+/**
+ref: https://en.wikipedia.org/wiki/Centroid#Of_a_polygon
+
+\warning: centroid CAN be outside of polygon!
+*/
+template<typename PLT,typename FPT>
+Point2d_<HOMOG2D_INUMTYPE>
+base::PolylineBase<PLT,FPT>::centroid() const
+{
+	if( !isSimple() )
+		HOMOG2D_THROW_ERROR_1( "unable, Polyline object is not simple" );
+
+	if( _attribs._centroid.isBad() )
+	{
+#ifdef HOMOG2D_VECTORIZE
+		auto sums = priv::reduc::reduce<priv::reduc::Sum::Centroid>( size(), p_getCoords(), true );
+		_attribs._signedArea.set( sums[0] / 2. );
+		auto c = Point2d_<HOMOG2D_INUMTYPE>(
+			_plinevec[0].getX() + sums[1] / ( 3. * sums[0] ),
+			_plinevec[0].getY() + sums[2] / ( 3. * sums[0] )
+		);
+#else
+		HOMOG2D_INUMTYPE cx = 0.;
+		HOMOG2D_INUMTYPE cy = 0.;
+		for( size_t i=0; i<size(); i++ )
+		{
+			auto j = (i == size()-1 ? 0 : i+1);
+			const auto& pt1 = _plinevec[i];
+			const auto& pt2 = _plinevec[j];
+			auto x1 = pt1.getX();
+			auto x2 = pt2.getX();
+			auto y1 = pt1.getY();
+			auto y2 = pt2.getY();
+
+			auto prod = x1*y2 - x2*y1;
+			cx += (x1+x2) * prod;
+			cy += (y1+y2) * prod;
+		}
+		auto signedArea = p_ComputeSignedArea();
+		cx /= (6. * signedArea);
+		cy /= (6. * signedArea);
+
+		auto c = Point2d_<HOMOG2D_INUMTYPE>( cx, cy );
+#endif
+		_attribs._centroid.set( c );
+	}
+	return _attribs._centroid.value();
+}
+
+//------------------------------------------------------------------
+/// Normalization of CPolyline_
+/**
+Two tasks:
+- rotating so that the smallest one is first
+- for closed polylines: constant orientation
+
+\note: is \c const, although it moves the points, but all the attributes are the same
+(done by declaring the vector of points as \c mutable).
+
+Reference for the orientation:
+- http://www.faqs.org/faqs/graphics/algorithms-faq/
+Subject 2.07: How do I find the orientation of a simple polygon?
+- https://en.wikipedia.org/wiki/Curve_orientation#Orientation_of_a_simple_polygon
+*/
+template<typename PLT,typename FPT>
+void
+base::PolylineBase<PLT,FPT>::p_normalizePoly() const
+{
+	if( size() == 0 )
+		return;
+
+	if( !_plIsNormalized )
+	{
+		_attribs._bvh.clear();  // points are reordered
+		_attribs._arcIndex.clear();
+		_attribs._convex.clear();
+		if constexpr ( std::is_same_v<PLT,typ::IsClosed> )
+		{
+			auto minpos = std::min_element( _plinevec.begin(), _plinevec.end() );
+			std::rotate( _plinevec.begin(), minpos, _plinevec.end() );
+
+			auto ptB = _plinevec[0];
+			auto ptA = _plinevec[1];
+			auto ptC = _plinevec[size()-1];
+
+			HOMOG2D_INUMTYPE xA = ptA.getX();
+			HOMOG2D_INUMTYPE xB = ptB.getX();
+			HOMOG2D_INUMTYPE xC = ptC.getX();
+			HOMOG2D_INUMTYPE yA = ptA.getY();
+			HOMOG2D_INUMTYPE yB = ptB.getY();
+			HOMOG2D_INUMTYPE yC = ptC.getY();
+
+			auto det = (xB-xA)*(yC-yA) - (xC-xA)*(yB-yA);
+			if( det < 0)
+			{
+				p_reversePts();
+				minpos = std::min_element( _plinevec.begin(), _plinevec.end() );
+				std::rotate( _plinevec.begin(), minpos, _plinevec.end() );
+			}
+		}
+		else
+		{
+			if( _plinevec.back() < _plinevec.front() )
+				p_reversePts();
+		}
+		_plIsNormalized=true;
+	}
+}
+
+} // namespace base
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - CLASS PolylineSoA (COLUMNAR STORAGE POLYLINE)
+/////////////////////////////////////////////////////////////////////////////
+
+namespace priv {
+
+//------------------------------------------------------------------
+/// Read-only view on a contiguous array of values (pointer + size), a C++17 stand-in for \c std::span
+/**
+\warning The view is invalidated if the object that owns the data is modified
+*/
+template<typename T>
+class ArrView
+{
+private:
+	const T* _data = nullptr;
+	size_t   _size = 0;
+
+public:
+	using value_type = T;
+
+	ArrView() = default;
+	ArrView( const T* data, size_t siz ): _data(data), _size(siz)
+	{}
+
+	size_t   size()  const { return _size; }
+	bool     empty() const { return _size == 0; }
+	const T* data()  const { return _data; }
+	const T* begin() const { return _data; }
+	const T* end()   const { return _data + _size; }
+
+	const T& operator [] ( size_t idx ) const
+	{
+		HOMOG2D_DEBUG_ASSERT( idx < _size, "invalid index " << idx << ", size=" << _size );
+		return _data[idx];
+	}
+};
+
+} // namespace priv
+
+template<typename FPT1,typename FPT2,typename PLT>
+auto
+operator * ( const Homogr_<FPT2>&, const base::PolylineSoA<PLT,FPT1>& ) -> base::PolylineSoA<PLT,FPT1>;
+
+namespace base {
+
+//------------------------------------------------------------------
+/// Polyline with columnar ("Structure of Arrays") storage, will be instanciated
+/// either as \ref OPolylineSoA_ or \ref CPolylineSoA_
+/**
+Points are stored as two contiguous arrays of cartesian coordinates, instead of a vector of
+homogeneous points (3 values and a flag each). This is meant for very large polylines, where
+the reductions (length, area, bounding box, centroid) are memory-bound.
+
+The coordinates are exposed as read-only views with getXs() and getYs().
+The rest of the polyline API is available through getPolyline(), that builds a regular
+base::PolylineBase object.
+
+template args:
+ - PLT: PolyLine Type: typ::IsClosed or typ::IsOpen
+ - FPT: Floating Point Type
+*/
+template<typename PLT,typename FPT>
+class PolylineSoA
+{
+public:
+	using FType = FPT;
+
+private:
+	std::vector<FPT> _vx;
+	std::vector<FPT> _vy;
+	mutable priv::PolylineAttribs _attribs;    ///< Attributes. Will get stored upon computing.
+
+	template<typename FPT1,typename FPT2,typename PLT2>
+	friend auto
+	h2d::operator * ( const Homogr_<FPT2>&, const PolylineSoA<PLT2,FPT1>& ) -> PolylineSoA<PLT2,FPT1>;
+
+public:
+/// \name Constructors
+///@{
+
+/// Default constructor
+	PolylineSoA() = default;
+
+/// Constructor from a vector/array/list of points
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	PolylineSoA( const T& vec )
+	{
+		set( vec );
+	}
+
+/// Constructor from a regular polyline (must be of same type: open or closed)
+	template<typename FPT2>
+	PolylineSoA( const PolylineBase<PLT,FPT2>& pl )
+	{
+		set( pl.getPts() );
+	}
+///@}
+
+/// \name Attributes access
+///@{
+
+/// Returns the number of points
+	size_t size() const { return _vx.size(); }
+
+	constexpr bool isClosed() const
+	{
+		return std::is_same_v<PLT,typ::IsClosed>;
+	}
+
+/// Returns the number of segments. If "closed", the last segment (going from last to first point) is counted
+	size_t nbSegs() const
+	{
+		if( size() < 2 )
+			return 0;
+		if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+			return size();
+		else
+			return size() - 1;
+	}
+
+	HOMOG2D_INUMTYPE           length()   const;
+	HOMOG2D_INUMTYPE           area()     const;
+	bool                       isSimple() const;
+	FRect_<HOMOG2D_INUMTYPE>   getBB()    const;
+	Point2d_<HOMOG2D_INUMTYPE> centroid() const;
+///@}
+
+/// \name Data access
+///@{
+
+/// Returns a view on the x coordinates
+	priv::ArrView<FPT> getXs() const
+	{
+		return priv::ArrView<FPT>( _vx.data(), _vx.size() );
+	}
+/// Returns a view on the y coordinates
+	priv::ArrView<FPT> getYs() const
+	{
+		return priv::ArrView<FPT>( _vy.data(), _vy.size() );
+	}
+
+/// Returns one point of the polyline.
+	Point2d_<FPT> getPoint( size_t idx ) const
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( idx >= size() )
+			HOMOG2D_THROW_ERROR_1( "requesting point " << idx
+				<< ", only has "  << size()
+			);
+#endif
+		return Point2d_<FPT>( _vx[idx], _vy[idx] );
+	}
+
+/// Returns segment \c idx of the polyline (the one between point \c idx and point \c idx+1)
+	Segment_<FPT> getSegment( size_t idx ) const
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( idx >= nbSegs() )
+			HOMOG2D_THROW_ERROR_1( "requesting segment " << idx
+				<< ", only has "  << nbSegs()
+			);
+#endif
+		auto next = ( idx+1 == size() ? 0 : idx+1 );
+		return Segment_<FPT>( _vx[idx], _vy[idx], _vx[next], _vy[next] );
+	}
+
+/// Returns (as a copy) the points
+	std::vector<Point2d_<FPT>> getPts() const
+	{
+		std::vector<Point2d_<FPT>> out;
+		out.reserve( size() );
+		for( size_t i=0; i<size(); i++ )
+			out.emplace_back( _vx[i], _vy[i] );
+		return out;
+	}
+
+/// Returns an equivalent regular polyline object, giving access to the whole polyline API
+	PolylineBase<PLT,FPT> getPolyline() const
+	{
+		return PolylineBase<PLT,FPT>( getPts() );
+	}
+///@}
+
+/// \name Modifiers (non-const member functions)
+///@{
+
+/// Clear all (does not change the "open/close" status).
+	void clear()
+	{
+		_vx.clear();
+		_vy.clear();
+		_attribs.setBad();
+	}
+
+/// Translate Polyline using \c dx, \c dy
+	template<typename TX,typename TY>
+	void translate( TX dx, TY dy )
+	{
+		HOMOG2D_CHECK_IS_NUMBER( TX );
+		HOMOG2D_CHECK_IS_NUMBER( TY );
+		for( auto& x: _vx )
+			x += dx;
+		for( auto& y: _vy )
+			y += dy;
+		_attribs.applyIsometry(
+			[dx,dy]           // lambda
+			( const Point2d_<HOMOG2D_INUMTYPE>& pt )
+			{
+				return Point2d_<HOMOG2D_INUMTYPE>( pt.getX() + dx, pt.getY() + dy );
+			},
+			false
+		);
+	}
+
+/// Set from vector/array/list of points (discards previous points)
+/**
+- nb of elements must be 0 or 2 or more
+- same checks as base::PolylineBase::set()
+*/
+	template<
+		typename CONT,
+		typename std::enable_if<
+			trait::IsContainer<CONT>::value,
+			CONT
+		>::type* = nullptr
+	>
+	void set( const CONT& vec )
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( vec.size() == 1 )
+			HOMOG2D_THROW_ERROR_1( "Invalid: number of points must be 0, 2 or more" );
+		if( vec.size() > 1 )
+		{
+			for( auto it=vec.begin(); it!=std::prev(vec.end()); it++ )
+				if( *it == *std::next(it) )
+					HOMOG2D_THROW_ERROR_1(
+						"cannot add two consecutive identical points:\npt:" << *it
+						<< " in set of size " << vec.size()
+					);
+			if( vec.front() == vec.back() )
+				HOMOG2D_THROW_ERROR_1(
+					"cannot add first point equal to last point:\npt:" << vec.front()
+					<< " in set of size " << vec.size()
+				);
+		}
+#endif
+		_attribs.setBad();
+		_vx.resize( vec.size() );
+		_vy.resize( vec.size() );
+		size_t i = 0;
+		for( const auto& pt: vec )
+		{
+			_vx[i]   = pt.getX();
+			_vy[i++] = pt.getY();
+		}
+	}
+///@}
+
+private:
+	HOMOG2D_INUMTYPE p_ComputeSignedArea() const;
+
+#ifdef HOMOG2D_VECTORIZE
+/// Returns a function object giving the coordinates of a point, used for the reductions
+	auto p_getCoords() const
+	{
+		return [this]( size_t i, HOMOG2D_INUMTYPE& x, HOMOG2D_INUMTYPE& y )    // lambda
+		{
+			x = _vx[i];
+			y = _vy[i];
+		};
+	}
+#endif
+
+}; // class PolylineSoA
+
+//------------------------------------------------------------------
+/// Returns length of Polyline
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineSoA<PLT,FPT>::length() const
+{
+	if( _attribs._length.isBad() )
+	{
+#ifdef HOMOG2D_VECTORIZE
+		auto sum = priv::reduc::reduce<priv::reduc::Sum::Length>( size(), p_getCoords(), std::is_same_v<PLT,typ::IsClosed> )[0];
+#else
+		HOMOG2D_INUMTYPE sum = 0.;
+		if( size() > 1 )
+		{
+			for( size_t i=0; i<size()-1; i++ )
+				sum += std::hypot(
+					static_cast<HOMOG2D_INUMTYPE>( _vx[i+1] ) - _vx[i],
+					static_cast<HOMOG2D_INUMTYPE>( _vy[i+1] ) - _vy[i]
+				);
+			if constexpr( std::is_same_v<PLT,typ::IsClosed> )
+				sum += std::hypot(
+					static_cast<HOMOG2D_INUMTYPE>( _vx.front() ) - _vx.back(),
+					static_cast<HOMOG2D_INUMTYPE>( _vy.front() ) - _vy.back()
+				);
+		}
+#endif
+		_attribs._length.set( sum );
+	}
+	return _attribs._length.value();
+}
+
+//------------------------------------------------------------------
+/// Returns true if object is a polygon (closed, and no segment crossing), see priv::hasCrossingsSweep()
+template<typename PLT,typename FPT>
+bool
+PolylineSoA<PLT,FPT>::isSimple() const
+{
+	if( size()<3 )
+		return false;
+	if constexpr( std::is_same_v<PLT,typ::IsOpen> )
+		return false;
+	else
+	{
+		if( _attribs._isSimplePolyg.isBad() )
+			_attribs._isSimplePolyg.set( !priv::hasCrossingsSweep( _vx, _vy ) );   // directly on the arrays, no copy
+		return _attribs._isSimplePolyg.value();
+	}
+}
+
+//------------------------------------------------------------------
+/// Compute and returns signed area (used in area() and in centroid() )
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineSoA<PLT,FPT>::p_ComputeSignedArea() const
+{
+#ifdef HOMOG2D_VECTORIZE
+	auto area = priv::reduc::reduce<priv::reduc::Sum::Area>( size(), p_getCoords(), true )[0];
+#else
+	HOMOG2D_INUMTYPE area = 0.;
+	for( size_t i=0; i<size(); i++ )
+	{
+		auto j = (i == size()-1 ? 0 : i+1);
+		area += static_cast<HOMOG2D_INUMTYPE>( _vx[i] ) * _vy[j];
+		area -= static_cast<HOMOG2D_INUMTYPE>( _vy[i] ) * _vx[j];
+	}
+#endif
+	return area / 2.;
+}
+
+//------------------------------------------------------------------
+/// Returns area of polygon (computed only if necessary)
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+PolylineSoA<PLT,FPT>::area() const
+{
+	if( !isSimple() )
+		return 0.;
+
+	if( _attribs._signedArea.isBad() )
+		_attribs._signedArea.set( p_ComputeSignedArea() );
+	return homog2d_abs( _attribs._signedArea.value() );
+}
+
+//------------------------------------------------------------------
+/// Returns Bounding Box of Polyline (single pass on each coordinate array)
+template<typename PLT,typename FPT>
+FRect_<HOMOG2D_INUMTYPE>
+PolylineSoA<PLT,FPT>::getBB() const
+{
+	HOMOG2D_START;
+#ifndef HOMOG2D_NOCHECKS
+	if( size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "cannot compute bounding box of empty Polyline" );
+#endif
+	auto mm_x = std::minmax_element( _vx.begin(), _vx.end() );
+	auto mm_y = std::minmax_element( _vy.begin(), _vy.end() );
+	Point2d_<HOMOG2D_INUMTYPE> p1( *mm_x.first,  *mm_y.first  );
+	Point2d_<HOMOG2D_INUMTYPE> p2( *mm_x.second, *mm_y.second );
+#ifndef HOMOG2D_NOCHECKS
+	if( shareCommonCoord( p1, p2 ) )
+		HOMOG2D_THROW_ERROR_1( "unable, points share common coordinate" );
+#endif
+	return FRect_<HOMOG2D_INUMTYPE>( p1, p2 );
+}
+
+//------------------------------------------------------------------
+/// Compute centroid of polygon
+/// \sa PolylineBase::centroid()
+template<typename PLT,typename FPT>
+Point2d_<HOMOG2D_INUMTYPE>
+PolylineSoA<PLT,FPT>::centroid() const
+{
+	if( !isSimple() )
+		HOMOG2D_THROW_ERROR_1( "unable, Polyline object is not simple" );
+
+	if( _attribs._centroid.isBad() )
+	{
+#ifdef HOMOG2D_VECTORIZE
+		auto sums = priv::reduc::reduce<priv::reduc::Sum::Centroid>( size(), p_getCoords(), true );
+		_attribs._signedArea.set( sums[0] / 2. );
+		HOMOG2D_INUMTYPE cx = _vx[0] + sums[1] / ( 3. * sums[0] );
+		HOMOG2D_INUMTYPE cy = _vy[0] + sums[2] / ( 3. * sums[0] );
+#else
+		HOMOG2D_INUMTYPE cx = 0.;
+		HOMOG2D_INUMTYPE cy = 0.;
+		for( size_t i=0; i<size(); i++ )
+		{
+			auto j = (i == size()-1 ? 0 : i+1);
+			HOMOG2D_INUMTYPE x1 = _vx[i];
+			HOMOG2D_INUMTYPE x2 = _vx[j];
+			HOMOG2D_INUMTYPE y1 = _vy[i];
+			HOMOG2D_INUMTYPE y2 = _vy[j];
+
+			auto prod = x1*y2 - x2*y1;
+			cx += (x1+x2) * prod;
+			cy += (y1+y2) * prod;
+		}
+		auto signedArea = p_ComputeSignedArea();
+		cx /= (6. * signedArea);
+		cy /= (6. * signedArea);
+#endif
+		_attribs._centroid.set( Point2d_<HOMOG2D_INUMTYPE>( cx, cy ) );
+	}
+	return _attribs._centroid.value();
+}
+
+} // namespace base
+
+//------------------------------------------------------------------
+/// Rotates the rectangle by either 90°, 180°, 270° (-90°) at point \c refpt
+/**
+For an arbitrary angle \c alpha (rad.), you can write:
+```
+auto r2 = Homogr(alpha) * rect;
+```
+\sa FRect_<FPT>::rotate( Rotate )
+\sa h2d::rotate()
+*/
+template<typename FPT>
+template<typename FPT2>
+void
+FRect_<FPT>::rotate( Rotate rot, const Point2d_<FPT2>& refpt )
+{
+	translate( -refpt.getX(), -refpt.getY() );
+	this->rotate( rot );
+	translate( refpt.getX(), refpt.getY() );
+}
+
+//------------------------------------------------------------------
+/// Rotates the rectangle by either 90°, 180°, 270° (-90°) at point (0,0)
+/**
+For an arbitrary angle \c alpha (rad.), you can write:
+```
 auto r2 = Homogr(alpha) * rect;
 ```
 \sa FRect_<FPT>::rotate( Rotate, const Point2d_<FPT2>& )
 \sa h2d::rotate()
 
-\note This function converts the FRect to a CPolyline_, rotates it, and builds the output rectangle
-by getting the bounding box.
-This is because we cannot directly rotate the points, because the two points of a FRect_ are switched so that
-the smallest point is always in _ptR1.
-*/
-template<typename FPT>
-void
-FRect_<FPT>::rotate( Rotate rot )
+\note This function converts the FRect to a CPolyline_, rotates it, and builds the output rectangle
+by getting the bounding box.
+This is because we cannot directly rotate the points, because the two points of a FRect_ are switched so that
+the smallest point is always in _ptR1.
+*/
+template<typename FPT>
+void
+FRect_<FPT>::rotate( Rotate rot )
+{
+	CPolyline_<HOMOG2D_INUMTYPE> pol( *this );
+	pol.rotate( rot );
+	*this = pol.getBB();
+}
+
+//------------------------------------------------------------------
+/// Returns Rectangle of the intersection area of two rectangles
+/**
+\return An object of type detail::RectArea, that can be checked for success using the ()
+operator, and if success, will hold the resulting FRect_
+
+Algorithm:
+
+4 situations need to be considered, depending on the number of intersection points:
+
+- A: 2 intersection points on same segment => we have 2 points inside.
+\verbatim
+  +------+                   +------+
+  |      |                   |      |
+  |   +--+-----+          +--+----+ |
+  |   |  |     |          |  |    | |
+  |   |  |     |    or    |  |    | |  or ...
+  |   +--+-----+          +--+----+ |
+  |      |                   |      |
+  +------+                   +------+
+\endverbatim
+
+- B: 2 intersection points on different segments => for each rectangle, 1 point is inside the other.
+\verbatim
+  +------+
+  |      |
+  |      |
+  |   +--+-----+
+  |   |  |     |   or ...
+  +---+--+     |
+      |        |
+      +--------+
+\endverbatim
+
+- C: 3 points
+\verbatim
+  +------+-----+
+  |      |     |
+  |      |     |
+  +------+-----+
+  |      |
+  +------+
+\endverbatim
+
+- D: 4 intersection points: the intersection rectangle is made of these 4 points
+\verbatim
+     +------+
+     |      |
+  +--+------+-----+
+  |  |      |     |
+  |  |      |     |
+  +--+------+-----+
+     |      |
+     +------+
+\endverbatim
+*/
+template<typename FPT>
+template<typename FPT2>
+detail::RectArea<FPT>
+FRect_<FPT>::intersectArea( const FRect_<FPT2>& other ) const
+{
+	if( *this == other )                      // if same rectangles, then
+		return detail::RectArea<FPT>(other);  // the intersection area is the rectangle
+
+	auto inter = this->intersects( other );
+
+	if( !inter() )                        // rectangles do not intersect
+	{
+		if( this->isInside( other ) )
+			return detail::RectArea<FPT>(*this);
+		if( other.isInside( *this ) )
+			return detail::RectArea<FPT>(other);
+		return detail::RectArea<FPT>();
+	}
+
+	if( inter.size() < 2 )                // only one intersection point
+		return detail::RectArea<FPT>();   // => no intersection area!
+
+	if( inter.size() == 4 )  // 4 intersection points => case "D"
+		return detail::RectArea<FPT>(FRect_<FPT>( inter.get().at(0), inter.get().at(3) ) );
+
+	if( inter.size() == 3 )  // 3 intersection points => case "C"
+	{
+		auto v = inter.get();
+
+		auto xmin = std::min( v[0].getX(), std::min( v[1].getX(),v[2].getX() ) );
+		auto ymin = std::min( v[0].getY(), std::min( v[1].getY(),v[2].getY() ) );
+		auto xmax = std::max( v[0].getX(), std::max( v[1].getX(),v[2].getX() ) );
+		auto ymax = std::max( v[0].getY(), std::max( v[1].getY(),v[2].getY() ) );
+#ifndef HOMOG2D_DEBUGMODE
+		assert( xmax-xmin > thr::nullOrthogDistance() );
+		assert( ymax-ymin > thr::nullOrthogDistance() );
+#else
+		HOMOG2D_DEBUG_ASSERT(
+			( ( xmax-xmin > thr::nullOrthogDistance() )
+			&&
+			( ymax-ymin > thr::nullOrthogDistance() )) ,
+			std::scientific
+			<< "this=" << *this << " other=" << other
+			<< "\nxmax=" << xmax << " xmin=" << xmin
+			<< "\nymax=" << ymax << " ymin=" << ymin
+			<< "\nnod=" << thr::nullOrthogDistance()
+		);
+#endif
+		return detail::RectArea<FPT>( FRect_<FPT>( xmin, ymin, xmax,ymax ) );
+	}
+/*------------------------
+ If we get to this point, we have 2 intersection points
+------------------------*/
+#ifndef HOMOG2D_DEBUGMODE
+	assert( inter.size() == 2 );
+#else
+/*	HOMOG2D_DEBUG_ASSERT(
+		inter.size() == 2,
+		"inter.size()=" << inter.size() << "\n-this=" << *this << "\n-other=" << other
+		<<"\n-inter:" << inter
+	);*/
+#endif
+	const auto& r1 = *this;
+	const auto& r2 = other;
+//	HOMOG2D_LOG( "r1="<<r1 << " r2="<<r2 );
+	auto v1 = r1.p_pointsInside( r2 );
+	auto v2 = r2.p_pointsInside( r1 );
+	auto c1 = v1.size();
+	auto c2 = v2.size();
+//	HOMOG2D_LOG( "c1=" << c1 << " c2=" << c2 );
+
+	if( c1==0 && c2==0 ) // unable, rectangles share a segment
+		return detail::RectArea<FPT>();
+
+	assert(
+		( c1==1 && c2==1 )
+		||
+		( c1==0 && c2==2 )
+		||
+		( c2==0 && c1==2 )
+	);
+	if( c1==1 || c2==1 ) // only 1 point inside => the rectangle is defined by the intersection points
+		return detail::RectArea<FPT>( FRect_<FPT>( inter.get().at(0), inter.get().at(1) ) );
+
+// here: 2 points inside, then build rectangle using the 4 points:
+// the 2 inside, and the two intersection points
+	assert( c1 == 2 || c2 == 2 );
+
+	if( c1 == 2 )
+		return detail::RectArea<FPT>(
+			FRect_<FPT>(
+				inter.get().at(0),
+				inter.get().at(1),
+				v1.at(0),
+				v1.at(1)
+			)
+		);
+	return detail::RectArea<FPT>(
+		FRect_<FPT>(
+			inter.get().at(0),
+			inter.get().at(1),
+			v2.at(0),
+			v2.at(1)
+		)
+	);
+}
+
+namespace priv {
+/// Common stuff for FRect_ union, see FRect_::unionArea()
+namespace runion {
+//------------------------------------------------------------------
+/// Holds x or y coordinate value of rectangle during computation of intersection area
+/**
+- \c T will be the floating-point type
+- used in FRect_<FPT>::unionArea()
+*/
+template<typename T>
+struct Index
+{
+	T       _value;
+	uint8_t _rect_idx=0;   // 0 means none, will be 1 or 2
+
+	Index() = default;
+	Index( T v, uint8_t r )
+		: _value(v), _rect_idx(r)
+	{}
+	friend bool operator < ( const Index& i1, const Index& i2 )
+	{
+
+		if( i1._value == i2._value )
+			return i1._rect_idx < i2._rect_idx;
+		return i1._value < i2._value;
+	}
+	friend std::ostream& operator << ( std::ostream& f, const Index& idx )
+	{
+		f << idx._value << " ";
+		return f;
+	}
+};
+
+/// A wrapper around a bool, that gets set if that point defined
+/// by indexes \c ix and \c iy is a corner in the table
+/**
+used in FRect_<FPT>::unionArea()
+*/
+struct Cell
+{
+	bool _isCorner = false;
+	Cell() = default;
+#ifdef HOMOG2D_DEBUGMODE
+	Cell( bool b ) : _isCorner(b)
+	{}
+#endif
+	template<typename T>
+	Cell( const Index<T>& ix, const Index<T>& iy )
+	{
+		if( ix._rect_idx == iy._rect_idx )
+			_isCorner = true;
+	}
+};
+
+
+using Table  = std::array<std::array<Cell,4>,4>;
+using PCoord = std::pair<uint8_t,uint8_t>;
+
+enum class Direction: uint8_t { N, E, S, W };
+
+/* NEEDED TO DEBUG
+const char* getString( Direction dir )
+{
+	switch( dir )
+	{
+		case Direction::W: return "W"; break;
+		case Direction::S: return "S"; break;
+		case Direction::E: return "E"; break;
+		case Direction::N: return "N"; break;
+	}
+	return 0; // to avoid a warning
+}*/
+
+enum class Turn: uint8_t { Left, Right };
+
+inline
+Direction
+turn( Direction dir, Turn turn )
+{
+	switch( dir )
+	{
+		case Direction::W:
+			return turn == Turn::Left ? Direction::S : Direction::N;
+		case Direction::S:
+			return turn == Turn::Left ? Direction::E : Direction::W;
+		case Direction::E:
+			return turn == Turn::Left ? Direction::N : Direction::S;
+		case Direction::N:
+			return turn == Turn::Left ? Direction::W : Direction::E;
+	}
+	return Direction::N; // to avoid a warning
+}
+
+inline
+void
+moveToNextCell( uint8_t& row, uint8_t& col, const Direction& dir )
+{
+	switch( dir )
+	{
+		case Direction::N: row--; break;
+		case Direction::S: row++; break;
+		case Direction::E: col++; break;
+		case Direction::W: col--; break;
+	}
+}
+
+/// Helper function for FRect_<FPT>::unionArea()
+/**
+- Start from 0,0, direction East
+*/
+inline
+std::vector<PCoord>
+parseTable( Table& table )
+{
+	bool firstTime = true;
+	bool done = false;
+	uint8_t row = 0;
+	uint8_t col = 0;
+	Direction dir = Direction::E;
+	std::vector<PCoord> out;
+	do
+	{
+		if( table[row][col]._isCorner )
+		{
+			auto new_pair = std::make_pair(row,col);
+			if( out.size() > 0 )
+				if( new_pair == out.front() && out.size() > 2 )
+					done = true;
+			if( !done )
+				out.push_back( new_pair );
+			if( firstTime )
+				firstTime = false;
+			else
+				dir = turn( dir, Turn::Right );
+		}
+		else
+		{
+			if( ( row==2 || row==1 ) && ( col==2 || col==1 ) )
+			{
+				out.push_back( std::make_pair(row,col) );
+				dir = turn( dir, Turn::Left );
+			}
+		}
+		moveToNextCell( row, col, dir );
+	}
+	while( !done );
+	return out;
+}
+
+#ifdef HOMOG2D_DEBUGMODE
+inline
+void
+printTable( const Table& t, std::string msg )
+{
+	std::cout << "Table: " << msg << "\n  | ";
+	for( uint8_t r=0;r<4; r++ )
+		std::cout << (int)r << " ";
+	std::cout << "\n--|---------|\n";
+	for( uint8_t r=0;r<4; r++ )
+	{
+		std::cout << (int)r << " | ";
+		for( uint8_t c=0;c<4; c++ )
+			std::cout << (t[r][c]._isCorner?'F':'.') << " ";
+		std::cout << "|\n";
+	}
+}
+#endif
+
+//------------------------------------------------------------------
+/// Helper function, used in FRect_<FPT>::unionArea()
+template<typename FPT>
+inline
+CPolyline_<FPT>
+convertToCoord(
+	const std::vector<PCoord>&      v_coord, ///< vector of coordinate indexes
+	const std::array<Index<FPT>,4>& v_x,      ///< holds x-coordinates
+	const std::array<Index<FPT>,4>& v_y       ///< holds y-coordinates
+)
+{
+	std::vector<Point2d_<FPT>> v_pts;
+	for( const auto& elem: v_coord )
+	{
+		auto id_x = elem.first;
+		auto id_y = elem.second;
+		assert( id_x<4 && id_y<4 );
+
+		auto pt = Point2d_<FPT>( v_x[id_x]._value, v_y[id_y]._value );
+		if( v_pts.empty() )
+			v_pts.push_back( pt );
+		else                             // add to vector only  if not same as previous
+		{                                // and not same as first
+			if( v_pts.back() != pt && v_pts.front() != pt )
+				v_pts.push_back( pt );
+		}
+	}
+//	printVector( v_pts, "polyline" );
+	return CPolyline_<FPT>( v_pts );//, IsClosed::Yes );
+}
+
+} // namespace priv
+} // namespace runion
+//------------------------------------------------------------------
+/// Computes the CPolyline of the union of two rectangles
+/**
+Algorithm:
+ -# build vectors of x and y coordinates (4 elements)
+ -# build table x-y (4x4), with corners tagged
+ -# parse the table by turning right at each corner, and left if position is not one the outside row/col
+ -# convert back indexes to real coordinates, to build the final CPolyline object
+
+Two examples:
+\verbatim
+9      +----+              +-------+
+       |    |              |       |
+8  +---+----+---+      +---+---+   |
+   |   |    |   |      |   |   |   |
+7  +---+----+---+      +---+---+   |
+       |    |              |       |
+6      +----+              +-------+
+   1   2    3   4      1   2   3   4
+\endverbatim
+Step 1 will build (for both situations above):
+ - vx: 1,2,3,4
+ - vy: 6,7,8,9
+
+ Step 2 will build a table showing where the corners are:
+\verbatim
+  | 0 1 2 3             | 0 1 2 3
+--|---------|         --|---------|
+0 | . F F . |          0| . F . F
+1 | F F F F |          1| F F . .
+2 | F F F F |          2| F F . .
+3 | . F F . |          3| . F . F
+\endverbatim
+
+Step 3: parse that table and turn on each corner:
+- left if "inner" corner (row and col = 1 or = 2)
+- right if "outer" corner (row and col = 0 or = 3)
+
+Final step: convert indexes to real coordinates
+
+Special note: if the rectangles have an identical coordinate, as in this example:
+\verbatim
+9      +----+
+       |    |
+8  +---+----+
+   |   |    |
+7  +---+----+
+       |    |
+6      +----+
+   1   2    3
+\endverbatim
+Then the vectors are:
+- vx: 1,2,3,3
+- vy: 6,7,8,9
+
+(notice the duped coordinate)
+
+This will produce a Polyline_ with 2 extra points:<br>
+(1,7)-(1,8)-(2,8)-(2,9)-(3,9)-(3,8)-(3,7)-(3,6)-(2,6)-(2,7)
+<br>instead of:<br>
+(1,7)-(1,8)-(2,8)-(2,9)-(3,9)-(3,6)-(2,6)-(2,7)
+<br>We solve this by proceeding an extra Polyline minimization,
+see PolylineBase::minimize()
+*/
+template<typename FPT>
+template<typename FPT2>
+CPolyline_<FPT>
+FRect_<FPT>::unionArea( const FRect_<FPT2>& other ) const
+{
+	using namespace priv::runion;
+
+	if( *this == other )                  // if same rectangles, then
+		return CPolyline_<FPT>( other );   // returns one of them
+
+	if( !this->intersects(other)() )  // if no intersection,
+	{
+		if( this->isInside( other ) )
+			return CPolyline_<FPT>(other);
+		if( other.isInside( *this ) )
+			return CPolyline_<FPT>(*this);
+		return CPolyline_<FPT>();      // return empty polygon
+	}
+
+/* step 0: make sure the rect with highest x is first.
+ This is needed to avoid this kind of situation in table:
+
+  F F . .
+  . . F F
+  . . F F
+  F F . .
+
+  That would happen if we have an identical x in the two rect
+  (thus, they DO intersect), because when sorting, the rect with smallest index
+  (1 or 2) is placed first in the vector of coordinates */
+	const auto* pr1 = this;
+	const auto* pr2 = &other;
+	if( pr1->getPts().first.getX() < pr2->getPts().first.getX() )
+		std::swap( pr1, pr2 );
+	const auto& r1 = *pr1;
+	const auto& r2 = *pr2;
+
+// step 1: build vectors of coordinates and sort them
+	std::array<Index<FPT>,4> vx, vy;
+	int i=0;
+	vx[i++] = Index<FPT>( r1.getPts().first.getX(),  1 );
+	vx[i++] = Index<FPT>( r1.getPts().second.getX(), 1 );
+	vx[i++] = Index<FPT>( r2.getPts().first.getX(),  2 );
+	vx[i++] = Index<FPT>( r2.getPts().second.getX(), 2 );
+
+	i=0;
+	vy[i++] = Index<FPT>( r1.getPts().first.getY(),  1 );
+	vy[i++] = Index<FPT>( r1.getPts().second.getY(), 1 );
+	vy[i++] = Index<FPT>( r2.getPts().first.getY(),  2 );
+	vy[i++] = Index<FPT>( r2.getPts().second.getY(), 2 );
+
+	std::sort( vx.begin(), vx.end() );
+	std::sort( vy.begin(), vy.end() );
+//	priv::printArray( vx, "vx" ); priv::printArray( vy, "vy");
+
+// step 2: fill table\n";
+	Table table;
+	for( uint8_t r=0;r<4; r++ )
+		for( uint8_t c=0;c<4; c++ )
+			table[r][c] = Cell( vx[r], vy[c] );
+//	printTable( table, "after step 2" );
+
+// step 3: parse table
+	auto vpts = parseTable( table );
+//	priv::printVectorPairs( vpts );
+
+// step 4: convert back vector of coordinates indexes into vector of coordinates
+	auto res1 = convertToCoord( vpts, vx, vy );
+	res1.minimize(); // remove unecessary points
+	return res1;
+}
+
+//------------------------------------------------------------------
+namespace detail {
+
+//------------------------------------------------------------------
+/// See getPtLabel( const Point2d_<FPT>& pt, const Circle_<FPT2>& circle )
+enum class PtTag: uint8_t
+{
+	Inside, Outside, OnEdge
+};
+
+/// Returns a label characterizing point \c pt, related to \c circle: inside, outside, or on edge of circle
+template<typename FPT,typename FPT2>
+PtTag
+getPtLabel( const Point2d_<FPT>& pt, const Circle_<FPT2>& circle )
+{
+	if( pt.isInside( circle ) )
+		return PtTag::Inside;
+	if(
+		homog2d_abs( pt.distTo( circle.center() ) - circle.radius() )
+			< thr::nullDistance()
+	)
+		return PtTag::OnEdge;
+	return PtTag::Outside;
+}
+#if 0
+/// Debug, can be removed after
+void
+printTag( std::string txt, PtTag tag )
+{
+	std::cout << "point " << txt << ": ";
+	switch( tag )
+	{
+		case PtTag::Inside: std::cout << "Inside\n"; break;
+		case PtTag::Outside: std::cout << "Outside\n"; break;
+		case PtTag::OnEdge: std::cout << "OnEdge\n"; break;
+	}
+}
+#endif
+} // namespace detail
+
+namespace base {
+//------------------------------------------------------------------
+/// Segment/Segment intersection
+/**
+Algorithm:<br>
+- first compute the intersection point
+- then check if the intersection point lies in between the range of both segments, both on x and on y
+*/
+template<typename SV,typename FPT>
+template<typename SV2,typename FPT2>
+detail::Intersect<detail::Inters_1,FPT>
+SegVec<SV,FPT>::intersects( const SegVec<SV2,FPT2>& s2 ) const
+{
+//	HOMOG2D_START;
+	if( *this == s2 )              // same segment => no intersection
+		return detail::Intersect<detail::Inters_1,FPT>();
+
+	Line2d_<HOMOG2D_INUMTYPE> l1 = getLine();
+	Line2d_<HOMOG2D_INUMTYPE> l2 = s2.getLine();
+	if( l1.isParallelTo( l2 ) )                            // if parallel,
+		return detail::Intersect<detail::Inters_1,FPT>();  // then, no intersection
+
+	const auto& ptA1 = getPts().first;
+	const auto& ptA2 = getPts().second;
+	const auto& ptB1 = s2.getPts().first;
+	const auto& ptB2 = s2.getPts().second;
+
+	auto ptInter = l1 * l2;   // intersection point
+
+	auto dA1 = ptA1.distTo( ptInter );
+	auto dA2 = ptA2.distTo( ptInter );
+	if( homog2d_abs(dA1+dA2 - length()) < thr::nullDistance() )
+	{
+		auto dB1 = ptB1.distTo( ptInter );
+		auto dB2 = ptB2.distTo( ptInter );
+		if( homog2d_abs(dB1+dB2 - s2.length()) < thr::nullDistance() )
+			return detail::Intersect<detail::Inters_1,FPT>( ptInter );
+	}
+	return detail::Intersect<detail::Inters_1,FPT>(); // no intersection
+}
+
+//------------------------------------------------------------------
+/// Segment/Line intersection
+/**
+Algorithm:<br>
+We check if the intersection point lies in between the range of the segment, both on x and on y
+*/
+template<typename SV,typename FPT>
+template<typename FPT2>
+detail::Intersect<detail::Inters_1,FPT>
+SegVec<SV,FPT>::intersects( const Line2d_<FPT2>& li1 ) const
+{
+//	HOMOG2D_START;
+//	HOMOG2D_LOG( "seg=" << *this << " line=" << li1 );
+	detail::Intersect<detail::Inters_1,FPT> out;
+	auto li2 = getLine();
+
+	if( li1.isParallelTo( li2 ) ) // if parallel, no intersection
+		return out;
+
+	out._ptIntersect = li1 * li2;   // intersection point
+
+	const auto& pi  = out._ptIntersect;
+	const auto& pt1 = getPts().first;
+	const auto& pt2 = getPts().second;
+
+	auto d1 = pt1.distTo( pi );
+	auto d2 = pt2.distTo( pi );
+	if( homog2d_abs(d1+d2-length()) < thr::nullDistance() )
+ 		out._doesIntersect = true;
+
+	return out;
+}
+
+//------------------------------------------------------------------
+/// Segment/Circle intersection
+/**
+For each point of the segment, we need to consider 3 different situations
+ - point is inside (PI)
+ - point is outside (PO)
+ - point is on the edge (PE)
+
+That makes 6 different situations to handle:
+
+ - S1: PI-PI => no intersection
+ - S2: PI-PO => 1 intersection
+ - S3: PI-PE => 1 intersection
+ - S4: PO-PO => depends on the support line:
+  - S4A: if line does NOT intersects circle, no intersection pts
+  - S4B: if line does intersects circle, and intersections point in segment area => 2 intersection pts
+  - S4C: if line does intersects circle, and intersections point NOT in segment area => no intersection pts
+ - S5: PO-PE => 1 intersection
+ - S6: PE-PE => 2 intersections
+*/
+template<typename SV,typename FPT>
+template<typename FPT2>
+detail::IntersectM<FPT>
+SegVec<SV,FPT>::intersects( const Circle_<FPT2>& circle ) const
+{
+//	HOMOG2D_START;
+	using detail::PtTag;
+
+	auto tag_ptS1 = detail::getPtLabel( _ptS1, circle ); // get status of segment points related to circle (inside/outside/on-edge)
+	auto tag_ptS2 = detail::getPtLabel( _ptS2, circle );
+
+	if( tag_ptS1 == PtTag::Inside )
+		if( tag_ptS2 == PtTag::Inside )
+			return detail::IntersectM<FPT>();
+
+	auto int_lc = getLine().intersects( circle );
+	if( !int_lc() )
+		return detail::IntersectM<FPT>();
+
+	auto p_pts = int_lc.get();      // get the line intersection points
+	const auto& p1 = p_pts.first;
+	const auto& p2 = p_pts.second;
+
+	if(                                                            // one inside, the other outside
+		( tag_ptS1 == PtTag::Inside  && tag_ptS2 == PtTag::Outside )
+		||
+		( tag_ptS1 == PtTag::Outside && tag_ptS2 == PtTag::Inside )
+	)
+	{
+		detail::IntersectM<FPT> out;
+
+		auto d1 = _ptS1.distTo( p1 );
+		auto d2 = _ptS2.distTo( p1 );
+		if( homog2d_abs( d1+d2-length() ) < thr::nullDistance() )
+			out.add( p1 );                          // points is inside
+		else
+			out.add( p2 );
+		return out;
+	}
+
+	detail::IntersectM<FPT> out;
+	if( tag_ptS1 == PtTag::Outside && tag_ptS2 == PtTag::Outside ) // both outside
+	{
+		auto d1 = _ptS1.distTo( p1 );
+		auto d2 = _ptS2.distTo( p1 );
+		if( homog2d_abs( d1+d2-length() ) >= thr::nullDistance() )   // if sum of the two distances is higher than length
+			return detail::IntersectM<FPT>();
+
+		out.add( p1 );
+		out.add( p2 );
+		return out;
+	}
+
+	if( tag_ptS1 == PtTag::OnEdge )
+		out.add( _ptS1 );
+	if( tag_ptS2 == PtTag::OnEdge )
+		out.add( _ptS2 );
+
+	return out;
+}
+
+} // namespace base
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - CLASS PolylineBuilder_ (STREAMING SIMPLIFICATION)
+/////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------
+/// Builds open polylines from a stream of points, and simplifies them on the fly
+/**
+Points are added one at a time with addPoint(), so the whole input never needs to be stored.
+A point is dropped if all the points since the last kept one stay at a distance less or equal to
+\c epsilon from the segment joining that last kept point and the new point
+(sliding window version of the Ramer-Douglas-Peucker algorithm).
+
+Memory usage is bounded: besides the output points, at most \c maxWindow points are kept pending.
+When the window is full, its last point is kept, whatever the distances.
+Consecutive identical points are always dropped.
+
+Calling newPolyline() ends the current polyline, so the next points will start a new one.
+This allows using an object of this type as sink of the SVG path parser (see svg::svgp::parsePath() ),
+where a "MoveTo" command starts a new polyline.
+
+The finished polylines are stored, unless a callback function is given with setEmitCallback(): then each one is
+handed to that function, and not stored. They can also be moved out with takePolylines().
+Either way, with an unbounded stream, memory usage then only depends on the current polyline.
+
+\sa PolylineBase::simplify()
+*/
+template<typename FPT>
+class PolylineBuilder_
+{
+private:
+	HOMOG2D_INUMTYPE _epsilon;
+	size_t           _maxWindow;
+	size_t           _nbInputPts = 0;
+	std::vector<Point2d_<FPT>>              _kept;   ///< output points of current polyline
+	std::vector<Point2d_<HOMOG2D_INUMTYPE>> _window; ///< points since last kept one, last one is the candidate end point
+	std::vector<OPolyline_<FPT>>            _done;   ///< previous polylines (if no callback)
+	std::function<void(OPolyline_<FPT>&&)>  _emit;   ///< called with each finished polyline, if set
+
+public:
+/// Constructor
+/**
+\param epsilon maximum distance of a dropped point to the output polyline
+\param maxWindow maximum number of pending points (must be at least 2)
+*/
+	template<typename T=double>
+	explicit PolylineBuilder_( T epsilon=0., size_t maxWindow=64 )
+		: _epsilon( epsilon ), _maxWindow( maxWindow )
+	{
+		HOMOG2D_CHECK_IS_NUMBER(T);
+		if( epsilon < 0 )
+			HOMOG2D_THROW_ERROR_1( "invalid negative value: epsilon=" << epsilon );
+		if( maxWindow < 2 )
+			HOMOG2D_THROW_ERROR_1( "invalid value: maxWindow=" << maxWindow << ", minimum is 2" );
+		_window.reserve( maxWindow );
+	}
+
+/// Adds a point to current polyline
+	template<typename FPT2>
+	void addPoint( const Point2d_<FPT2>& pt )
+	{
+		_nbInputPts++;
+		Point2d_<HOMOG2D_INUMTYPE> newPt( pt );
+		if( _kept.empty() )
+		{
+			_kept.emplace_back( pt );
+			return;
+		}
+		const auto& prev = ( _window.empty() ? Point2d_<HOMOG2D_INUMTYPE>( _kept.back() ) : _window.back() );
+		if( prev == newPt )                     // consecutive identical points
+			return;
+
+		if( _window.size() < _maxWindow && p_windowFits( newPt ) )
+			_window.push_back( newPt );
+		else                                    // last point of window is kept,
+		{                                       //  and becomes the new anchor
+			_kept.emplace_back( _window.back() );
+			_window.clear();
+			_window.push_back( newPt );
+		}
+	}
+
+/// Adds a point to current polyline, given by its coordinates
+	template<typename T1,typename T2>
+	void addPoint( T1 x, T2 y )
+	{
+		HOMOG2D_CHECK_IS_NUMBER(T1);
+		HOMOG2D_CHECK_IS_NUMBER(T2);
+		addPoint( Point2d_<HOMOG2D_INUMTYPE>( x, y ) );
+	}
+
+/// Ends current polyline, following points will go to a new one (does nothing if current one is empty)
+/**
+The finished polyline is handed to the callback function if there is one (see setEmitCallback() ), else it is stored.
+*/
+	void newPolyline()
+	{
+		if( _kept.empty() )
+			return;
+		if( _emit )
+			_emit( getPolyline() );
+		else
+			_done.push_back( getPolyline() );
+		_kept.clear();
+		_window.clear();
+	}
+
+/// Sets a function that will be called with each finished polyline, instead of storing it.
+/// An empty function object restores the default behaviour
+	void setEmitCallback( std::function<void(OPolyline_<FPT>&&)> f )
+	{
+		_emit = std::move( f );
+	}
+
+/// Moves out the finished polylines (not the current one), releasing the memory they use
+	std::vector<OPolyline_<FPT>> takePolylines()
+	{
+		std::vector<OPolyline_<FPT>> out;
+		std::swap( out, _done );
+		return out;
+	}
+
+/// Returns current polyline (empty if less than 2 points)
+	OPolyline_<FPT> getPolyline() const
+	{
+		if( _kept.size() + (_window.empty() ? 0 : 1) < 2 )
+			return OPolyline_<FPT>();
+		auto vpts = _kept;
+		vpts.emplace_back( _window.back() );
+		return OPolyline_<FPT>( vpts );
+	}
+
+/// Returns all the stored polylines, the previous ones and the current one (if not empty)
+/// \sa takePolylines()
+	std::vector<OPolyline_<FPT>> getPolylines() const
+	{
+		auto out = _done;
+		auto pl = getPolyline();
+		if( pl.size() )
+			out.push_back( pl );
+		return out;
+	}
+
+/// Number of points added so far (including the dropped ones)
+	size_t nbInputPts() const { return _nbInputPts; }
+
+/// Clears all, parameters (and callback function) are unchanged
+	void clear()
+	{
+		_kept.clear();
+		_window.clear();
+		_done.clear();
+		_nbInputPts = 0;
+	}
+
+private:
+/// Returns true if all the points of the window are close enough to the segment joining the last kept point and \c newPt
+	bool p_windowFits( const Point2d_<HOMOG2D_INUMTYPE>& newPt ) const
+	{
+		HOMOG2D_INUMTYPE ax = _kept.back().getX();
+		HOMOG2D_INUMTYPE ay = _kept.back().getY();
+		auto bx = newPt.getX();
+		auto by = newPt.getY();
+		auto eps2 = _epsilon * _epsilon;
+		for( const auto& pt: _window )
+			if( priv::sqDistPtSeg( pt.getX(), pt.getY(), ax, ay, bx, by ) > eps2 )
+				return false;
+		return true;
+	}
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - STREAMING OPERATORS
+/////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------
+namespace base {
+
+/// Stream operator, free function, call member function pseudo operator impl_op_stream()
+template<typename LP,typename FPT>
+std::ostream&
+operator << ( std::ostream& f, const h2d::base::LPBase<LP,FPT>& pl )
+{
+	if constexpr( std::is_same_v<LP,typ::IsLine> )
+		f << '[' << pl._v[0] << ',' << pl._v[1] << ',' << pl._v[2] << "]";
+	else
+	{
+		if( pl.isInf() )
+			f << '[' << pl._v[0] << ',' << pl._v[1] << ',' << pl._v[2] << "]";
+		else
+			f
+		//	<< std::scientific << std::setprecision(25)
+				<< '[' << pl.getX() << ',' << pl.getY() << "]";
+	}
+
+	return f;
+}
+
+} // namespace base
+
+/// Stream operator for a container of points/lines, free function
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+std::ostream&
+operator << ( std::ostream& f, const T& vec )
+{
+	f << "#="<< vec.size() << '\n';
+	for( const auto& elem: vec )
+		f << elem << '\n';
+	return f;
+}
+
+/// Stream operator for a pair of points/lines, free function
+template<typename LP1,typename LP2,typename FPT>
+std::ostream&
+operator << ( std::ostream& f, const std::pair<base::LPBase<LP1,FPT>,base::LPBase<LP2,FPT>>& pr )
+{
+	f << "std::pair (" << getString(pr.first.type()) << "-" << getString(pr.second.type())
+		<< "):\n -first="  << pr.first
+		<< "\n -second=" << pr.second
+		<< ' ';
+	return f;
+}
+
+template<typename T>
+std::ostream&
+operator << ( std::ostream& f, const FRect_<T>& r )
+{
+	f << "pt1: " << r._ptR1 << " pt2: " << r._ptR2;
+	return f;
+}
+
+template<typename T>
+std::ostream&
+operator << ( std::ostream& f, const Circle_<T>& r )
+{
+	f << "center: " << r._center << ", radius=" << r._radius;
+	return f;
+}
+
+namespace base {
+
+template<typename SV,typename T>
+std::ostream&
+operator << ( std::ostream& f, const h2d::base::SegVec<SV,T>& seg )
+{
+	f << seg._ptS1;
+	if constexpr( std::is_same_v<SV,typ::IsOSeg> )
+		f << "=>";
+	else
+		f << "-";
+	f << seg._ptS2;
+	return f;
+}
+
+template<typename PLT,typename FPT>
+std::ostream&
+operator << ( std::ostream& f, const h2d::base::PolylineBase<PLT,FPT>& pl )
+{
+	f << (pl.isClosed() ? 'C' : 'O' ) << "Polyline: ";
+	if( !pl.size() )
+		f << "empty";
+	else
+	{
+		for( const auto& pt: pl._plinevec )
+			f << pt << "-";
+	}
+	return f;
+}
+} // namespace base
+
+template<typename T>
+std::ostream&
+operator << ( std::ostream& f, const Ellipse_<T>& ell )
+{
+	auto par = ell.template p_getParams<HOMOG2D_INUMTYPE>();
+	f << par;
+	return f;
+}
+
+//------------------------------------------------------------------
+/// Returns the 2 parallel lines at distance \c dist from \c li (free function)
+template<typename FPT,typename T>
+std::pair<Line2d_<FPT>,Line2d_<FPT>>
+getParallelLines( const Line2d_<FPT>& li, T dist )
+{
+	return li.getParallelLines( dist );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - MEMBER FUNCTION IMPLEMENTATION: CLASS Ellipse_
+/////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------
+/// Returns standard parameters from matrix coeffs
+template<typename FPT>
+template<typename T>
+detail::EllParams<T>
+Ellipse_<FPT>::p_getParams() const
+{
+#ifdef HOMOG2D_OPTIMIZE_SPEED
+	if( _epHasChanged )
+	{
+		_par = p_computeParams<T>();
+		_epHasChanged = false;
+	}
+	return _par;
+#else
+	return p_computeParams<T>();
+#endif // HOMOG2D_OPTIMIZE_SPEED
+}
+//------------------------------------------------------------------
+/// Compute and returns standard parameters from matrix coeffs
+/**
+\note In the checking below, we **cannot** print the matrix using the
+<< operator, because it call this function, thus it would enter
+an infinite loop (an eventually SO).
+*/
+template<typename FPT>
+template<typename T>
+detail::EllParams<T>
+Ellipse_<FPT>::p_computeParams() const
+{
+	const auto& m = detail::Matrix_<FPT>::_mdata;
+	HOMOG2D_INUMTYPE A = m[0][0];
+	HOMOG2D_INUMTYPE C = m[1][1];
+	HOMOG2D_INUMTYPE F = m[2][2];
+	HOMOG2D_INUMTYPE B = 2. * m[0][1];
+	HOMOG2D_INUMTYPE D = 2. * m[0][2];
+	HOMOG2D_INUMTYPE E = 2. * m[1][2];
+
+	detail::EllParams<T> par;  // theta already set to zero
+
+	auto denom = B*B - (HOMOG2D_INUMTYPE)4. * A * C;
+
+#ifndef HOMOG2D_NOCHECKS
+	if( homog2d_abs(denom) < thr::nullDenom() )
+		HOMOG2D_THROW_ERROR_1(
+			"unable to compute parameters, denom=" << std::scientific << std::setprecision(15) << denom
+		);
+#endif
+
+	par.x0 = ( (HOMOG2D_INUMTYPE)2.*C*D - B*E ) / denom;
+	par.y0 = ( (HOMOG2D_INUMTYPE)2.*A*E - B*D ) / denom;
+	auto common_ab = (HOMOG2D_INUMTYPE)2. * ( A*E*E + C*D*D - B*D*E + denom*F );
+	auto AmC = A-C;
+	auto AmC2 = AmC*AmC;
+
+	auto sqr = homog2d_sqrt(AmC2+B*B);
+	par.a = -homog2d_sqrt( common_ab * ( A+C+sqr ) )/ denom;
+	par.b = -homog2d_sqrt( common_ab * ( A+C-sqr ) )/ denom;
+
+
+	par.a2 = par.a * par.a;
+	par.b2 = par.b * par.b;
+	if( homog2d_abs(B) < thr::nullDenom() )
+	{
+		if( A > C )
+			par.theta = 90.;
+	}
+	else
+	{
+		auto t = (C - A - sqr) / B;
+		par.theta = homog2d_atan( t );
+	}
+	par.sint = homog2d_sin( par.theta );
+	par.cost = homog2d_cos( par.theta );
+	return par;
+}
+
+//------------------------------------------------------------------
+/// Returns true if ellipse is a circle
+/**
+Using the matrix representation, if A = C and B = 0, then the ellipse is a circle
+
+You can provide the 0 threshold as and argument
+*/
+template<typename FPT>
+bool
+Ellipse_<FPT>::isCircle( HOMOG2D_INUMTYPE thres ) const
+{
+	const auto& m = detail::Matrix_<FPT>::_mdata;
+	HOMOG2D_INUMTYPE A  = m[0][0];
+	HOMOG2D_INUMTYPE C  = m[1][1];
+	HOMOG2D_INUMTYPE B2 = m[0][1];
+	if( homog2d_abs(A-C) < thres )
+		if( homog2d_abs(B2)*2. < thres )
+			return true;
+	return false;
+}
+
+//------------------------------------------------------------------
+/// Returns center of ellipse
+/// \sa center( const T& )
+template<typename FPT>
+Point2d_<FPT>
+Ellipse_<FPT>::getCenter() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	return Point2d_<FPT>( par.x0, par.y0 );
+}
+
+//------------------------------------------------------------------
+template<typename FPT>
+std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
+Ellipse_<FPT>::getMajMin() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	return std::make_pair( par.a, par.b );
+}
+
+//------------------------------------------------------------------
+/// Returns angle of ellipse
+/// \sa angle( const Ellipse_& )
+template<typename FPT>
+HOMOG2D_INUMTYPE
+Ellipse_<FPT>::angle() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	return par.theta;
+}
+
+//------------------------------------------------------------------
+/// Returns (approximate) perimeter of ellipse using the Ramanujan second formulae
+/**
+See https://en.wikipedia.org/wiki/Ellipse#Circumference
+*/
+template<typename FPT>
+HOMOG2D_INUMTYPE
+Ellipse_<FPT>::length() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	auto ab_sum  = par.a + par.b;
+	auto ab_diff = par.a - par.b;
+	auto h = ab_diff * ab_diff / (ab_sum * ab_sum);
+	auto denom = (HOMOG2D_INUMTYPE)10. + homog2d_sqrt(4. - 3. * h);
+	return (par.a + par.b) * M_PI * ( 1. + 3. * h / denom );
+}
+
+//------------------------------------------------------------------
+/// Returns pair of axis lines of ellipse
+template<typename FPT>
+std::pair<Line2d_<FPT>,Line2d_<FPT>>
+Ellipse_<FPT>::getAxisLines() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	auto dy = static_cast<HOMOG2D_INUMTYPE>(par.sint) * par.a;
+	auto dx = static_cast<HOMOG2D_INUMTYPE>(par.cost) * par.a;
+	Point2d_<HOMOG2D_INUMTYPE> ptA(
+		par.x0 + dx,
+		par.y0 + dy
+	);
+	auto pt0 = Point2d_<HOMOG2D_INUMTYPE>( par.x0, par.y0 );
+	auto li_H = ptA * pt0;
+	HOMOG2D_LOG( std::scientific << "ptA=" << ptA << " pt0=" << pt0 << " li_H=" << li_H );
+
+	auto li_V = li_H.getOrthogLine( pt0 );
+	return std::make_pair( li_H, li_V );
+}
+
+//------------------------------------------------------------------
+/// Returns axis-aligned bounding box of ellipse
+/**
+- see https://math.stackexchange.com/questions/91132/how-to-get-the-limits-of-rotated-ellipse
+*/
+template<typename FPT>
+auto
+Ellipse_<FPT>::getBB() const
+{
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	auto vx = par.a2 * par.cost * par.cost	+ par.b2 * par.sint * par.sint;
+	auto vy = par.a2 * par.sint * par.sint	+ par.b2 * par.cost * par.cost;
+	auto vx_sq = homog2d_sqrt( vx );
+	auto vy_sq = homog2d_sqrt( vy );
+	return FRect_<HOMOG2D_INUMTYPE>(
+		Point2d_<HOMOG2D_INUMTYPE>( par.x0 - vx_sq, par.y0 - vy_sq ),
+		Point2d_<HOMOG2D_INUMTYPE>( par.x0 + vx_sq, par.y0 + vy_sq )
+	);
+}
+
+//------------------------------------------------------------------
+/// Returns oriented bounding box of ellipse as a closed Polyline
+/**
+Algorithm:
+ - build line \c liH going through major axis, by using center point and
+ point on semi-major axis, intersecting ellipse
+ - get opposite point \c ptB, lying on line and at distance \c a
+ - get the two parallel lines to \c liH, at a distance \c b
+ - get the two orthogonal lines at \c ptA and \c ptB
+
+\todo 20240330: unclear, the text above does not match what is done below (or does it?).
+Clarify that, and build a gif showing how this is done.
+*/
+template<typename FPT>
+CPolyline_<FPT>
+Ellipse_<FPT>::getOBB() const
+{
+// step 1: build ptA using angle
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	auto dy = par.sint * par.a;
+	auto dx = par.cost * par.a;
+	Point2d_<FPT> ptA(
+		par.x0 + dx,
+		par.y0 + dy
+	);
+	auto pt0 = Point2d_<HOMOG2D_INUMTYPE>( par.x0, par.y0 );
+
+// step 2: build main-axis line, going through center and ptA
+	auto li_H = ptA * pt0;
+
+// step 3: get ptB, using line and distance
+	auto ppts = li_H.getPoints( pt0, par.a );
+	auto ptB = ppts.first;
+	if( ptB == ptA )
+		ptB = ppts.second;
+
+	auto para = getParallelLines( li_H, par.b );
+	auto li_V1 = li_H.getOrthogLine( ptA );
+	auto li_V2 = li_H.getOrthogLine( ptB );
+
+	CPolyline_<FPT> out;
+#ifndef	HOMOG2D_DEBUGMODE
+	out.p_addPoint( para.first  * li_V1 );
+	out.p_addPoint( para.second * li_V1 );
+	out.p_addPoint( para.second * li_V2 );
+	out.p_addPoint( para.first  * li_V2 );
+#else
+	auto p1 = para.first  * li_V1;
+	auto p2 = para.second * li_V1;
+	auto p3 = para.second * li_V2;
+	auto p4 = para.first  * li_V2;
+	HOMOG2D_DEBUG_ASSERT(
+		( p2!=p1 && p3!=p2 && p4!=p3 ),
+		"p1=" << p1 << " p2=" << p2 << " p3=" << p3 << " p4=" << p4
+		<< "\n para.1=" << para.first
+		<< "\n li_V1=" << li_V1
+		<< "\n ptA=" << ptA
+		<< "\n ptB=" << ptB
+		<< "\n " << ppts
+	);
+	out.p_addPoint( p1 );
+	out.p_addPoint( p2 );
+	out.p_addPoint( p3 );
+	out.p_addPoint( p4 );
+#endif
+	return out;
+}
+
+//------------------------------------------------------------------
+/// Returns true if point is inside ellipse
+/**
+taken from https://stackoverflow.com/a/16814494/193789
+*/
+template<typename FPT>
+template<typename FPT2>
+bool
+Ellipse_<FPT>::pointIsInside( const Point2d_<FPT2>& pt ) const
+{
+	HOMOG2D_INUMTYPE x = pt.getX();
+	HOMOG2D_INUMTYPE y = pt.getY();
+
+	auto par = p_getParams<HOMOG2D_INUMTYPE>();
+	const auto& x0 = par.x0;
+	const auto& y0 = par.y0;
+
+	auto v1 = par.cost * (x-x0) + par.sint * (y-y0);
+	HOMOG2D_INUMTYPE sum = v1*v1 / par.a2;
+
+	auto v2 = par.sint * (x-x0) - par.cost * (y-y0);
+	sum += v2*v2 / par.b2;
+	if( sum < 1. )
+		return true;
+	return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - MEMBER FUNCTION IMPLEMENTATION: CLASS LPBase
+/////////////////////////////////////////////////////////////////////////////
+
+namespace base {
+//------------------------------------------------------------------
+/// Normalize to unit length, and make sure \c a is always >0
+/**
+\todo Checkout: in what situation will we be unable to normalize?
+Is the test below relevant? Clarify.
+*/
+template<typename LP,typename FPT>
+void
+LPBase<LP,FPT>::impl_normalize( const detail::BaseHelper<typename typ::IsLine>& ) const
+{
+// not sure which one is the best...
+#if 0
+	auto sq = homog2d_sqrt( _v[0]*_v[0] + _v[1]*_v[1] );
+#else
+	#ifdef HOMOG2D_USE_TTMATH
+		auto sq = ttmath::Sqrt( _v[0]*_v[0] + _v[1]*_v[1] );
+	#else
+		auto sq = std::hypot( _v[0], _v[1] );
+	#endif
+#endif
+
+#ifndef HOMOG2D_NOCHECKS
+	if( sq <= std::numeric_limits<double>::epsilon() )
+		HOMOG2D_THROW_ERROR_1( "unable to normalize line, sq=" << sq << " values: a=" << _v[0] << " b=" << _v[1] << " c=" << _v[2] );
+#endif
+	for( int i=0; i<3; i++ )
+		const_cast<LPBase<LP,FPT>*>(this)->_v[i] /= sq; // needed to remove constness
+
+	if( _v[0] < 0. ) // a always >0
+		for( int i=0; i<3; i++ )
+			const_cast<LPBase<LP,FPT>*>(this)->_v[i] = -_v[i];
+
+	if( homog2d_abs(_v[0]) < thr::nullDenom() ) // then, change sign so that b>0
+		if( _v[1] < 0 )
+		{
+			const_cast<LPBase<LP,FPT>*>(this)->_v[1] = - _v[1];
+			const_cast<LPBase<LP,FPT>*>(this)->_v[2] = - _v[2];
+		}
+}
+
+//------------------------------------------------------------------
+/// Point normalization. Just make sure a>0
+template<typename LP,typename FPT>
+void
+LPBase<LP,FPT>::impl_normalize( const detail::BaseHelper<typename typ::IsPoint>& ) const
+{
+	if( _v[0] < 0. )
+	{
+		const_cast<LPBase<LP,FPT>*>(this)->_v[0] = -_v[0];
+		const_cast<LPBase<LP,FPT>*>(this)->_v[1] = -_v[1];
+		const_cast<LPBase<LP,FPT>*>(this)->_v[2] = -_v[2];
+	}
+#ifndef HOMOG2D_NOCHECKS
+	if(
+		homog2d_abs(_v[2]) < thr::nullDenom()
+		&&
+		( _v[0] < thr::nullOrthogDistance() && homog2d_abs(_v[1]) < thr::nullOrthogDistance() )
+	)
+		HOMOG2D_THROW_ERROR_1( "invalid point values" );
+#endif
+}
+
+//------------------------------------------------------------------
+template<typename LP,typename FPT>
+template<typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::getCoord( GivenCoord gc, FPT2 other ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call on a point" );
+
+	const auto a = static_cast<HOMOG2D_INUMTYPE>( _v[0] );
+	const auto b = static_cast<HOMOG2D_INUMTYPE>( _v[1] );
+	auto denom = ( gc == GivenCoord::X ? b : a );
+#ifndef HOMOG2D_NOCHECKS
+	if( homog2d_abs(denom) < thr::nullDenom() )
+		HOMOG2D_THROW_ERROR_1( "null denominator encountered" );
+#endif
+	if( gc == GivenCoord::X )
+		return ( -a * other - _v[2] ) / b;
+	else
+		return ( -b * other - _v[2] ) / a;
+}
+
+//------------------------------------------------------------------
+/// Returns pair of points on line at distance \c dist from point on line
+/// at coord \c coord.
+template<typename LP,typename FPT>
+template<typename FPT2,typename FPT3>
+PointPair_<FPT>
+LPBase<LP,FPT>::getPoints( const Point2d_<FPT2>& pt, FPT3 dist ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call on a point" );
+	HOMOG2D_CHECK_IS_NUMBER(FPT2);
+	HOMOG2D_CHECK_IS_NUMBER(FPT3);
+
+#ifndef HOMOG2D_NOCHECKS
+	if( this->distTo( pt ) > thr::nullDistance() )
+	{
+		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
+			<< " > null distance (" << thr::nullDistance() << ")\n";
+		HOMOG2D_THROW_ERROR_2( "getPoints", "point is not on line" );
+	}
+#endif
+
+	return priv::getPoints_B2( pt, dist, *this );
+}
+
+
+//------------------------------------------------------------------
+/// Returns an orthogonal line to the one it is called on, at a point on the line defined by one of its coordinates.
+template<typename LP,typename FPT>
+template<typename FPT2>
+Line2d_<FPT>
+LPBase<LP,FPT>::getOrthogLine( GivenCoord gc, FPT2 val ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getOrthogLine() on a point" );
+
+	auto other_val = getCoord( gc, val );
+	Point2d_<HOMOG2D_INUMTYPE> pt( other_val, val ) ;
+	if( gc == GivenCoord::X )
+		pt.set( val, other_val );
+
+	return priv::getOrthogonalLine_B2( pt, *this );
+}
+
+/// Returns an orthogonal line to the one it is called on, at point \c pt
+template<typename LP,typename FPT>
+template<typename FPT2>
+Line2d_<FPT>
+LPBase<LP,FPT>::getOrthogLine( const Point2d_<FPT2>& pt ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getOrthogLine() on a point" );
+
+/*
+#ifndef HOMOG2D_NOCHECKS
+	if( this->distTo( pt ) > thr::nullDistance() )
+	{
+		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
+			<< "> null distance (" << thr::nullDistance() << ")\n";
+		HOMOG2D_THROW_ERROR_1( "point is not on line" );
+	}
+#endif
+*/
+	return priv::getOrthogonalLine_B2( pt, *this );
+}
+
+//------------------------------------------------------------------
+template<typename LP,typename FPT>
+template<typename FPT2,typename T>
+Line2d_<FPT>
+LPBase<LP,FPT>::getRotatedLine( const Point2d_<FPT2>& pt, T theta ) const
+{
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getRotatedLine() on a point" );
+
+#ifndef HOMOG2D_NOCHECKS
+	if( this->distTo( pt ) > thr::nullDistance() )
+	{
+		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
+			<< "> null distance (" << thr::nullDistance() << ")\n";
+		HOMOG2D_THROW_ERROR_2( "getLineAngle", "point is not on line" );
+	}
+#endif
+	Homogr_<HOMOG2D_INUMTYPE> H;
+	H.addTranslation( -pt.getX(), -pt.getY() ).addRotation(theta).addTranslation( pt.getX(), pt.getY() );
+	return H * *this;
+}
+
+/// Returns the shortest (oriented) segment that joins a point and a line
+/**
+Upon return, the first point will hold the intersection point (projection of point on line),
+and the second will hold the given point.
+*/
+template<typename LP,typename FPT>
+template<typename FPT2>
+OSegment_<FPT>
+LPBase<LP,FPT>::getOrthogSegment( const Point2d_<FPT2>& pt ) const
+{
+	static_assert( !std::is_same_v<LP,typ::IsPoint>, "Invalid call, cannot compute orthogonal segment between two points" );
+
+	Line2d_<HOMOG2D_INUMTYPE> src = *this;  // copy to highest precision
+	auto dist = src.distTo(pt);
+#ifndef HOMOG2D_NOCHECKS
+	if( dist < thr::nullDistance() )   // sanity check
+		HOMOG2D_THROW_ERROR_1( "unable to compute segment, distance too small=" << dist );
+#endif
+	auto pair_lines = getParallelLines( dist );
+
+// determine on which of the two parallel lines does the point lie?
+	Line2d_<HOMOG2D_INUMTYPE>* pline = &pair_lines.first;
+	if( pt.distTo(pair_lines.second) < thr::nullDistance() )
+		pline = &pair_lines.second;
+
+	auto oline = pline->getOrthogLine( pt );
+	auto p2 = *this * oline;
+	return OSegment_<FPT>( p2, pt );
+}
+
+//------------------------------------------------------------------
+/// Returns an parallel line, implementation of getParallelLine().
+template<typename LP,typename FPT>
+template<typename FPT2>
+Line2d_<FPT>
+LPBase<LP,FPT>::getParallelLine( const Point2d_<FPT2>& pt ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getParallelLine() on a point" );
+
+	Line2d_<FPT> out = *this;
+	out._v[2] = static_cast<HOMOG2D_INUMTYPE>(-_v[0]) * pt.getX() - _v[1] * pt.getY();
+	out.p_normalizePL();
+	return out;
+}
+
+//------------------------------------------------------------------
+
+/// Implementation for lines
+template<typename LP,typename FPT>
+template<typename T>
+std::pair<Line2d_<FPT>,Line2d_<FPT>>
+LPBase<LP,FPT>::getParallelLines( T dist ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getParallelLines() on a point" );
+
+	Line2d_<FPT> l1 = *this;
+	Line2d_<FPT> l2 = *this;
+	l1._v[2] = static_cast<HOMOG2D_INUMTYPE>(this->_v[2]) + dist;
+	l2._v[2] = static_cast<HOMOG2D_INUMTYPE>(this->_v[2]) - dist;
+	return std::make_pair( l1, l2 );
+}
+
+//------------------------------------------------------------------
+/// Comparison operator, used for lines
+/**
+Definition: two lines will be equal:
+- if they are parallel
+AND
+- if their offset (3 third value) is less than nullDistance()
+*/
+template<typename LP,typename FPT>
+bool
+LPBase<LP,FPT>::impl_op_equal( const LPBase<LP,FPT>& other, const detail::BaseHelper<typename typ::IsLine>& ) const
+{
+	if( !this->isParallelTo( other ) )
+		return false;
+
+	if( std::fabs( _v[2] - other._v[2] ) > thr::nullDistance() )
+		return false;
+
+	return true;
+}
+
+/// Comparison operator, used for points
+template<typename LP,typename FPT>
+bool
+LPBase<LP,FPT>::impl_op_equal( const LPBase<LP,FPT>& other, const detail::BaseHelper<typename typ::IsPoint>& ) const
 {
-	CPolyline_<HOMOG2D_INUMTYPE> pol( *this );
-	pol.rotate( rot );
-	*this = pol.getBB();
+	return ( this->distTo( other ) < thr::nullDistance() );
 }
 
 //------------------------------------------------------------------
-/// Returns Rectangle of the intersection area of two rectangles
-/**
-\return An object of type detail::RectArea, that can be checked for success using the ()
-operator, and if success, will hold the resulting FRect_
-
-Algorithm:
-
-4 situations need to be considered, depending on the number of intersection points:
+/// Sorting operator, for points (illegal for lines)
+template<typename LP,typename FPT>
+bool
+LPBase<LP,FPT>::operator < ( const LPBase<LP,FPT>& other ) const
+{
+	static_assert( std::is_same_v<LP,typ::IsPoint>, "Invalid < operator: you cannot sort lines" );
 
-- A: 2 intersection points on same segment => we have 2 points inside.
-\verbatim
-  +------+                   +------+
-  |      |                   |      |
-  |   +--+-----+          +--+----+ |
-  |   |  |     |          |  |    | |
-  |   |  |     |    or    |  |    | |  or ...
-  |   +--+-----+          +--+----+ |
-  |      |                   |      |
-  +------+                   +------+
-\endverbatim
+	if( getX() < other.getX() )
+		return true;
+	if( getX() > other.getX() )
+		return false;
+	if( getY() < other.getY() )
+		return true;
+	return false;
+}
 
-- B: 2 intersection points on different segments => for each rectangle, 1 point is inside the other.
-\verbatim
-  +------+
-  |      |
-  |      |
-  |   +--+-----+
-  |   |  |     |   or ...
-  +---+--+     |
-      |        |
-      +--------+
-\endverbatim
+} // namespace base
 
-- C: 3 points
-\verbatim
-  +------+-----+
-  |      |     |
-  |      |     |
-  +------+-----+
-  |      |
-  +------+
-\endverbatim
+//------------------------------------------------------------------
+/// Inner implementation details
+namespace detail {
 
-- D: 4 intersection points: the intersection rectangle is made of these 4 points
-\verbatim
-     +------+
-     |      |
-  +--+------+-----+
-  |  |      |     |
-  |  |      |     |
-  +--+------+-----+
-     |      |
-     +------+
-\endverbatim
+/// Cross product of points * points or line * line
+/**
+- https://en.wikipedia.org/wiki/Cross_product#Coordinate_notation
 */
-template<typename FPT>
-template<typename FPT2>
-detail::RectArea<FPT>
-FRect_<FPT>::intersectArea( const FRect_<FPT2>& other ) const
+template<typename Out,typename In,typename FPT1,typename FPT2>
+base::LPBase<Out,FPT1>
+crossProduct(
+	const base::LPBase<In,FPT1>& r1,
+	const base::LPBase<In,FPT2>& r2
+)
 {
-	if( *this == other )                      // if same rectangles, then
-		return detail::RectArea<FPT>(other);  // the intersection area is the rectangle
-
-	auto inter = this->intersects( other );
-
-	if( !inter() )                        // rectangles do not intersect
-	{
-		if( this->isInside( other ) )
-			return detail::RectArea<FPT>(*this);
-		if( other.isInside( *this ) )
-			return detail::RectArea<FPT>(other);
-		return detail::RectArea<FPT>();
-	}
-
-	if( inter.size() < 2 )                // only one intersection point
-		return detail::RectArea<FPT>();   // => no intersection area!
+	auto r1_a = static_cast<HOMOG2D_INUMTYPE>(r1._v[0]);
+	auto r1_b = static_cast<HOMOG2D_INUMTYPE>(r1._v[1]);
+	auto r1_c = static_cast<HOMOG2D_INUMTYPE>(r1._v[2]);
+	auto r2_a = static_cast<HOMOG2D_INUMTYPE>(r2._v[0]);
+	auto r2_b = static_cast<HOMOG2D_INUMTYPE>(r2._v[1]);
+	auto r2_c = static_cast<HOMOG2D_INUMTYPE>(r2._v[2]);
 
-	if( inter.size() == 4 )  // 4 intersection points => case "D"
-		return detail::RectArea<FPT>(FRect_<FPT>( inter.get().at(0), inter.get().at(3) ) );
+	base::LPBase<Out,FPT1> res;
+	res._v[0] = static_cast<FPT1>( r1_b * r2_c  - r1_c * r2_b );
+	res._v[1] = static_cast<FPT1>( r1_c * r2_a  - r1_a * r2_c );
+	res._v[2] = static_cast<FPT1>( r1_a * r2_b  - r1_b * r2_a );
 
-	if( inter.size() == 3 )  // 3 intersection points => case "C"
-	{
-		auto v = inter.get();
+	return res;
+}
 
-		auto xmin = std::min( v[0].getX(), std::min( v[1].getX(),v[2].getX() ) );
-		auto ymin = std::min( v[0].getY(), std::min( v[1].getY(),v[2].getY() ) );
-		auto xmax = std::max( v[0].getX(), std::max( v[1].getX(),v[2].getX() ) );
-		auto ymax = std::max( v[0].getY(), std::max( v[1].getY(),v[2].getY() ) );
-#ifndef HOMOG2D_DEBUGMODE
-		assert( xmax-xmin > thr::nullOrthogDistance() );
-		assert( ymax-ymin > thr::nullOrthogDistance() );
-#else
-		HOMOG2D_DEBUG_ASSERT(
-			( ( xmax-xmin > thr::nullOrthogDistance() )
-			&&
-			( ymax-ymin > thr::nullOrthogDistance() )) ,
-			std::scientific
-			<< "this=" << *this << " other=" << other
-			<< "\nxmax=" << xmax << " xmin=" << xmin
-			<< "\nymax=" << ymax << " ymin=" << ymin
-			<< "\nnod=" << thr::nullOrthogDistance()
-		);
-#endif
-		return detail::RectArea<FPT>( FRect_<FPT>( xmin, ymin, xmax,ymax ) );
-	}
-/*------------------------
- If we get to this point, we have 2 intersection points
-------------------------*/
-#ifndef HOMOG2D_DEBUGMODE
-	assert( inter.size() == 2 );
-#else
-/*	HOMOG2D_DEBUG_ASSERT(
-		inter.size() == 2,
-		"inter.size()=" << inter.size() << "\n-this=" << *this << "\n-other=" << other
-		<<"\n-inter:" << inter
-	);*/
-#endif
-	const auto& r1 = *this;
-	const auto& r2 = other;
-//	HOMOG2D_LOG( "r1="<<r1 << " r2="<<r2 );
-	auto v1 = r1.p_pointsInside( r2 );
-	auto v2 = r2.p_pointsInside( r1 );
-	auto c1 = v1.size();
-	auto c2 = v2.size();
-//	HOMOG2D_LOG( "c1=" << c1 << " c2=" << c2 );
+/// Cross product of two oriented segments, return a scalar
+template<typename FPT1,typename FPT2>
+HOMOG2D_INUMTYPE
+crossProductV(
+	const base::SegVec<typ::IsOSeg,FPT1>& v1,
+	const base::SegVec<typ::IsOSeg,FPT2>& v2
+)
+{
+	auto ppts1 = v1.getPts();
+	auto ppts2 = v2.getPts();
 
-	if( c1==0 && c2==0 ) // unable, rectangles share a segment
-		return detail::RectArea<FPT>();
+	auto dx1 =
+		static_cast<HOMOG2D_INUMTYPE>( ppts1.second.getX()  )
+		- static_cast<HOMOG2D_INUMTYPE>( ppts1.first.getX() );
+	auto dy1 =
+		static_cast<HOMOG2D_INUMTYPE>(   ppts1.second.getY() )
+		- static_cast<HOMOG2D_INUMTYPE>( ppts1.first.getY()  );
+	auto dx2 =
+		static_cast<HOMOG2D_INUMTYPE>(   ppts2.second.getX() )
+		- static_cast<HOMOG2D_INUMTYPE>( ppts2.first.getX()  );
+	auto dy2 =
+		static_cast<HOMOG2D_INUMTYPE>(   ppts2.second.getY() )
+		- static_cast<HOMOG2D_INUMTYPE>( ppts2.first.getY()  );
 
-	assert(
-		( c1==1 && c2==1 )
-		||
-		( c1==0 && c2==2 )
-		||
-		( c2==0 && c1==2 )
-	);
-	if( c1==1 || c2==1 ) // only 1 point inside => the rectangle is defined by the intersection points
-		return detail::RectArea<FPT>( FRect_<FPT>( inter.get().at(0), inter.get().at(1) ) );
+	return dx1 * dy2 - dy1 * dx2;
+}
 
-// here: 2 points inside, then build rectangle using the 4 points:
-// the 2 inside, and the two intersection points
-	assert( c1 == 2 || c2 == 2 );
+} // namespace detail
 
-	if( c1 == 2 )
-		return detail::RectArea<FPT>(
-			FRect_<FPT>(
-				inter.get().at(0),
-				inter.get().at(1),
-				v1.at(0),
-				v1.at(1)
-			)
-		);
-	return detail::RectArea<FPT>(
-		FRect_<FPT>(
-			inter.get().at(0),
-			inter.get().at(1),
-			v2.at(0),
-			v2.at(1)
-		)
-	);
-}
 
-namespace priv {
-/// Common stuff for FRect_ union, see FRect_::unionArea()
-namespace runion {
 //------------------------------------------------------------------
-/// Holds x or y coordinate value of rectangle during computation of intersection area
-/**
-- \c T will be the floating-point type
-- used in FRect_<FPT>::unionArea()
-*/
-template<typename T>
-struct Index
-{
-	T       _value;
-	uint8_t _rect_idx=0;   // 0 means none, will be 1 or 2
+///////////////////////////////////////////
+// CONSTRUCTORS
+///////////////////////////////////////////
 
-	Index() = default;
-	Index( T v, uint8_t r )
-		: _value(v), _rect_idx(r)
-	{}
-	friend bool operator < ( const Index& i1, const Index& i2 )
+namespace base {
+
+/// Generic init from two numeric args
+template<typename LP, typename FPT>
+template<typename T1,typename T2>
+void
+LPBase<LP,FPT>::p_init_2( const T1& v1, const T2& v2 )
+{
+	if constexpr( std::is_same_v<LP,typ::IsPoint> )
 	{
-
-		if( i1._value == i2._value )
-			return i1._rect_idx < i2._rect_idx;
-		return i1._value < i2._value;
+		_v[0] = v1;
+		_v[1] = v2;
+		_v[2] = 1.;
 	}
-	friend std::ostream& operator << ( std::ostream& f, const Index& idx )
+	else
 	{
-		f << idx._value << " ";
-		return f;
+		Point2d_<FPT> pt1;                // 0,0
+		Point2d_<FPT> pt2(v1,v2);
+		pt2.p_normalizePL();
+		*this = detail::crossProduct<typ::IsLine>( pt1, pt2 );
+		p_normalizePL();
 	}
-};
+}
 
-/// A wrapper around a bool, that gets set if that point defined
-/// by indexes \c ix and \c iy is a corner in the table
+/// Overload for point to point distance
+template<typename LP, typename FPT>
+template<typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::impl_distToPoint( const Point2d_<FPT2>& pt, const detail::BaseHelper<typename typ::IsPoint>& ) const
+{
+#ifndef HOMOG2D_USE_TTMATH
+	return std::hypot(
+		static_cast<HOMOG2D_INUMTYPE>( getX() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getX() ),
+		static_cast<HOMOG2D_INUMTYPE>( getY() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getY() )
+	);
+#else
+	auto v1 = static_cast<HOMOG2D_INUMTYPE>( getX() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getX() );
+	auto v2 = static_cast<HOMOG2D_INUMTYPE>( getY() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getY() );
+	return ttmath::Sqrt( v1*v1 + v2*v2 );
+#endif
+}
+//------------------------------------------------------------------
+/// Returns distance between the line and point \b pt. overload for line to point distance.
 /**
-used in FRect_<FPT>::unionArea()
+http://mathworld.wolfram.com/Point-LineDistance2-Dimensional.html
+<pre>
+        | a.x0 + b.y0 + c |
+  d = -----------------------
+         sqrt( a*a + b*b )
+</pre>
+\todo Do we really require computation of hypot ? (because the line is supposed to be normalized, i.e. h=1 ?)
 */
-struct Cell
+template<typename LP, typename FPT>
+template<typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::impl_distToPoint( const Point2d_<FPT2>& pt, const detail::BaseHelper<typename typ::IsLine>& ) const
 {
-	bool _isCorner = false;
-	Cell() = default;
-#ifdef HOMOG2D_DEBUGMODE
-	Cell( bool b ) : _isCorner(b)
-	{}
+	return std::fabs(
+		static_cast<HOMOG2D_INUMTYPE>( _v[0] ) * pt.getX()
+		+ static_cast<HOMOG2D_INUMTYPE>( _v[1] ) * pt.getY()
+		+ static_cast<HOMOG2D_INUMTYPE>( _v[2] )
+	)
+#ifndef HOMOG2D_USE_TTMATH
+	/ std::hypot( _v[0], _v[1] );
+#else
+;
 #endif
-	template<typename T>
-	Cell( const Index<T>& ix, const Index<T>& iy )
-	{
-		if( ix._rect_idx == iy._rect_idx )
-			_isCorner = true;
-	}
-};
-
-
-using Table  = std::array<std::array<Cell,4>,4>;
-using PCoord = std::pair<uint8_t,uint8_t>;
+}
 
-enum class Direction: uint8_t { N, E, S, W };
+/// overload for line to point distance
+template<typename LP, typename FPT>
+template<typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::distTo( const Line2d_<FPT2>& li ) const
+{
+	static_assert( !std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot compute distance between two lines" );
+	return li.distTo( *this );
+}
 
-/* NEEDED TO DEBUG
-const char* getString( Direction dir )
+template<typename LP, typename FPT>
+template<typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::distTo( const Segment_<FPT2>& seg ) const
 {
-	switch( dir )
-	{
-		case Direction::W: return "W"; break;
-		case Direction::S: return "S"; break;
-		case Direction::E: return "E"; break;
-		case Direction::N: return "N"; break;
-	}
-	return 0; // to avoid a warning
-}*/
+	static_assert( !std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot compute distance between a line and a segment" );
+	return seg.distTo( *this );
+}
 
-enum class Turn: uint8_t { Left, Right };
+} // namespace base
 
-inline
-Direction
-turn( Direction dir, Turn turn )
+//------------------------------------------------------------------
+/// Free function, returns angle between two segments/lines
+/// \sa Segment_::getAngle()
+/// \sa Line2d_::getAngle()
+template<typename T1,typename T2>
+HOMOG2D_INUMTYPE
+getAngle( const T1& t1, const T2& t2 )
 {
-	switch( dir )
-	{
-		case Direction::W:
-			return turn == Turn::Left ? Direction::S : Direction::N;
-		case Direction::S:
-			return turn == Turn::Left ? Direction::E : Direction::W;
-		case Direction::E:
-			return turn == Turn::Left ? Direction::N : Direction::S;
-		case Direction::N:
-			return turn == Turn::Left ? Direction::W : Direction::E;
-	}
-	return Direction::N; // to avoid a warning
+	static_assert(
+		(
+			   std::is_same_v<typename T1::SType,typ::IsLine>
+			|| std::is_same_v<typename T1::SType,typ::IsSegment>
+			|| std::is_same_v<typename T1::SType,typ::IsOSeg>
+		) &&
+		(
+			   std::is_same_v<typename T2::SType,typ::IsLine>
+			|| std::is_same_v<typename T2::SType,typ::IsSegment>
+			|| std::is_same_v<typename T2::SType,typ::IsOSeg>
+		),
+		"Both types must be either a Line or a Segment"
+	);
+	return t1.getAngle( t2 );
 }
 
-inline
-void
-moveToNextCell( uint8_t& row, uint8_t& col, const Direction& dir )
+//------------------------------------------------------------------
+namespace base {
+
+template<typename LP, typename FPT>
+template<typename FPT2>
+bool
+LPBase<LP,FPT>::isParallelTo( const Line2d_<FPT2>& li ) const
 {
-	switch( dir )
-	{
-		case Direction::N: row--; break;
-		case Direction::S: row++; break;
-		case Direction::E: col++; break;
-		case Direction::W: col--; break;
-	}
+	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot use IsParallel() with a point" );
+
+	if( this->getAngle(li) < thr::nullAngleValue() )
+		return true;
+	return false;
 }
 
-/// Helper function for FRect_<FPT>::unionArea()
+//------------------------------------------------------------------
+/// Returns the angle (in rad.) between the line and the other one.
 /**
-- Start from 0,0, direction East
+- The returned value will be in the range <code> [0, M_PI/2] </code>
+
+If the lines \f$ (a_0,a_1,a_2) \f$ and \f$ (b_0,b_1,b_2) \f$ are correctly normalized (should be, but...)
+then the angle between them is \f$ \alpha = acos( a_0*b_0 + a_1*b_1) \f$. <br>
+However, in "some situations", even if the lines have been previously normalized (which is the case here)
+we can encounter numerical issues, so here we "reinforce the normalization and compute:
+\f[
+\alpha = acos \left(
+	\frac{a_0*b_0 + a_1*b_1} { \sqrt{ a_0^2 + a_1^2 } * \sqrt{ b_0^2 + b_1^2 } }
+\right)
+\f]
+In some situations, the value inside the parenthesis "may" be equal to \f$ 1+\epsilon \f$
+(typically, something like "1.0000000000123").
+This is out of bounds for the \f$ acos() \f$ function, that will then return "nan"
+(thus induce some failure further on). <br>
+To avoid this, a checking is done, and any value higher than 1 will be truncated.
+This is logged on \c std::cerr so that the user may take that into consideration.
+
+\todo more investigation needed ! : what are the exact situation that will lead to this event?
 */
-inline
-std::vector<PCoord>
-parseTable( Table& table )
+template<typename LP, typename FPT>
+template<typename LP2, typename FPT2>
+HOMOG2D_INUMTYPE
+LPBase<LP,FPT>::getAngle( const LPBase<LP2,FPT2>& li ) const
 {
-	bool firstTime = true;
-	bool done = false;
-	uint8_t row = 0;
-	uint8_t col = 0;
-	Direction dir = Direction::E;
-	std::vector<PCoord> out;
-	do
+	static_assert( !std::is_same_v<LP,typ::IsPoint>, "cannot get angle of a point" );
+
+	HOMOG2D_INUMTYPE l1_a = _v[0];
+	HOMOG2D_INUMTYPE l1_b = _v[1];
+	HOMOG2D_INUMTYPE l2_a = li._v[0];
+	HOMOG2D_INUMTYPE l2_b = li._v[1];
+	HOMOG2D_INUMTYPE res = l1_a * l2_a + l1_b * l2_b;
+
+	res /= homog2d_sqrt( (l1_a*l1_a + l1_b*l1_b) * (l2_a*l2_a + l2_b*l2_b) );
+	auto fres = homog2d_abs(res);
+
+	if( fres > 1.0 )
 	{
-		if( table[row][col]._isCorner )
-		{
-			auto new_pair = std::make_pair(row,col);
-			if( out.size() > 0 )
-				if( new_pair == out.front() && out.size() > 2 )
-					done = true;
-			if( !done )
-				out.push_back( new_pair );
-			if( firstTime )
-				firstTime = false;
-			else
-				dir = turn( dir, Turn::Right );
-		}
-		else
-		{
-			if( ( row==2 || row==1 ) && ( col==2 || col==1 ) )
-			{
-				out.push_back( std::make_pair(row,col) );
-				dir = turn( dir, Turn::Left );
-			}
-		}
-		moveToNextCell( row, col, dir );
+		HOMOG2D_LOG_WARNING(
+			"homog2d Warning: angle computation overflow detected, value "
+			<< std::scientific << std::setprecision(20)
+			<< fres << ", truncated to 1.0\n input lines:\n  l1: "
+			<< *this << "\n  l2: " << li
+		);
+		fres = 1.0;
+	}
+	return homog2d_acos( fres );
+}
+
+//------------------------------------------------------------------
+/// Returns true if point is inside (or on the edge) of a flat rectangle
+template<typename LP, typename FPT>
+template<typename FPT2>
+bool
+LPBase<LP,FPT>::isInside( const FRect_<FPT2>& rect ) const
+{
+	if constexpr( std::is_same_v<LP,typ::IsLine> )
+		return false;
+	else
+	{
+		auto pair_pts = rect.getPts();
+		const auto& p00 = pair_pts.first;
+		const auto& p11 = pair_pts.second;
+		return detail::ptIsInside( *this, p00, p11 );
 	}
-	while( !done );
-	return out;
 }
 
-#ifdef HOMOG2D_DEBUGMODE
-inline
-void
-printTable( const Table& t, std::string msg )
+
+//------------------------------------------------------------------
+#if 0
+// deprecated. kept here just in case it would be useful in the future (who knows?)
+namespace sub {
+
+/// Returns the index of the segment (among the ones in \c bbox)
+/// that is the farthest from point \c pt
+template<typename FPT1,typename FPT2>
+int
+getFarthestSegment( const Point2d_<FPT1>& pt, const FRect_<FPT2>& bbox )
 {
-	std::cout << "Table: " << msg << "\n  | ";
-	for( uint8_t r=0;r<4; r++ )
-		std::cout << (int)r << " ";
-	std::cout << "\n--|---------|\n";
-	for( uint8_t r=0;r<4; r++ )
+	auto segs = bbox.getSegs();
+	using localPair = std::pair<HOMOG2D_INUMTYPE,int>;
+	std::array<localPair,4> dist_array;
+	for( int i=0; i<4; i++ )
 	{
-		std::cout << (int)r << " | ";
-		for( uint8_t c=0;c<4; c++ )
-			std::cout << (t[r][c]._isCorner?'F':'.') << " ";
-		std::cout << "|\n";
+		dist_array[i].first  = pt.distTo( segs[i].getLine() );
+		dist_array[i].second = i;
 	}
+	std::sort(
+		dist_array.begin(),
+		dist_array.end(),
+		[]                     // lambda
+		( const localPair& i, const localPair& j )
+		{
+			return i.first < j.first;
+		}
+	);
+
+	return dist_array[3].second;
 }
+
+} // namespace sub
 #endif
+} // namespace base
 
+namespace priv {
 //------------------------------------------------------------------
-/// Helper function, used in FRect_<FPT>::unionArea()
-template<typename FPT>
+/// Result of pipTestEdge()
+enum class PipEdge: uint8_t { NoCross, Crosses, OnEdge };
+
+/// Point in polygon, crossing number algorithm: tests point (px,py) against the edge (xi,yi)-(xj,yj)
+/**
+- returns \c OnEdge if the point is at a distance less than \c eps of the edge
+- returns \c Crosses if the horizontal half-line starting at point, going to +infinity, crosses the edge
+(half-open rule on y, so that a vertex is never counted twice)
+
+\sa isInsidePolygon()
+\sa PreparedPolygon
+*/
 inline
-CPolyline_<FPT>
-convertToCoord(
-	const std::vector<PCoord>&      v_coord, ///< vector of coordinate indexes
-	const std::array<Index<FPT>,4>& v_x,      ///< holds x-coordinates
-	const std::array<Index<FPT>,4>& v_y       ///< holds y-coordinates
+PipEdge
+pipTestEdge(
+	HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py,
+	HOMOG2D_INUMTYPE xi, HOMOG2D_INUMTYPE yi,
+	HOMOG2D_INUMTYPE xj, HOMOG2D_INUMTYPE yj,
+	HOMOG2D_INUMTYPE eps
 )
 {
-	std::vector<Point2d_<FPT>> v_pts;
-	for( const auto& elem: v_coord )
+// on-edge check, only if the point is in the (extended) box of the edge
+	if(
+		px >= std::min( xi, xj ) - eps && px <= std::max( xi, xj ) + eps
+		&&
+		py >= std::min( yi, yj ) - eps && py <= std::max( yi, yj ) + eps
+	)
 	{
-		auto id_x = elem.first;
-		auto id_y = elem.second;
-		assert( id_x<4 && id_y<4 );
-
-		auto pt = Point2d_<FPT>( v_x[id_x]._value, v_y[id_y]._value );
-		if( v_pts.empty() )
-			v_pts.push_back( pt );
-		else                             // add to vector only  if not same as previous
-		{                                // and not same as first
-			if( v_pts.back() != pt && v_pts.front() != pt )
-				v_pts.push_back( pt );
-		}
+		auto dx = xj - xi;
+		auto dy = yj - yi;
+		auto t = ( ( px - xi ) * dx + ( py - yi ) * dy ) / ( dx*dx + dy*dy );
+		t = std::max( static_cast<HOMOG2D_INUMTYPE>(0), std::min( static_cast<HOMOG2D_INUMTYPE>(1), t ) );
+		auto ex = xi + t * dx - px;
+		auto ey = yi + t * dy - py;
+		if( ex*ex + ey*ey < eps*eps )
+			return PipEdge::OnEdge;
 	}
-//	printVector( v_pts, "polyline" );
-	return CPolyline_<FPT>( v_pts );//, IsClosed::Yes );
+
+	if( ( yi > py ) != ( yj > py ) )
+		if( px < xi + ( py - yi ) * ( xj - xi ) / ( yj - yi ) )
+			return PipEdge::Crosses;
+	return PipEdge::NoCross;
 }
 
-} // namespace priv
-} // namespace runion
 //------------------------------------------------------------------
-/// Computes the CPolyline of the union of two rectangles
+/// Returns true if point \c pt is inside the polygon defined by the points \c pts
 /**
-Algorithm:
- -# build vectors of x and y coordinates (4 elements)
- -# build table x-y (4x4), with corners tagged
- -# parse the table by turning right at each corner, and left if position is not one the outside row/col
- -# convert back indexes to real coordinates, to build the final CPolyline object
+Crossing number algorithm, see https://en.wikipedia.org/wiki/Point_in_polygon
 
-Two examples:
-\verbatim
-9      +----+              +-------+
-       |    |              |       |
-8  +---+----+---+      +---+---+   |
-   |   |    |   |      |   |   |   |
-7  +---+----+---+      +---+---+   |
-       |    |              |       |
-6      +----+              +-------+
-   1   2    3   4      1   2   3   4
-\endverbatim
-Step 1 will build (for both situations above):
- - vx: 1,2,3,4
- - vy: 6,7,8,9
+Single pass on the points, no allocation, never throws.
+The polygon is assumed to be simple, this is not checked here.
+If the point lies on one of the edges (distance less than thr::nullDistance() ),
+it is considered as not inside.
 
- Step 2 will build a table showing where the corners are:
-\verbatim
-  | 0 1 2 3             | 0 1 2 3
---|---------|         --|---------|
-0 | . F F . |          0| . F . F
-1 | F F F F |          1| F F . .
-2 | F F F F |          2| F F . .
-3 | . F F . |          3| . F . F
-\endverbatim
+See page \ref md_docs_homog2d_algorithms for details.
+*/
+template<typename FPT1,typename FPT2>
+bool
+isInsidePolygon( const Point2d_<FPT1>& pt, const std::vector<Point2d_<FPT2>>& pts )
+{
+	const auto n = pts.size();
+	if( n < 3 )
+		return false;
 
-Step 3: parse that table and turn on each corner:
-- left if "inner" corner (row and col = 1 or = 2)
-- right if "outer" corner (row and col = 0 or = 3)
+	const HOMOG2D_INUMTYPE px = pt.getX();
+	const HOMOG2D_INUMTYPE py = pt.getY();
+	const auto eps = thr::nullDistance();
 
-Final step: convert indexes to real coordinates
+	bool inside = false;
+	HOMOG2D_INUMTYPE xi = pts[n-1].getX();   // previous point
+	HOMOG2D_INUMTYPE yi = pts[n-1].getY();
+	for( size_t j=0; j<n; j++ )
+	{
+		HOMOG2D_INUMTYPE xj = pts[j].getX();
+		HOMOG2D_INUMTYPE yj = pts[j].getY();
+		switch( pipTestEdge( px, py, xi, yi, xj, yj, eps ) )
+		{
+			case PipEdge::OnEdge:  return false;
+			case PipEdge::Crosses: inside = !inside; break;
+			default: break;
+		}
+		xi = xj;
+		yi = yj;
+	}
+	return inside;
+}
 
-Special note: if the rectangles have an identical coordinate, as in this example:
-\verbatim
-9      +----+
-       |    |
-8  +---+----+
-   |   |    |
-7  +---+----+
-       |    |
-6      +----+
-   1   2    3
-\endverbatim
-Then the vectors are:
-- vx: 1,2,3,3
-- vy: 6,7,8,9
+} // namespace priv
 
-(notice the duped coordinate)
+namespace base {
 
-This will produce a Polyline_ with 2 extra points:<br>
-(1,7)-(1,8)-(2,8)-(2,9)-(3,9)-(3,8)-(3,7)-(3,6)-(2,6)-(2,7)
-<br>instead of:<br>
-(1,7)-(1,8)-(2,8)-(2,9)-(3,9)-(3,6)-(2,6)-(2,7)
-<br>We solve this by proceeding an extra Polyline minimization,
-see PolylineBase::minimize()
+//------------------------------------------------------------------
+/// Returns true if point is inside closed Polyline
+/**
+Returns false if the polyline is not a polygon (see PolylineBase::isSimple() ),
+or if the point lies on one of its edges.
+O(log n) if the polygon is already known to be convex (see PolylineBase::isConvex() ), O(n) otherwise.
+\sa priv::isInsidePolygon()
 */
-template<typename FPT>
-template<typename FPT2>
-CPolyline_<FPT>
-FRect_<FPT>::unionArea( const FRect_<FPT2>& other ) const
+template<typename LP, typename FPT>
+template<typename T,typename PTYPE>
+bool
+LPBase<LP,FPT>::impl_isInsidePoly( const base::PolylineBase<PTYPE,T>& poly, const detail::BaseHelper<typename typ::IsPoint>& ) const
 {
-	using namespace priv::runion;
-
-	if( *this == other )                  // if same rectangles, then
-		return CPolyline_<FPT>( other );   // returns one of them
+	if( const auto* convex = poly.p_getConvexIndex() )   // O(log n)
+		return convex->contains( getX(), getY() );
+	if( !poly.isSimple() )
+		return false;
+	return priv::isInsidePolygon( *this, poly.getPts() );
+}
 
-	if( !this->intersects(other)() )  // if no intersection,
-	{
-		if( this->isInside( other ) )
-			return CPolyline_<FPT>(other);
-		if( other.isInside( *this ) )
-			return CPolyline_<FPT>(*this);
-		return CPolyline_<FPT>();      // return empty polygon
-	}
+template<typename LP, typename FPT>
+template<typename T,typename PTYPE>
+constexpr bool
+LPBase<LP,FPT>::impl_isInsidePoly( const base::PolylineBase<PTYPE,T>&, const detail::BaseHelper<typename typ::IsLine>& ) const
+{
+	return false;
+}
 
-/* step 0: make sure the rect with highest x is first.
- This is needed to avoid this kind of situation in table:
+//------------------------------------------------------------------
+/// Point is inside Polyline
+template<typename LP, typename FPT>
+template<typename FPT2>
+bool
+LPBase<LP,FPT>::isInside( const Ellipse_<FPT2>& ell ) const
+{
+	if constexpr( std::is_same_v<LP,typ::IsPoint> )
+		return ell.pointIsInside( *this );
+	else
+		return false;
+}
 
-  F F . .
-  . . F F
-  . . F F
-  F F . .
 
-  That would happen if we have an identical x in the two rect
-  (thus, they DO intersect), because when sorting, the rect with smallest index
-  (1 or 2) is placed first in the vector of coordinates */
-	const auto* pr1 = this;
-	const auto* pr2 = &other;
-	if( pr1->getPts().first.getX() < pr2->getPts().first.getX() )
-		std::swap( pr1, pr2 );
-	const auto& r1 = *pr1;
-	const auto& r2 = *pr2;
+//------------------------------------------------------------------
+/// Intersection of line and circle: implementation for points
+template<typename LP, typename FPT>
+template<typename T>
+constexpr detail::Intersect<detail::Inters_2,FPT>
+LPBase<LP,FPT>::impl_intersectsCircle( const Point2d_<FPT>&, T, const detail::BaseHelper<typename typ::IsPoint>& ) const
+{
+	static_assert( detail::AlwaysFalse<LP>::value, "cannot use intersects(Circle) with a point" );
+}
 
-// step 1: build vectors of coordinates and sort them
-	std::array<Index<FPT>,4> vx, vy;
-	int i=0;
-	vx[i++] = Index<FPT>( r1.getPts().first.getX(),  1 );
-	vx[i++] = Index<FPT>( r1.getPts().second.getX(), 1 );
-	vx[i++] = Index<FPT>( r2.getPts().first.getX(),  2 );
-	vx[i++] = Index<FPT>( r2.getPts().second.getX(), 2 );
+/// Line/Circle intersection: implementation
+/// For computation details, checkout http://skramm.lautre.net/files/misc/intersect_circle_line.pdf
+/// \todo 20230124: change return type: intersection of a circle with a line can be a single point
+template<typename LP, typename FPT>
+template<typename T>
+detail::Intersect<detail::Inters_2,FPT>
+LPBase<LP,FPT>::impl_intersectsCircle(
+	const Point2d_<FPT>& pt,       ///< circle origin
+	T                    radius,   ///< radius
+	const detail::BaseHelper<typename typ::IsLine>&  ///< dummy arg, needed so that this overload is only called for lines
+) const
+{
+	detail::Intersect<detail::Inters_2,FPT> out;
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	const HOMOG2D_INUMTYPE a = static_cast<HOMOG2D_INUMTYPE>(_v[0]); // just to lighten a bit...
+	const HOMOG2D_INUMTYPE b = static_cast<HOMOG2D_INUMTYPE>(_v[1]);
+	const HOMOG2D_INUMTYPE c = static_cast<HOMOG2D_INUMTYPE>(_v[2]);
 
-	i=0;
-	vy[i++] = Index<FPT>( r1.getPts().first.getY(),  1 );
-	vy[i++] = Index<FPT>( r1.getPts().second.getY(), 1 );
-	vy[i++] = Index<FPT>( r2.getPts().first.getY(),  2 );
-	vy[i++] = Index<FPT>( r2.getPts().second.getY(), 2 );
+// step 1: translate to origin
+	auto cp = pt.getX() * a + pt.getY() * b + c;
 
-	std::sort( vx.begin(), vx.end() );
-	std::sort( vy.begin(), vy.end() );
-//	priv::printArray( vx, "vx" ); priv::printArray( vy, "vy");
+// step 2: compute distance	between center (origin) and middle point
+	auto a2b2 = a * a + b * b;
+	auto d0 = homog2d_abs(cp) / homog2d_sqrt( a2b2 );
+	if( radius < d0 )                            // if less than radius,
+		return out;                         // no intersection
 
-// step 2: fill table\n";
-	Table table;
-	for( uint8_t r=0;r<4; r++ )
-		for( uint8_t c=0;c<4; c++ )
-			table[r][c] = Cell( vx[r], vy[c] );
-//	printTable( table, "after step 2" );
+	auto d2 = radius*radius - d0*d0;
 
-// step 3: parse table
-	auto vpts = parseTable( table );
-//	priv::printVectorPairs( vpts );
+// step 3: compute coordinates of middle point B
+	auto xb = - a * cp / a2b2;
+	auto yb = - b * cp / a2b2;
 
-// step 4: convert back vector of coordinates indexes into vector of coordinates
-	auto res1 = convertToCoord( vpts, vx, vy );
-	res1.minimize(); // remove unecessary points
-	return res1;
-}
+// step 4: compute coordinates of intersection points, with center at (0,0)
+	auto m  = homog2d_sqrt( d2 / a2b2 );
+	auto x1 = xb + m*b;
+	auto y1 = yb - m*a;
 
-//------------------------------------------------------------------
-namespace detail {
+	auto x2 = xb - m*b;
+	auto y2 = yb + m*a;
 
-//------------------------------------------------------------------
-/// See getPtLabel( const Point2d_<FPT>& pt, const Circle_<FPT2>& circle )
-enum class PtTag: uint8_t
-{
-	Inside, Outside, OnEdge
-};
+// last step: translate back
+	out._ptIntersect_1.set( x1 + pt.getX(), y1 + pt.getY() );
+	out._ptIntersect_2.set( x2 + pt.getX(), y2 + pt.getY() );
+	out._doesIntersect = true;
 
-/// Returns a label characterizing point \c pt, related to \c circle: inside, outside, or on edge of circle
-template<typename FPT,typename FPT2>
-PtTag
-getPtLabel( const Point2d_<FPT>& pt, const Circle_<FPT2>& circle )
+	priv::fix_order( out._ptIntersect_1, out._ptIntersect_2 );
+	return out;
+}
+//------------------------------------------------------------------
+/// Overload used when attempting to use that on a point
+template<typename LP, typename FPT>
+template<typename FPT2>
+constexpr detail::IntersectM<FPT>
+LPBase<LP,FPT>::impl_intersectsFRect( const FRect_<FPT2>&, const detail::BaseHelper<typename typ::IsPoint>& ) const
 {
-	if( pt.isInside( circle ) )
-		return PtTag::Inside;
-	if(
-		homog2d_abs( pt.distTo( circle.center() ) - circle.radius() )
-			< thr::nullDistance()
-	)
-		return PtTag::OnEdge;
-	return PtTag::Outside;
+	static_assert( detail::AlwaysFalse<LP>::value, "Invalid: you cannot call intersects(FRect) on a point" );
 }
-#if 0
-/// Debug, can be removed after
-void
-printTag( std::string txt, PtTag tag )
+
+/// Line/FRect intersection
+/**
+Returns 0, 1, or 2 intersections
+(1 when the line touches the edge of rectangle)
+
+\todo 20230118: check if there is a need to fix the order of points in returned object (this was done previously)
+*/
+template<typename LP, typename FPT>
+template<typename FPT2>
+detail::IntersectM<FPT>
+LPBase<LP,FPT>::impl_intersectsFRect( const FRect_<FPT2>& rect, const detail::BaseHelper<typename typ::IsLine>& ) const
 {
-	std::cout << "point " << txt << ": ";
-	switch( tag )
+	std::vector<Point2d_<FPT>> pti;
+	for( const auto& seg: rect.getSegs() ) // get segment of rectangle
 	{
-		case PtTag::Inside: std::cout << "Inside\n"; break;
-		case PtTag::Outside: std::cout << "Outside\n"; break;
-		case PtTag::OnEdge: std::cout << "OnEdge\n"; break;
+		auto ppts_seg = seg.getPts();
+		auto inters = seg.intersects( *this );
+		if( inters() )
+		{
+			bool storePoint(true);
+			auto pt = inters.get();
+			if( pt == ppts_seg.first || pt == ppts_seg.second )  // if intersection point is one of the segment pts
+				if( pti.size() == 1 ) {                          // AND if there is already one
+					if( pti[0] == pt )                           // AND that one is already stored
+						storePoint = false;                      // THEN don't store it
+				}
+			if( storePoint )
+				pti.push_back( pt );
+
+			if( pti.size() == 2 )  // already got 2, done
+				break;
+		}
 	}
+	if( pti.empty() )
+		return detail::IntersectM<FPT>();
+	detail::IntersectM<FPT> out;
+	out.add( pti );
+	return out;
 }
-#endif
-} // namespace detail
 
-namespace base {
+} // namespace base
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - PRODUCT OPERATORS DEFINITIONS (HELPER FUNCTIONS)
+/////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
 //------------------------------------------------------------------
-/// Segment/Segment intersection
+/// Batch transform of points by a homography, used for containers of points
 /**
-Algorithm:<br>
-- first compute the intersection point
-- then check if the intersection point lies in between the range of both segments, both on x and on y
+The loops hold no branches and no function calls, so that they can get vectorized by the compiler
+(4 to 8 points at a time, depending on the instruction set and on the floating-point type).
+A single division is done for each point.
 */
-template<typename SV,typename FPT>
-template<typename SV2,typename FPT2>
-detail::Intersect<detail::Inters_1,FPT>
-SegVec<SV,FPT>::intersects( const SegVec<SV2,FPT2>& s2 ) const
+template<typename FPT>
+class BatchTransform
 {
-//	HOMOG2D_START;
-	if( *this == s2 )              // same segment => no intersection
-		return detail::Intersect<detail::Inters_1,FPT>();
-
-	Line2d_<HOMOG2D_INUMTYPE> l1 = getLine();
-	Line2d_<HOMOG2D_INUMTYPE> l2 = s2.getLine();
-	if( l1.isParallelTo( l2 ) )                            // if parallel,
-		return detail::Intersect<detail::Inters_1,FPT>();  // then, no intersection
+private:
+	HOMOG2D_INUMTYPE _h00, _h01, _h02;
+	HOMOG2D_INUMTYPE _h10, _h11, _h12;
+	HOMOG2D_INUMTYPE _h20, _h21, _h22;
+	bool _isAffine = false;  ///< if true, last row is (0,0,1)
 
-	const auto& ptA1 = getPts().first;
-	const auto& ptA2 = getPts().second;
-	const auto& ptB1 = s2.getPts().first;
-	const auto& ptB2 = s2.getPts().second;
+public:
+	explicit BatchTransform( const Matrix_<FPT>& mat, bool isAffine=false )
+		: _isAffine( isAffine )
+	{
+		const auto& m = mat.getRaw();
+		_h00 = m[0][0]; _h01 = m[0][1]; _h02 = m[0][2];
+		_h10 = m[1][0]; _h11 = m[1][1]; _h12 = m[1][2];
+		_h20 = m[2][0]; _h21 = m[2][1]; _h22 = m[2][2];
+	}
 
-	auto ptInter = l1 * l2;   // intersection point
+/// Transforms \c n points given as arrays of euclidean coordinates (can be done in place).
+/// Returns the number of points that went to infinity
+	template<typename T1,typename T2>
+	size_t apply( const T1* xin, const T1* yin, T2* xout, T2* yout, size_t n ) const
+	{
+		const auto h00 = _h00, h01 = _h01, h02 = _h02; // local copies, so the compiler knows
+		const auto h10 = _h10, h11 = _h11, h12 = _h12; // they cannot be changed by the stores
+		const auto h20 = _h20, h21 = _h21, h22 = _h22;
+		if( _isAffine )
+		{
+			for( size_t i=0; i<n; i++ )
+			{
+				HOMOG2D_INUMTYPE x = xin[i];
+				HOMOG2D_INUMTYPE y = yin[i];
+				xout[i] = h00 * x + h01 * y + h02;
+				yout[i] = h10 * x + h11 * y + h12;
+			}
+			return 0;
+		}
+		size_t nbInf = 0;
+		for( size_t i=0; i<n; i++ )
+		{
+			HOMOG2D_INUMTYPE x = xin[i];
+			HOMOG2D_INUMTYPE y = yin[i];
+			HOMOG2D_INUMTYPE w = h20 * x + h21 * y + h22;
+			nbInf += ( w == 0. );
+			HOMOG2D_INUMTYPE iw = 1. / w;
+			xout[i] = ( h00 * x + h01 * y + h02 ) * iw;
+			yout[i] = ( h10 * x + h11 * y + h12 ) * iw;
+		}
+		return nbInf;
+	}
 
-	auto dA1 = ptA1.distTo( ptInter );
-	auto dA2 = ptA2.distTo( ptInter );
-	if( homog2d_abs(dA1+dA2 - length()) < thr::nullDistance() )
+/// Transforms \c n points (can be done in place: \c out == \c in)
+/**
+Output points are normalized (third homogeneous coordinate is +1 or -1, see LPBase::impl_normalize()).
+If a point goes to infinity, it is stored as such.
+With an affine transformation, the third coordinate is kept and no division is done.
+*/
+	template<typename T1,typename T2>
+	void apply( const Point2d_<T1>* in, Point2d_<T2>* out, size_t n ) const
 	{
-		auto dB1 = ptB1.distTo( ptInter );
-		auto dB2 = ptB2.distTo( ptInter );
-		if( homog2d_abs(dB1+dB2 - s2.length()) < thr::nullDistance() )
-			return detail::Intersect<detail::Inters_1,FPT>( ptInter );
+		const auto h00 = _h00, h01 = _h01, h02 = _h02;
+		const auto h10 = _h10, h11 = _h11, h12 = _h12;
+		const auto h20 = _h20, h21 = _h21, h22 = _h22;
+		if( _isAffine )
+		{
+			for( size_t i=0; i<n; i++ )
+			{
+				HOMOG2D_INUMTYPE x = in[i]._v[0];
+				HOMOG2D_INUMTYPE y = in[i]._v[1];
+				HOMOG2D_INUMTYPE z = in[i]._v[2];
+				HOMOG2D_INUMTYPE u = h00 * x + h01 * y + h02 * z;
+				HOMOG2D_INUMTYPE v = h10 * x + h11 * y + h12 * z;
+				HOMOG2D_INUMTYPE sg = u < 0. ? -1. : 1.;
+				out[i]._v[0] = u * sg;
+				out[i]._v[1] = v * sg;
+				out[i]._v[2] = z * sg;
+			}
+			return;
+		}
+		for( size_t i=0; i<n; i++ )
+		{
+			HOMOG2D_INUMTYPE x = in[i]._v[0];
+			HOMOG2D_INUMTYPE y = in[i]._v[1];
+			HOMOG2D_INUMTYPE z = in[i]._v[2];
+			HOMOG2D_INUMTYPE u = h00 * x + h01 * y + h02 * z;
+			HOMOG2D_INUMTYPE v = h10 * x + h11 * y + h12 * z;
+			HOMOG2D_INUMTYPE w = h20 * x + h21 * y + h22 * z;
+			bool isFinite = ( w != 0. );
+			HOMOG2D_INUMTYPE iw = isFinite ? 1. / w : 1.;
+			u *= iw;
+			v *= iw;
+			w  = isFinite ? 1. : 0.;
+			HOMOG2D_INUMTYPE sg = u < 0. ? -1. : 1.;
+			out[i]._v[0] = u * sg;
+			out[i]._v[1] = v * sg;
+			out[i]._v[2] = w * sg;
+		}
 	}
-	return detail::Intersect<detail::Inters_1,FPT>(); // no intersection
-}
+};
+
+} // namespace detail
 
 //------------------------------------------------------------------
-/// Segment/Line intersection
+/// Apply homography to a vector/array/list (type T) of points or lines.
 /**
-Algorithm:<br>
-We check if the intersection point lies in between the range of the segment, both on x and on y
+Vectors and arrays of points are processed with a vectorizable kernel (see detail::BatchTransform).
 */
-template<typename SV,typename FPT>
-template<typename FPT2>
-detail::Intersect<detail::Inters_1,FPT>
-SegVec<SV,FPT>::intersects( const Line2d_<FPT2>& li1 ) const
+template<typename W,typename FPT>
+template<typename T>
+void
+Hmatrix_<W,FPT>::applyTo( T& vin ) const
 {
-//	HOMOG2D_START;
-//	HOMOG2D_LOG( "seg=" << *this << " line=" << li1 );
-	detail::Intersect<detail::Inters_1,FPT> out;
-	auto li2 = getLine();
-
-	if( li1.isParallelTo( li2 ) ) // if parallel, no intersection
-		return out;
-
-	out._ptIntersect = li1 * li2;   // intersection point
-
-	const auto& pi  = out._ptIntersect;
-	const auto& pt1 = getPts().first;
-	const auto& pt2 = getPts().second;
+	if constexpr(
+		std::is_same_v<W,typ::IsHomogr>
+		&& trait::IsPoint<typename T::value_type>::value
+		&& !trait::IsList<T>::value
+	)
+	{
+		detail::BatchTransform<FPT> bt( *this, kind() != HKind::Projective );
+		bt.apply( vin.data(), vin.data(), vin.size() );
+	}
+	else
+		for( auto& elem: vin )
+			elem = *this * elem;
+}
 
-	auto d1 = pt1.distTo( pi );
-	auto d2 = pt2.distTo( pi );
-	if( homog2d_abs(d1+d2-length()) < thr::nullDistance() )
- 		out._doesIntersect = true;
+//------------------------------------------------------------------
+/// Apply homography (in place) to a set of \c n points, given as two arrays of euclidean coordinates
+/**
+\c xs and \c ys must point on \c n values.
 
-	return out;
+Vectorizable, see detail::BatchTransform.
+Will throw if a point goes to infinity (unless \c HOMOG2D_NOCHECKS is defined), but all the points get processed.
+*/
+template<typename W,typename FPT>
+template<typename T>
+void
+Hmatrix_<W,FPT>::applyTo( T* xs, T* ys, size_t n ) const
+{
+	applyTo( static_cast<const T*>(xs), static_cast<const T*>(ys), xs, ys, n );
 }
 
 //------------------------------------------------------------------
-/// Segment/Circle intersection
+/// Apply homography to a set of \c n points, given as two arrays of euclidean coordinates,
+/// and stores the result in \c xout and \c yout
 /**
-For each point of the segment, we need to consider 3 different situations
- - point is inside (PI)
- - point is outside (PO)
- - point is on the edge (PE)
+All the arrays must hold at least \c n values. Output arrays can be the same as input arrays.
 
-That makes 6 different situations to handle:
+Vectorizable, see detail::BatchTransform.
+Will throw if a point goes to infinity (unless \c HOMOG2D_NOCHECKS is defined), but all the points get processed.
+*/
+template<typename W,typename FPT>
+template<typename T1,typename T2>
+void
+Hmatrix_<W,FPT>::applyTo( const T1* xin, const T1* yin, T2* xout, T2* yout, size_t n ) const
+{
+	static_assert( std::is_same_v<W,typ::IsHomogr>, "Invalid: only for homographies" );
+	HOMOG2D_CHECK_IS_NUMBER( T1 );
+	HOMOG2D_CHECK_IS_NUMBER( T2 );
+	detail::BatchTransform<FPT> bt( *this, kind() != HKind::Projective );
+	auto nbInf = bt.apply( xin, yin, xout, yout, n );
+#ifndef HOMOG2D_NOCHECKS
+	if( nbInf )
+		HOMOG2D_THROW_ERROR_1( "unable to transform " << nbInf << " points, they go to infinity" );
+#else
+	(void)nbInf;
+#endif
+}
+
+namespace detail {
+
+/// Implementation of product 3x3 by 3x3
+
+template<typename FPT1,typename FPT2,typename FPT3>
+void
+product(
+	Matrix_<FPT1>&       out,
+	const Matrix_<FPT2>& h1,
+	const Matrix_<FPT3>& h2
+)
+{
+	out.p_fillZero();
+	for( int i=0; i<3; i++ )
+		for( int j=0; j<3; j++ )
+			for( int k=0; k<3; k++ )
+				out.value(i,j) +=
+					static_cast<HOMOG2D_INUMTYPE>( h1.value(i,k) ) * h2.value(k,j);
+}
 
- - S1: PI-PI => no intersection
- - S2: PI-PO => 1 intersection
- - S3: PI-PE => 1 intersection
- - S4: PO-PO => depends on the support line:
-  - S4A: if line does NOT intersects circle, no intersection pts
-  - S4B: if line does intersects circle, and intersections point in segment area => 2 intersection pts
-  - S4C: if line does intersects circle, and intersections point NOT in segment area => no intersection pts
- - S5: PO-PE => 1 intersection
- - S6: PE-PE => 2 intersections
+/// Implementation of product 3x3 by 3x1
+/**
+- T1 and T2: typ::IsLine or typ::IsPoint (same but also different)
 */
-template<typename SV,typename FPT>
-template<typename FPT2>
-detail::IntersectM<FPT>
-SegVec<SV,FPT>::intersects( const Circle_<FPT2>& circle ) const
+template<typename T1,typename T2,typename FPT1,typename FPT2>
+void
+product(
+	base::LPBase<T1,FPT1>&        out,
+	const Matrix_<FPT2>&          h,
+	const base::LPBase<T2,FPT1>&  in
+)
 {
-//	HOMOG2D_START;
-	using detail::PtTag;
+	for( int i=0; i<3; i++ )
+	{
+		auto sum  = static_cast<HOMOG2D_INUMTYPE>(h._mdata[i][0]) * in._v[0];
+		sum      += h._mdata[i][1] * in._v[1];
+		sum      += h._mdata[i][2] * in._v[2];
+		out._v[i] = sum;
+	}
+}
 
-	auto tag_ptS1 = detail::getPtLabel( _ptS1, circle ); // get status of segment points related to circle (inside/outside/on-edge)
-	auto tag_ptS2 = detail::getPtLabel( _ptS2, circle );
+} // namespace detail
 
-	if( tag_ptS1 == PtTag::Inside )
-		if( tag_ptS2 == PtTag::Inside )
-			return detail::IntersectM<FPT>();
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - PRODUCT OPERATORS DEFINITIONS
+/////////////////////////////////////////////////////////////////////////////
 
-	auto int_lc = getLine().intersects( circle );
-	if( !int_lc() )
-		return detail::IntersectM<FPT>();
+/// Free function template, product of two lines, returns a point
+template<typename FPT,typename FPT2>
+Point2d_<FPT>
+operator * ( const Line2d_<FPT>& lhs, const Line2d_<FPT2>& rhs )
+{
+#ifndef HOMOG2D_NOCHECKS
+	if( lhs.isParallelTo(rhs) )
+		HOMOG2D_THROW_ERROR_1( "lines are parallel, unable to compute product:\nlhs="
+			<< lhs << " rhs=" << rhs
+		);
+#endif
 
-	auto p_pts = int_lc.get();      // get the line intersection points
-	const auto& p1 = p_pts.first;
-	const auto& p2 = p_pts.second;
+	return detail::crossProduct<typ::IsPoint,typ::IsLine,FPT>(lhs, rhs);
+}
 
-	if(                                                            // one inside, the other outside
-		( tag_ptS1 == PtTag::Inside  && tag_ptS2 == PtTag::Outside )
-		||
-		( tag_ptS1 == PtTag::Outside && tag_ptS2 == PtTag::Inside )
-	)
-	{
-		detail::IntersectM<FPT> out;
+/// Free function template, product of two segments/vector, returns a point
+template<typename SV1,typename SV2,typename FPT1,typename FPT2>
+Point2d_<FPT1>
+operator * ( const base::SegVec<SV1,FPT1>& lhs, const base::SegVec<SV2,FPT2>& rhs )
+{
+	return lhs.getLine() * rhs.getLine();
+}
 
-		auto d1 = _ptS1.distTo( p1 );
-		auto d2 = _ptS2.distTo( p1 );
-		if( homog2d_abs( d1+d2-length() ) < thr::nullDistance() )
-			out.add( p1 );                          // points is inside
-		else
-			out.add( p2 );
-		return out;
-	}
+#ifdef HOMOG2D_FUTURE_STUFF
+/// Apply Epipolar matrix to a point or line, this will return the opposite type.
+/// Free function, templated by point or line
+template<typename T,typename U,typename V>
+base::LPBase<typename detail::HelperPL<T>::OtherType,V>
+operator * ( const Hmatrix_<typ::IsEpipmat,U>& h, const base::LPBase<T,V>& in )
+{
+	LPBase<typename detail::HelperPL<T>::OtherType,V> out;
+	detail::product( out, h._data, in );
+	return out;
+}
+#endif
 
-	detail::IntersectM<FPT> out;
-	if( tag_ptS1 == PtTag::Outside && tag_ptS2 == PtTag::Outside ) // both outside
+/// Free function, apply homography to a point.
+template<typename T,typename U>
+Point2d_<T>
+operator * ( const Homogr_<U>& h, const Point2d_<T>& in )
+{
+	Point2d_<T> out;
+	if( h.kind() == HKind::Projective )
+		detail::product( out, h, in );
+	else
 	{
-		auto d1 = _ptS1.distTo( p1 );
-		auto d2 = _ptS2.distTo( p1 );
-		if( homog2d_abs( d1+d2-length() ) >= thr::nullDistance() )   // if sum of the two distances is higher than length
-			return detail::IntersectM<FPT>();
-
-		out.add( p1 );
-		out.add( p2 );
-		return out;
+		detail::BatchTransform<U> bt( h, true );
+		bt.apply( &in, &out, 1 );
 	}
-
-	if( tag_ptS1 == PtTag::OnEdge )
-		out.add( _ptS1 );
-	if( tag_ptS2 == PtTag::OnEdge )
-		out.add( _ptS2 );
-
 	return out;
 }
 
-} // namespace base
+/// Free function, apply homography to a line.
+template<typename T,typename U>
+Line2d_<T>
+operator * ( const Homogr_<U>& h, const Line2d_<T>& in )
+{
+	detail::Matrix_<U> tmp;
+	Line2d_<T> out;
+	detail::product( out, h.p_getInvTransp( tmp ), in );  // H^-T, computed on first call
+	out.p_normalizePL();
+	return out;
+}
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - STREAMING OPERATORS
-/////////////////////////////////////////////////////////////////////////////
+/// Apply homography to a Segment
+template<typename SV,typename FPT1,typename FPT2>
+Segment_<FPT1>
+operator * ( const Homogr_<FPT1>& h, const base::SegVec<SV,FPT2>& seg )
+{
+	const auto& pts = seg.getPts();
+	Point2d_<FPT1> pt1 = h * pts.first;
+	Point2d_<FPT1> pt2 = h * pts.second;
+	return base::SegVec<SV,FPT2>( pt1, pt2 );
+}
 
+namespace priv {
 //------------------------------------------------------------------
-namespace base {
-
-/// Stream operator, free function, call member function pseudo operator impl_op_stream()
-template<typename LP,typename FPT>
-std::ostream&
-operator << ( std::ostream& f, const h2d::base::LPBase<LP,FPT>& pl )
+/// Sets the attributes \c dst of a point set transformed by the non-projective homography \c h, from the attributes \c src
+/// of the original set. Returns false if \c h is not invertible.
+template<typename FPT>
+bool
+setAttribsAffine( PolylineAttribs& dst, const PolylineAttribs& src, const Homogr_<FPT>& h )
 {
-	if constexpr( std::is_same_v<LP,typ::IsLine> )
-		f << '[' << pl._v[0] << ',' << pl._v[1] << ',' << pl._v[2] << "]";
-	else
-	{
-		if( pl.isInf() )
-			f << '[' << pl._v[0] << ',' << pl._v[1] << ',' << pl._v[2] << "]";
-		else
-			f
-		//	<< std::scientific << std::setprecision(25)
-				<< '[' << pl.getX() << ',' << pl.getY() << "]";
-	}
+	HOMOG2D_INUMTYPE a = h.value(0,0), b = h.value(0,1), tx = h.value(0,2);
+	HOMOG2D_INUMTYPE c = h.value(1,0), d = h.value(1,1), ty = h.value(1,2);
+	auto det = a * d - b * c;
+	if( homog2d_abs(det) < thr::nullDeter() )
+		return false;
+	HOMOG2D_INUMTYPE lenScale = -1.;
+	if( h.kind() == HKind::Rigid )
+		lenScale = 1.;
+	if( h.kind() == HKind::Similarity )
+		lenScale = homog2d_sqrt( homog2d_abs(det) );
+	dst.setFromAffine(
+		src,
+		[a,b,c,d,tx,ty]             // lambda
+		( const Point2d_<HOMOG2D_INUMTYPE>& pt )
+		{
+			HOMOG2D_INUMTYPE x = pt.getX();
+			HOMOG2D_INUMTYPE y = pt.getY();
+			return Point2d_<HOMOG2D_INUMTYPE>( a * x + b * y + tx, c * x + d * y + ty );
+		},
+		det,
+		lenScale,
+		( b == 0. && c == 0. ) || ( a == 0. && d == 0. )
+	);
+	return true;
+}
+} // namespace priv
 
-	return f;
+/// Apply homography to a Polyline
+/**
+If the transformation is not projective, the computed attributes (length, area, ...) of the polyline
+are kept (see HKind and priv::PolylineAttribs::setFromAffine())
+*/
+template<typename FPT1,typename FPT2,typename PLT>
+base::PolylineBase<PLT,FPT1>
+operator * ( const Homogr_<FPT2>& h, const base::PolylineBase<PLT,FPT1>& pl )
+{
+	base::PolylineBase<PLT,FPT1> out;
+	const auto& pts = pl.getPts();
+	if( h.kind() != HKind::Projective )
+		if( priv::setAttribsAffine( out._attribs, pl._attribs, h ) )
+		{
+			out._plinevec = h * pts;
+			return out;
+		}
+	for( const auto& pt: pts )
+		out.p_addPoint( h * pt );
+	return out;
 }
 
-} // namespace base
+/// Apply homography to a flat rectangle produces a closed polyline
+template<typename FPT1,typename FPT2>
+CPolyline_<FPT1>
+operator * ( const h2d::Homogr_<FPT2>& h, const h2d::FRect_<FPT1>& rin )
+{
+	h2d::CPolyline_<FPT1> out;
+	for( const auto& pt: rin.get4Pts() )
+		out.p_addPoint( h * pt );
+	return out;
+}
 
-/// Stream operator for a container of points/lines, free function
-template<
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
-std::ostream&
-operator << ( std::ostream& f, const T& vec )
+/// Apply homography to a Ellipse, produces an Ellipse
+/**
+\f[
+Q' = H^{-T} \cdot Q \cdot H^{-1}
+\f]
+*/
+template<typename FPT1,typename FPT2>
+Ellipse_<FPT1>
+operator * ( const Homogr_<FPT2>& h, const Ellipse_<FPT1>& ell_in )
 {
-	f << "#="<< vec.size() << '\n';
-	for( const auto& elem: vec )
-		f << elem << '\n';
-	return f;
+	auto hm = static_cast<detail::Matrix_<HOMOG2D_INUMTYPE>>(h);
+	hm.inverse();
+	auto hmt = hm;
+	hmt.transpose();
+
+	const auto& ell_in2 = static_cast<detail::Matrix_<FPT1>>(ell_in);
+	auto prod = hmt * ell_in2 * hm;
+
+	Ellipse_<FPT1> out( prod );
+	return out;
 }
 
-/// Stream operator for a pair of points/lines, free function
-template<typename LP1,typename LP2,typename FPT>
-std::ostream&
-operator << ( std::ostream& f, const std::pair<base::LPBase<LP1,FPT>,base::LPBase<LP2,FPT>>& pr )
+/// Apply homography to a Circle, produces an Ellipse
+/** Converts the circle to an ellipse, then calls the corresponding code */
+template<typename FPT1,typename FPT2>
+Ellipse_<FPT1>
+operator * ( const Homogr_<FPT2>& h, const Circle_<FPT1>& cir )
 {
-	f << "std::pair (" << getString(pr.first.type()) << "-" << getString(pr.second.type())
-		<< "):\n -first="  << pr.first
-		<< "\n -second=" << pr.second
-		<< ' ';
-	return f;
+	Ellipse_<FPT1> ell_in( cir );
+	return h * ell_in;
 }
 
-template<typename T>
-std::ostream&
-operator << ( std::ostream& f, const FRect_<T>& r )
+//------------------------------------------------------------------
+namespace priv {
+
+/// Allocation for \c std::array container
+/**
+\sa operator * ( const Hmatrix_&, const Cont& );
+*/
+template<
+	typename Cont,
+	typename std::enable_if<
+		trait::IsArray<Cont>::value,
+		Cont
+	>::type* = nullptr
+>
+Cont
+alloc( std::size_t /* unused here */ )
 {
-	f << "pt1: " << r._ptR1 << " pt2: " << r._ptR2;
-	return f;
+	return Cont();
 }
 
-template<typename T>
-std::ostream&
-operator << ( std::ostream& f, const Circle_<T>& r )
+/// Allocation for \c std::vector and \c std::list container
+template<
+	typename Cont,
+	typename std::enable_if<
+		!trait::IsArray<Cont>::value,
+		Cont
+	>::type* = nullptr
+>
+Cont
+alloc( std::size_t nb )
 {
-	f << "center: " << r._center << ", radius=" << r._radius;
-	return f;
+	return Cont(nb);
 }
 
-namespace base {
-
-template<typename SV,typename T>
-std::ostream&
-operator << ( std::ostream& f, const h2d::base::SegVec<SV,T>& seg )
-{
-	f << seg._ptS1;
-	if constexpr( std::is_same_v<SV,typ::IsOSeg> )
-		f << "=>";
-	else
-		f << "-";
-	f << seg._ptS2;
-	return f;
-}
+} // namespace priv
 
-template<typename PLT,typename FPT>
-std::ostream&
-operator << ( std::ostream& f, const h2d::base::PolylineBase<PLT,FPT>& pl )
+//------------------------------------------------------------------
+/// Used to proceed multiple products, whatever the container (\c std::list, \c std::vector, or \c std::array).
+/// Returned container is of same type as given input
+template<typename FPT,typename Cont>
+typename std::enable_if<trait::IsContainer<Cont>::value,Cont>::type
+operator * (
+	const Hmatrix_<typ::IsHomogr,FPT>& h,    ///< Matrix
+	const Cont&                        vin   ///< Input container
+)
 {
-	f << (pl.isClosed() ? 'C' : 'O' ) << "Polyline: ";
-	if( !pl.size() )
-		f << "empty";
+	Cont vout = priv::alloc<Cont>( vin.size() );
+	if constexpr( trait::IsPoint<typename Cont::value_type>::value && !trait::IsList<Cont>::value )
+	{
+		detail::BatchTransform<FPT> bt( h, h.kind() != HKind::Projective );
+		bt.apply( vin.data(), vout.data(), vin.size() );
+	}
 	else
 	{
-		for( const auto& pt: pl._plinevec )
-			f << pt << "-";
+		auto it = std::begin( vout );
+		for( const auto& elem: vin )
+			*it++ = h * elem;
 	}
-	return f;
-}
-} // namespace base
-
-template<typename T>
-std::ostream&
-operator << ( std::ostream& f, const Ellipse_<T>& ell )
-{
-	auto par = ell.template p_getParams<HOMOG2D_INUMTYPE>();
-	f << par;
-	return f;
+	return vout;
 }
 
 //------------------------------------------------------------------
-/// Returns the 2 parallel lines at distance \c dist from \c li (free function)
-template<typename FPT,typename T>
-std::pair<Line2d_<FPT>,Line2d_<FPT>>
-getParallelLines( const Line2d_<FPT>& li, T dist )
-{
-	return li.getParallelLines( dist );
+/// Apply homography to a Polyline stored as "Structure of Arrays", see detail::BatchTransform
+template<typename FPT1,typename FPT2,typename PLT>
+auto
+operator * ( const Homogr_<FPT2>& h, const base::PolylineSoA<PLT,FPT1>& pl ) -> base::PolylineSoA<PLT,FPT1>
+{
+	base::PolylineSoA<PLT,FPT1> out;
+	out._vx.resize( pl.size() );
+	out._vy.resize( pl.size() );
+	h.applyTo( pl._vx.data(), pl._vy.data(), out._vx.data(), out._vy.data(), pl.size() );
+	if( h.kind() != HKind::Projective )
+		priv::setAttribsAffine( out._attribs, pl._attribs, h );
+	return out;
 }
 
 /////////////////////////////////////////////////////////////////////////////
-// SECTION  - MEMBER FUNCTION IMPLEMENTATION: CLASS Ellipse_
+// SECTION  - FREE FUNCTIONS
 /////////////////////////////////////////////////////////////////////////////
 
-//------------------------------------------------------------------
-/// Returns standard parameters from matrix coeffs
-template<typename FPT>
-template<typename T>
-detail::EllParams<T>
-Ellipse_<FPT>::p_getParams() const
-{
-#ifdef HOMOG2D_OPTIMIZE_SPEED
-	if( _epHasChanged )
-	{
-		_par = p_computeParams<T>();
-		_epHasChanged = false;
-	}
-	return _par;
-#else
-	return p_computeParams<T>();
-#endif // HOMOG2D_OPTIMIZE_SPEED
-}
-//------------------------------------------------------------------
-/// Compute and returns standard parameters from matrix coeffs
-/**
-\note In the checking below, we **cannot** print the matrix using the
-<< operator, because it call this function, thus it would enter
-an infinite loop (an eventually SO).
-*/
 template<typename FPT>
-template<typename T>
-detail::EllParams<T>
-Ellipse_<FPT>::p_computeParams() const
-{
-	const auto& m = detail::Matrix_<FPT>::_mdata;
-	HOMOG2D_INUMTYPE A = m[0][0];
-	HOMOG2D_INUMTYPE C = m[1][1];
-	HOMOG2D_INUMTYPE F = m[2][2];
-	HOMOG2D_INUMTYPE B = 2. * m[0][1];
-	HOMOG2D_INUMTYPE D = 2. * m[0][2];
-	HOMOG2D_INUMTYPE E = 2. * m[1][2];
-
-	detail::EllParams<T> par;  // theta already set to zero
+FPT getX( const Point2d_<FPT>& pt) { return pt.getX(); }
 
-	auto denom = B*B - (HOMOG2D_INUMTYPE)4. * A * C;
+template<typename FPT>
+FPT getY( const Point2d_<FPT>& pt) { return pt.getY(); }
 
-#ifndef HOMOG2D_NOCHECKS
-	if( homog2d_abs(denom) < thr::nullDenom() )
-		HOMOG2D_THROW_ERROR_1(
-			"unable to compute parameters, denom=" << std::scientific << std::setprecision(15) << denom
-		);
-#endif
+//------------------------------------------------------------------
+/// Free function, returns -1 or +1 depending on the side of \c pt, related to \c li
+template<typename FPT1,typename FPT2>
+int
+side( const Point2d_<FPT1>& pt, const Line2d_<FPT2>& li )
+{
+	const auto& arr = li.get();
+	HOMOG2D_INUMTYPE a = arr[0];
+	HOMOG2D_INUMTYPE b = arr[1];
+	HOMOG2D_INUMTYPE c = arr[2];
 
-	par.x0 = ( (HOMOG2D_INUMTYPE)2.*C*D - B*E ) / denom;
-	par.y0 = ( (HOMOG2D_INUMTYPE)2.*A*E - B*D ) / denom;
-	auto common_ab = (HOMOG2D_INUMTYPE)2. * ( A*E*E + C*D*D - B*D*E + denom*F );
-	auto AmC = A-C;
-	auto AmC2 = AmC*AmC;
+	auto dist = a * pt.getX() + b * pt.getY() + c;
+	if( homog2d_abs(dist) < thr::nullDistance() )
+		return 0;
+	return (std::signbit( dist ) ? -1 : +1);
+}
 
-	auto sqr = homog2d_sqrt(AmC2+B*B);
-	par.a = -homog2d_sqrt( common_ab * ( A+C+sqr ) )/ denom;
-	par.b = -homog2d_sqrt( common_ab * ( A+C-sqr ) )/ denom;
+//------------------------------------------------------------------
+/// Free function, distance between points
+/// \sa Point2d_::distTo()
+template<typename FPT1,typename FPT2>
+HOMOG2D_INUMTYPE
+dist( const Point2d_<FPT1>& pt1, const Point2d_<FPT2>& pt2 )
+{
+	return pt1.distTo( pt2 );
+}
 
+//------------------------------------------------------------------
+/// Intersection area over Union area (free function)
+template<typename FPT1,typename FPT2>
+HOMOG2D_INUMTYPE
+IoU( const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
+{
+	auto ia = intersectArea( r1, r2 );
+	if( ia() )
+		return ia.get().area() / unionArea( r1, r2 ).area();
+	return 0.;
+}
 
-	par.a2 = par.a * par.a;
-	par.b2 = par.b * par.b;
-	if( homog2d_abs(B) < thr::nullDenom() )
-	{
-		if( A > C )
-			par.theta = 90.;
-	}
-	else
-	{
-		auto t = (C - A - sqr) / B;
-		par.theta = homog2d_atan( t );
-	}
-	par.sint = homog2d_sin( par.theta );
-	par.cost = homog2d_cos( par.theta );
-	return par;
+//------------------------------------------------------------------
+/// Free function, see FRect_::unionArea()
+template<typename FPT1,typename FPT2>
+CPolyline_<FPT1>
+unionArea( const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
+{
+	return r1.unionArea(r2);
 }
 
 //------------------------------------------------------------------
-/// Returns true if ellipse is a circle
-/**
-Using the matrix representation, if A = C and B = 0, then the ellipse is a circle
+/// Free function, see FRect_::intersectArea()
+template<typename FPT1,typename FPT2>
+detail::RectArea<FPT1>
+intersectArea(  const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
+{
+	return r1.intersectArea(r2);
+}
 
-You can provide the 0 threshold as and argument
-*/
+//------------------------------------------------------------------
+/// Returns circle passing through 4 points of flat rectangle (free function)
+/// \sa FRect_::getBoundingCircle()
 template<typename FPT>
-bool
-Ellipse_<FPT>::isCircle( HOMOG2D_INUMTYPE thres ) const
+Circle_<FPT>
+getBoundingCircle( const FRect_<FPT>& rect )
 {
-	const auto& m = detail::Matrix_<FPT>::_mdata;
-	HOMOG2D_INUMTYPE A  = m[0][0];
-	HOMOG2D_INUMTYPE C  = m[1][1];
-	HOMOG2D_INUMTYPE B2 = m[0][1];
-	if( homog2d_abs(A-C) < thres )
-		if( homog2d_abs(B2)*2. < thres )
-			return true;
-	return false;
+	return rect.getBoundingCircle();
 }
 
 //------------------------------------------------------------------
-/// Returns center of ellipse
-/// \sa center( const T& )
+/// Return circle inscribed in rectangle
+/// \sa hFRect_::getInscribedCircle()
 template<typename FPT>
-Point2d_<FPT>
-Ellipse_<FPT>::getCenter() const
+Circle_<FPT>
+getInscribedCircle( const FRect_<FPT>& rect )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	return Point2d_<FPT>( par.x0, par.y0 );
+	return rect.getInscribedCircle();
 }
 
 //------------------------------------------------------------------
-template<typename FPT>
-std::pair<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>
-Ellipse_<FPT>::getMajMin() const
+/// Returns true if is a polygon (free function)
+///  \sa PolylineBase::isSimple()
+template<typename PLT,typename FPT>
+bool
+isSimple( const base::PolylineBase<PLT,FPT>& pl )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	return std::make_pair( par.a, par.b );
+	return pl.isSimple();
 }
 
 //------------------------------------------------------------------
-/// Returns angle of ellipse
-/// \sa angle( const Ellipse_& )
-template<typename FPT>
-HOMOG2D_INUMTYPE
-Ellipse_<FPT>::angle() const
+/// Returns true if polygon is convex (free function)
+/// \sa PolylineBase::isConvex()
+template<typename PLT,typename FPT>
+bool
+isConvex( const base::PolylineBase<PLT,FPT>& poly )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	return par.theta;
+	return poly.isConvex();
 }
 
 //------------------------------------------------------------------
-/// Returns (approximate) perimeter of ellipse using the Ramanujan second formulae
-/**
-See https://en.wikipedia.org/wiki/Ellipse#Circumference
-*/
-template<typename FPT>
-HOMOG2D_INUMTYPE
-Ellipse_<FPT>::length() const
+/// Returns the number of segments (free function)
+/// \sa PolylineBase::nbSegs()
+template<typename PLT,typename FPT>
+size_t
+nbSegs( const base::PolylineBase<PLT,FPT>& pl )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	auto ab_sum  = par.a + par.b;
-	auto ab_diff = par.a - par.b;
-	auto h = ab_diff * ab_diff / (ab_sum * ab_sum);
-	auto denom = (HOMOG2D_INUMTYPE)10. + homog2d_sqrt(4. - 3. * h);
-	return (par.a + par.b) * M_PI * ( 1. + 3. * h / denom );
+	return pl.nbSegs();
 }
 
 //------------------------------------------------------------------
-/// Returns pair of axis lines of ellipse
-template<typename FPT>
-std::pair<Line2d_<FPT>,Line2d_<FPT>>
-Ellipse_<FPT>::getAxisLines() const
+/// Returns the segments of the polyline (free function)
+/// \sa PolylineBase::getSegs()
+template<typename PLT,typename FPT>
+std::vector<Segment_<FPT>>
+getSegs( const base::PolylineBase<PLT,FPT>& pl )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	auto dy = static_cast<HOMOG2D_INUMTYPE>(par.sint) * par.a;
-	auto dx = static_cast<HOMOG2D_INUMTYPE>(par.cost) * par.a;
-	Point2d_<HOMOG2D_INUMTYPE> ptA(
-		par.x0 + dx,
-		par.y0 + dy
-	);
-	auto pt0 = Point2d_<HOMOG2D_INUMTYPE>( par.x0, par.y0 );
-	auto li_H = ptA * pt0;
-	HOMOG2D_LOG( std::scientific << "ptA=" << ptA << " pt0=" << pt0 << " li_H=" << li_H );
-
-	auto li_V = li_H.getOrthogLine( pt0 );
-	return std::make_pair( li_H, li_V );
+	return pl.getSegs();
 }
 
 //------------------------------------------------------------------
-/// Returns axis-aligned bounding box of ellipse
-/**
-- see https://math.stackexchange.com/questions/91132/how-to-get-the-limits-of-rotated-ellipse
-*/
-template<typename FPT>
-auto
-Ellipse_<FPT>::getBB() const
+/// Rotates the primitive (only available for Polyline and FRect) around (0,0)
+template<typename T>
+void
+rotate( T& prim, Rotate rot )
 {
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	auto vx = par.a2 * par.cost * par.cost	+ par.b2 * par.sint * par.sint;
-	auto vy = par.a2 * par.sint * par.sint	+ par.b2 * par.cost * par.cost;
-	auto vx_sq = homog2d_sqrt( vx );
-	auto vy_sq = homog2d_sqrt( vy );
-	return FRect_<HOMOG2D_INUMTYPE>(
-		Point2d_<HOMOG2D_INUMTYPE>( par.x0 - vx_sq, par.y0 - vy_sq ),
-		Point2d_<HOMOG2D_INUMTYPE>( par.x0 + vx_sq, par.y0 + vy_sq )
-	);
+	prim.rotate( rot );
 }
 
 //------------------------------------------------------------------
-/// Returns oriented bounding box of ellipse as a closed Polyline
-/**
-Algorithm:
- - build line \c liH going through major axis, by using center point and
- point on semi-major axis, intersecting ellipse
- - get opposite point \c ptB, lying on line and at distance \c a
- - get the two parallel lines to \c liH, at a distance \c b
- - get the two orthogonal lines at \c ptA and \c ptB
-
-\todo 20240330: unclear, the text above does not match what is done below (or does it?).
-Clarify that, and build a gif showing how this is done.
-*/
-template<typename FPT>
-CPolyline_<FPT>
-Ellipse_<FPT>::getOBB() const
+/// Rotates the primitive (only available for Polyline and FRect) around \c refpt
+template<typename T,typename FPT>
+void
+rotate( T& prim, Rotate rot, const Point2d_<FPT>& refpt )
 {
-// step 1: build ptA using angle
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	auto dy = par.sint * par.a;
-	auto dx = par.cost * par.a;
-	Point2d_<FPT> ptA(
-		par.x0 + dx,
-		par.y0 + dy
-	);
-	auto pt0 = Point2d_<HOMOG2D_INUMTYPE>( par.x0, par.y0 );
-
-// step 2: build main-axis line, going through center and ptA
-	auto li_H = ptA * pt0;
-
-// step 3: get ptB, using line and distance
-	auto ppts = li_H.getPoints( pt0, par.a );
-	auto ptB = ppts.first;
-	if( ptB == ptA )
-		ptB = ppts.second;
-
-	auto para = getParallelLines( li_H, par.b );
-	auto li_V1 = li_H.getOrthogLine( ptA );
-	auto li_V2 = li_H.getOrthogLine( ptB );
-
-	CPolyline_<FPT> out;
-#ifndef	HOMOG2D_DEBUGMODE
-	out.p_addPoint( para.first  * li_V1 );
-	out.p_addPoint( para.second * li_V1 );
-	out.p_addPoint( para.second * li_V2 );
-	out.p_addPoint( para.first  * li_V2 );
-#else
-	auto p1 = para.first  * li_V1;
-	auto p2 = para.second * li_V1;
-	auto p3 = para.second * li_V2;
-	auto p4 = para.first  * li_V2;
-	HOMOG2D_DEBUG_ASSERT(
-		( p2!=p1 && p3!=p2 && p4!=p3 ),
-		"p1=" << p1 << " p2=" << p2 << " p3=" << p3 << " p4=" << p4
-		<< "\n para.1=" << para.first
-		<< "\n li_V1=" << li_V1
-		<< "\n ptA=" << ptA
-		<< "\n ptB=" << ptB
-		<< "\n " << ppts
-	);
-	out.p_addPoint( p1 );
-	out.p_addPoint( p2 );
-	out.p_addPoint( p3 );
-	out.p_addPoint( p4 );
-#endif
-	return out;
+	prim.rotate( rot, refpt );
 }
 
 //------------------------------------------------------------------
-/// Returns true if point is inside ellipse
-/**
-taken from https://stackoverflow.com/a/16814494/193789
-*/
+/// Returns Bounding Box of Ellipse_ (free function)
+/// \sa Ellipse_::getBB()
 template<typename FPT>
-template<typename FPT2>
-bool
-Ellipse_<FPT>::pointIsInside( const Point2d_<FPT2>& pt ) const
+CPolyline_<FPT>
+getOBB( const Ellipse_<FPT>& ell )
 {
-	HOMOG2D_INUMTYPE x = pt.getX();
-	HOMOG2D_INUMTYPE y = pt.getY();
-
-	auto par = p_getParams<HOMOG2D_INUMTYPE>();
-	const auto& x0 = par.x0;
-	const auto& y0 = par.y0;
-
-	auto v1 = par.cost * (x-x0) + par.sint * (y-y0);
-	HOMOG2D_INUMTYPE sum = v1*v1 / par.a2;
-
-	auto v2 = par.sint * (x-x0) - par.cost * (y-y0);
-	sum += v2*v2 / par.b2;
-	if( sum < 1. )
-		return true;
-	return false;
+	return ell.getOBB();
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - MEMBER FUNCTION IMPLEMENTATION: CLASS LPBase
-/////////////////////////////////////////////////////////////////////////////
-
-namespace base {
 //------------------------------------------------------------------
-/// Normalize to unit length, and make sure \c a is always >0
+/// Returns bisector lines of a Polyline
 /**
-\todo Checkout: in what situation will we be unable to normalize?
-Is the test below relevant? Clarify.
+Size of vector will be:
+- equal to size() of polyline if closed
+- equal to size()-2 of polyline if open
+
+\warning:
+- if open: the FIRST line (index 0) will correspond to SECOND point of the polyline
 */
-template<typename LP,typename FPT>
-void
-LPBase<LP,FPT>::impl_normalize( const detail::BaseHelper<typename typ::IsLine>& ) const
+template<typename PLT,typename FPT>
+std::vector<Line2d_<HOMOG2D_INUMTYPE>>
+getBisectorLines( const base::PolylineBase<PLT,FPT>& pl )
 {
-// not sure which one is the best...
-#if 0
-	auto sq = homog2d_sqrt( _v[0]*_v[0] + _v[1]*_v[1] );
-#else
-	#ifdef HOMOG2D_USE_TTMATH
-		auto sq = ttmath::Sqrt( _v[0]*_v[0] + _v[1]*_v[1] );
-	#else
-		auto sq = std::hypot( _v[0], _v[1] );
-	#endif
-#endif
-
-#ifndef HOMOG2D_NOCHECKS
-	if( sq <= std::numeric_limits<double>::epsilon() )
-		HOMOG2D_THROW_ERROR_1( "unable to normalize line, sq=" << sq << " values: a=" << _v[0] << " b=" << _v[1] << " c=" << _v[2] );
-#endif
-	for( int i=0; i<3; i++ )
-		const_cast<LPBase<LP,FPT>*>(this)->_v[i] /= sq; // needed to remove constness
-
-	if( _v[0] < 0. ) // a always >0
-		for( int i=0; i<3; i++ )
-			const_cast<LPBase<LP,FPT>*>(this)->_v[i] = -_v[i];
+	if( pl.size() < 3 )
+	{
+		HOMOG2D_THROW_ERROR_1( "unable, minimum size is 3, currently=" << pl.size() );
+	}
+	const auto& pts  = pl.getPts();
+	std::vector<Line2d_<HOMOG2D_INUMTYPE>> out;
 
-	if( homog2d_abs(_v[0]) < thr::nullDenom() ) // then, change sign so that b>0
-		if( _v[1] < 0 )
+	if constexpr ( std::is_same_v<PLT,typ::IsOpen> )
+	{
+		out.reserve( pl.size()-2 );
+		OSegment_<HOMOG2D_INUMTYPE> seg1( pts[1], pts[0] );
+		for( size_t i=0; i<pl.size()-2; i++ )
 		{
-			const_cast<LPBase<LP,FPT>*>(this)->_v[1] = - _v[1];
-			const_cast<LPBase<LP,FPT>*>(this)->_v[2] = - _v[2];
+			OSegment_<HOMOG2D_INUMTYPE> seg2( pts[i+1], pts[i+2] );
+			auto angle = seg1.getAngle( seg2 );
+			out.emplace_back( seg1.getLine().getRotatedLine( pts[i+1], angle/2. ) );
+			seg1 = -seg2;
 		}
-}
-
-//------------------------------------------------------------------
-/// Point normalization. Just make sure a>0
-template<typename LP,typename FPT>
-void
-LPBase<LP,FPT>::impl_normalize( const detail::BaseHelper<typename typ::IsPoint>& ) const
-{
-	if( _v[0] < 0. )
-	{
-		const_cast<LPBase<LP,FPT>*>(this)->_v[0] = -_v[0];
-		const_cast<LPBase<LP,FPT>*>(this)->_v[1] = -_v[1];
-		const_cast<LPBase<LP,FPT>*>(this)->_v[2] = -_v[2];
 	}
-#ifndef HOMOG2D_NOCHECKS
-	if(
-		homog2d_abs(_v[2]) < thr::nullDenom()
-		&&
-		( _v[0] < thr::nullOrthogDistance() && homog2d_abs(_v[1]) < thr::nullOrthogDistance() )
-	)
-		HOMOG2D_THROW_ERROR_1( "invalid point values" );
-#endif
+	else
+	{
+		out.reserve( pl.size() );
+		OSegment_<HOMOG2D_INUMTYPE> seg1( pts[0], pts[pl.size()-1] );
+		for( size_t i=0; i<pl.size(); i++ )
+		{
+			auto next = ( i != pl.size()-1 ? i+1 : 0 );
+			OSegment_<HOMOG2D_INUMTYPE> seg2( pts[i], pts[next] );
+			auto angle = seg1.getAngle( seg2 );
+			out.emplace_back( seg1.getLine().getRotatedLine( pts[i], angle/2. ) );
+			seg1 = -seg2;
+		}
+	}
+	return out;
 }
 
+
 //------------------------------------------------------------------
-template<typename LP,typename FPT>
-template<typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::getCoord( GivenCoord gc, FPT2 other ) const
-{
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call on a point" );
+/// Holds free functions returning a pair of points
+namespace ppair {
 
-	const auto a = static_cast<HOMOG2D_INUMTYPE>( _v[0] );
-	const auto b = static_cast<HOMOG2D_INUMTYPE>( _v[1] );
-	auto denom = ( gc == GivenCoord::X ? b : a );
-#ifndef HOMOG2D_NOCHECKS
-	if( homog2d_abs(denom) < thr::nullDenom() )
-		HOMOG2D_THROW_ERROR_1( "null denominator encountered" );
-#endif
-	if( gc == GivenCoord::X )
-		return ( -a * other - _v[2] ) / b;
-	else
-		return ( -b * other - _v[2] ) / a;
+/// Returns pair of points defining a BB of a primitive
+/// Overload 1/4, private free function
+/**
+Arg is a neither a Point2d, a Segment, a Line2d or a polyline
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		(                                                          // type is
+			   !std::is_same<T,Line2d_<typename    T::FType>>::value // not a line,
+			&& !std::is_same<T,Point2d_<typename   T::FType>>::value // not a point,
+			&& !std::is_same<T,Segment_<typename   T::FType>>::value // not a segment
+			&& !std::is_same<T,OSegment_<typename  T::FType>>::value // not a vector
+			&& !std::is_same<T,CPolyline_<typename T::FType>>::value // not a CPolyline
+			&& !std::is_same<T,OPolyline_<typename T::FType>>::value // not a OPolyline
+		)
+		,T
+	>::type* = nullptr
+>
+auto
+getPointPair( const T& elem )
+{
+	HOMOG2D_START;
+	return elem.getBB().getPts();
 }
 
-//------------------------------------------------------------------
-/// Returns pair of points on line at distance \c dist from point on line
-/// at coord \c coord.
-template<typename LP,typename FPT>
-template<typename FPT2,typename FPT3>
-PointPair_<FPT>
-LPBase<LP,FPT>::getPoints( const Point2d_<FPT2>& pt, FPT3 dist ) const
+/// Returns pair of points defining a BB of a Polyline
+/// Overload 2/4, private free function
+template<
+	typename T,
+	typename std::enable_if<
+		(
+			std::is_same<T,CPolyline_<typename T::FType>>::value
+			|| std::is_same<T,OPolyline_<typename T::FType>>::value
+		)
+		,T
+	>::type* = nullptr
+>
+auto
+getPointPair( const T& poly )
 {
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call on a point" );
-	HOMOG2D_CHECK_IS_NUMBER(FPT2);
-	HOMOG2D_CHECK_IS_NUMBER(FPT3);
+	HOMOG2D_START;
 
-#ifndef HOMOG2D_NOCHECKS
-	if( this->distTo( pt ) > thr::nullDistance() )
+	if( poly.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "cannot compute point pair of empty Polyline" );
+	if( poly.size() == 2 )
 	{
-		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
-			<< " > null distance (" << thr::nullDistance() << ")\n";
-		HOMOG2D_THROW_ERROR_2( "getPoints", "point is not on line" );
+		const auto& pts = poly.getPts();
+		return std::make_pair( pts[0], pts[1] );
 	}
-#endif
+	return priv::getBB_Points( poly.getPts() );
+}
 
-	return priv::getPoints_B2( pt, dist, *this );
+/// Returns pair of points defining a BB of a Point2d
+/// Overload 3/4, private free function
+/**
+This seems useless at first glance, but it is used to get the common bounding box of two objects
+when one of them (or both) is a point.
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		std::is_same<T,Point2d_<typename T::FType>>::value
+		,T
+	>::type* = nullptr
+>
+auto
+getPointPair( const T& elem )
+{
+	HOMOG2D_START;
+	return std::make_pair( Point2d_<HOMOG2D_INUMTYPE>(elem), Point2d_<HOMOG2D_INUMTYPE>(elem) );
 }
 
+/// Returns pair of points defining a BB of Segment
+/// Overload 4/4, private free function
+template<
+	typename T,
+	typename std::enable_if<
+		( std::is_same_v<T,Segment_<typename T::FType>>
+		|| std::is_same_v<T,OSegment_<typename T::FType>> )
+		,T
+	>::type* = nullptr
+>
+auto
+getPointPair( const T& elem )
+{
+	HOMOG2D_START;
+	return elem.getPts();
+}
 
-//------------------------------------------------------------------
-/// Returns an orthogonal line to the one it is called on, at a point on the line defined by one of its coordinates.
-template<typename LP,typename FPT>
-template<typename FPT2>
-Line2d_<FPT>
-LPBase<LP,FPT>::getOrthogLine( GivenCoord gc, FPT2 val ) const
+/// Needed because of variant
+template<typename FPT>
+PointPair_<FPT>
+getPointPair( const Line2d_<FPT>& )
 {
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getOrthogLine() on a point" );
+	HOMOG2D_START;
+	HOMOG2D_THROW_ERROR_1( "Unable to get pair of points for a Line2d" );
+}
 
-	auto other_val = getCoord( gc, val );
-	Point2d_<HOMOG2D_INUMTYPE> pt( other_val, val ) ;
-	if( gc == GivenCoord::X )
-		pt.set( val, other_val );
+} // namespace ppair
 
-	return priv::getOrthogonalLine_B2( pt, *this );
-}
 
-/// Returns an orthogonal line to the one it is called on, at point \c pt
-template<typename LP,typename FPT>
-template<typename FPT2>
-Line2d_<FPT>
-LPBase<LP,FPT>::getOrthogLine( const Point2d_<FPT2>& pt ) const
-{
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getOrthogLine() on a point" );
+/////////////////////////////////////////////////////////////////////////////
+// SECTION - FUNCTORS USED IN FOLLOWING FREE FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////
 
-/*
-#ifndef HOMOG2D_NOCHECKS
-	if( this->distTo( pt ) > thr::nullDistance() )
+#ifdef HOMOG2D_ENABLE_VRTP
+namespace fct {
+//------------------------------------------------------------------
+/// A functor to get pair of points englobing the element
+/**
+\sa CommonType_
+\sa area()
+*/
+struct PtPairFunct
+{
+	template<typename T>
+	PointPair_<typename T::FType>
+	operator ()(const T& a)
 	{
-		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
-			<< "> null distance (" << thr::nullDistance() << ")\n";
-		HOMOG2D_THROW_ERROR_1( "point is not on line" );
+		return ppair::getPointPair(a);
 	}
-#endif
-*/
-	return priv::getOrthogonalLine_B2( pt, *this );
-}
+};
 
 //------------------------------------------------------------------
-template<typename LP,typename FPT>
-template<typename FPT2,typename T>
-Line2d_<FPT>
-LPBase<LP,FPT>::getRotatedLine( const Point2d_<FPT2>& pt, T theta ) const
+/// A functor to get the Bounding Box
+/// \sa getBB()
+struct BBFunct
 {
-	HOMOG2D_CHECK_IS_NUMBER(T);
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getRotatedLine() on a point" );
-
-#ifndef HOMOG2D_NOCHECKS
-	if( this->distTo( pt ) > thr::nullDistance() )
+	template<typename T>
+//	FRect_<typename T::FType> operator ()(const T& a)
+	FRect_<HOMOG2D_INUMTYPE> operator ()(const T& a)
 	{
-		std::cerr << "homog2d: distance=" << std::scientific << this->distTo( pt )
-			<< "> null distance (" << thr::nullDistance() << ")\n";
-		HOMOG2D_THROW_ERROR_2( "getLineAngle", "point is not on line" );
+		return a.getBB();
 	}
-#endif
-	Homogr_<HOMOG2D_INUMTYPE> H;
-	H.addTranslation( -pt.getX(), -pt.getY() ).addRotation(theta).addTranslation( pt.getX(), pt.getY() );
-	return H * *this;
-}
+};
 
-/// Returns the shortest (oriented) segment that joins a point and a line
-/**
-Upon return, the first point will hold the intersection point (projection of point on line),
-and the second will hold the given point.
-*/
-template<typename LP,typename FPT>
-template<typename FPT2>
-OSegment_<FPT>
-LPBase<LP,FPT>::getOrthogSegment( const Point2d_<FPT2>& pt ) const
-{
-	static_assert( !std::is_same_v<LP,typ::IsPoint>, "Invalid call, cannot compute orthogonal segment between two points" );
+} // namespace fct
 
-	Line2d_<HOMOG2D_INUMTYPE> src = *this;  // copy to highest precision
-	auto dist = src.distTo(pt);
-#ifndef HOMOG2D_NOCHECKS
-	if( dist < thr::nullDistance() )   // sanity check
-		HOMOG2D_THROW_ERROR_1( "unable to compute segment, distance too small=" << dist );
-#endif
-	auto pair_lines = getParallelLines( dist );
+#endif // HOMOG2D_ENABLE_VRTP
 
-// determine on which of the two parallel lines does the point lie?
-	Line2d_<HOMOG2D_INUMTYPE>* pline = &pair_lines.first;
-	if( pt.distTo(pair_lines.second) < thr::nullDistance() )
-		pline = &pair_lines.second;
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - FREE FUNCTIONS HANDLING VARIANT TYPE
+/////////////////////////////////////////////////////////////////////////////
 
-	auto oline = pline->getOrthogLine( pt );
-	auto p2 = *this * oline;
-	return OSegment_<FPT>( p2, pt );
-}
+/**
+\addtogroup varff Free functions handling variant type
 
-//------------------------------------------------------------------
-/// Returns an parallel line, implementation of getParallelLine().
-template<typename LP,typename FPT>
-template<typename FPT2>
-Line2d_<FPT>
-LPBase<LP,FPT>::getParallelLine( const Point2d_<FPT2>& pt ) const
-{
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getParallelLine() on a point" );
 
-	Line2d_<FPT> out = *this;
-	out._v[2] = static_cast<HOMOG2D_INUMTYPE>(-_v[0]) * pt.getX() - _v[1] * pt.getY();
-	out.p_normalizePL();
-	return out;
-}
+defgroup
+
+These function can be used on a "regular" geometric object or on a `CommonType` object,
+holding a std::variant and allowing run-time polymorphism,
+
+See md_docs_homog2d_manual.html#section_rtp
+*/
 
 //------------------------------------------------------------------
-
-/// Implementation for lines
-template<typename LP,typename FPT>
+/// Free function. Returns the type of object or variant
+/**
+Can be printed with `getString()`
+\sa CommonType_
+\ingroup varff
+*/
 template<typename T>
-std::pair<Line2d_<FPT>,Line2d_<FPT>>
-LPBase<LP,FPT>::getParallelLines( T dist ) const
+Type
+type( const T& elem )
 {
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot call getParallelLines() on a point" );
-
-	Line2d_<FPT> l1 = *this;
-	Line2d_<FPT> l2 = *this;
-	l1._v[2] = static_cast<HOMOG2D_INUMTYPE>(this->_v[2]) + dist;
-	l2._v[2] = static_cast<HOMOG2D_INUMTYPE>(this->_v[2]) - dist;
-	return std::make_pair( l1, l2 );
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::TypeFunct{}, elem );
+	else
+#endif
+		return elem.type();
 }
 
 //------------------------------------------------------------------
-/// Comparison operator, used for lines
+/// Returns the underlying data type of object or variant
 /**
-Definition: two lines will be equal:
-- if they are parallel
-AND
-- if their offset (3 third value) is less than nullDistance()
+Can be printed with `getString()`
+\ingroup varff
 */
-template<typename LP,typename FPT>
-bool
-LPBase<LP,FPT>::impl_op_equal( const LPBase<LP,FPT>& other, const detail::BaseHelper<typename typ::IsLine>& ) const
+template<typename T>
+Dtype
+dtype( const T& elem )
 {
-	if( !this->isParallelTo( other ) )
-		return false;
-
-	if( std::fabs( _v[2] - other._v[2] ) > thr::nullDistance() )
-		return false;
-
-	return true;
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::DTypeFunct{}, elem );
+	else
+#endif
+		return elem.dtype();
 }
 
-/// Comparison operator, used for points
-template<typename LP,typename FPT>
-bool
-LPBase<LP,FPT>::impl_op_equal( const LPBase<LP,FPT>& other, const detail::BaseHelper<typename typ::IsPoint>& ) const
+//------------------------------------------------------------------
+/// Returns length of element or variant (free function)
+/// \ingroup varff
+template<typename T>
+HOMOG2D_INUMTYPE
+length( const T& elem )
 {
-	return ( this->distTo( other ) < thr::nullDistance() );
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::LengthFunct{}, elem );
+	else
+#endif
+		return elem.length();
 }
 
 //------------------------------------------------------------------
-/// Sorting operator, for points (illegal for lines)
-template<typename LP,typename FPT>
-bool
-LPBase<LP,FPT>::operator < ( const LPBase<LP,FPT>& other ) const
+/// Returns area of element or variant (free function)
+/// \ingroup varff
+template<typename T>
+HOMOG2D_INUMTYPE
+area( const T& elem )
 {
-	static_assert( std::is_same_v<LP,typ::IsPoint>, "Invalid < operator: you cannot sort lines" );
-
-	if( getX() < other.getX() )
-		return true;
-	if( getX() > other.getX() )
-		return false;
-	if( getY() < other.getY() )
-		return true;
-	return false;
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::AreaFunct{}, elem );
+	else
+#endif
+		return elem.area();
 }
 
-} // namespace base
-
 //------------------------------------------------------------------
-/// Inner implementation details
-namespace detail {
-
-/// Cross product of points * points or line * line
-/**
-- https://en.wikipedia.org/wiki/Cross_product#Coordinate_notation
-*/
-template<typename Out,typename In,typename FPT1,typename FPT2>
-base::LPBase<Out,FPT1>
-crossProduct(
-	const base::LPBase<In,FPT1>& r1,
-	const base::LPBase<In,FPT2>& r2
-)
+/// Returns size of element or variant (free function)
+/// \ingroup varff
+template<typename T>
+HOMOG2D_INUMTYPE
+size( const T& elem )
 {
-	auto r1_a = static_cast<HOMOG2D_INUMTYPE>(r1._v[0]);
-	auto r1_b = static_cast<HOMOG2D_INUMTYPE>(r1._v[1]);
-	auto r1_c = static_cast<HOMOG2D_INUMTYPE>(r1._v[2]);
-	auto r2_a = static_cast<HOMOG2D_INUMTYPE>(r2._v[0]);
-	auto r2_b = static_cast<HOMOG2D_INUMTYPE>(r2._v[1]);
-	auto r2_c = static_cast<HOMOG2D_INUMTYPE>(r2._v[2]);
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::SizeFunct{}, elem );
+	else
+#endif
+		return elem.size();
+}
 
-	base::LPBase<Out,FPT1> res;
-	res._v[0] = static_cast<FPT1>( r1_b * r2_c  - r1_c * r2_b );
-	res._v[1] = static_cast<FPT1>( r1_c * r2_a  - r1_a * r2_c );
-	res._v[2] = static_cast<FPT1>( r1_a * r2_b  - r1_b * r2_a );
 
-	return res;
-}
+#ifdef HOMOG2D_ENABLE_VRTP
+namespace priv {
 
-/// Cross product of two oriented segments, return a scalar
-template<typename FPT1,typename FPT2>
-HOMOG2D_INUMTYPE
-crossProductV(
-	const base::SegVec<typ::IsOSeg,FPT1>& v1,
-	const base::SegVec<typ::IsOSeg,FPT2>& v2
-)
-{
-	auto ppts1 = v1.getPts();
-	auto ppts2 = v2.getPts();
+/// Get Bounding Box for a container holding variant objects
+/**
+\note Here, we DO NOT preallocate the vector, because if the container holds lines, then no point pair will be added for these elements.
+If we would have preallocate with 2 x size of input vector, then some default-constructed points could sneak in, and introduce an error.
 
-	auto dx1 =
-		static_cast<HOMOG2D_INUMTYPE>( ppts1.second.getX()  )
-		- static_cast<HOMOG2D_INUMTYPE>( ppts1.first.getX() );
-	auto dy1 =
-		static_cast<HOMOG2D_INUMTYPE>(   ppts1.second.getY() )
-		- static_cast<HOMOG2D_INUMTYPE>( ppts1.first.getY()  );
-	auto dx2 =
-		static_cast<HOMOG2D_INUMTYPE>(   ppts2.second.getX() )
-		- static_cast<HOMOG2D_INUMTYPE>( ppts2.first.getX()  );
-	auto dy2 =
-		static_cast<HOMOG2D_INUMTYPE>(   ppts2.second.getY() )
-		- static_cast<HOMOG2D_INUMTYPE>( ppts2.first.getY()  );
+\todo 20240513: At present, this is only implemented for std::vector. Let it handle std::list and std::array.
+*/
+template<typename FPT>
+auto
+getBB_CommonType( const std::vector<CommonType_<FPT>>& v_var )
+{
+	HOMOG2D_START;
+	HOMOG2D_DEBUG_ASSERT( v_var.size(), "cannot compute bounding box of empty set of variant" );
 
-	return dx1 * dy2 - dy1 * dx2;
+	std::vector<Point2d_<FPT>> vpts;
+	vpts.reserve( v_var.size()*2 );
+	PointPair_<FPT> ppair;
+	for( const auto& elem: v_var )
+	{
+		try
+		{
+			ppair = std::visit( fct::PtPairFunct{}, elem );
+		}
+		catch( const std::exception& err )
+		{
+			HOMOG2D_LOG_WARNING( "unable to compute point pair\n -msg=" << err.what() );
+		}
+		vpts.push_back( ppair.first );
+		vpts.push_back( ppair.second );
+	}
+	return FRect_<FPT>( getBB_Points( vpts ) );
 }
 
-} // namespace detail
+} // namespace priv
 
+#endif // HOMOG2D_ENABLE_VRTP
 
 //------------------------------------------------------------------
-///////////////////////////////////////////
-// CONSTRUCTORS
-///////////////////////////////////////////
-
-namespace base {
-
-/// Generic init from two numeric args
-template<typename LP, typename FPT>
-template<typename T1,typename T2>
-void
-LPBase<LP,FPT>::p_init_2( const T1& v1, const T2& v2 )
+/// Return Bounding Box of primitive or container holding primitives (free function)
+/**
+tests: [BB-cont]
+\ingroup varff
+*/
+template<typename T>
+FRect_<HOMOG2D_INUMTYPE>
+getBB( const T& t )
 {
-	if constexpr( std::is_same_v<LP,typ::IsPoint> )
-	{
-		_v[0] = v1;
-		_v[1] = v2;
-		_v[2] = 1.;
-	}
+	HOMOG2D_START;
+
+	if constexpr( !trait::IsContainer<T>::value ) // if not a container,
+		return t.getBB();                         // then call the member function
 	else
 	{
-		Point2d_<FPT> pt1;                // 0,0
-		Point2d_<FPT> pt2(v1,v2);
-		pt2.p_normalizePL();
-		*this = detail::crossProduct<typ::IsLine>( pt1, pt2 );
-		p_normalizePL();
-	}
-}
+		if( t.empty() )
+			HOMOG2D_THROW_ERROR_1( "unable, can't compute BB of empty container" );
 
-/// Overload for point to point distance
-template<typename LP, typename FPT>
-template<typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::impl_distToPoint( const Point2d_<FPT2>& pt, const detail::BaseHelper<typename typ::IsPoint>& ) const
-{
-#ifndef HOMOG2D_USE_TTMATH
-	return std::hypot(
-		static_cast<HOMOG2D_INUMTYPE>( getX() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getX() ),
-		static_cast<HOMOG2D_INUMTYPE>( getY() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getY() )
-	);
+		if constexpr( trait::IsPoint<typename T::value_type>::value )
+		{
+			if( t.size() < 2 )
+				HOMOG2D_THROW_ERROR_1( "unable, need at least two points" );
+			return FRect_<typename T::value_type::FType>( priv::getBB_Points( t ) );
+		}
+		else
+		{
+			if constexpr( trait::HasBB<typename T::value_type>::value )
+			{
+				using FPT = typename T::value_type::FType;
+				std::vector<FRect_<FPT>> v_bb( t.size() );
+
+				auto it = v_bb.begin();
+				for( const auto& elem: t ) // compute bounding box of each element
+					*it++ = elem.getBB();
+
+				return priv::getBB_FRect( v_bb ); // compute BB of all the BB
+			}
+			else
+			{
+				if constexpr( trait::IsSegment<typename T::value_type>::value )
+				{
+					if( t.empty()  )
+						HOMOG2D_THROW_ERROR_1( "unable, need at least one segment" );
+					return priv::getBB_Segments( t );
+				}
+				else
+				{
+#ifdef HOMOG2D_ENABLE_VRTP
+					if constexpr( !trait::IsVariant<typename T::value_type>::value )
+					{
+						HOMOG2D_THROW_ERROR_1( "Unable, cannot compute BoundingBox of a container holding Line2d objects" );
+					}
+					else
+						return priv::getBB_CommonType( t );
 #else
-	auto v1 = static_cast<HOMOG2D_INUMTYPE>( getX() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getX() );
-	auto v2 = static_cast<HOMOG2D_INUMTYPE>( getY() ) - static_cast<HOMOG2D_INUMTYPE>( pt.getY() );
-	return ttmath::Sqrt( v1*v1 + v2*v2 );
+					HOMOG2D_THROW_ERROR_1( "Unable, cannot compute BoundingBox of a container holding Line2d objects" );
 #endif
+				}
+			}
+		}
+	}
 }
-//------------------------------------------------------------------
-/// Returns distance between the line and point \b pt. overload for line to point distance.
+
+#ifdef HOMOG2D_ENABLE_VRTP
+
+/// Apply homography to primitive
 /**
-http://mathworld.wolfram.com/Point-LineDistance2-Dimensional.html
-<pre>
-        | a.x0 + b.y0 + c |
-  d = -----------------------
-         sqrt( a*a + b*b )
-</pre>
-\todo Do we really require computation of hypot ? (because the line is supposed to be normalized, i.e. h=1 ?)
+\warning The floating-point type of the returned object (variant) will be the one of the homography \c h,
+\b NOT the one of the input element.
+\ingroup varff
 */
-template<typename LP, typename FPT>
-template<typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::impl_distToPoint( const Point2d_<FPT2>& pt, const detail::BaseHelper<typename typ::IsLine>& ) const
+template<typename T, typename FPT>
+CommonType_<FPT>
+transform( const Homogr_<FPT>& h, const T& elem )
 {
-	return std::fabs(
-		static_cast<HOMOG2D_INUMTYPE>( _v[0] ) * pt.getX()
-		+ static_cast<HOMOG2D_INUMTYPE>( _v[1] ) * pt.getY()
-		+ static_cast<HOMOG2D_INUMTYPE>( _v[2] )
-	)
-#ifndef HOMOG2D_USE_TTMATH
-	/ std::hypot( _v[0], _v[1] );
-#else
-;
-#endif
+	if constexpr( trait::IsVariant<T>::value )
+		return std::visit( fct::TransformFunct<FPT>(h), elem );
+	else
+		return h * elem;
 }
+#endif
 
-/// overload for line to point distance
-template<typename LP, typename FPT>
-template<typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::distTo( const Line2d_<FPT2>& li ) const
-{
-	static_assert( !std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot compute distance between two lines" );
-	return li.distTo( *this );
-}
+/////////////////////////////////////////////////////////////////////////////
+// SECTION - FREE FUNCTIONS
+/////////////////////////////////////////////////////////////////////////////
 
-template<typename LP, typename FPT>
-template<typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::distTo( const Segment_<FPT2>& seg ) const
+/// Returns a pair of points holding min and max coordinates of the two input pair of points
+/**
+Tests: search for [minmax]
+*/
+
+template<typename T1,typename T2,typename T3,typename T4>
+auto
+getMinMax( const PointPair2_<T1,T2>& pp1, const PointPair2_<T3,T4>& pp2 )
 {
-	static_assert( !std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot compute distance between a line and a segment" );
-	return seg.distTo( *this );
-}
+	HOMOG2D_START;
 
-} // namespace base
+	std::array<Point2d_<HOMOG2D_INUMTYPE>,4> arr;
+	arr[0] = pp1.first;
+	arr[1] = pp2.first;
+	arr[2] = pp1.second;
+	arr[3] = pp2.second;
 
-//------------------------------------------------------------------
-/// Free function, returns angle between two segments/lines
-/// \sa Segment_::getAngle()
-/// \sa Line2d_::getAngle()
-template<typename T1,typename T2>
-HOMOG2D_INUMTYPE
-getAngle( const T1& t1, const T2& t2 )
-{
-	static_assert(
-		(
-			   std::is_same_v<typename T1::SType,typ::IsLine>
-			|| std::is_same_v<typename T1::SType,typ::IsSegment>
-			|| std::is_same_v<typename T1::SType,typ::IsOSeg>
-		) &&
-		(
-			   std::is_same_v<typename T2::SType,typ::IsLine>
-			|| std::is_same_v<typename T2::SType,typ::IsSegment>
-			|| std::is_same_v<typename T2::SType,typ::IsOSeg>
-		),
-		"Both types must be either a Line or a Segment"
-	);
-	return t1.getAngle( t2 );
+	return priv::getBB_Points( arr );
 }
 
 //------------------------------------------------------------------
-namespace base {
-
-template<typename LP, typename FPT>
-template<typename FPT2>
-bool
-LPBase<LP,FPT>::isParallelTo( const Line2d_<FPT2>& li ) const
+/// Returns bounding box of two pairs of points
+/**
+\warning May throw in case of identical coordinates
+(for example with [0,0]-[1,0] and [10,0]-[20,0]
+*/
+template<typename T1,typename T2,typename T3,typename T4>
+auto
+getBB( const PointPair2_<T1,T2>& pp1, const PointPair2_<T3,T4>& pp2 )
 {
-	static_assert( std::is_same_v<LP,typ::IsLine>, "Invalid: you cannot use IsParallel() with a point" );
-
-	if( this->getAngle(li) < thr::nullAngleValue() )
-		return true;
-	return false;
+	HOMOG2D_START;
+	return FRect_<T1>( getMinMax( pp1, pp2 ) );
 }
 
 //------------------------------------------------------------------
-/// Returns the angle (in rad.) between the line and the other one.
-/**
-- The returned value will be in the range <code> [0, M_PI/2] </code>
+/// Overload 1/3. This one is called if NONE of the args are a Line2d
+template<
+	typename T1,
+	typename T2,
+	typename std::enable_if<(
+		   !std::is_same_v<T1,Line2d_<typename T1::FType>>
+		&& !std::is_same_v<T2,Line2d_<typename T2::FType>>
+		),T1
+	>::type* = nullptr
+>
+auto
+getBB( const T1& elem1, const T2& elem2 )
+{
+	HOMOG2D_START;
 
-If the lines \f$ (a_0,a_1,a_2) \f$ and \f$ (b_0,b_1,b_2) \f$ are correctly normalized (should be, but...)
-then the angle between them is \f$ \alpha = acos( a_0*b_0 + a_1*b_1) \f$. <br>
-However, in "some situations", even if the lines have been previously normalized (which is the case here)
-we can encounter numerical issues, so here we "reinforce the normalization and compute:
-\f[
-\alpha = acos \left(
-	\frac{a_0*b_0 + a_1*b_1} { \sqrt{ a_0^2 + a_1^2 } * \sqrt{ b_0^2 + b_1^2 } }
-\right)
-\f]
-In some situations, the value inside the parenthesis "may" be equal to \f$ 1+\epsilon \f$
-(typically, something like "1.0000000000123").
-This is out of bounds for the \f$ acos() \f$ function, that will then return "nan"
-(thus induce some failure further on). <br>
-To avoid this, a checking is done, and any value higher than 1 will be truncated.
-This is logged on \c std::cerr so that the user may take that into consideration.
+	bool isPoly_1 = false;
+	if( elem1.type() == Type::OPolyline || elem1.type() == Type::CPolyline )
+		isPoly_1 = true;
 
-\todo more investigation needed ! : what are the exact situation that will lead to this event?
-*/
-template<typename LP, typename FPT>
-template<typename LP2, typename FPT2>
-HOMOG2D_INUMTYPE
-LPBase<LP,FPT>::getAngle( const LPBase<LP2,FPT2>& li ) const
-{
-	static_assert( !std::is_same_v<LP,typ::IsPoint>, "cannot get angle of a point" );
+	bool isPoly_2 = false;
+	if( elem2.type() == Type::OPolyline || elem2.type() == Type::CPolyline )
+		isPoly_1 = true;
 
-	HOMOG2D_INUMTYPE l1_a = _v[0];
-	HOMOG2D_INUMTYPE l1_b = _v[1];
-	HOMOG2D_INUMTYPE l2_a = li._v[0];
-	HOMOG2D_INUMTYPE l2_b = li._v[1];
-	HOMOG2D_INUMTYPE res = l1_a * l2_a + l1_b * l2_b;
+	auto siz_1 = elem1.size();
+	auto siz_2 = elem2.size();
 
-	res /= homog2d_sqrt( (l1_a*l1_a + l1_b*l1_b) * (l2_a*l2_a + l2_b*l2_b) );
-	auto fres = homog2d_abs(res);
+	if( isPoly_1 && isPoly_2 )
+		if( siz_1==0 && siz_2==0 )
+			HOMOG2D_THROW_ERROR_1( "unable to compute bounding box of two empty polyline objects" );
 
-	if( fres > 1.0 )
+	FRect_<typename T1::FType> out;
+// we need to do that in two steps: first, copy return value into `out`, then return
+// because the underlying floating point might not be the same for the two arguments.
+	if( isPoly_2 && siz_1==0 )
 	{
-		HOMOG2D_LOG_WARNING(
-			"homog2d Warning: angle computation overflow detected, value "
-			<< std::scientific << std::setprecision(20)
-			<< fres << ", truncated to 1.0\n input lines:\n  l1: "
-			<< *this << "\n  l2: " << li
-		);
-		fres = 1.0;
+		auto pp = ppair::getPointPair( elem2 );
+		if( shareCommonCoord(pp) )
+		{
+			HOMOG2D_THROW_ERROR_1( "Unable to build common Bounding Box of empty polyline and elem2:" << elem2 );
+		}
+		else
+			return FRect_<typename T1::FType>( pp );
+	}
+	if( isPoly_1 && siz_2==0 )
+	{
+		auto pp = ppair::getPointPair( elem1 );
+		if( shareCommonCoord(pp) )
+		{
+			HOMOG2D_THROW_ERROR_1( "Unable to build common Bounding Box of empty polyline and elem1:" << elem1 );
+		}
+		else
+			return FRect_<typename T1::FType>( pp );
 	}
-	return homog2d_acos( fres );
-}
 
-//------------------------------------------------------------------
-/// Returns true if point is inside (or on the edge) of a flat rectangle
-template<typename LP, typename FPT>
-template<typename FPT2>
-bool
-LPBase<LP,FPT>::isInside( const FRect_<FPT2>& rect ) const
-{
-	if constexpr( std::is_same_v<LP,typ::IsLine> )
-		return false;
-	else
+	try
 	{
-		auto pair_pts = rect.getPts();
-		const auto& p00 = pair_pts.first;
-		const auto& p11 = pair_pts.second;
-		return detail::ptIsInside( *this, p00, p11 );
+		out = getBB(
+			ppair::getPointPair( elem1 ),
+			ppair::getPointPair( elem2 )
+		);
+	}
+	catch( const std::exception& err )
+	{
+		HOMOG2D_THROW_ERROR_1( "unable to compute bounding box:\n -arg1="
+			<< elem1 << "\n -arg2=" << elem2 << "\n -err=" << err.what() );
 	}
+	return out;
 }
 
-
 //------------------------------------------------------------------
-#if 0
-// deprecated. kept here just in case it would be useful in the future (who knows?)
-namespace sub {
-
-/// Returns the index of the segment (among the ones in \c bbox)
-/// that is the farthest from point \c pt
-template<typename FPT1,typename FPT2>
-int
-getFarthestSegment( const Point2d_<FPT1>& pt, const FRect_<FPT2>& bbox )
+/// Overload 3/3. Called if one of the args is a Line2d (=> no build!)
+template<
+	typename T1,
+	typename T2,
+	typename std::enable_if<
+		(std::is_same<T1,Line2d_<typename T1::FType>>::value || std::is_same<T2,Line2d_<typename T2::FType>>::value)
+		,T1
+	>::type* = nullptr
+>
+auto
+getBB( const T1&, const T2& )
 {
-	auto segs = bbox.getSegs();
-	using localPair = std::pair<HOMOG2D_INUMTYPE,int>;
-	std::array<localPair,4> dist_array;
-	for( int i=0; i<4; i++ )
-	{
-		dist_array[i].first  = pt.distTo( segs[i].getLine() );
-		dist_array[i].second = i;
-	}
-	std::sort(
-		dist_array.begin(),
-		dist_array.end(),
-		[]                     // lambda
-		( const localPair& i, const localPair& j )
-		{
-			return i.first < j.first;
-		}
-	);
-
-	return dist_array[3].second;
+	HOMOG2D_START;
+	static_assert( detail::AlwaysFalse<T1>::value, "fallback: undefined function" );
+	return FRect_<T1>(); // to avoid a compile warning
 }
 
-} // namespace sub
-#endif
 //------------------------------------------------------------------
-/// Returns true if point is inside closed Polyline
+/// Spatial index on a set of points (k-d tree), for repeated nearest neighbour queries
 /**
-See https://en.wikipedia.org/wiki/Point_in_polygon
+Built once from a container of points (\c std::vector, \c std::array or \c std::list),
+all the queries return indexes of points in that container.
+Each query is O(log n) on average, instead of O(n) for the linear search.
 
-Implementing this algorithm in a naive way may encounter some issue:
-if the main segment used to compute the number of intersections is colinear with
-one of the points of the polyline, we might run into a numerical issue.
+\warning The object holds a copy of the coordinates, it is not updated if the source container is modified.
 
-See page \ref md_docs_homog2d_algorithms for details.
+\sa findNearestPoint()
+\sa findNearestFarthestPoint()
+\sa getClosestPoints()
 */
-template<typename LP, typename FPT>
-template<typename T,typename PTYPE>
-bool
-LPBase<LP,FPT>::impl_isInsidePoly( const base::PolylineBase<PTYPE,T>& poly, const detail::BaseHelper<typename typ::IsPoint>& ) const
+class PointIndex
 {
-	if( !poly.isSimple() )
-		return false;
-
-// step 1: if point is outside bounding box, return false
-	auto bbox = poly.getBB();
-	if( !this->isInside(bbox) )
-		return false;
-
-// step 2: check if point is lying on one of the segments. If so, return false;
-	for( auto seg: poly.getSegs() )
-		if( seg.getLine().distTo( *this ) < thr::nullDistance() )
-				return false;
-
-	auto segarr = bbox.getExtended().getSegs();
-	std::vector<Segment_<HOMOG2D_INUMTYPE>> seg_bb( segarr.begin(), segarr.end() );
-
-	int iter = 0;
-	do
+private:
+	struct Box
 	{
-		bool tooClose = false;
-		for( size_t i=0; i<seg_bb.size(); i++ )        // iterate on all segments of the extended bounding box
-		{
-			Segment_<HOMOG2D_INUMTYPE> seg_ref( *this, seg_bb[i].getCenter() );
+		HOMOG2D_INUMTYPE _xmin = 0., _ymin = 0., _xmax = 0., _ymax = 0.;
 
-			auto poly_pts = poly.getPts();
-			for( size_t j=0; j<poly_pts.size() && !tooClose; j++  )   // make sure that every point of the polyline is not on the reference segment
-			{
-				const auto& poly_pt = poly_pts[j];
-				if( poly_pt.distTo(seg_ref) < thr::nullDistance() )
-					tooClose = true;
-			}
-			if( !tooClose )     // if no polyline points
-			{                   // was found on the segment supporting line
-				size_t c = 0;
-				for( auto seg: poly.getSegs() )  // iterate on the polyline segments
-				{
-					if( seg.intersects(seg_ref)() )
-						c++;
-				}
-				return static_cast<bool>( c%2 );
-			}
+	/// squared distance from point to nearest point of box
+		HOMOG2D_INUMTYPE minDist2( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
+		{
+			auto dx = std::max( static_cast<HOMOG2D_INUMTYPE>(0), std::max( _xmin - x, x - _xmax ) );
+			auto dy = std::max( static_cast<HOMOG2D_INUMTYPE>(0), std::max( _ymin - y, y - _ymax ) );
+			return dx*dx + dy*dy;
 		}
-		iter++;
-		if( tooClose )  // if unable to find a suitable reference segment,
-		{               //  we double the number of segments, by splitting each of them
-			if( iter < HOMOG2D_MAXITER_PIP ) // (only if not max iterations!)
-			{
-				std::vector<Segment_<HOMOG2D_INUMTYPE>> seg_bb2( seg_bb.size() * 2 );
-				for( size_t j=0; j<seg_bb.size(); j++ )
-				{
-					auto pseg      = seg_bb[j].split();
-					seg_bb2[j*2]   = pseg.first;
-					seg_bb2[j*2+1] = pseg.second;
-				}
-				std::swap( seg_bb, seg_bb2 );
-			}
+	/// squared distance from point to farthest point of box
+		HOMOG2D_INUMTYPE maxDist2( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
+		{
+			auto dx = std::max( x - _xmin, _xmax - x );
+			auto dy = std::max( y - _ymin, _ymax - y );
+			return dx*dx + dy*dy;
 		}
-	}
-	while( iter < HOMOG2D_MAXITER_PIP );
-	HOMOG2D_THROW_ERROR_1( "unable to determine if point is inside after " + std::to_string(HOMOG2D_MAXITER_PIP) + " iterations" );
-	return false; // to avoid a warning
-}
+	};
 
-template<typename LP, typename FPT>
-template<typename T,typename PTYPE>
-constexpr bool
-LPBase<LP,FPT>::impl_isInsidePoly( const base::PolylineBase<PTYPE,T>&, const detail::BaseHelper<typename typ::IsLine>& ) const
-{
-	return false;
-}
+	std::vector<HOMOG2D_INUMTYPE> _vx, _vy;  ///< coordinates, reordered as an implicit k-d tree
+	std::vector<size_t>  _idx;               ///< index of each point in the source container
+	std::vector<uint8_t> _axis;              ///< split axis (0:x, 1:y), stored at the position of the median of each node
+	Box                  _bbox;
 
-//------------------------------------------------------------------
-/// Point is inside Polyline
-template<typename LP, typename FPT>
-template<typename FPT2>
-bool
-LPBase<LP,FPT>::isInside( const Ellipse_<FPT2>& ell ) const
-{
-	if constexpr( std::is_same_v<LP,typ::IsPoint> )
-		return ell.pointIsInside( *this );
-	else
-		return false;
-}
+	static constexpr size_t s_leafSize = 8;
 
+public:
+	PointIndex() = default;
 
-//------------------------------------------------------------------
-/// Intersection of line and circle: implementation for points
-template<typename LP, typename FPT>
-template<typename T>
-constexpr detail::Intersect<detail::Inters_2,FPT>
-LPBase<LP,FPT>::impl_intersectsCircle( const Point2d_<FPT>&, T, const detail::BaseHelper<typename typ::IsPoint>& ) const
-{
-	static_assert( detail::AlwaysFalse<LP>::value, "cannot use intersects(Circle) with a point" );
-}
+/// Constructor from a vector/array/list of points
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	explicit PointIndex( const T& cont )
+	{
+		set( cont );
+	}
 
-/// Line/Circle intersection: implementation
-/// For computation details, checkout http://skramm.lautre.net/files/misc/intersect_circle_line.pdf
-/// \todo 20230124: change return type: intersection of a circle with a line can be a single point
-template<typename LP, typename FPT>
-template<typename T>
-detail::Intersect<detail::Inters_2,FPT>
-LPBase<LP,FPT>::impl_intersectsCircle(
-	const Point2d_<FPT>& pt,       ///< circle origin
-	T                    radius,   ///< radius
-	const detail::BaseHelper<typename typ::IsLine>&  ///< dummy arg, needed so that this overload is only called for lines
-) const
-{
-	detail::Intersect<detail::Inters_2,FPT> out;
-	HOMOG2D_CHECK_IS_NUMBER(T);
-	const HOMOG2D_INUMTYPE a = static_cast<HOMOG2D_INUMTYPE>(_v[0]); // just to lighten a bit...
-	const HOMOG2D_INUMTYPE b = static_cast<HOMOG2D_INUMTYPE>(_v[1]);
-	const HOMOG2D_INUMTYPE c = static_cast<HOMOG2D_INUMTYPE>(_v[2]);
+	size_t size() const { return _idx.size(); }
 
-// step 1: translate to origin
-	auto cp = pt.getX() * a + pt.getY() * b + c;
+/// (Re)builds the index from a vector/array/list of points
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	void set( const T& cont )
+	{
+		const auto n = cont.size();
+		_vx.resize( n );
+		_vy.resize( n );
+		_axis.assign( n, 0 );
+		std::vector<size_t> perm( n );
+		std::iota( perm.begin(), perm.end(), 0 );
+		size_t i = 0;
+		for( const auto& pt: cont )
+		{
+			_vx[i]   = pt.getX();
+			_vy[i++] = pt.getY();
+		}
+		if( n )
+			p_build( perm, 0, n );
 
-// step 2: compute distance	between center (origin) and middle point
-	auto a2b2 = a * a + b * b;
-	auto d0 = homog2d_abs(cp) / homog2d_sqrt( a2b2 );
-	if( radius < d0 )                            // if less than radius,
-		return out;                         // no intersection
+		std::vector<HOMOG2D_INUMTYPE> vx( n ), vy( n );
+		for( size_t j=0; j<n; j++ )
+		{
+			vx[j] = _vx[ perm[j] ];
+			vy[j] = _vy[ perm[j] ];
+		}
+		std::swap( _vx, vx );
+		std::swap( _vy, vy );
+		_idx = std::move( perm );
 
-	auto d2 = radius*radius - d0*d0;
+		if( n )
+		{
+			auto mmx = std::minmax_element( _vx.begin(), _vx.end() );
+			auto mmy = std::minmax_element( _vy.begin(), _vy.end() );
+			_bbox = Box{ *mmx.first, *mmy.first, *mmx.second, *mmy.second };
+		}
+	}
 
-// step 3: compute coordinates of middle point B
-	auto xb = - a * cp / a2b2;
-	auto yb = - b * cp / a2b2;
+/// Returns index of point nearest to \c pt
+/**
+If \c skipEqual is true, the points equal to \c pt (distance less than thr::nullDistance()) are ignored.
+Throws if no point can be found.
+*/
+	template<typename FPT>
+	size_t nearest( const Point2d_<FPT>& pt, bool skipEqual=false ) const
+	{
+		std::pair<size_t,HOMOG2D_INUMTYPE> best( size(), std::numeric_limits<HOMOG2D_INUMTYPE>::max() );
+		if( size() )
+			p_nearest( 0, size(), _bbox, pt.getX(), pt.getY(), skipEqual, best );
+		if( best.first == size() )
+			HOMOG2D_THROW_ERROR_1( "unable to find nearest point, index size=" << size() );
+		return _idx[best.first];
+	}
 
-// step 4: compute coordinates of intersection points, with center at (0,0)
-	auto m  = homog2d_sqrt( d2 / a2b2 );
-	auto x1 = xb + m*b;
-	auto y1 = yb - m*a;
+/// Returns index of point farthest from \c pt
+/**
+If \c skipEqual is true, the points equal to \c pt (distance less than thr::nullDistance()) are ignored.
+Throws if no point can be found.
+*/
+	template<typename FPT>
+	size_t farthest( const Point2d_<FPT>& pt, bool skipEqual=false ) const
+	{
+		std::pair<size_t,HOMOG2D_INUMTYPE> best( size(), -1. );
+		if( size() )
+			p_farthest( 0, size(), _bbox, pt.getX(), pt.getY(), skipEqual, best );
+		if( best.first == size() )
+			HOMOG2D_THROW_ERROR_1( "unable to find farthest point, index size=" << size() );
+		return _idx[best.first];
+	}
+
+/// Returns indexes of the \c k points nearest to \c pt, sorted by increasing distance
+	template<typename FPT>
+	std::vector<size_t> kNearest( const Point2d_<FPT>& pt, size_t k ) const
+	{
+		std::vector<std::pair<HOMOG2D_INUMTYPE,size_t>> heap;  // max-heap on distance
+		heap.reserve( k+1 );
+		if( size() && k )
+			p_kNearest( 0, size(), _bbox, pt.getX(), pt.getY(), k, heap );
+		std::sort_heap( heap.begin(), heap.end() );
+		std::vector<size_t> out( heap.size() );
+		for( size_t i=0; i<heap.size(); i++ )
+			out[i] = _idx[ heap[i].second ];
+		return out;
+	}
 
-	auto x2 = xb - m*b;
-	auto y2 = yb + m*a;
+/// Returns indexes of the points at a distance less or equal to \c radius from \c pt, sorted by increasing index
+	template<typename FPT,typename T>
+	std::vector<size_t> inRadius( const Point2d_<FPT>& pt, T radius ) const
+	{
+		HOMOG2D_CHECK_IS_NUMBER(T);
+		std::vector<size_t> out;
+		if( size() )
+			p_inRadius( 0, size(), _bbox, pt.getX(), pt.getY(), static_cast<HOMOG2D_INUMTYPE>(radius)*radius, out );
+		std::sort( out.begin(), out.end() );
+		return out;
+	}
 
-// last step: translate back
-	out._ptIntersect_1.set( x1 + pt.getX(), y1 + pt.getY() );
-	out._ptIntersect_2.set( x2 + pt.getX(), y2 + pt.getY() );
-	out._doesIntersect = true;
+private:
+	void p_build( std::vector<size_t>& perm, size_t begin, size_t end )
+	{
+		if( end - begin <= s_leafSize )
+			return;
+		HOMOG2D_INUMTYPE xmin, xmax, ymin, ymax;
+		xmin = xmax = _vx[ perm[begin] ];
+		ymin = ymax = _vy[ perm[begin] ];
+		for( auto i=begin+1; i<end; i++ )
+		{
+			xmin = std::min( xmin, _vx[perm[i]] );
+			xmax = std::max( xmax, _vx[perm[i]] );
+			ymin = std::min( ymin, _vy[perm[i]] );
+			ymax = std::max( ymax, _vy[perm[i]] );
+		}
+		uint8_t axis = ( xmax - xmin >= ymax - ymin ? 0 : 1 );
+		const auto& coord = ( axis == 0 ? _vx : _vy );
+		auto mid = begin + (end - begin) / 2;
+		std::nth_element(
+			perm.begin() + begin,
+			perm.begin() + mid,
+			perm.begin() + end,
+			[&coord]( size_t i1, size_t i2 ){ return coord[i1] < coord[i2]; }
+		);
+		_axis[mid] = axis;
+		p_build( perm, begin, mid );
+		p_build( perm, mid+1, end );
+	}
 
-	priv::fix_order( out._ptIntersect_1, out._ptIntersect_2 );
-	return out;
-}
-//------------------------------------------------------------------
-/// Overload used when attempting to use that on a point
-template<typename LP, typename FPT>
-template<typename FPT2>
-constexpr detail::IntersectM<FPT>
-LPBase<LP,FPT>::impl_intersectsFRect( const FRect_<FPT2>&, const detail::BaseHelper<typename typ::IsPoint>& ) const
-{
-	static_assert( detail::AlwaysFalse<LP>::value, "Invalid: you cannot call intersects(FRect) on a point" );
-}
+/// Returns boxes of the two sub-trees of node at position \c mid
+	std::pair<Box,Box> p_split( const Box& box, size_t mid ) const
+	{
+		Box b1 = box;
+		Box b2 = box;
+		if( _axis[mid] == 0 )
+			b1._xmax = b2._xmin = _vx[mid];
+		else
+			b1._ymax = b2._ymin = _vy[mid];
+		return std::make_pair( b1, b2 );
+	}
 
-/// Line/FRect intersection
-/**
-Returns 0, 1, or 2 intersections
-(1 when the line touches the edge of rectangle)
+	HOMOG2D_INUMTYPE p_dist2( size_t i, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
+	{
+		auto dx = _vx[i] - x;
+		auto dy = _vy[i] - y;
+		return dx*dx + dy*dy;
+	}
 
-\todo 20230118: check if there is a need to fix the order of points in returned object (this was done previously)
-*/
-template<typename LP, typename FPT>
-template<typename FPT2>
-detail::IntersectM<FPT>
-LPBase<LP,FPT>::impl_intersectsFRect( const FRect_<FPT2>& rect, const detail::BaseHelper<typename typ::IsLine>& ) const
-{
-	std::vector<Point2d_<FPT>> pti;
-	for( const auto& seg: rect.getSegs() ) // get segment of rectangle
+	void p_nearest(
+		size_t begin, size_t end, const Box& box,
+		HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, bool skipEqual,
+		std::pair<size_t,HOMOG2D_INUMTYPE>& best
+	) const
 	{
-		auto ppts_seg = seg.getPts();
-		auto inters = seg.intersects( *this );
-		if( inters() )
+		if( box.minDist2( x, y ) > best.second )
+			return;
+		const auto nd2 = thr::nullDistance() * thr::nullDistance();
+		if( end - begin <= s_leafSize )
 		{
-			bool storePoint(true);
-			auto pt = inters.get();
-			if( pt == ppts_seg.first || pt == ppts_seg.second )  // if intersection point is one of the segment pts
-				if( pti.size() == 1 ) {                          // AND if there is already one
-					if( pti[0] == pt )                           // AND that one is already stored
-						storePoint = false;                      // THEN don't store it
+			for( auto i=begin; i<end; i++ )
+			{
+				auto d2 = p_dist2( i, x, y );
+				if( d2 < best.second && !( skipEqual && d2 < nd2 ) )
+					best = std::make_pair( i, d2 );
+			}
+			return;
+		}
+		auto mid = begin + (end - begin) / 2;
+		auto d2 = p_dist2( mid, x, y );
+		if( d2 < best.second && !( skipEqual && d2 < nd2 ) )
+			best = std::make_pair( mid, d2 );
+
+		auto boxes = p_split( box, mid );
+		bool leftFirst = ( _axis[mid] == 0 ? x < _vx[mid] : y < _vy[mid] );
+		if( leftFirst )
+		{
+			p_nearest( begin, mid, boxes.first, x, y, skipEqual, best );
+			p_nearest( mid+1, end, boxes.second, x, y, skipEqual, best );
+		}
+		else
+		{
+			p_nearest( mid+1, end, boxes.second, x, y, skipEqual, best );
+			p_nearest( begin, mid, boxes.first, x, y, skipEqual, best );
+		}
+	}
+
+	void p_farthest(
+		size_t begin, size_t end, const Box& box,
+		HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, bool skipEqual,
+		std::pair<size_t,HOMOG2D_INUMTYPE>& best
+	) const
+	{
+		if( box.maxDist2( x, y ) < best.second )
+			return;
+		const auto nd2 = thr::nullDistance() * thr::nullDistance();
+		if( end - begin <= s_leafSize )
+		{
+			for( auto i=begin; i<end; i++ )
+			{
+				auto d2 = p_dist2( i, x, y );
+				if( d2 > best.second && !( skipEqual && d2 < nd2 ) )
+					best = std::make_pair( i, d2 );
+			}
+			return;
+		}
+		auto mid = begin + (end - begin) / 2;
+		auto d2 = p_dist2( mid, x, y );
+		if( d2 > best.second && !( skipEqual && d2 < nd2 ) )
+			best = std::make_pair( mid, d2 );
+
+		auto boxes = p_split( box, mid );
+		bool leftFirst = ( _axis[mid] == 0 ? x > _vx[mid] : y > _vy[mid] );  // farthest side first
+		if( leftFirst )
+		{
+			p_farthest( begin, mid, boxes.first, x, y, skipEqual, best );
+			p_farthest( mid+1, end, boxes.second, x, y, skipEqual, best );
+		}
+		else
+		{
+			p_farthest( mid+1, end, boxes.second, x, y, skipEqual, best );
+			p_farthest( begin, mid, boxes.first, x, y, skipEqual, best );
+		}
+	}
+
+	void p_kNearest(
+		size_t begin, size_t end, const Box& box,
+		HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, size_t k,
+		std::vector<std::pair<HOMOG2D_INUMTYPE,size_t>>& heap
+	) const
+	{
+		if( heap.size() == k && box.minDist2( x, y ) > heap.front().first )
+			return;
+
+		auto tryAdd = [&]          // lambda
+			( size_t i )
+			{
+				auto d2 = p_dist2( i, x, y );
+				if( heap.size() < k )
+				{
+					heap.emplace_back( d2, i );
+					std::push_heap( heap.begin(), heap.end() );
 				}
-			if( storePoint )
-				pti.push_back( pt );
+				else if( d2 < heap.front().first )
+				{
+					std::pop_heap( heap.begin(), heap.end() );
+					heap.back() = std::make_pair( d2, i );
+					std::push_heap( heap.begin(), heap.end() );
+				}
+			};
 
-			if( pti.size() == 2 )  // already got 2, done
-				break;
+		if( end - begin <= s_leafSize )
+		{
+			for( auto i=begin; i<end; i++ )
+				tryAdd( i );
+			return;
+		}
+		auto mid = begin + (end - begin) / 2;
+		tryAdd( mid );
+		auto boxes = p_split( box, mid );
+		bool leftFirst = ( _axis[mid] == 0 ? x < _vx[mid] : y < _vy[mid] );
+		if( leftFirst )
+		{
+			p_kNearest( begin, mid, boxes.first, x, y, k, heap );
+			p_kNearest( mid+1, end, boxes.second, x, y, k, heap );
+		}
+		else
+		{
+			p_kNearest( mid+1, end, boxes.second, x, y, k, heap );
+			p_kNearest( begin, mid, boxes.first, x, y, k, heap );
 		}
 	}
-	if( pti.empty() )
-		return detail::IntersectM<FPT>();
-	detail::IntersectM<FPT> out;
-	out.add( pti );
-	return out;
+
+	void p_inRadius(
+		size_t begin, size_t end, const Box& box,
+		HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, HOMOG2D_INUMTYPE r2,
+		std::vector<size_t>& out
+	) const
+	{
+		if( box.minDist2( x, y ) > r2 )
+			return;
+		if( end - begin <= s_leafSize )
+		{
+			for( auto i=begin; i<end; i++ )
+				if( p_dist2( i, x, y ) <= r2 )
+					out.push_back( _idx[i] );
+			return;
+		}
+		auto mid = begin + (end - begin) / 2;
+		if( p_dist2( mid, x, y ) <= r2 )
+			out.push_back( _idx[mid] );
+		auto boxes = p_split( box, mid );
+		p_inRadius( begin, mid, boxes.first, x, y, r2, out );
+		p_inRadius( mid+1, end, boxes.second, x, y, r2, out );
+	}
+};
+
+//------------------------------------------------------------------
+// forward declaration
+namespace priv {
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+class ClosestPoints;
 }
 
-} // namespace base
+// forward declaration
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+getClosestPoints(
+	const base::PolylineBase<PLT1,FPT1>& poly1,
+	const base::PolylineBase<PLT2,FPT2>& poly2
+);
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - PRODUCT OPERATORS DEFINITIONS (HELPER FUNCTIONS)
-/////////////////////////////////////////////////////////////////////////////
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+getClosestPoints(
+	const base::PolylineBase<PLT1,FPT1>& poly1,
+	const base::PolylineBase<PLT2,FPT2>& poly2,
+	const PointIndex&                    index2
+);
 
-//------------------------------------------------------------------
-/// Apply homography to a vector/array/list (type T) of points or lines.
-template<typename W,typename FPT>
-template<typename T>
-void
-Hmatrix_<W,FPT>::applyTo( T& vin ) const
+namespace priv {
+
+/// Used in getClosestPoints()
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+class ClosestPoints
 {
-#if 0
-	std::transform(
-		std::begin( vin ),
-		std::end( vin ),
-		std::begin( vin ),
-		[](){}
-	);
-#else
-	for( auto& elem: vin )
-		elem = *this * elem;
-#endif
-}
+	friend priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+	h2d::getClosestPoints<>( const base::PolylineBase<PLT1,FPT1>&,const base::PolylineBase<PLT2,FPT2>& );
+	friend priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+	h2d::getClosestPoints<>( const base::PolylineBase<PLT1,FPT1>&,const base::PolylineBase<PLT2,FPT2>&, const PointIndex& );
 
-namespace detail {
+private:
+	size_t _pt1_min = 0;
+	size_t _pt2_min = 0;
+	HOMOG2D_INUMTYPE _minDist;
+	Point2d_<HOMOG2D_INUMTYPE> _pt1;
+	Point2d_<HOMOG2D_INUMTYPE> _pt2;
+	const base::PolylineBase<PLT1,FPT1>& _poly1;
+	const base::PolylineBase<PLT2,FPT2>& _poly2;
 
-/// Implementation of product 3x3 by 3x3
+	ClosestPoints( const base::PolylineBase<PLT1,FPT1>& poly1, const base::PolylineBase<PLT2,FPT2>& poly2 )
+		: _poly1(poly1), _poly2(poly2)
+	{
+		_minDist = dist( poly1.getPoint(0), poly2.getPoint(0) );
+	}
+	void store( HOMOG2D_INUMTYPE d, size_t idx1, size_t idx2 )
+	{
+		_minDist = d;
+		_pt1_min = idx1;
+		_pt2_min = idx2;
+	}
 
-template<typename FPT1,typename FPT2,typename FPT3>
-void
-product(
-	Matrix_<FPT1>&       out,
-	const Matrix_<FPT2>& h1,
-	const Matrix_<FPT3>& h2
+public:
+	PointPair_<HOMOG2D_INUMTYPE>
+	getPoints() const
+	{
+		return std::make_pair(
+			_poly1.getPoint(_pt1_min),
+			_poly2.getPoint(_pt2_min)
+		);
+	}
+	HOMOG2D_INUMTYPE getMinDist() const
+	{
+		return _minDist;
+	}
+	std::pair<size_t,size_t>
+	getIndexes() const
+	{
+		return std::make_pair( _pt1_min, _pt2_min );
+	}
+	void print() const
+	{
+		std::cout << "ClosestPoints:\n _pt1_min=" << _pt1_min << " _pt2_min=" << _pt2_min
+			<< "\n_minDist=" << _minDist
+			<< "\npt1=" << _pt1 << " pt2=" << _pt2
+		<< std::endl;
+	}
+};
+
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Computes the closest points between two polylines (types can be different)
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+getClosestPoints(
+	const base::PolylineBase<PLT1,FPT1>& poly1,
+	const base::PolylineBase<PLT2,FPT2>& poly2
 )
 {
-	out.p_fillZero();
-	for( int i=0; i<3; i++ )
-		for( int j=0; j<3; j++ )
-			for( int k=0; k<3; k++ )
-				out.value(i,j) +=
-					static_cast<HOMOG2D_INUMTYPE>( h1.value(i,k) ) * h2.value(k,j);
+#ifndef HOMOG2D_NOCHECKS
+	if( poly1.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "arg 1 is empty" );
+	if( poly2.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "arg 2 is empty" );
+#endif
+	priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2> out( poly1, poly2 );
+	for( size_t i=0; i<poly1.size(); i++ )
+	{
+		const auto& pt1 = poly1.getPoint(i);
+		for( size_t j=0; j<poly2.size(); j++ )
+		{
+			const auto& pt2 = poly2.getPoint(j);
+			auto currentDist = dist( pt1, pt2 );
+			if( currentDist < out._minDist )
+				out.store( currentDist, i, j );
+		}
+	}
+	return out;
 }
 
-/// Implementation of product 3x3 by 3x1
+//------------------------------------------------------------------
+/// Computes the closest points between two polylines, using a prebuilt index on the points of the second one
 /**
-- T1 and T2: typ::IsLine or typ::IsPoint (same but also different)
+Same result as the other overload, but O(n.log(m)) instead of O(n.m).
+\c index2 must have been built from the points of \c poly2 (see PointIndex).
 */
-template<typename T1,typename T2,typename FPT1,typename FPT2>
-void
-product(
-	base::LPBase<T1,FPT1>&        out,
-	const Matrix_<FPT2>&          h,
-	const base::LPBase<T2,FPT1>&  in
+template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
+priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
+getClosestPoints(
+	const base::PolylineBase<PLT1,FPT1>& poly1,
+	const base::PolylineBase<PLT2,FPT2>& poly2,
+	const PointIndex&                    index2
 )
 {
-	for( int i=0; i<3; i++ )
+#ifndef HOMOG2D_NOCHECKS
+	if( poly1.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "arg 1 is empty" );
+	if( poly2.size() == 0 )
+		HOMOG2D_THROW_ERROR_1( "arg 2 is empty" );
+	if( poly2.size() != index2.size() )
+		HOMOG2D_THROW_ERROR_1( "index size (" << index2.size()
+			<< ") does not match polyline size (" << poly2.size() << ")" );
+#endif
+	priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2> out( poly1, poly2 );
+	for( size_t i=0; i<poly1.size(); i++ )
 	{
-		auto sum  = static_cast<HOMOG2D_INUMTYPE>(h._mdata[i][0]) * in._v[0];
-		sum      += h._mdata[i][1] * in._v[1];
-		sum      += h._mdata[i][2] * in._v[2];
-		out._v[i] = sum;
+		const auto& pt1 = poly1.getPoint(i);
+		auto j = index2.nearest( pt1 );
+		auto currentDist = dist( pt1, poly2.getPoint(j) );
+		if( currentDist < out._minDist )
+			out.store( currentDist, i, j );
 	}
+	return out;
 }
 
-} // namespace detail
-
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - PRODUCT OPERATORS DEFINITIONS
-/////////////////////////////////////////////////////////////////////////////
-
-/// Free function template, product of two lines, returns a point
-template<typename FPT,typename FPT2>
-Point2d_<FPT>
-operator * ( const Line2d_<FPT>& lhs, const Line2d_<FPT2>& rhs )
+//------------------------------------------------------------------
+/// Returns the points of Segment as a std::pair (free function)
+/// \sa Segment_::getPts()
+template<typename FPT>
+auto
+getPts( const Segment_<FPT>& seg )
 {
-#ifndef HOMOG2D_NOCHECKS
-	if( lhs.isParallelTo(rhs) )
-		HOMOG2D_THROW_ERROR_1( "lines are parallel, unable to compute product:\nlhs="
-			<< lhs << " rhs=" << rhs
-		);
-#endif
+	return seg.getPts();
+}
 
-	return detail::crossProduct<typ::IsPoint,typ::IsLine,FPT>(lhs, rhs);
+/// Returns Segment supporting line (free function)
+/// \sa Segment_::getLine()
+template<typename FPT>
+Line2d_<FPT>
+getLine( const Segment_<FPT>& seg )
+{
+	return seg.getLine();
 }
 
-/// Free function template, product of two segments/vector, returns a point
-template<typename SV1,typename SV2,typename FPT1,typename FPT2>
-Point2d_<FPT1>
-operator * ( const base::SegVec<SV1,FPT1>& lhs, const base::SegVec<SV2,FPT2>& rhs )
+/// Returns Extended Segment (free function)
+/// \sa Segment_::geExtended()
+template<typename FPT>
+Segment_<FPT>
+getExtended( const Segment_<FPT>& seg )
 {
-	return lhs.getLine() * rhs.getLine();
+	return seg.getExtended();
 }
 
-#ifdef HOMOG2D_FUTURE_STUFF
-/// Apply Epipolar matrix to a point or line, this will return the opposite type.
-/// Free function, templated by point or line
-template<typename T,typename U,typename V>
-base::LPBase<typename detail::HelperPL<T>::OtherType,V>
-operator * ( const Hmatrix_<typ::IsEpipmat,U>& h, const base::LPBase<T,V>& in )
+/// Returns a pair of segments, corresponding to the input segment split by middle point (free function)
+/// \sa Segment_::split()
+template<typename SV,typename FPT>
+std::pair<base::SegVec<SV,FPT>,base::SegVec<SV,FPT>>
+split( const base::SegVec<SV,FPT>& seg )
 {
-	LPBase<typename detail::HelperPL<T>::OtherType,V> out;
-	detail::product( out, h._data, in );
-	return out;
+	return seg.split();
 }
-#endif
 
-/// Free function, apply homography to a point.
-template<typename T,typename U>
-Point2d_<T>
-operator * ( const Homogr_<U>& h, const Point2d_<T>& in )
+/// Returns a pair of segments, corresponding to the input segment split by point at distance \c dist (free function)
+/// \note: can only be used on oriented segments
+/// \sa Segment_::split( T )
+template<typename FPT, typename T>
+std::pair<OSegment_<FPT>,OSegment_<FPT>>
+split( const OSegment_<FPT>& seg, T dist )
 {
-	Point2d_<T> out;
-	detail::product( out, h, in );
-	return out;
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	return seg.split( dist );
 }
 
-/// Free function, apply homography to a line.
-template<typename T,typename U>
-Line2d_<T>
-operator * ( const Homogr_<U>& h, const Line2d_<T>& in )
-{
-	if( h._hmt == nullptr )             // if H^-T	not allocated yet, do it
-	{
-		h._hmt = std::unique_ptr<detail::Matrix_<U>>( new detail::Matrix_<U>() );
-		h._hasChanged = true;
-	}
-
-	if( h._hasChanged )                  // if homography has changed, recompute inverse and transposed
-	{
-		auto hi = h;
-		auto mat_inv = hi.inverse().transpose();
-		*h._hmt = mat_inv;
-		h._hasChanged = false;
-	}
 
-	Line2d_<T> out;
-	detail::product( out, *h._hmt, in );
-	out.p_normalizePL();
-	return out;
+/// Returns the 4 orthogonal segments to the segment
+/// \sa Segment_::getOrthogSegs()
+template<typename FPT>
+std::array<Segment_<FPT>,4>
+getOrthogSegs( const Segment_<FPT>& seg )
+{
+	return seg.getOrthogSegs();
 }
 
-/// Apply homography to a Segment
-template<typename SV,typename FPT1,typename FPT2>
-Segment_<FPT1>
-operator * ( const Homogr_<FPT1>& h, const base::SegVec<SV,FPT2>& seg )
+/// Returns the 4 orthogonal points to the segment
+/// \sa Segment_::getOrthogPts()
+template<typename FPT>
+std::array<Point2d_<FPT>,4>
+getOrthogPts( const Segment_<FPT>& seg )
 {
-	const auto& pts = seg.getPts();
-	Point2d_<FPT1> pt1 = h * pts.first;
-	Point2d_<FPT1> pt2 = h * pts.second;
-	return base::SegVec<SV,FPT2>( pt1, pt2 );
+	return seg.getOrthogPts();
 }
 
-/// Apply homography to a Polyline
-template<typename FPT1,typename FPT2,typename PLT>
-base::PolylineBase<PLT,FPT1>
-operator * ( const Homogr_<FPT2>& h, const base::PolylineBase<PLT,FPT1>& pl )
+//------------------------------------------------------------------
+/// Free function, returns segment between two circle centers (or ellipse)
+template<typename T1,typename T2>
+Segment_<typename T1::FType>
+getSegment( const T1& c1, const T2& c2 )
 {
-	base::PolylineBase<PLT,FPT1> out;
-	const auto& pts = pl.getPts();
-	for( const auto& pt: pts )
-		out.p_addPoint( h * pt );
-	return out;
+	return Segment_<typename T1::FType>( c1.getCenter(), c2.getCenter() );
 }
 
-/// Apply homography to a flat rectangle produces a closed polyline
-template<typename FPT1,typename FPT2>
-CPolyline_<FPT1>
-operator * ( const h2d::Homogr_<FPT2>& h, const h2d::FRect_<FPT1>& rin )
+/// Free function, returns line between two circle centers
+template<typename FPT1,typename FPT2,typename FPT3>
+Line2d_<FPT1>
+getLine( const Circle_<FPT2>& c1, const Circle_<FPT3>& c2 )
 {
-	h2d::CPolyline_<FPT1> out;
-	for( const auto& pt: rin.get4Pts() )
-		out.p_addPoint( h * pt );
-	return out;
+	return Line2d_<FPT1>( c1.center(), c2.center() );
 }
 
-/// Apply homography to a Ellipse, produces an Ellipse
-/**
-\f[
-Q' = H^{-T} \cdot Q \cdot H^{-1}
-\f]
-*/
-template<typename FPT1,typename FPT2>
-Ellipse_<FPT1>
-operator * ( const Homogr_<FPT2>& h, const Ellipse_<FPT1>& ell_in )
+/// Free function, returns middle point of segment
+/// \sa Segment_::getCenter()
+template<typename FPT>
+Point2d_<FPT>
+getCenter( const Segment_<FPT>& seg )
 {
-	auto hm = static_cast<detail::Matrix_<HOMOG2D_INUMTYPE>>(h);
-	hm.inverse();
-	auto hmt = hm;
-	hmt.transpose();
-
-	const auto& ell_in2 = static_cast<detail::Matrix_<FPT1>>(ell_in);
-	auto prod = hmt * ell_in2 * hm;
-
-	Ellipse_<FPT1> out( prod );
-	return out;
+	return seg.getCenter();
 }
 
-/// Apply homography to a Circle, produces an Ellipse
-/** Converts the circle to an ellipse, then calls the corresponding code */
-template<typename FPT1,typename FPT2>
-Ellipse_<FPT1>
-operator * ( const Homogr_<FPT2>& h, const Circle_<FPT1>& cir )
+/// Free function, returns bisector line of segment
+/// \sa Segment_::getBisector()
+template<typename FPT>
+Line2d_<FPT>
+getBisector( const Segment_<FPT>& seg )
 {
-	Ellipse_<FPT1> ell_in( cir );
-	return h * ell_in;
+	return seg.getBisector();
 }
 
-//------------------------------------------------------------------
-namespace priv {
+/// Free function, returns a pair of parallel segments at a distance \c dist
+/// \sa Segment_::getBisector()
+template<typename FPT,typename T>
+std::pair<Segment_<FPT>,Segment_<FPT>>
+getParallelSegs( const Segment_<FPT>& seg, T dist )
+{
+	return seg.getParallelSegs(dist);
+}
 
-/// Allocation for \c std::array container
+/// Free function, returns middle points of set of segments/circles
 /**
-\sa operator * ( const Hmatrix_&, const Cont& );
+\sa Segment_::getCenter()
+\sa Circle_::getCenter()
+- input: set of segments
+- output: set of points (same container)
 */
 template<
-	typename Cont,
+	typename T,
 	typename std::enable_if<
-		trait::IsArray<Cont>::value,
-		Cont
+		trait::IsContainer<T>::value,
+		T
 	>::type* = nullptr
 >
-Cont
-alloc( std::size_t /* unused here */ )
+auto
+getCenters( const T& vsegs )
 {
-	return Cont();
+	std::vector<Point2d_<typename T::value_type::FType>> vout( vsegs.size() );
+
+	auto it = std::begin( vout );
+	for( const auto& seg: vsegs )
+		*it++ = getCenter( seg );
+	return vout;
 }
 
-/// Allocation for \c std::vector and \c std::list container
+/// Free function, returns a set of lines from a set of segments
+/**
+\sa Segment_::getLine()
+*/
 template<
-	typename Cont,
+	typename T,
 	typename std::enable_if<
-		!trait::IsArray<Cont>::value,
-		Cont
+		trait::IsContainer<T>::value,
+		T
 	>::type* = nullptr
 >
-Cont
-alloc( std::size_t nb )
+auto
+getLines( const T& vsegs )
 {
-	return Cont(nb);
-}
-
-} // namespace priv
+	std::vector<Line2d_<typename T::value_type::FType>> vout( vsegs.size() );
 
-//------------------------------------------------------------------
-/// Used to proceed multiple products, whatever the container (\c std::list, \c std::vector, or \c std::array).
-/// Returned container is of same type as given input
-template<typename FPT,typename Cont>
-typename std::enable_if<trait::IsContainer<Cont>::value,Cont>::type
-operator * (
-	const Hmatrix_<typ::IsHomogr,FPT>& h,    ///< Matrix
-	const Cont&                        vin   ///< Input container
-)
-{
-	Cont vout = priv::alloc<Cont>( vin.size() );
 	auto it = std::begin( vout );
-	for( const auto& elem: vin )
-		*it++ = h * elem;
+	for( const auto& seg: vsegs )
+		*it++ = seg.getLine();
 	return vout;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - FREE FUNCTIONS
-/////////////////////////////////////////////////////////////////////////////
-
-template<typename FPT>
-FPT getX( const Point2d_<FPT>& pt) { return pt.getX(); }
-
+/// Free function, returns segments of the rectangle
+/// \sa FRect_::getSegs()
 template<typename FPT>
-FPT getY( const Point2d_<FPT>& pt) { return pt.getY(); }
-
-//------------------------------------------------------------------
-/// Free function, returns -1 or +1 depending on the side of \c pt, related to \c li
-template<typename FPT1,typename FPT2>
-int
-side( const Point2d_<FPT1>& pt, const Line2d_<FPT2>& li )
+std::array<Segment_<FPT>,4>
+getSegs( const FRect_<FPT>& seg )
 {
-	const auto& arr = li.get();
-	HOMOG2D_INUMTYPE a = arr[0];
-	HOMOG2D_INUMTYPE b = arr[1];
-	HOMOG2D_INUMTYPE c = arr[2];
-
-	auto dist = a * pt.getX() + b * pt.getY() + c;
-	if( homog2d_abs(dist) < thr::nullDistance() )
-		return 0;
-	return (std::signbit( dist ) ? -1 : +1);
+	return seg.getSegs();
 }
 
-//------------------------------------------------------------------
-/// Free function, distance between points
-/// \sa Point2d_::distTo()
+/// Free function, returns the pair of segments tangential to the two circles
+/** Sources:
+  - https://math.stackexchange.com/questions/719758/
+  - https://math.stackexchange.com/a/211854/133647
+  - https://en.wikipedia.org/wiki/Tangent_lines_to_circles
+  - https://gieseanw.wordpress.com/2012/09/12/finding-external-tangent-points-for-two-circles/
+*/
 template<typename FPT1,typename FPT2>
-HOMOG2D_INUMTYPE
-dist( const Point2d_<FPT1>& pt1, const Point2d_<FPT2>& pt2 )
+std::pair<Segment_<FPT1>,Segment_<FPT1>>
+getTanSegs( const Circle_<FPT1>& c1, const Circle_<FPT2>& c2 )
 {
-	return pt1.distTo( pt2 );
-}
+#ifndef HOMOG2D_NOCHECKS
+	if( c1 == c2 )
+		HOMOG2D_THROW_ERROR_1( "c1 and c2 identical" );
+#endif
 
-//------------------------------------------------------------------
-/// Intersection area over Union area (free function)
-template<typename FPT1,typename FPT2>
-HOMOG2D_INUMTYPE
-IoU( const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
-{
-	auto ia = intersectArea( r1, r2 );
-	if( ia() )
-		return ia.get().area() / unionArea( r1, r2 ).area();
-	return 0.;
-}
+// if same radius, return the two segments parallel to the one joining the centers
+	if( homog2d_abs( c1.radius() - c2.radius() ) < thr::nullDistance() )
+	{
+		Segment_<HOMOG2D_INUMTYPE> seg_center( c1.center(), c2.center() );
+		return seg_center.getParallelSegs( c1.radius() );
+	}
 
-//------------------------------------------------------------------
-/// Free function, see FRect_::unionArea()
-template<typename FPT1,typename FPT2>
-CPolyline_<FPT1>
-unionArea( const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
-{
-	return r1.unionArea(r2);
-}
+// check which one is the smallest
+	Circle_<HOMOG2D_INUMTYPE> cA = c1;
+	Circle_<HOMOG2D_INUMTYPE> cB = c2;
+	if( c1.radius() < c2.radius() )
+		std::swap( cA, cB );
+
+	auto h = dist( cA.center(), cB.center() );
+
+	auto theta = homog2d_asin( ( cA.radius() - cB.radius() ) / h ) ;
+	auto hcost = h * homog2d_cos(theta);
+
+// get rotated lines at center of CB
+	auto l0 = cA.center() * cB.center();
+	auto l1 = l0.getRotatedLine( cB.center(),  theta );
+	auto l2 = l0.getRotatedLine( cB.center(), -theta );
 
-//------------------------------------------------------------------
-/// Free function, see FRect_::intersectArea()
-template<typename FPT1,typename FPT2>
-detail::RectArea<FPT1>
-intersectArea(  const FRect_<FPT1>& r1, const FRect_<FPT2>& r2 )
-{
-	return r1.intersectArea(r2);
-}
+// build segments by getting the opposite point
 
-//------------------------------------------------------------------
-/// Returns circle passing through 4 points of flat rectangle (free function)
-/// \sa FRect_::getBoundingCircle()
-template<typename FPT>
-Circle_<FPT>
-getBoundingCircle( const FRect_<FPT>& rect )
-{
-	return rect.getBoundingCircle();
-}
+	auto ppts1 = l1.getPoints( cB.center(), hcost );
+	auto p1 = ppts1.first;
+	if( ppts1.second.distTo( cA.center()) < p1.distTo( cA.center()) )
+		p1 = ppts1.second;
 
-//------------------------------------------------------------------
-/// Return circle inscribed in rectangle
-/// \sa hFRect_::getInscribedCircle()
-template<typename FPT>
-Circle_<FPT>
-getInscribedCircle( const FRect_<FPT>& rect )
-{
-	return rect.getInscribedCircle();
-}
+	auto ppts2 = l2.getPoints( cB.center(), hcost );
+	auto p2 = ppts2.first;
+	if( ppts2.second.distTo( cA.center()) < p2.distTo( cA.center()) )
+		p2 = ppts2.second;
+//	std::cout <<"p1=" << p1 << " p2=" << p2 << '\n';
 
-//------------------------------------------------------------------
-/// Returns true if is a polygon (free function)
-///  \sa PolylineBase::isSimple()
-template<typename PLT,typename FPT>
-bool
-isSimple( const base::PolylineBase<PLT,FPT>& pl )
-{
-	return pl.isSimple();
-}
+	auto seg1 = Segment_<HOMOG2D_INUMTYPE>( p1, cB.center() );
+	auto seg2 = Segment_<HOMOG2D_INUMTYPE>( p2, cB.center() );
 
-//------------------------------------------------------------------
-/// Returns true if polygon is convex (free function)
-/// \sa PolylineBase::isConvex()
-template<typename PLT,typename FPT>
-bool
-isConvex( const base::PolylineBase<PLT,FPT>& poly )
-{
-	return poly.isConvex();
-}
+	auto psegs1 = seg1.getParallelSegs( cB.radius() );
+	if( psegs1.first.distTo(cA.center()) <  psegs1.second.distTo(cA.center()) )
+		std::swap( psegs1.first, psegs1.second );
 
-//------------------------------------------------------------------
-/// Returns the number of segments (free function)
-/// \sa PolylineBase::nbSegs()
-template<typename PLT,typename FPT>
-size_t
-nbSegs( const base::PolylineBase<PLT,FPT>& pl )
-{
-	return pl.nbSegs();
+	auto psegs2 = seg2.getParallelSegs( cB.radius() );
+	if( psegs2.second.distTo(cA.center()) <  psegs2.first.distTo(cA.center()) )
+		std::swap( psegs2.first, psegs2.second );
+
+	return std::make_pair(
+		psegs1.first,
+		psegs2.second
+	);
 }
 
-//------------------------------------------------------------------
-/// Returns the segments of the polyline (free function)
-/// \sa PolylineBase::getSegs()
-template<typename PLT,typename FPT>
-std::vector<Segment_<FPT>>
-getSegs( const base::PolylineBase<PLT,FPT>& pl )
+/// Returns the 4 points of the rectangle (free function)
+/// \sa FRect_::get4Pts()
+template<typename FPT>
+std::array<Point2d_<FPT>,4>
+get4Pts( const FRect_<FPT>& rect )
 {
-	return pl.getSegs();
+	return rect.get4Pts();
 }
 
-//------------------------------------------------------------------
-/// Rotates the primitive (only available for Polyline and FRect) around (0,0)
-template<typename T>
-void
-rotate( T& prim, Rotate rot )
+/// Returns the 2 major points of the rectangle (free function)
+/// \sa FRect_::getPts()
+template<typename FPT>
+auto
+getPts( const FRect_<FPT>& rect )
 {
-	prim.rotate( rot );
+	return rect.getPts();
 }
 
-//------------------------------------------------------------------
-/// Rotates the primitive (only available for Polyline and FRect) around \c refpt
-template<typename T,typename FPT>
-void
-rotate( T& prim, Rotate rot, const Point2d_<FPT>& refpt )
+/// Free function
+template<typename FPT>
+HOMOG2D_INUMTYPE
+height( const FRect_<FPT>& rect )
 {
-	prim.rotate( rot, refpt );
+	return rect.height();
 }
 
-//------------------------------------------------------------------
-/// Returns Bounding Box of Ellipse_ (free function)
-/// \sa Ellipse_::getBB()
+/// Free function
 template<typename FPT>
-CPolyline_<FPT>
-getOBB( const Ellipse_<FPT>& ell )
+HOMOG2D_INUMTYPE
+width( const FRect_<FPT>& rect )
 {
-	return ell.getOBB();
+	return rect.width();
 }
 
-//------------------------------------------------------------------
-/// Returns bisector lines of a Polyline
-/**
-Size of vector will be:
-- equal to size() of polyline if closed
-- equal to size()-2 of polyline if open
-
-\warning:
-- if open: the FIRST line (index 0) will correspond to SECOND point of the polyline
-*/
-template<typename PLT,typename FPT>
-std::vector<Line2d_<HOMOG2D_INUMTYPE>>
-getBisectorLines( const base::PolylineBase<PLT,FPT>& pl )
+/// Free function
+template<typename FPT>
+FRect_<FPT>
+getExtended( const FRect_<FPT>& rect )
 {
-	if( pl.size() < 3 )
-	{
-		HOMOG2D_THROW_ERROR_1( "unable, minimum size is 3, currently=" << pl.size() );
-	}
-	const auto& pts  = pl.getPts();
-	std::vector<Line2d_<HOMOG2D_INUMTYPE>> out;
-
-	if constexpr ( std::is_same_v<PLT,typ::IsOpen> )
-	{
-		out.reserve( pl.size()-2 );
-		OSegment_<HOMOG2D_INUMTYPE> seg1( pts[1], pts[0] );
-		for( size_t i=0; i<pl.size()-2; i++ )
-		{
-			OSegment_<HOMOG2D_INUMTYPE> seg2( pts[i+1], pts[i+2] );
-			auto angle = seg1.getAngle( seg2 );
-			out.emplace_back( seg1.getLine().getRotatedLine( pts[i+1], angle/2. ) );
-			seg1 = -seg2;
-		}
-	}
-	else
-	{
-		out.reserve( pl.size() );
-		OSegment_<HOMOG2D_INUMTYPE> seg1( pts[0], pts[pl.size()-1] );
-		for( size_t i=0; i<pl.size(); i++ )
-		{
-			auto next = ( i != pl.size()-1 ? i+1 : 0 );
-			OSegment_<HOMOG2D_INUMTYPE> seg2( pts[i], pts[next] );
-			auto angle = seg1.getAngle( seg2 );
-			out.emplace_back( seg1.getLine().getRotatedLine( pts[i], angle/2. ) );
-			seg1 = -seg2;
-		}
-	}
-	return out;
+	return rect.getExtended();
 }
 
-
-//------------------------------------------------------------------
-/// Holds free functions returning a pair of points
-namespace ppair {
-
-/// Returns pair of points defining a BB of a primitive
-/// Overload 1/4, private free function
-/**
-Arg is a neither a Point2d, a Segment, a Line2d or a polyline
-*/
-template<
-	typename T,
-	typename std::enable_if<
-		(                                                          // type is
-			   !std::is_same<T,Line2d_<typename    T::FType>>::value // not a line,
-			&& !std::is_same<T,Point2d_<typename   T::FType>>::value // not a point,
-			&& !std::is_same<T,Segment_<typename   T::FType>>::value // not a segment
-			&& !std::is_same<T,OSegment_<typename  T::FType>>::value // not a vector
-			&& !std::is_same<T,CPolyline_<typename T::FType>>::value // not a CPolyline
-			&& !std::is_same<T,OPolyline_<typename T::FType>>::value // not a OPolyline
-		)
-		,T
-	>::type* = nullptr
->
-auto
-getPointPair( const T& elem )
+/// Free function
+template<typename FPT>
+std::pair<Segment_<FPT>,Segment_<FPT>>
+getDiagonals( const FRect_<FPT>& rect )
 {
-	HOMOG2D_START;
-	return elem.getBB().getPts();
+	return rect.getDiagonals();
 }
 
-/// Returns pair of points defining a BB of a Polyline
-/// Overload 2/4, private free function
-template<
-	typename T,
-	typename std::enable_if<
-		(
-			std::is_same<T,CPolyline_<typename T::FType>>::value
-			|| std::is_same<T,OPolyline_<typename T::FType>>::value
-		)
-		,T
-	>::type* = nullptr
->
-auto
-getPointPair( const T& poly )
+/// Returns triangulation of Polyline (free function)
+/// \sa PolylineBase::triangulate()
+template<typename PLT,typename FPT>
+std::vector<std::array<size_t,3>>
+triangulate( const base::PolylineBase<PLT,FPT>& pl )
 {
-	HOMOG2D_START;
-
-	if( poly.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "cannot compute point pair of empty Polyline" );
-	if( poly.size() == 2 )
-	{
-		const auto& pts = poly.getPts();
-		return std::make_pair( pts[0], pts[1] );
-	}
-	return priv::getBB_Points( poly.getPts() );
+	return pl.triangulate();
 }
 
-/// Returns pair of points defining a BB of a Point2d
-/// Overload 3/4, private free function
-/**
-This seems useless at first glance, but it is used to get the common bounding box of two objects
-when one of them (or both) is a point.
-*/
-template<
-	typename T,
-	typename std::enable_if<
-		std::is_same<T,Point2d_<typename T::FType>>::value
-		,T
-	>::type* = nullptr
->
-auto
-getPointPair( const T& elem )
+/// Returns centroid of Polyline (free function)
+/// \sa PolylineBase::centroid()
+template<typename PLT,typename FPT>
+base::LPBase<typ::IsPoint,FPT>
+centroid( const base::PolylineBase<PLT,FPT>& pl )
 {
-	HOMOG2D_START;
-	return std::make_pair( Point2d_<HOMOG2D_INUMTYPE>(elem), Point2d_<HOMOG2D_INUMTYPE>(elem) );
+	return pl.centroid();
 }
 
-/// Returns pair of points defining a BB of Segment
-/// Overload 4/4, private free function
-template<
-	typename T,
-	typename std::enable_if<
-		( std::is_same_v<T,Segment_<typename T::FType>>
-		|| std::is_same_v<T,OSegment_<typename T::FType>> )
-		,T
-	>::type* = nullptr
->
-auto
-getPointPair( const T& elem )
+/// Returns reference on radius of circle (free function), non-const version
+/// \sa Circle_::radius()
+template<typename FPT>
+FPT&
+radius( Circle_<FPT>& cir )
 {
-	HOMOG2D_START;
-	return elem.getPts();
+	return cir.radius();
 }
 
-/// Needed because of variant
+/// Returns reference on radius of circle (free function), const version
+/// \sa Circle_::radius()
 template<typename FPT>
-PointPair_<FPT>
-getPointPair( const Line2d_<FPT>& )
+const FPT&
+radius( const Circle_<FPT>& cir )
 {
-	HOMOG2D_START;
-	HOMOG2D_THROW_ERROR_1( "Unable to get pair of points for a Line2d" );
+	return cir.radius();
 }
 
-} // namespace ppair
+/// Returns reference on center of circle (free function), non-const version
+/// \sa Circle_::center()
+template<typename FPT>
+Point2d_<FPT>&
+center( Circle_<FPT>& cir )
+{
+	return cir.center();
+}
 
+/// Returns reference on center of circle (free function), const version
+/// \sa Circle_::center()
+template<typename FPT>
+const Point2d_<FPT>&
+center( const Circle_<FPT>& cir )
+{
+	return cir.center();
+}
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION - FUNCTORS USED IN FOLLOWING FREE FUNCTIONS
-/////////////////////////////////////////////////////////////////////////////
+/// Get data size expressed as number of bits for, respectively, mantissa and exponent
+/// \sa detail::Common::dsize()
+template<typename T>
+std::pair<int,int>
+dsize( const T& t )
+{
+	return t.dsize();
+}
 
-#ifdef HOMOG2D_ENABLE_VRTP
-namespace fct {
 //------------------------------------------------------------------
-/// A functor to get pair of points englobing the element
+/// Returns the distance between 2 parallel lines (free function)
 /**
-\sa CommonType_
-\sa area()
-*/
-struct PtPairFunct
-{
-	template<typename T>
-	PointPair_<typename T::FType>
-	operator ()(const T& a)
-	{
-		return ppair::getPointPair(a);
-	}
-};
+- ref: https://en.wikipedia.org/wiki/Distance_between_two_parallel_lines
 
-//------------------------------------------------------------------
-/// A functor to get the Bounding Box
-/// \sa getBB()
-struct BBFunct
+We first check that the two lines are indeed parallel.
+This should ensure that a1=a2 and b1=b2.
+But due to numeric issues they could by slightly different. In order to gain accuracy,
+we use the geometric mean of these.
+*/
+template<typename FPT>
+HOMOG2D_INUMTYPE
+getParallelDistance( const Line2d_<FPT>& li1, const Line2d_<FPT>& li2 )
 {
-	template<typename T>
-//	FRect_<typename T::FType> operator ()(const T& a)
-	FRect_<HOMOG2D_INUMTYPE> operator ()(const T& a)
-	{
-		return a.getBB();
-	}
-};
+#ifndef HOMOG2D_NOCHECKS
+	if( !li1.isParallelTo(li2) )
+		HOMOG2D_THROW_ERROR_1( "lines are not parallel" );
+#endif
+	const auto ar1 = li1.get();
+	const auto ar2 = li2.get();
+	const HOMOG2D_INUMTYPE a1 = ar1[0];
+	const HOMOG2D_INUMTYPE b1 = ar1[1];
+	const HOMOG2D_INUMTYPE c1 = ar1[2];
+	const HOMOG2D_INUMTYPE a2 = ar2[0];
+	const HOMOG2D_INUMTYPE b2 = ar2[1];
+	const HOMOG2D_INUMTYPE c2 = ar2[2];
 
-} // namespace fct
+	HOMOG2D_INUMTYPE a = homog2d_sqrt( a1*a2 );
+	HOMOG2D_INUMTYPE b = homog2d_sqrt( b1*b2 );
+	return homog2d_abs( c1 - c2 ) / homog2d_sqrt( a*a + b*b );
+}
 
-#endif // HOMOG2D_ENABLE_VRTP
+/// Return angle of ellipse (free function)
+/// \sa Ellipse_::angle()
+template<typename FPT>
+HOMOG2D_INUMTYPE
+angle( const Ellipse_<FPT>& ell )
+{
+	return ell.angle();
+}
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - FREE FUNCTIONS HANDLING VARIANT TYPE
-/////////////////////////////////////////////////////////////////////////////
+/// Return center of Segment_, FRect_, or Ellipse_ (free function)
+/// \sa Ellipse_::getCenter()
+/// \sa FRect_::getCenter()
+/// \sa Segment_::getCenter()
+template<typename T>
+Point2d_<typename T::FType>
+getCenter(const T& other )
+{
+	return other.getCenter();
+}
 
+/// Translate primitive \c prim (free function)
 /**
-\addtogroup varff Free functions handling variant type
-
-
-defgroup
-
-These function can be used on a "regular" geometric object or on a `CommonType` object,
-holding a std::variant and allowing run-time polymorphism,
-
-See md_docs_homog2d_manual.html#section_rtp
+Calls the member function. Type checking is done there.
 */
+template<typename T,typename FP1,typename FP2>
+void
+translate( T& prim, FP1 dx, FP2 dy )
+{
+	prim.translate( dx, dy );
+}
 
-//------------------------------------------------------------------
-/// Free function. Returns the type of object or variant
+/// Translate primitive \c prim with values in a \c std::pair (free function)
 /**
-Can be printed with `getString()`
-\sa CommonType_
-\ingroup varff
+Calls the member function. Type checking is done there.
 */
-template<typename T>
-Type
-type( const T& elem )
+template<typename T,typename FP1,typename FP2>
+void
+translate( T& prim, const std::pair<FP1,FP2>& ppt )
 {
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::TypeFunct{}, elem );
-	else
-#endif
-		return elem.type();
+	prim.translate( ppt.first, ppt.second );
 }
 
-//------------------------------------------------------------------
-/// Returns the underlying data type of object or variant
+/// Move primitive to other location (free function)
 /**
-Can be printed with `getString()`
-\ingroup varff
+Calls the member function. Type checking is done there.
 */
-template<typename T>
-Dtype
-dtype( const T& elem )
+template<typename T,typename FP>
+void
+moveTo( T& prim, const Point2d_<FP>& pt )
 {
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::DTypeFunct{}, elem );
-	else
-#endif
-		return elem.dtype();
+	prim.moveTo( pt );
 }
 
-//------------------------------------------------------------------
-/// Returns length of element or variant (free function)
-/// \ingroup varff
-template<typename T>
-HOMOG2D_INUMTYPE
-length( const T& elem )
-{
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::LengthFunct{}, elem );
-	else
-#endif
-		return elem.length();
-}
+/// Move primitive to other location (free function)
+/**
+Calls the member function. Type checking is done there.
+*/
+	template<typename T,typename FP1,typename FP2>
+	void moveTo( T& prim, FP1 x, FP2 y )
+	{
+		prim.moveTo( x, y );
+	}
 
-//------------------------------------------------------------------
-/// Returns area of element or variant (free function)
-/// \ingroup varff
-template<typename T>
-HOMOG2D_INUMTYPE
-area( const T& elem )
+/// Returns true if ellipse is a circle
+/// \sa Ellipse_::isCircle()
+template<typename FPT>
+bool
+isCircle( const Ellipse_<FPT>& ell, HOMOG2D_INUMTYPE thres=1.E-10 )
 {
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::AreaFunct{}, elem );
-	else
-#endif
-		return elem.area();
+	return ell.isCircle( thres );
 }
 
-//------------------------------------------------------------------
-/// Returns size of element or variant (free function)
-/// \ingroup varff
-template<typename T>
-HOMOG2D_INUMTYPE
-size( const T& elem )
+/// Returns ellipse axis lines
+/// \sa Ellipse_::getAxisLines()
+template<typename FPT>
+std::pair<Line2d_<FPT>,Line2d_<FPT>>
+getAxisLines( const Ellipse_<FPT>& ell )
 {
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::SizeFunct{}, elem );
-	else
-#endif
-		return elem.size();
+	return ell.getAxisLines();
 }
 
 
-#ifdef HOMOG2D_ENABLE_VRTP
 namespace priv {
 
-/// Get Bounding Box for a container holding variant objects
-/**
-\note Here, we DO NOT preallocate the vector, because if the container holds lines, then no point pair will be added for these elements.
-If we would have preallocate with 2 x size of input vector, then some default-constructed points could sneak in, and introduce an error.
+/// used in findPoint()
+struct F_MIN{};
+struct F_MAX{};
 
-\todo 20240513: At present, this is only implemented for std::vector. Let it handle std::list and std::array.
+/// Private. Common function for searching nearest of farthest point
+/*
+\sa findNearestPoint()
+\sa findFarthestPoint
 */
-template<typename FPT>
-auto
-getBB_CommonType( const std::vector<CommonType_<FPT>>& v_var )
+template<typename FPT, typename CONT, typename S_WHAT>
+size_t
+findPoint(
+	const Point2d_<FPT>& qpt,  ///< query point
+	const CONT&          cont, ///< container
+	const S_WHAT&              ///< F_MIN or F_MAX
+//	const CONT2*         mask  ///< optional vector or list or array of bool
+)
 {
-	HOMOG2D_START;
-	HOMOG2D_DEBUG_ASSERT( v_var.size(), "cannot compute bounding box of empty set of variant" );
+	if( cont.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "container holds " << cont.size() \
+			<< " points, minimum is 2" );
 
-	std::vector<Point2d_<FPT>> vpts;
-	vpts.reserve( v_var.size()*2 );
-	PointPair_<FPT> ppair;
-	for( const auto& elem: v_var )
+	decltype( priv::sqDist( qpt, qpt ) ) resDist;
+	size_t startIdx = 1;
+	size_t resIdx = 0;
+
+// if point is the first one of the container, then
+// initialize with the second one
+	if( cont[0] == qpt )
 	{
-		try
-		{
-			ppair = std::visit( fct::PtPairFunct{}, elem );
-		}
-		catch( const std::exception& err )
+		startIdx++;
+		resIdx++;
+		resDist = priv::sqDist( qpt, cont[1] );
+	}
+	else // initialize with first point
+	{
+		resDist = priv::sqDist( qpt, cont[0] );
+	}
+
+	for( size_t i=startIdx; i<cont.size(); i++ )
+	{
+		if( qpt != cont[i] )
 		{
-			HOMOG2D_LOG_WARNING( "unable to compute point pair\n -msg=" << err.what() );
+			auto currentDist = priv::sqDist( qpt, cont[i] );
+			if constexpr( std::is_same_v<S_WHAT, F_MIN> )
+			{
+				if( currentDist < resDist )
+				{
+					resIdx  = i;
+					resDist = currentDist;
+				}
+			}
+			else
+			{
+				if( currentDist > resDist )
+				{
+					resIdx  = i;
+					resDist = currentDist;
+				}
+			}
 		}
-		vpts.push_back( ppair.first );
-		vpts.push_back( ppair.second );
 	}
-	return FRect_<FPT>( getBB_Points( vpts ) );
+	return resIdx;
 }
 
-} // namespace priv
-
-#endif // HOMOG2D_ENABLE_VRTP
+} //namespace priv
 
 //------------------------------------------------------------------
-/// Return Bounding Box of primitive or container holding primitives (free function)
+/// Returns index of point in container \c cont that is the nearest to \c pt
+/// \todo add some sfinae and/or checking on type T
+/// \todo perform some speed analysis, and check if usage of squared distance is really better
+/// \todo add other distance computations (Manhattan?)
+/// \todo Would it be better to return an iterator?
+template<typename FPT, typename T>
+size_t
+findNearestPoint( const Point2d_<FPT>& pt, const T& cont )
+{
+	return priv::findPoint( pt, cont, priv::F_MIN() );
+}
+//------------------------------------------------------------------
+/// Returns index of point in container \c cont that is the farthest to \c pt
+template<typename FPT, typename T>
+size_t
+findFarthestPoint( const Point2d_<FPT>& pt, const T& cont )
+{
+	return priv::findPoint( pt, cont, priv::F_MAX() );
+}
+//------------------------------------------------------------------
+/// Returns indexes of points in container \c cont that are nearest/farthest
 /**
-tests: [BB-cont]
-\ingroup varff
+- return pair: first is nearest, second is farthest
 */
-template<typename T>
-FRect_<HOMOG2D_INUMTYPE>
-getBB( const T& t )
+template<typename FPT, typename T>
+auto
+findNearestFarthestPoint( const Point2d_<FPT>& pt, const T& cont )
 {
-	HOMOG2D_START;
+	if( cont.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "container holds " << cont.size() \
+			<< " points, minimum is 2" );
 
-	if constexpr( !trait::IsContainer<T>::value ) // if not a container,
-		return t.getBB();                         // then call the member function
-	else
+	auto maxDist = priv::sqDist( pt, cont[0] );
+	auto minDist = maxDist;
+	size_t idxMin = 0;
+	size_t idxMax = 0;
+	size_t startIdx = 1;
+	if( pt == cont[0] )
 	{
-		if( t.empty() )
-			HOMOG2D_THROW_ERROR_1( "unable, can't compute BB of empty container" );
-
-		if constexpr( trait::IsPoint<typename T::value_type>::value )
-		{
-			if( t.size() < 2 )
-				HOMOG2D_THROW_ERROR_1( "unable, need at least two points" );
-			return FRect_<typename T::value_type::FType>( priv::getBB_Points( t ) );
-		}
-		else
+		idxMin++;
+		idxMax++;
+		startIdx++;
+		maxDist = priv::sqDist( pt, cont[1] );
+		minDist = maxDist;
+	}
+	for( size_t i=startIdx; i<cont.size(); i++ )
+	{
+		if( pt != cont[i] )
 		{
-			if constexpr( trait::HasBB<typename T::value_type>::value )
+			auto currentDist = priv::sqDist( pt, cont[i] );
+			if( currentDist > maxDist )
 			{
-				using FPT = typename T::value_type::FType;
-				std::vector<FRect_<FPT>> v_bb( t.size() );
-
-				auto it = v_bb.begin();
-				for( const auto& elem: t ) // compute bounding box of each element
-					*it++ = elem.getBB();
-
-				return priv::getBB_FRect( v_bb ); // compute BB of all the BB
+				idxMax  = i;
+				maxDist = currentDist;
 			}
-			else
+			if( currentDist < minDist )
 			{
-				if constexpr( trait::IsSegment<typename T::value_type>::value )
-				{
-					if( t.empty()  )
-						HOMOG2D_THROW_ERROR_1( "unable, need at least one segment" );
-					return priv::getBB_Segments( t );
-				}
-				else
-				{
-#ifdef HOMOG2D_ENABLE_VRTP
-					if constexpr( !trait::IsVariant<typename T::value_type>::value )
-					{
-						HOMOG2D_THROW_ERROR_1( "Unable, cannot compute BoundingBox of a container holding Line2d objects" );
-					}
-					else
-						return priv::getBB_CommonType( t );
-#else
-					HOMOG2D_THROW_ERROR_1( "Unable, cannot compute BoundingBox of a container holding Line2d objects" );
-#endif
-				}
+				idxMin  = i;
+				minDist = currentDist;
 			}
 		}
 	}
+	return std::make_pair(idxMin, idxMax);
 }
 
-#ifdef HOMOG2D_ENABLE_VRTP
-
-/// Apply homography to primitive
+//------------------------------------------------------------------
+/// Returns index of point that is the nearest to \c pt, using a prebuilt index (see PointIndex)
 /**
-\warning The floating-point type of the returned object (variant) will be the one of the homography \c h,
-\b NOT the one of the input element.
-\ingroup varff
+Same semantics as the linear search overload: points equal to \c pt are ignored.
 */
-template<typename T, typename FPT>
-CommonType_<FPT>
-transform( const Homogr_<FPT>& h, const T& elem )
+template<typename FPT>
+size_t
+findNearestPoint( const Point2d_<FPT>& pt, const PointIndex& index )
 {
-	if constexpr( trait::IsVariant<T>::value )
-		return std::visit( fct::TransformFunct<FPT>(h), elem );
-	else
-		return h * elem;
+	if( index.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "index holds " << index.size() \
+			<< " points, minimum is 2" );
+	return index.nearest( pt, true );
 }
-#endif
-
-/////////////////////////////////////////////////////////////////////////////
-// SECTION - FREE FUNCTIONS
-/////////////////////////////////////////////////////////////////////////////
-
-/// Returns a pair of points holding min and max coordinates of the two input pair of points
-/**
-Tests: search for [minmax]
-*/
-
-template<typename T1,typename T2,typename T3,typename T4>
-auto
-getMinMax( const PointPair2_<T1,T2>& pp1, const PointPair2_<T3,T4>& pp2 )
+//------------------------------------------------------------------
+/// Returns index of point that is the farthest to \c pt, using a prebuilt index (see PointIndex)
+template<typename FPT>
+size_t
+findFarthestPoint( const Point2d_<FPT>& pt, const PointIndex& index )
 {
-	HOMOG2D_START;
-
-	std::array<Point2d_<HOMOG2D_INUMTYPE>,4> arr;
-	arr[0] = pp1.first;
-	arr[1] = pp2.first;
-	arr[2] = pp1.second;
-	arr[3] = pp2.second;
-
-	return priv::getBB_Points( arr );
+	if( index.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "index holds " << index.size() \
+			<< " points, minimum is 2" );
+	return index.farthest( pt, true );
 }
-
 //------------------------------------------------------------------
-/// Returns bounding box of two pairs of points
+/// Returns indexes of points that are nearest/farthest to \c pt, using a prebuilt index (see PointIndex)
 /**
-\warning May throw in case of identical coordinates
-(for example with [0,0]-[1,0] and [10,0]-[20,0]
+- return pair: first is nearest, second is farthest
 */
-template<typename T1,typename T2,typename T3,typename T4>
-auto
-getBB( const PointPair2_<T1,T2>& pp1, const PointPair2_<T3,T4>& pp2 )
+template<typename FPT>
+std::pair<size_t,size_t>
+findNearestFarthestPoint( const Point2d_<FPT>& pt, const PointIndex& index )
 {
-	HOMOG2D_START;
-	return FRect_<T1>( getMinMax( pp1, pp2 ) );
+	if( index.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "index holds " << index.size() \
+			<< " points, minimum is 2" );
+	return std::make_pair( index.nearest( pt, true ), index.farthest( pt, true ) );
 }
 
 //------------------------------------------------------------------
-/// Overload 1/3. This one is called if NONE of the args are a Line2d
-template<
-	typename T1,
-	typename T2,
-	typename std::enable_if<(
-		   !std::is_same_v<T1,Line2d_<typename T1::FType>>
-		&& !std::is_same_v<T2,Line2d_<typename T2::FType>>
-		),T1
-	>::type* = nullptr
->
-auto
-getBB( const T1& elem1, const T2& elem2 )
-{
-	HOMOG2D_START;
+/// A polygon prepared for fast "point inside" queries on large sets of points
+/**
+Built once from a CPolyline_, it stores the edges sorted in horizontal bands (slabs), so that
+a query only needs to consider the edges overlapping the band holding the point.
 
-	bool isPoly_1 = false;
-	if( elem1.type() == Type::OPolyline || elem1.type() == Type::CPolyline )
-		isPoly_1 = true;
+Same semantics as the Point2d_::isInside() member function:
+- returns false if the polyline is not a polygon (see PolylineBase::isSimple() )
+- returns false if the point lies on an edge (distance less than thr::nullDistance() )
+
+\warning The object holds a copy of the edges: it is not updated if the source polyline is modified.
+
+\sa getPtsInside()
+*/
+class PreparedPolygon
+{
+private:
+	struct Edge
+	{
+		HOMOG2D_INUMTYPE _x1, _y1, _x2, _y2;
+	};
 
-	bool isPoly_2 = false;
-	if( elem2.type() == Type::OPolyline || elem2.type() == Type::CPolyline )
-		isPoly_1 = true;
+	std::vector<Edge>   _edges;      ///< edges, grouped by band (an edge can appear in several bands)
+	std::vector<size_t> _bandStart;  ///< index of first edge of each band in \c _edges (size: nb of bands + 1)
+	HOMOG2D_INUMTYPE    _xmin = 0., _xmax = 0., _ymin = 0., _ymax = 0.;
+	HOMOG2D_INUMTYPE    _bandHeight = 1.;
+	size_t              _nbEdges = 0;
 
-	auto siz_1 = elem1.size();
-	auto siz_2 = elem2.size();
+public:
+	PreparedPolygon() = default;
 
-	if( isPoly_1 && isPoly_2 )
-		if( siz_1==0 && siz_2==0 )
-			HOMOG2D_THROW_ERROR_1( "unable to compute bounding box of two empty polyline objects" );
+	template<typename FPT>
+	explicit PreparedPolygon( const CPolyline_<FPT>& poly )
+	{
+		set( poly );
+	}
 
-	FRect_<typename T1::FType> out;
-// we need to do that in two steps: first, copy return value into `out`, then return
-// because the underlying floating point might not be the same for the two arguments.
-	if( isPoly_2 && siz_1==0 )
+/// Number of edges of the source polygon (0 if it was not a polygon)
+	size_t nbEdges() const { return _nbEdges; }
+
+/// Number of horizontal bands
+	size_t nbBands() const { return _bandStart.empty() ? 0 : _bandStart.size() - 1; }
+
+/// Builds the edge table from the polygon \c poly
+	template<typename FPT>
+	void set( const CPolyline_<FPT>& poly )
 	{
-		auto pp = ppair::getPointPair( elem2 );
-		if( shareCommonCoord(pp) )
+		_edges.clear();
+		_bandStart.clear();
+		_nbEdges = 0;
+		if( !poly.isSimple() )
+			return;
+
+		const auto& pts = poly.getPts();
+		const auto n = pts.size();
+		std::vector<Edge> edges( n );
+		_xmin = _xmax = pts[0].getX();
+		_ymin = _ymax = pts[0].getY();
+		for( size_t i=0; i<n; i++ )
 		{
-			HOMOG2D_THROW_ERROR_1( "Unable to build common Bounding Box of empty polyline and elem2:" << elem2 );
+			const auto& p1 = pts[i];
+			const auto& p2 = pts[ i+1==n ? 0 : i+1 ];
+			edges[i] = Edge{ p1.getX(), p1.getY(), p2.getX(), p2.getY() };
+			_xmin = std::min( _xmin, edges[i]._x1 );
+			_xmax = std::max( _xmax, edges[i]._x1 );
+			_ymin = std::min( _ymin, edges[i]._y1 );
+			_ymax = std::max( _ymax, edges[i]._y1 );
+		}
+		_nbEdges = n;
+
+		auto nbBands = std::min( n, size_t(4096) );
+		_bandHeight = ( _ymax - _ymin ) / static_cast<HOMOG2D_INUMTYPE>( nbBands );
+		const auto eps = thr::nullDistance();
+
+	// counting pass, then filling pass (edges are extended by eps, for the "on edge" check)
+		_bandStart.assign( nbBands+1, 0 );
+		for( const auto& e: edges )
+		{
+			auto b = p_bandRange( e, eps );
+			for( auto i=b.first; i<=b.second; i++ )
+				_bandStart[i+1]++;
+		}
+		std::partial_sum( _bandStart.begin(), _bandStart.end(), _bandStart.begin() );
+		_edges.resize( _bandStart.back() );
+		auto pos = _bandStart;
+		for( const auto& e: edges )
+		{
+			auto b = p_bandRange( e, eps );
+			for( auto i=b.first; i<=b.second; i++ )
+				_edges[ pos[i]++ ] = e;
 		}
-		else
-			return FRect_<typename T1::FType>( pp );
 	}
-	if( isPoly_1 && siz_2==0 )
+
+/// Returns true if point is inside the polygon
+	template<typename FPT>
+	bool contains( const Point2d_<FPT>& pt ) const
 	{
-		auto pp = ppair::getPointPair( elem1 );
-		if( shareCommonCoord(pp) )
+		return p_contains( pt.getX(), pt.getY() );
+	}
+
+/// Returns a vector of bool, holding for each point of the container \c cont if it is inside the polygon
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	std::vector<bool> contains( const T& cont ) const
+	{
+		std::vector<bool> out( cont.size() );
+		size_t i = 0;
+		for( const auto& pt: cont )
+			out[i++] = p_contains( pt.getX(), pt.getY() );
+		return out;
+	}
+
+/// Returns a vector of bool, for points given by their coordinates (columnar storage, see base::PolylineSoA)
+	template<typename FPT>
+	std::vector<bool> contains( priv::ArrView<FPT> xs, priv::ArrView<FPT> ys ) const
+	{
+#ifndef HOMOG2D_NOCHECKS
+		if( xs.size() != ys.size() )
+			HOMOG2D_THROW_ERROR_1( "sizes differ: xs=" << xs.size() << " ys=" << ys.size() );
+#endif
+		std::vector<bool> out( xs.size() );
+		for( size_t i=0; i<xs.size(); i++ )
+			out[i] = p_contains( xs[i], ys[i] );
+		return out;
+	}
+
+private:
+/// Returns first and last bands that edge \c e overlaps
+	std::pair<size_t,size_t>
+	p_bandRange( const Edge& e, HOMOG2D_INUMTYPE eps ) const
+	{
+		return std::make_pair(
+			p_getBand( std::min( e._y1, e._y2 ) - eps ),
+			p_getBand( std::max( e._y1, e._y2 ) + eps )
+		);
+	}
+
+	size_t p_getBand( HOMOG2D_INUMTYPE y ) const
+	{
+		auto nbb = nbBands();
+		if( y <= _ymin || _bandHeight <= 0. )
+			return 0;
+		auto b = static_cast<size_t>( ( y - _ymin ) / _bandHeight );
+		return std::min( b, nbb - 1 );
+	}
+
+	bool p_contains( HOMOG2D_INUMTYPE px, HOMOG2D_INUMTYPE py ) const
+	{
+		if( _nbEdges == 0 )
+			return false;
+		if( px <= _xmin || px >= _xmax || py <= _ymin || py >= _ymax )
+			return false;
+
+		const auto eps = thr::nullDistance();
+		auto band = p_getBand( py );
+		bool inside = false;
+		for( auto i=_bandStart[band]; i<_bandStart[band+1]; i++ )
 		{
-			HOMOG2D_THROW_ERROR_1( "Unable to build common Bounding Box of empty polyline and elem1:" << elem1 );
+			const auto& e = _edges[i];
+			switch( priv::pipTestEdge( px, py, e._x1, e._y1, e._x2, e._y2, eps ) )
+			{
+				case priv::PipEdge::OnEdge:  return false;
+				case priv::PipEdge::Crosses: inside = !inside; break;
+				default: break;
+			}
 		}
-		else
-			return FRect_<typename T1::FType>( pp );
+		return inside;
 	}
+};
 
-	try
+/// Returns set of points that are inside primitive \c prim
+/**
+Output container will be of same type as input container (vector, list or array
+
+\todo 20250123: maybe replace the bunch of static_asserts with something around trait::HasArea ?
+*/
+template<typename CONT, typename PRIM>
+CONT
+getPtsInside(
+	const CONT& input_set,
+	const PRIM& prim        ///< geometrical primitive (FRect, Circle, ...?)
+)
+{
+	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_OPol>,    "Cannot find points inside a Open Polyline" );
+	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Line>,    "Cannot find points inside a Line" );
+	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Point>,   "Cannot find points inside a Point" );
+	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Segment>, "Cannot find points inside a Segment" );
+	static_assert( !trait::IsArray<CONT>::value, "Cannot use std::array as container" );
+
+	CONT out;
+	out.reserve( input_set.size() );
+
+	if constexpr( trait::PolIsClosed<PRIM>::value )  // polygon: prepare it once
 	{
-		out = getBB(
-			ppair::getPointPair( elem1 ),
-			ppair::getPointPair( elem2 )
-		);
+		PreparedPolygon ppol( prim );
+		for( const auto& pt: input_set )
+			if( ppol.contains( pt ) )
+				out.push_back( pt );
 	}
-	catch( const std::exception& err )
+	else
 	{
-		HOMOG2D_THROW_ERROR_1( "unable to compute bounding box:\n -arg1="
-			<< elem1 << "\n -arg2=" << elem2 << "\n -err=" << err.what() );
+		for( auto pt: input_set )
+			if( pt.isInside( prim ) )
+				out.push_back( pt );
 	}
 	return out;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - GENERIC DRAWING FREE FUNCTIONS (BACK-END INDEPENDENT)
+/////////////////////////////////////////////////////////////////////////////
+
 //------------------------------------------------------------------
-/// Overload 3/3. Called if one of the args is a Line2d (=> no build!)
+/// Free function, draws any of the primitives by calling the relevant member function
+/**
+\todo 20240504: see note on the IsDrawable trait class
+*/
 template<
-	typename T1,
-	typename T2,
+	typename U,
+	typename Prim,
 	typename std::enable_if<
-		(std::is_same<T1,Line2d_<typename T1::FType>>::value || std::is_same<T2,Line2d_<typename T2::FType>>::value)
-		,T1
+		trait::IsDrawable<Prim>::value,
+		Prim
 	>::type* = nullptr
 >
-auto
-getBB( const T1&, const T2& )
+void
+draw( img::Image<U>& img, const Prim& prim, const img::DrawParams& dp=img::DrawParams() )
 {
-	HOMOG2D_START;
-	static_assert( detail::AlwaysFalse<T1>::value, "fallback: undefined function" );
-	return FRect_<T1>(); // to avoid a compile warning
+	prim.draw( img, dp );
 }
 
-//------------------------------------------------------------------
-// forward declaration
-namespace priv {
-template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
-class ClosestPoints;
+/// Free function, draws text \c str at position \c pt
+template<typename U,typename FPT>
+void
+drawText( img::Image<U>& im, std::string str, Point2d_<FPT> pt, img::DrawParams dp=img::DrawParams() )
+{
+	im.drawText( str, pt, dp );
 }
 
-// forward declaration
-template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
-priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
-getClosestPoints(
-	const base::PolylineBase<PLT1,FPT1>& poly1,
-	const base::PolylineBase<PLT2,FPT2>& poly2
-);
-
 namespace priv {
 
-/// Used in getClosestPoints()
-template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
-class ClosestPoints
+/// Draw indexes for points
+template<typename IMG,typename FPT>
+void
+impl_drawIndexes( img::Image<IMG>& img, size_t c, const img::DrawParams& dp, const Point2d_<FPT>& pt )
 {
-	friend priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
-	h2d::getClosestPoints<>( const base::PolylineBase<PLT1,FPT1>&,const base::PolylineBase<PLT2,FPT2>& );
-
-private:
-	size_t _pt1_min = 0;
-	size_t _pt2_min = 0;
-	HOMOG2D_INUMTYPE _minDist;
-	Point2d_<HOMOG2D_INUMTYPE> _pt1;
-	Point2d_<HOMOG2D_INUMTYPE> _pt2;
-	const base::PolylineBase<PLT1,FPT1>& _poly1;
-	const base::PolylineBase<PLT2,FPT2>& _poly2;
+	if( dp._dpValues._showIndex )
+		drawText( img, std::to_string(c), pt, dp );
+}
 
-	ClosestPoints( const base::PolylineBase<PLT1,FPT1>& poly1, const base::PolylineBase<PLT2,FPT2>& poly2 )
-		: _poly1(poly1), _poly2(poly2)
-	{
-		_minDist = dist( poly1.getPoint(0), poly2.getPoint(0) );
-	}
-	void store( HOMOG2D_INUMTYPE d, size_t idx1, size_t idx2 )
-	{
-		_minDist = d;
-		_pt1_min = idx1;
-		_pt2_min = idx2;
-	}
+/// Draw indexes for segment
+template<typename IMG,typename FPT>
+void
+impl_drawIndexes( img::Image<IMG>& img, size_t c, const img::DrawParams& dp, const Segment_<FPT>& seg )
+{
+	if( dp._dpValues._showIndex )
+		drawText( img, std::to_string(c), seg.getCenter(), dp );
+}
 
-public:
-	PointPair_<HOMOG2D_INUMTYPE>
-	getPoints() const
-	{
-		return std::make_pair(
-			_poly1.getPoint(_pt1_min),
-			_poly2.getPoint(_pt2_min)
-		);
-	}
-	HOMOG2D_INUMTYPE getMinDist() const
-	{
-		return _minDist;
-	}
-	std::pair<size_t,size_t>
-	getIndexes() const
-	{
-		return std::make_pair( _pt1_min, _pt2_min );
-	}
-	void print() const
-	{
-		std::cout << "ClosestPoints:\n _pt1_min=" << _pt1_min << " _pt2_min=" << _pt2_min
-			<< "\n_minDist=" << _minDist
-			<< "\npt1=" << _pt1 << " pt2=" << _pt2
-		<< std::endl;
-	}
-};
+/// Default signature, will be instanciated if no other fits (and does nothing)
+template<typename IMG,typename DUMMY>
+void
+impl_drawIndexes( img::Image<IMG>&, size_t, const img::DrawParams&, const DUMMY& )
+{}
 
 } // namespace priv
 
-//------------------------------------------------------------------
-/// Computes the closest points between two polylines (types can be different)
-template<typename PLT1,typename FPT1,typename PLT2,typename FPT2>
-priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2>
-getClosestPoints(
-	const base::PolylineBase<PLT1,FPT1>& poly1,
-	const base::PolylineBase<PLT2,FPT2>& poly2
-)
+/// Free function, draws a set of primitives
+/**
+- Type \c T can be \c std::array<type> or \c std::vector<type>, with \c type being anything drawable.
+- The types inside the container can be either plain \c h2d types (\c FRect, \c Segment, ...) of variant types,
+using the \c CommonType class (requires HOMOG2D_ENABLE_VRTP symbol).
+
+\ingroup varff
+*/
+template<
+	typename U,
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+void
+draw( img::Image<U>& img, const T& cont, const img::DrawParams& dp=img::DrawParams() )
 {
-#ifndef HOMOG2D_NOCHECKS
-	if( poly1.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "arg 1 is empty" );
-	if( poly2.size() == 0 )
-		HOMOG2D_THROW_ERROR_1( "arg 2 is empty" );
+#ifdef HOMOG2D_ENABLE_VRTP
+	if constexpr( trait::IsVariant<typename T::value_type>::value )
+	{
+		fct::DrawFunct vde( img, dp ); // functor
+		for( auto& e: cont )
+			std::visit( vde, e );
+	}
+	else
 #endif
-	priv::ClosestPoints<PLT1,FPT1,PLT2,FPT2> out( poly1, poly2 );
-	for( size_t i=0; i<poly1.size(); i++ )
 	{
-		const auto& pt1 = poly1.getPoint(i);
-		for( size_t j=0; j<poly2.size(); j++ )
+		size_t c=0;
+		for( const auto& elem: cont )
 		{
-			const auto& pt2 = poly2.getPoint(j);
-			auto currentDist = dist( pt1, pt2 );
-			if( currentDist < out._minDist )
-				out.store( currentDist, i, j );
+			elem.draw( img, dp );
+			priv::impl_drawIndexes( img, c++, dp, elem );
 		}
 	}
-	return out;
 }
 
-//------------------------------------------------------------------
-/// Returns the points of Segment as a std::pair (free function)
-/// \sa Segment_::getPts()
-template<typename FPT>
-auto
-getPts( const Segment_<FPT>& seg )
+/// This version holds a \c std::function as 3th parameter. It can be used to pass a function
+/// that will return a different img::DrawParams for a given index of the container.
+/**
+At present, cannot be used with container holding variants...
+*/
+template<
+	typename U,
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+void
+draw( img::Image<U>& img, const T& cont, std::function<img::DrawParams(int)>& func )
 {
-	return seg.getPts();
+	size_t c=0;
+	for( const auto& elem: cont )
+	{
+		auto dp = func(c);
+		elem.draw( img, dp );
+		priv::impl_drawIndexes( img, c++, dp, elem );
+	}
 }
 
-/// Returns Segment supporting line (free function)
-/// \sa Segment_::getLine()
-template<typename FPT>
-Line2d_<FPT>
-getLine( const Segment_<FPT>& seg )
+//------------------------------------------------------------------
+/// Free function, draws a pair of objects
+/**
+Type \c T1 and \c T2 can be anything drawable
+*/
+template<typename T1,typename T2,typename U>
+void draw(
+	img::Image<U>&          img,
+	const std::pair<T1,T2>& pa,
+	const img::DrawParams&  dp=img::DrawParams() )
 {
-	return seg.getLine();
+	pa.first.draw(  img, dp );
+	pa.second.draw( img, dp );
 }
 
-/// Returns Extended Segment (free function)
-/// \sa Segment_::geExtended()
-template<typename FPT>
-Segment_<FPT>
-getExtended( const Segment_<FPT>& seg )
-{
-	return seg.getExtended();
-}
+namespace detail {
 
-/// Returns a pair of segments, corresponding to the input segment split by middle point (free function)
-/// \sa Segment_::split()
-template<typename SV,typename FPT>
-std::pair<base::SegVec<SV,FPT>,base::SegVec<SV,FPT>>
-split( const base::SegVec<SV,FPT>& seg )
+/// Private helper function, used by LPBase<IsPoint>::draw(). Draw point on image.
+template<typename T>
+void
+drawPt(
+	img::Image<T>&               img,
+	img::PtStyle                 ps,
+	std::vector<Point2d_<float>> vpt,
+	const img::DrawParams&       dp,
+	bool                         drawDiag=false
+)
 {
-	return seg.split();
-}
+	auto delta  = dp._dpValues._ptDelta;
+	auto delta2 = std::round( 0.7 * delta);
+	switch( ps )
+	{
+		case img::PtStyle::Times:
+		case img::PtStyle::Squ:
+			vpt[0].translate( -delta2, +delta2 );
+			vpt[1].translate( +delta2, -delta2 );
+			vpt[2].translate( +delta2, +delta2 );
+			vpt[3].translate( -delta2, -delta2 );
+		break;
 
-/// Returns a pair of segments, corresponding to the input segment split by point at distance \c dist (free function)
-/// \note: can only be used on oriented segments
-/// \sa Segment_::split( T )
-template<typename FPT, typename T>
-std::pair<OSegment_<FPT>,OSegment_<FPT>>
-split( const OSegment_<FPT>& seg, T dist )
-{
-	HOMOG2D_CHECK_IS_NUMBER(T);
-	return seg.split( dist );
+		case img::PtStyle::Plus:
+		case img::PtStyle::Diam:
+			vpt[0].translate( -delta, 0.      );
+			vpt[1].translate( +delta, 0.      );
+			vpt[2].translate( 0.,      -delta );
+			vpt[3].translate( 0.,      +delta );
+		break;
+		default: assert(0);
+	}
+	auto dp2(dp);          // we need to do this, because this is called by the
+	dp2.showPoints(false); //  segment drawing function. If not, infinite recursion
+	if( !drawDiag )
+	{
+		if( ps == img::PtStyle::Squ )
+		{
+			std::vector<Segment_<float>> vseg{
+				{vpt[0], vpt[1]},
+				{vpt[2], vpt[1]},
+				{vpt[2], vpt[3]},
+				{vpt[0], vpt[3]}
+			};
+			for( const auto& s:vseg )
+				s.draw( img, dp2 );
+		}
+		else
+		{
+			Segment_<float> s1( vpt[0], vpt[1] );
+			Segment_<float> s2( vpt[2], vpt[3] );
+			s1.draw( img, dp2 );
+			s2.draw( img, dp2 );
+		}
+	}
+	else // draw 4 diagonal lines
+	{
+		Segment_<float>( vpt[0], vpt[2] ).draw( img, dp2 );
+		Segment_<float>( vpt[2], vpt[1] ).draw( img, dp2 );
+		Segment_<float>( vpt[1], vpt[3] ).draw( img, dp2 );
+		Segment_<float>( vpt[0], vpt[3] ).draw( img, dp2 );
+	}
 }
 
+} // namespace detail
 
-/// Returns the 4 orthogonal segments to the segment
-/// \sa Segment_::getOrthogSegs()
-template<typename FPT>
-std::array<Segment_<FPT>,4>
-getOrthogSegs( const Segment_<FPT>& seg )
-{
-	return seg.getOrthogSegs();
-}
+//------------------------------------------------------------------
+namespace priv {
+/// Holds convex hull code
+namespace chull {
 
-/// Returns the 4 orthogonal points to the segment
-/// \sa Segment_::getOrthogPts()
-template<typename FPT>
-std::array<Point2d_<FPT>,4>
-getOrthogPts( const Segment_<FPT>& seg )
+//------------------------------------------------------------------
+/// Cross product of vectors (a,b) and (a,c), its sign gives the orientation of the triplet (a,b,c)
+/**
+Positive: counterclockwise, negative: clockwise, null: collinear
+*/
+inline
+HOMOG2D_INUMTYPE
+cross(
+	const std::vector<HOMOG2D_INUMTYPE>& vx,
+	const std::vector<HOMOG2D_INUMTYPE>& vy,
+	size_t ia,
+	size_t ib,
+	size_t ic
+)
 {
-	return seg.getOrthogPts();
+	return (vx[ib] - vx[ia]) * (vy[ic] - vy[ia]) - (vy[ib] - vy[ia]) * (vx[ic] - vx[ia]);
 }
 
 //------------------------------------------------------------------
-/// Free function, returns segment between two circle centers (or ellipse)
-template<typename T1,typename T2>
-Segment_<typename T1::FType>
-getSegment( const T1& c1, const T2& c2 )
-{
-	return Segment_<typename T1::FType>( c1.getCenter(), c2.getCenter() );
-}
+/// Andrew's monotone chain algorithm, on the points whose indexes are given in \c idx
+/**
+Returns the indexes of the hull points, in counterclockwise order, starting from the lowest (x,y) point.
+Collinear points on the hull and duplicate points are removed (for duplicates, the lowest index is kept).
 
-/// Free function, returns line between two circle centers
-template<typename FPT1,typename FPT2,typename FPT3>
-Line2d_<FPT1>
-getLine( const Circle_<FPT2>& c1, const Circle_<FPT3>& c2 )
+\c idx gets sorted on the cartesian coordinates (and on index as third key, so that the result is deterministic).
+Complexity: O(n.log(n)), only the indexes are moved around, not the points.
+*/
+inline
+std::vector<size_t>
+monotoneChain(
+	const std::vector<HOMOG2D_INUMTYPE>& vx,
+	const std::vector<HOMOG2D_INUMTYPE>& vy,
+	std::vector<size_t>& idx
+)
 {
-	return Line2d_<FPT1>( c1.center(), c2.center() );
-}
+	std::sort(
+		idx.begin(),
+		idx.end(),
+		[&vx,&vy]           // lambda
+		( size_t i1, size_t i2 )
+		{
+			if( vx[i1] != vx[i2] )
+				return vx[i1] < vx[i2];
+			if( vy[i1] != vy[i2] )
+				return vy[i1] < vy[i2];
+			return i1 < i2;
+		}
+	);
+	idx.erase(
+		std::unique(
+			idx.begin(),
+			idx.end(),
+			[&vx,&vy]           // lambda
+			( size_t i1, size_t i2 )
+			{
+				return vx[i1] == vx[i2] && vy[i1] == vy[i2];
+			}
+		),
+		idx.end()
+	);
 
-/// Free function, returns middle point of segment
-/// \sa Segment_::getCenter()
-template<typename FPT>
-Point2d_<FPT>
-getCenter( const Segment_<FPT>& seg )
-{
-	return seg.getCenter();
+	const auto n = idx.size();
+	if( n < 3 )
+		return idx;
+
+	std::vector<size_t> hull( 2*n );
+	size_t k = 0;
+	for( size_t i=0; i<n; i++ )                    // lower hull
+	{
+		while( k >= 2 && cross( vx, vy, hull[k-2], hull[k-1], idx[i] ) <= 0 )
+			k--;
+		hull[k++] = idx[i];
+	}
+	for( size_t i=n-1, t=k+1; i>0; i-- )           // upper hull
+	{
+		while( k >= t && cross( vx, vy, hull[k-2], hull[k-1], idx[i-1] ) <= 0 )
+			k--;
+		hull[k++] = idx[i-1];
+	}
+	hull.resize( k-1 );  // last one is the first point
+	return hull;
 }
 
-/// Free function, returns bisector line of segment
-/// \sa Segment_::getBisector()
-template<typename FPT>
-Line2d_<FPT>
-getBisector( const Segment_<FPT>& seg )
+//------------------------------------------------------------------
+/// Parallel version of monotoneChain(): divide and conquer
+/**
+The set is split in \c nbThreads chunks, whose hulls are computed concurrently.
+The final hull is the hull of the union of these partial hulls, as any point of the full hull
+is necessarily a point of the hull of the chunk it belongs to.
+*/
+inline
+std::vector<size_t>
+monotoneChainParallel(
+	const std::vector<HOMOG2D_INUMTYPE>& vx,
+	const std::vector<HOMOG2D_INUMTYPE>& vy,
+	size_t nbThreads
+)
 {
-	return seg.getBisector();
+	const auto n = vx.size();
+	const auto chunk = ( n + nbThreads - 1 ) / nbThreads;
+
+	std::vector<std::future<std::vector<size_t>>> vfut;
+	for( size_t beg=0; beg<n; beg+=chunk )
+	{
+		auto end = std::min( n, beg+chunk );
+		vfut.push_back(
+			std::async(
+				std::launch::async,
+				[&vx,&vy,beg,end]           // lambda
+				()
+				{
+					std::vector<size_t> idx( end-beg );
+					std::iota( idx.begin(), idx.end(), beg );
+					return monotoneChain( vx, vy, idx );
+				}
+			)
+		);
+	}
+
+	std::vector<size_t> merged;
+	for( auto& fut: vfut )
+	{
+		auto part = fut.get();
+		merged.insert( merged.end(), part.begin(), part.end() );
+	}
+	return monotoneChain( vx, vy, merged );
 }
 
-/// Free function, returns a pair of parallel segments at a distance \c dist
-/// \sa Segment_::getBisector()
-template<typename FPT,typename T>
-std::pair<Segment_<FPT>,Segment_<FPT>>
-getParallelSegs( const Segment_<FPT>& seg, T dist )
+//------------------------------------------------------------------
+} // namespace chull
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Parameters for convexHull() and convexHullIdx()
+struct ConvexHullParams
 {
-	return seg.getParallelSegs(dist);
-}
+/// Minimal number of points to switch to the parallel algorithm (0: never)
+	size_t _parallelMinSize = 0;
+/// Number of threads used by the parallel algorithm (0: \c std::thread::hardware_concurrency() )
+	size_t _nbThreads = 0;
+};
 
-/// Free function, returns middle points of set of segments/circles
+//------------------------------------------------------------------
+/// Returns the indexes of the points of the convex hull of a set of points (free function)
 /**
-\sa Segment_::getCenter()
-\sa Circle_::getCenter()
-- input: set of segments
-- output: set of points (same container)
+- input: \c std::vector, \c std::array or \c std::list of points
+- output: indexes of the hull points in the input container, counterclockwise, starting from the lowest (x,y) point
+- Andrew's monotone chain algorithm: https://en.wikibooks.org/wiki/Algorithm_Implementation/Geometry/Convex_hull/Monotone_chain
+
+Collinear points lying on the hull are not part of it.
+If the set holds more than \c params._parallelMinSize points (and that value is not 0),
+the computation is split over several threads.
 */
 template<
 	typename T,
@@ -10743,20 +17038,58 @@ template<
 		T
 	>::type* = nullptr
 >
-auto
-getCenters( const T& vsegs )
+std::vector<size_t>
+convexHullIdx( const T& cont, const ConvexHullParams& params=ConvexHullParams() )
 {
-	std::vector<Point2d_<typename T::value_type::FType>> vout( vsegs.size() );
+	const auto n = cont.size();
+	std::vector<HOMOG2D_INUMTYPE> vx( n ), vy( n );
+	size_t i = 0;
+	for( const auto& pt: cont )
+	{
+		vx[i]   = pt.getX();
+		vy[i++] = pt.getY();
+	}
 
-	auto it = std::begin( vout );
-	for( const auto& seg: vsegs )
-		*it++ = getCenter( seg );
-	return vout;
+	size_t nbThreads = params._nbThreads;
+	if( nbThreads == 0 )
+		nbThreads = std::thread::hardware_concurrency();
+	if( params._parallelMinSize != 0 && n >= params._parallelMinSize && nbThreads > 1 )
+		return priv::chull::monotoneChainParallel( vx, vy, nbThreads );
+
+	std::vector<size_t> idx( n );
+	std::iota( idx.begin(), idx.end(), 0 );
+	return priv::chull::monotoneChain( vx, vy, idx );
 }
 
-/// Free function, returns a set of lines from a set of segments
+/// Returns the indexes of the points of the convex hull of a Polyline (free function)
+template<typename CT,typename FPT>
+std::vector<size_t>
+convexHullIdx( const base::PolylineBase<CT,FPT>& input, const ConvexHullParams& params=ConvexHullParams() )
+{
+	return convexHullIdx( input.getPts(), params );
+}
+
+//------------------------------------------------------------------
+/// Compute Convex Hull of a Polyline (free function)
 /**
-\sa Segment_::getLine()
+- type \c T: can be either OPolyline, CPolyline, or std::vector<Point2d>
+- see convexHullIdx()
+*/
+template<typename CT,typename FPT>
+CPolyline_<FPT>
+convexHull( const base::PolylineBase<CT,FPT>& input, const ConvexHullParams& params=ConvexHullParams() )
+{
+	return convexHull( input.getPts(), params );
+}
+
+namespace base {
+//------------------------------------------------------------------
+/// Computes and returns the convex hull of a set of points (free function)
+/**
+- input: \c std::vector, \c std::array or \c std::list of points
+- see convexHullIdx()
+
+If the set holds less than 3 points, it is returned as is.
 */
 template<
 	typename T,
@@ -10765,870 +17098,2054 @@ template<
 		T
 	>::type* = nullptr
 >
-auto
-getLines( const T& vsegs )
+CPolyline_<typename T::value_type::FType>
+convexHull( const T& input, const ConvexHullParams& params=ConvexHullParams() )
 {
-	std::vector<Line2d_<typename T::value_type::FType>> vout( vsegs.size() );
+	using FPT = typename T::value_type::FType;
+	if( input.size() < 3 )
+		return CPolyline_<FPT>( std::vector<Point2d_<FPT>>( input.begin(), input.end() ) );
 
-	auto it = std::begin( vout );
-	for( const auto& seg: vsegs )
-		*it++ = seg.getLine();
-	return vout;
+	const auto vidx = convexHullIdx( input, params );
+
+// fetch the points with a single traversal, so that this also works for std::list
+	const auto npos = std::numeric_limits<size_t>::max();
+	std::vector<size_t> rank( input.size(), npos );
+	for( size_t k=0; k<vidx.size(); k++ )
+		rank[ vidx[k] ] = k;
+
+	std::vector<Point2d_<FPT>> vout( vidx.size() );
+	size_t i = 0;
+	for( const auto& pt: input )
+	{
+		if( rank[i] != npos )
+			vout[ rank[i] ] = pt;
+		i++;
+	}
+	return CPolyline_<FPT>( vout );
 }
 
-/// Free function, returns segments of the rectangle
-/// \sa FRect_::getSegs()
-template<typename FPT>
-std::array<Segment_<FPT>,4>
-getSegs( const FRect_<FPT>& seg )
+} // namespace base
+
+/// Return convex hull (member function implementation)
+template<typename CT,typename FPT>
+CPolyline_<FPT>
+base::PolylineBase<CT,FPT>::convexHull() const
 {
-	return seg.getSegs();
+	return h2d::convexHull( *this );
 }
 
-/// Free function, returns the pair of segments tangential to the two circles
-/** Sources:
-  - https://math.stackexchange.com/questions/719758/
-  - https://math.stackexchange.com/a/211854/133647
-  - https://en.wikipedia.org/wiki/Tangent_lines_to_circles
-  - https://gieseanw.wordpress.com/2012/09/12/finding-external-tangent-points-for-two-circles/
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - CLASS ConvexHullBuilder_ (ONLINE CONVEX HULL)
+/////////////////////////////////////////////////////////////////////////////
+
+namespace priv {
+namespace chull {
+
+//------------------------------------------------------------------
+/// Upper part of a convex hull, stored as a map holding y for each x, used by ConvexHullBuilder_
+/**
+The lower part of the hull is handled with the same class, by negating the y coordinates.
 */
-template<typename FPT1,typename FPT2>
-std::pair<Segment_<FPT1>,Segment_<FPT1>>
-getTanSegs( const Circle_<FPT1>& c1, const Circle_<FPT2>& c2 )
+class HalfHull
 {
-#ifndef HOMOG2D_NOCHECKS
-	if( c1 == c2 )
-		HOMOG2D_THROW_ERROR_1( "c1 and c2 identical" );
-#endif
+private:
+	using MapT = std::map<HOMOG2D_INUMTYPE,HOMOG2D_INUMTYPE>;
+	MapT _map;
+
+/// Cross product of vectors (a,b) and (a,c)
+	static HOMOG2D_INUMTYPE
+	p_cross(
+		HOMOG2D_INUMTYPE ax, HOMOG2D_INUMTYPE ay,
+		HOMOG2D_INUMTYPE bx, HOMOG2D_INUMTYPE by,
+		HOMOG2D_INUMTYPE cx, HOMOG2D_INUMTYPE cy
+	)
+	{
+		return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+	}
 
-// if same radius, return the two segments parallel to the one joining the centers
-	if( homog2d_abs( c1.radius() - c2.radius() ) < thr::nullDistance() )
+/// Returns the value of the cross product of point (x,y) with the chain segment over \c x.
+/// Positive if point is above, null if on it (or on a vertex).
+/// Requires that \c x is in the range of the chain
+	HOMOG2D_INUMTYPE
+	p_above( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, MapT::const_iterator it ) const
 	{
-		Segment_<HOMOG2D_INUMTYPE> seg_center( c1.center(), c2.center() );
-		return seg_center.getParallelSegs( c1.radius() );
+		if( it->first == x )
+			return y - it->second;
+		auto prev = std::prev( it );
+		return p_cross( prev->first, prev->second, it->first, it->second, x, y );
 	}
 
-// check which one is the smallest
-	Circle_<HOMOG2D_INUMTYPE> cA = c1;
-	Circle_<HOMOG2D_INUMTYPE> cB = c2;
-	if( c1.radius() < c2.radius() )
-		std::swap( cA, cB );
+public:
+	const MapT& get() const { return _map; }
+	size_t size() const     { return _map.size(); }
+	void clear()            { _map.clear(); }
 
-	auto h = dist( cA.center(), cB.center() );
+/// Returns true if point (x,y) is strictly below the chain, and strictly inside its x range
+	bool isBelow( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
+	{
+		if( _map.empty() || x <= _map.begin()->first || x >= _map.rbegin()->first )
+			return false;
+		return p_above( x, y, _map.lower_bound( x ) ) < 0;
+	}
 
-	auto theta = homog2d_asin( ( cA.radius() - cB.radius() ) / h ) ;
-	auto hcost = h * homog2d_cos(theta);
+/// Adds point (x,y), returns false if it is below or on the chain (thus not added)
+/**
+Amortised O(log n): the points removed to keep the chain convex are removed only once.
+*/
+	bool add( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
+	{
+		auto it = _map.lower_bound( x );
+		if( it != _map.end() && it != _map.begin() && p_above( x, y, it ) <= 0 )
+			return false;
+		if( it != _map.end() && it->first == x )
+		{
+			if( y <= it->second )
+				return false;
+			it->second = y;
+		}
+		else
+			it = _map.emplace_hint( it, x, y );
 
-// get rotated lines at center of CB
-	auto l0 = cA.center() * cB.center();
-	auto l1 = l0.getRotatedLine( cB.center(),  theta );
-	auto l2 = l0.getRotatedLine( cB.center(), -theta );
+// remove the points on the right that are not above the chain anymore
+		for(;;)
+		{
+			auto next = std::next( it );
+			if( next == _map.end() )
+				break;
+			auto next2 = std::next( next );
+			if( next2 == _map.end() )
+				break;
+			if( p_cross( x, y, next->first, next->second, next2->first, next2->second ) < 0 )
+				break;
+			_map.erase( next );
+		}
+// same on the left
+		while( it != _map.begin() )
+		{
+			auto prev = std::prev( it );
+			if( prev == _map.begin() )
+				break;
+			auto prev2 = std::prev( prev );
+			if( p_cross( prev2->first, prev2->second, prev->first, prev->second, x, y ) < 0 )
+				break;
+			_map.erase( prev );
+		}
+		return true;
+	}
+};
 
-// build segments by getting the opposite point
+} // namespace chull
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Maintains the convex hull of a set of points that are added one at a time
+/**
+Points are not stored, only the current hull, as two monotone chains (upper and lower) held in ordered maps.
+Adding a point is amortised O(log n), with \c n the number of hull points, and so is isInside().
+
+The hull is returned by getHull() as a CPolyline_, that is built only if the hull has changed since the last call
+(O(n)).
+As for convexHull(), collinear points on the hull are not part of it.
+
+\sa convexHull()
+*/
+template<typename FPT>
+class ConvexHullBuilder_
+{
+private:
+	priv::chull::HalfHull _upper;
+	priv::chull::HalfHull _lower;       ///< y coordinates are negated
+	size_t                _nbInputPts = 0;
+	mutable CPolyline_<FPT> _hull;               ///< cached hull
+	mutable bool            _hullIsValid = true;
+
+public:
+	ConvexHullBuilder_() = default;
+
+/// Constructor from a vector/array/list of points
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	explicit ConvexHullBuilder_( const T& cont )
+	{
+		addPoints( cont );
+	}
+
+/// Adds a point, returns true if the hull has changed
+	template<typename FPT2>
+	bool addPoint( const Point2d_<FPT2>& pt )
+	{
+		_nbInputPts++;
+		HOMOG2D_INUMTYPE x = pt.getX();
+		HOMOG2D_INUMTYPE y = pt.getY();
+		bool b1 = _upper.add( x,  y );
+		bool b2 = _lower.add( x, -y );
+		if( b1 || b2 )
+			_hullIsValid = false;
+		return b1 || b2;
+	}
+
+/// Adds a point given by its coordinates, returns true if the hull has changed
+	template<typename T1,typename T2>
+	bool addPoint( T1 x, T2 y )
+	{
+		HOMOG2D_CHECK_IS_NUMBER(T1);
+		HOMOG2D_CHECK_IS_NUMBER(T2);
+		return addPoint( Point2d_<HOMOG2D_INUMTYPE>( x, y ) );
+	}
+
+/// Adds a vector/array/list of points, returns true if the hull has changed
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	bool addPoints( const T& cont )
+	{
+		bool changed = false;
+		for( const auto& pt: cont )
+			changed = addPoint( pt ) || changed;
+		return changed;
+	}
+
+/// Number of points given so far
+	size_t nbInputPts() const { return _nbInputPts; }
+
+/// Number of points of the current hull
+	size_t size() const
+	{
+		if( _upper.size() == 0 )
+			return 0;
+		auto nb = _upper.size() + _lower.size() - 2;
+		if( p_firstDiffers() )
+			nb++;
+		if( p_lastDiffers() )
+			nb++;
+		return std::max( nb, size_t(1) );
+	}
+
+/// Returns true if point is strictly inside the current hull (not on its boundary)
+	template<typename FPT2>
+	bool isInside( const Point2d_<FPT2>& pt ) const
+	{
+		HOMOG2D_INUMTYPE x = pt.getX();
+		HOMOG2D_INUMTYPE y = pt.getY();
+		return _upper.isBelow( x, y ) && _lower.isBelow( x, -y );
+	}
+
+/// Returns the current hull, counterclockwise, starting from the lowest (x,y) point
+/**
+Empty if less than 2 different points were given.
+*/
+	const CPolyline_<FPT>& getHull() const
+	{
+		if( !_hullIsValid )
+		{
+			_hull = p_buildHull();
+			_hullIsValid = true;
+		}
+		return _hull;
+	}
+
+	void clear()
+	{
+		_upper.clear();
+		_lower.clear();
+		_nbInputPts = 0;
+		_hull = CPolyline_<FPT>();
+		_hullIsValid = true;
+	}
+
+private:
+	bool p_firstDiffers() const
+	{
+		return _upper.get().begin()->second != -_lower.get().begin()->second;
+	}
+	bool p_lastDiffers() const
+	{
+		return _upper.get().rbegin()->second != -_lower.get().rbegin()->second;
+	}
+
+	CPolyline_<FPT> p_buildHull() const
+	{
+		if( _upper.size() == 0 )
+			return CPolyline_<FPT>();
+		if( _upper.size() == 1 && !p_firstDiffers() )    // single point
+			return CPolyline_<FPT>();
+
+		std::vector<Point2d_<FPT>> vpts;
+		vpts.reserve( size() );
+		for( const auto& elem: _lower.get() )            // lower chain, left to right
+			vpts.emplace_back( elem.first, -elem.second );
+
+		const auto& up = _upper.get();
+		auto it = up.rbegin();
+		if( !p_lastDiffers() )
+			++it;
+		auto itEnd = up.rend();
+		if( !p_firstDiffers() )
+			--itEnd;
+		for( ; it != itEnd; ++it )                       // upper chain, right to left
+			vpts.emplace_back( it->first, it->second );
+
+		return CPolyline_<FPT>( vpts );
+	}
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - CLASS ConvexPolygon_ (FAST QUERIES ON CONVEX POLYGONS)
+/////////////////////////////////////////////////////////////////////////////
+
+//------------------------------------------------------------------
+/// A convex polygon, for O(log n) queries
+/**
+Built once from a CPolyline_, that is checked for convexity (throws if not).
+The points are stored in counterclockwise order, without the points that are aligned with their neighbours
+(so indexes do not necessarily match the ones of the source polyline).
+
+Then, these queries use binary searches, in O(log n):
+- contains(): point inside polygon (false if on an edge, same semantics as Point2d_::isInside() )
+- getSupportIdx() / getSupportPoint(): extreme point in a given direction
+- getTangents(): tangent points from an outside point
+- distTo(): distance from a point
+- intersects(): intersection points with a line
+
+getExtremePoint() is O(1), as the four extreme points are computed at build time.
+
+On a default-constructed (empty) object, contains() returns false and intersects() finds no intersection,
+the other queries throw.
+
+\warning The object holds a copy of the points: it is not updated if the source polyline is modified.
+
+\sa PreparedPolygon
+*/
+template<typename FPT>
+class ConvexPolygon_
+{
+private:
+	std::vector<Point2d_<FPT>> _pts;      ///< counterclockwise
+	priv::ConvexIndex          _index;
+
+public:
+	ConvexPolygon_() = default;
+
+	template<typename FPT2>
+	explicit ConvexPolygon_( const CPolyline_<FPT2>& poly )
+	{
+		set( poly );
+	}
+
+/// Builds the convex polygon from \c poly, throws if not a convex polygon
+	template<typename FPT2>
+	void set( const CPolyline_<FPT2>& poly )
+	{
+		if( !poly.isSimple() )
+			HOMOG2D_THROW_ERROR_1( "unable, Polyline object is not simple" );
+
+		const auto& pts = poly.getPts();
+		if( !_index.build( pts ) )
+			HOMOG2D_THROW_ERROR_1( "unable, polygon is not convex or is degenerate" );
+		_pts.resize( _index.size() );
+		for( size_t i=0; i<_pts.size(); i++ )
+			_pts[i] = pts[ _index.srcIdx(i) ];
+	}
+
+	size_t size() const { return _pts.size(); }
+
+/// Returns the points, counterclockwise
+	const std::vector<Point2d_<FPT>>& getPts() const { return _pts; }
+
+/// Returns the polygon as a CPolyline_ object
+	CPolyline_<FPT> getPolyline() const { return CPolyline_<FPT>( _pts ); }
+
+/// Returns true if point is strictly inside the polygon, O(log n)
+	template<typename FPT2>
+	bool contains( const Point2d_<FPT2>& pt ) const
+	{
+		return _index.contains( pt.getX(), pt.getY() );
+	}
+
+/// Returns a vector of bool, holding for each point of the container \c cont if it is inside the polygon
+	template<
+		typename T,
+		typename std::enable_if<
+			trait::IsContainer<T>::value,
+			T
+		>::type* = nullptr
+	>
+	std::vector<bool> contains( const T& cont ) const
+	{
+		std::vector<bool> out( cont.size() );
+		size_t i = 0;
+		for( const auto& pt: cont )
+			out[i++] = _index.contains( pt.getX(), pt.getY() );
+		return out;
+	}
+
+/// Get Top-most / Bottom-most / Left-most / Right-most point, O(1)
+/// (same as PolylineBase::getExtremePoint() )
+	Point2d_<FPT> getExtremePoint( CardDir dir ) const
+	{
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, ConvexPolygon is empty" );
+		return _pts[ _index.extremeIdx( dir ) ];
+	}
+
+/// Returns index of the point that is the farthest in the direction (dx,dy), O(log n)
+	template<typename T1,typename T2>
+	size_t getSupportIdx( T1 dx, T2 dy ) const
+	{
+		HOMOG2D_CHECK_IS_NUMBER( T1 );
+		HOMOG2D_CHECK_IS_NUMBER( T2 );
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, ConvexPolygon is empty" );
+		return _index.support( dx, dy );
+	}
 
-	auto ppts1 = l1.getPoints( cB.center(), hcost );
-	auto p1 = ppts1.first;
-	if( ppts1.second.distTo( cA.center()) < p1.distTo( cA.center()) )
-		p1 = ppts1.second;
+/// Returns the point that is the farthest in the direction (dx,dy), O(log n)
+	template<typename T1,typename T2>
+	Point2d_<FPT> getSupportPoint( T1 dx, T2 dy ) const
+	{
+		return _pts[ getSupportIdx( dx, dy ) ];
+	}
 
-	auto ppts2 = l2.getPoints( cB.center(), hcost );
-	auto p2 = ppts2.first;
-	if( ppts2.second.distTo( cA.center()) < p2.distTo( cA.center()) )
-		p2 = ppts2.second;
-//	std::cout <<"p1=" << p1 << " p2=" << p2 << '\n';
+/// Returns the indexes of the two tangent points from a point lying outside, O(log n)
+/**
+The first one is the first point (counterclockwise) of the part of the polygon that is visible from \c pt,
+the second one is the last one.
+Throws if the point is not outside.
+*/
+	template<typename FPT2>
+	std::pair<size_t,size_t> getTangents( const Point2d_<FPT2>& pt ) const
+	{
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, ConvexPolygon is empty" );
+		auto v = _index.visibleEdge( pt.getX(), pt.getY() );
+		if( v == size() )
+			HOMOG2D_THROW_ERROR_1( "unable, point " << pt << " is not outside" );
+		return _index.tangents( pt.getX(), pt.getY(), v );
+	}
 
-	auto seg1 = Segment_<HOMOG2D_INUMTYPE>( p1, cB.center() );
-	auto seg2 = Segment_<HOMOG2D_INUMTYPE>( p2, cB.center() );
+/// Returns the distance between point \c pt and the polygon (0 if inside), O(log n)
+	template<typename FPT2>
+	HOMOG2D_INUMTYPE distTo( const Point2d_<FPT2>& pt ) const
+	{
+		if( size() == 0 )
+			HOMOG2D_THROW_ERROR_1( "Invalid call, ConvexPolygon is empty" );
+		return _index.distTo( pt.getX(), pt.getY() );
+	}
 
-	auto psegs1 = seg1.getParallelSegs( cB.radius() );
-	if( psegs1.first.distTo(cA.center()) <  psegs1.second.distTo(cA.center()) )
-		std::swap( psegs1.first, psegs1.second );
+/// Intersection points with line \c li (0, 1 or 2 points), O(log n). No intersection if empty
+	template<typename FPT2>
+	detail::IntersectM<FPT> intersects( const Line2d_<FPT2>& li ) const
+	{
+		bool onVertex = false;
+		return _index.template intersects<FPT>( li, onVertex );
+	}
+};
 
-	auto psegs2 = seg2.getParallelSegs( cB.radius() );
-	if( psegs2.second.distTo(cA.center()) <  psegs2.first.distTo(cA.center()) )
-		std::swap( psegs2.first, psegs2.second );
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - ROTATING CALIPERS (OBB, DIAMETER, WIDTH)
+/////////////////////////////////////////////////////////////////////////////
 
-	return std::make_pair(
-		psegs1.first,
-		psegs2.second
-	);
-}
+namespace priv {
+/// Rotating calipers algorithms, operating on a convex hull
+namespace calipers {
 
-/// Returns the 4 points of the rectangle (free function)
-/// \sa FRect_::get4Pts()
-template<typename FPT>
-std::array<Point2d_<FPT>,4>
-get4Pts( const FRect_<FPT>& rect )
+//------------------------------------------------------------------
+/// Convex hull, as counterclockwise coordinates
+struct Hull
 {
-	return rect.get4Pts();
-}
+	std::vector<HOMOG2D_INUMTYPE> _vx, _vy;
 
-/// Returns the 2 major points of the rectangle (free function)
-/// \sa FRect_::getPts()
-template<typename FPT>
-auto
-getPts( const FRect_<FPT>& rect )
-{
-	return rect.getPts();
-}
+	size_t size() const { return _vx.size(); }
+	size_t next( size_t i ) const { return i+1 == size() ? 0 : i+1; }
 
-/// Free function
-template<typename FPT>
-HOMOG2D_INUMTYPE
-height( const FRect_<FPT>& rect )
-{
-	return rect.height();
-}
+/// Twice the area of triangle (i,j,k)
+	HOMOG2D_INUMTYPE area2( size_t i, size_t j, size_t k ) const
+	{
+		return homog2d_abs( ( _vx[j] - _vx[i] ) * ( _vy[k] - _vy[i] ) - ( _vy[j] - _vy[i] ) * ( _vx[k] - _vx[i] ) );
+	}
+/// Dot product of edge \c i with vector (ux,uy)
+	HOMOG2D_INUMTYPE dotEdge( size_t i, HOMOG2D_INUMTYPE ux, HOMOG2D_INUMTYPE uy ) const
+	{
+		auto j = next( i );
+		return ( _vx[j] - _vx[i] ) * ux + ( _vy[j] - _vy[i] ) * uy;
+	}
+};
 
-/// Free function
-template<typename FPT>
-HOMOG2D_INUMTYPE
-width( const FRect_<FPT>& rect )
+/// Computes the convex hull of a container holding points, O(n.log(n))
+template<typename T>
+Hull
+getHull( const T& cont )
 {
-	return rect.width();
-}
+	const auto n = cont.size();
+	std::vector<HOMOG2D_INUMTYPE> vx( n ), vy( n );
+	size_t i = 0;
+	for( const auto& pt: cont )
+	{
+		vx[i]   = pt.getX();
+		vy[i++] = pt.getY();
+	}
+	std::vector<size_t> idx( n );
+	std::iota( idx.begin(), idx.end(), 0 );
+	auto vidx = chull::monotoneChain( vx, vy, idx );
 
-/// Free function
-template<typename FPT>
-FRect_<FPT>
-getExtended( const FRect_<FPT>& rect )
-{
-	return rect.getExtended();
+	Hull hull;
+	hull._vx.resize( vidx.size() );
+	hull._vy.resize( vidx.size() );
+	for( size_t k=0; k<vidx.size(); k++ )
+	{
+		hull._vx[k] = vx[ vidx[k] ];
+		hull._vy[k] = vy[ vidx[k] ];
+	}
+	return hull;
 }
 
-/// Free function
+//------------------------------------------------------------------
+/// Minimum area (or minimum perimeter) rectangle enclosing a convex hull, returns its 4 corners
+/**
+One of the sides of the optimal rectangle is collinear with an edge of the hull.
+For each edge, the three other "calipers" (farthest points along the edge, opposite to it, and backwards)
+only move forward, so this is O(n).
+*/
 template<typename FPT>
-std::pair<Segment_<FPT>,Segment_<FPT>>
-getDiagonals( const FRect_<FPT>& rect )
+std::vector<Point2d_<FPT>>
+minRect( const Hull& hull, bool minPerimeter )
 {
-	return rect.getDiagonals();
-}
+	const auto n = hull.size();
+	const auto& vx = hull._vx;
+	const auto& vy = hull._vy;
 
-/// Returns centroid of Polyline (free function)
-/// \sa PolylineBase::centroid()
-template<typename PLT,typename FPT>
-base::LPBase<typ::IsPoint,FPT>
-centroid( const base::PolylineBase<PLT,FPT>& pl )
-{
-	return pl.centroid();
+	size_t iR = 1, iT = 1, iL = 1;             // right, top, and left calipers
+	HOMOG2D_INUMTYPE bestVal = std::numeric_limits<HOMOG2D_INUMTYPE>::max();
+	std::vector<Point2d_<FPT>> out( 4 );
+	for( size_t i=0; i<n; i++ )
+	{
+		auto j = hull.next( i );
+		auto len = homog2d_sqrt( ( vx[j] - vx[i] ) * ( vx[j] - vx[i] ) + ( vy[j] - vy[i] ) * ( vy[j] - vy[i] ) );
+		auto ux = ( vx[j] - vx[i] ) / len;    // edge direction
+		auto uy = ( vy[j] - vy[i] ) / len;
+		auto wx = -uy;                           // normal, towards the inside
+		auto wy =  ux;
+
+		if( i == 0 )
+			iR = j;
+		while( hull.dotEdge( iR, ux, uy ) > 0. )
+			iR = hull.next( iR );
+		if( i == 0 )
+			iT = iR;
+		while( hull.dotEdge( iT, wx, wy ) > 0. )
+			iT = hull.next( iT );
+		if( i == 0 )
+			iL = iT;
+		while( hull.dotEdge( iL, ux, uy ) < 0. )
+			iL = hull.next( iL );
+
+		auto proj = [&]( size_t k, HOMOG2D_INUMTYPE dx, HOMOG2D_INUMTYPE dy )
+		{
+			return ( vx[k] - vx[i] ) * dx + ( vy[k] - vy[i] ) * dy;
+		};
+		auto aMax = proj( iR, ux, uy );
+		auto aMin = proj( iL, ux, uy );
+		auto h    = proj( iT, wx, wy );
+		auto val  = ( minPerimeter ? aMax - aMin + h : ( aMax - aMin ) * h );
+		if( val < bestVal )
+		{
+			bestVal = val;
+			out[0] = Point2d_<FPT>( vx[i] + aMin * ux,          vy[i] + aMin * uy );
+			out[1] = Point2d_<FPT>( vx[i] + aMax * ux,          vy[i] + aMax * uy );
+			out[2] = Point2d_<FPT>( vx[i] + aMax * ux + h * wx, vy[i] + aMax * uy + h * wy );
+			out[3] = Point2d_<FPT>( vx[i] + aMin * ux + h * wx, vy[i] + aMin * uy + h * wy );
+		}
+	}
+	return out;
 }
 
-/// Returns reference on radius of circle (free function), non-const version
-/// \sa Circle_::radius()
-template<typename FPT>
-FPT&
-radius( Circle_<FPT>& cir )
+//------------------------------------------------------------------
+/// Calls \c f(i,j) for each edge \c i of the hull, with \c j the point that is the farthest from it
+/**
+The farthest point only moves forward, so this is O(n).
+*/
+template<typename FUNC>
+void
+forEachAntipodal( const Hull& hull, FUNC f )
 {
-	return cir.radius();
+	size_t j = 1;
+	for( size_t i=0; i<hull.size(); i++ )
+	{
+		auto i2 = hull.next( i );
+		while( hull.area2( i, i2, hull.next(j) ) > hull.area2( i, i2, j ) )
+			j = hull.next( j );
+		f( i, j );
+	}
 }
 
-/// Returns reference on radius of circle (free function), const version
-/// \sa Circle_::radius()
-template<typename FPT>
-const FPT&
-radius( const Circle_<FPT>& cir )
-{
-	return cir.radius();
+} // namespace calipers
+} // namespace priv
+
+//------------------------------------------------------------------
+/// Returns the minimum area Oriented Bounding Box of a set of points (free function)
+/**
+- input: \c std::vector, \c std::array or \c std::list of points
+- output: a closed polyline of 4 points
+- complexity: O(n.log(n)) (convex hull, then rotating calipers in O(n))
+- throws if the convex hull has less than 3 points (all points aligned)
+
+\sa getMinPerimOBB()
+\sa Ellipse_::getOBB()
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+CPolyline_<typename T::value_type::FType>
+getMinAreaOBB( const T& cont )
+{
+	auto hull = priv::calipers::getHull( cont );
+	if( hull.size() < 3 )
+		HOMOG2D_THROW_ERROR_1( "unable, convex hull has " << hull.size() << " points, minimum is 3" );
+	return CPolyline_<typename T::value_type::FType>(
+		priv::calipers::minRect<typename T::value_type::FType>( hull, false )
+	);
 }
 
-/// Returns reference on center of circle (free function), non-const version
-/// \sa Circle_::center()
-template<typename FPT>
-Point2d_<FPT>&
-center( Circle_<FPT>& cir )
+/// Returns the minimum area Oriented Bounding Box of a Polyline (free function)
+template<typename PLT,typename FPT>
+CPolyline_<FPT>
+getMinAreaOBB( const base::PolylineBase<PLT,FPT>& pl )
 {
-	return cir.center();
+	return getMinAreaOBB( pl.getPts() );
 }
 
-/// Returns reference on center of circle (free function), const version
-/// \sa Circle_::center()
-template<typename FPT>
-const Point2d_<FPT>&
-center( const Circle_<FPT>& cir )
-{
-	return cir.center();
+//------------------------------------------------------------------
+/// Returns the minimum perimeter Oriented Bounding Box of a set of points (free function)
+/**
+Same as getMinAreaOBB(), but the perimeter of the box is minimized instead of its area.
+*/
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+CPolyline_<typename T::value_type::FType>
+getMinPerimOBB( const T& cont )
+{
+	auto hull = priv::calipers::getHull( cont );
+	if( hull.size() < 3 )
+		HOMOG2D_THROW_ERROR_1( "unable, convex hull has " << hull.size() << " points, minimum is 3" );
+	return CPolyline_<typename T::value_type::FType>(
+		priv::calipers::minRect<typename T::value_type::FType>( hull, true )
+	);
 }
 
-/// Get data size expressed as number of bits for, respectively, mantissa and exponent
-/// \sa detail::Common::dsize()
-template<typename T>
-std::pair<int,int>
-dsize( const T& t )
+/// Returns the minimum perimeter Oriented Bounding Box of a Polyline (free function)
+template<typename PLT,typename FPT>
+CPolyline_<FPT>
+getMinPerimOBB( const base::PolylineBase<PLT,FPT>& pl )
 {
-	return t.dsize();
+	return getMinPerimOBB( pl.getPts() );
 }
 
 //------------------------------------------------------------------
-/// Returns the distance between 2 parallel lines (free function)
+/// Returns the diameter of a set of points, that is the segment joining the two points that are the farthest apart
+/// (free function)
 /**
-- ref: https://en.wikipedia.org/wiki/Distance_between_two_parallel_lines
-
-We first check that the two lines are indeed parallel.
-This should ensure that a1=a2 and b1=b2.
-But due to numeric issues they could by slightly different. In order to gain accuracy,
-we use the geometric mean of these.
+- input: \c std::vector, \c std::array or \c std::list of points
+- complexity: O(n.log(n)) (convex hull, then rotating calipers in O(n))
+- throws if less than 2 different points
 */
-template<typename FPT>
-HOMOG2D_INUMTYPE
-getParallelDistance( const Line2d_<FPT>& li1, const Line2d_<FPT>& li2 )
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+Segment_<typename T::value_type::FType>
+getDiameter( const T& cont )
 {
-#ifndef HOMOG2D_NOCHECKS
-	if( !li1.isParallelTo(li2) )
-		HOMOG2D_THROW_ERROR_1( "lines are not parallel" );
-#endif
-	const auto ar1 = li1.get();
-	const auto ar2 = li2.get();
-	const HOMOG2D_INUMTYPE a1 = ar1[0];
-	const HOMOG2D_INUMTYPE b1 = ar1[1];
-	const HOMOG2D_INUMTYPE c1 = ar1[2];
-	const HOMOG2D_INUMTYPE a2 = ar2[0];
-	const HOMOG2D_INUMTYPE b2 = ar2[1];
-	const HOMOG2D_INUMTYPE c2 = ar2[2];
-
-	HOMOG2D_INUMTYPE a = homog2d_sqrt( a1*a2 );
-	HOMOG2D_INUMTYPE b = homog2d_sqrt( b1*b2 );
-	return homog2d_abs( c1 - c2 ) / homog2d_sqrt( a*a + b*b );
-}
+	using FPT = typename T::value_type::FType;
+	auto hull = priv::calipers::getHull( cont );
+	if( hull.size() < 2 )
+		HOMOG2D_THROW_ERROR_1( "unable, need at least 2 different points" );
 
-/// Return angle of ellipse (free function)
-/// \sa Ellipse_::angle()
-template<typename FPT>
-HOMOG2D_INUMTYPE
-angle( const Ellipse_<FPT>& ell )
-{
-	return ell.angle();
+	const auto& vx = hull._vx;
+	const auto& vy = hull._vy;
+	auto sqd = [&]( size_t i, size_t j )
+	{
+		return ( vx[j] - vx[i] ) * ( vx[j] - vx[i] ) + ( vy[j] - vy[i] ) * ( vy[j] - vy[i] );
+	};
+	std::pair<size_t,size_t> best( 0, 1 );
+	if( hull.size() > 2 )
+		priv::calipers::forEachAntipodal(
+			hull,
+			[&]( size_t i, size_t j )                          // lambda
+			{
+				for( auto k: { i, hull.next(i) } )
+					if( sqd( k, j ) > sqd( best.first, best.second ) )
+						best = std::make_pair( k, j );
+			}
+		);
+	return Segment_<FPT>(
+		Point2d_<FPT>( vx[best.first],  vy[best.first] ),
+		Point2d_<FPT>( vx[best.second], vy[best.second] )
+	);
 }
 
-/// Return center of Segment_, FRect_, or Ellipse_ (free function)
-/// \sa Ellipse_::getCenter()
-/// \sa FRect_::getCenter()
-/// \sa Segment_::getCenter()
-template<typename T>
-Point2d_<typename T::FType>
-getCenter(const T& other )
+/// Returns the diameter of a Polyline (free function)
+template<typename PLT,typename FPT>
+Segment_<FPT>
+getDiameter( const base::PolylineBase<PLT,FPT>& pl )
 {
-	return other.getCenter();
+	return getDiameter( pl.getPts() );
 }
 
-/// Translate primitive \c prim (free function)
+//------------------------------------------------------------------
+/// Returns the minimum width of a set of points, that is the smallest distance between two parallel lines enclosing them
+/// (free function)
 /**
-Calls the member function. Type checking is done there.
+- input: \c std::vector, \c std::array or \c std::list of points
+- complexity: O(n.log(n)) (convex hull, then rotating calipers in O(n))
+- returns 0 if all the points are aligned
 */
-template<typename T,typename FP1,typename FP2>
-void
-translate( T& prim, FP1 dx, FP2 dy )
+template<
+	typename T,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+HOMOG2D_INUMTYPE
+getMinWidth( const T& cont )
+{
+	auto hull = priv::calipers::getHull( cont );
+	if( hull.size() < 3 )
+		return 0.;
+
+	const auto& vx = hull._vx;
+	const auto& vy = hull._vy;
+	HOMOG2D_INUMTYPE best = std::numeric_limits<HOMOG2D_INUMTYPE>::max();
+	priv::calipers::forEachAntipodal(
+		hull,
+		[&]( size_t i, size_t j )                          // lambda
+		{
+			auto i2 = hull.next( i );
+			auto len = homog2d_sqrt( ( vx[i2] - vx[i] ) * ( vx[i2] - vx[i] ) + ( vy[i2] - vy[i] ) * ( vy[i2] - vy[i] ) );
+			best = std::min( best, hull.area2( i, i2, j ) / len );
+		}
+	);
+	return best;
+}
+
+/// Returns the minimum width of a Polyline (free function)
+template<typename PLT,typename FPT>
+HOMOG2D_INUMTYPE
+getMinWidth( const base::PolylineBase<PLT,FPT>& pl )
 {
-	prim.translate( dx, dy );
+	return getMinWidth( pl.getPts() );
 }
 
-/// Translate primitive \c prim with values in a \c std::pair (free function)
-/**
-Calls the member function. Type checking is done there.
-*/
-template<typename T,typename FP1,typename FP2>
-void
-translate( T& prim, const std::pair<FP1,FP2>& ppt )
+//------------------------------------------------------------------
+/// Clips a segment against a rectangle (free function)
+/// \sa SegVec::clip()
+template<typename SV,typename FPT,typename FPT2>
+std::pair<bool,base::SegVec<SV,FPT>>
+clip( const base::SegVec<SV,FPT>& seg, const FRect_<FPT2>& rect )
 {
-	prim.translate( ppt.first, ppt.second );
+	return seg.clip( rect );
 }
 
-/// Move primitive to other location (free function)
-/**
-Calls the member function. Type checking is done there.
-*/
-template<typename T,typename FP>
-void
-moveTo( T& prim, const Point2d_<FP>& pt )
+//------------------------------------------------------------------
+/// Clips a polyline against a rectangle (free function)
+/// \sa PolylineBase::clip()
+template<typename PLT,typename FPT,typename FPT2>
+auto
+clip( const base::PolylineBase<PLT,FPT>& pl, const FRect_<FPT2>& rect )
 {
-	prim.moveTo( pt );
+	return pl.clip( rect );
 }
 
-/// Move primitive to other location (free function)
+//------------------------------------------------------------------
+/// Clips a set of segments against a rectangle (free function)
 /**
-Calls the member function. Type checking is done there.
+- input: \c std::vector, \c std::array or \c std::list of segments (\c Segment_ or \c OSegment_)
+- returns a vector holding the parts of the segments that lie inside, using the Liang-Barsky algorithm
 */
-	template<typename T,typename FP1,typename FP2>
-	void moveTo( T& prim, FP1 x, FP2 y )
+template<
+	typename T,
+	typename FPT2,
+	typename std::enable_if<
+		trait::IsContainer<T>::value,
+		T
+	>::type* = nullptr
+>
+std::vector<typename T::value_type>
+clip( const T& segs, const FRect_<FPT2>& rect )
+{
+	std::vector<typename T::value_type> vout;
+	vout.reserve( segs.size() );
+	for( const auto& seg: segs )
 	{
-		prim.moveTo( x, y );
+		auto res = seg.clip( rect );
+		if( res.first )
+			vout.push_back( res.second );
 	}
-
-/// Returns true if ellipse is a circle
-/// \sa Ellipse_::isCircle()
-template<typename FPT>
-bool
-isCircle( const Ellipse_<FPT>& ell, HOMOG2D_INUMTYPE thres=1.E-10 )
-{
-	return ell.isCircle( thres );
-}
-
-/// Returns ellipse axis lines
-/// \sa Ellipse_::getAxisLines()
-template<typename FPT>
-std::pair<Line2d_<FPT>,Line2d_<FPT>>
-getAxisLines( const Ellipse_<FPT>& ell )
-{
-	return ell.getAxisLines();
+	return vout;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - POLYGON BOOLEAN OPERATIONS
+/////////////////////////////////////////////////////////////////////////////
 
-namespace priv {
-
-/// used in findPoint()
-struct F_MIN{};
-struct F_MAX{};
+/// Boolean operation between two polygons, see booleanOp()
+enum class BoolOp: uint8_t { Union, Intersection, Difference, Xor };
 
-/// Private. Common function for searching nearest of farthest point
-/*
-\sa findNearestPoint()
-\sa findFarthestPoint
+//------------------------------------------------------------------
+/// Result of a boolean operation between two polygons, see booleanOp()
+/**
+The result can be made of several disjoint polygons, some of them having holes.
+It is stored as a set of contours (CPolyline_), each of them being either an outer boundary or a hole.
+For holes, getOuter() returns the index of the outer contour holding it.
 */
-template<typename FPT, typename CONT, typename S_WHAT>
-size_t
-findPoint(
-	const Point2d_<FPT>& qpt,  ///< query point
-	const CONT&          cont, ///< container
-	const S_WHAT&              ///< F_MIN or F_MAX
-//	const CONT2*         mask  ///< optional vector or list or array of bool
-)
+template<typename FPT>
+class BoolOpResult_
 {
-	if( cont.size() < 2 )
-		HOMOG2D_THROW_ERROR_1( "container holds " << cont.size() \
-			<< " points, minimum is 2" );
+private:
+	std::vector<CPolyline_<FPT>> _contours;
+	std::vector<int>             _holeOf;  ///< -1 for outer contours
 
-	decltype( priv::sqDist( qpt, qpt ) ) resDist;
-	size_t startIdx = 1;
-	size_t resIdx = 0;
+public:
+	BoolOpResult_() = default;
+	BoolOpResult_( std::vector<CPolyline_<FPT>>&& contours, std::vector<int>&& holeOf )
+		: _contours( std::move(contours) ), _holeOf( std::move(holeOf) )
+	{
+		assert( _contours.size() == _holeOf.size() );
+	}
 
-// if point is the first one of the container, then
-// initialize with the second one
-	if( cont[0] == qpt )
+/// Number of contours (outer ones and holes)
+	size_t size() const  { return _contours.size(); }
+	bool   empty() const { return _contours.empty(); }
+
+/// Number of holes
+	size_t nbHoles() const
 	{
-		startIdx++;
-		resIdx++;
-		resDist = priv::sqDist( qpt, cont[1] );
+		return std::count_if( _holeOf.begin(), _holeOf.end(), [](int i){ return i != -1; } );
 	}
-	else // initialize with first point
+
+	const std::vector<CPolyline_<FPT>>& getContours() const { return _contours; }
+	const CPolyline_<FPT>& getContour( size_t i ) const     { return _contours.at(i); }
+
+	bool isHole( size_t i ) const { return _holeOf.at(i) != -1; }
+
+/// Returns index of the outer contour of hole \c i
+	size_t getOuter( size_t i ) const
 	{
-		resDist = priv::sqDist( qpt, cont[0] );
+		if( !isHole( i ) )
+			HOMOG2D_THROW_ERROR_1( "contour " << i << " is not a hole" );
+		return static_cast<size_t>( _holeOf[i] );
 	}
 
-	for( size_t i=startIdx; i<cont.size(); i++ )
+/// Area of the result: sum of the area of outer contours, minus the area of holes
+/**
+Contours may touch themselves at a vertex, so the area is computed directly
+(CPolyline_::area() returns 0 for non-simple polygons)
+*/
+	HOMOG2D_INUMTYPE area() const
 	{
-		if( qpt != cont[i] )
+		HOMOG2D_INUMTYPE sum = 0.;
+		for( size_t i=0; i<size(); i++ )
 		{
-			auto currentDist = priv::sqDist( qpt, cont[i] );
-			if constexpr( std::is_same_v<S_WHAT, F_MIN> )
-			{
-				if( currentDist < resDist )
-				{
-					resIdx  = i;
-					resDist = currentDist;
-				}
-			}
-			else
-			{
-				if( currentDist > resDist )
-				{
-					resIdx  = i;
-					resDist = currentDist;
-				}
-			}
+			const auto& pts = _contours[i].getPts();
+			HOMOG2D_INUMTYPE a = 0.;
+			for( size_t j=0; j<pts.size(); j++ )
+				a += priv::shoelaceTerm( pts[j], pts[ (j+1)%pts.size() ] );
+			sum += ( isHole(i) ? -1. : 1. ) * homog2d_abs( a );
 		}
+		return sum / 2.;
 	}
-	return resIdx;
-}
+};
 
-} //namespace priv
+namespace priv {
+/// Polygon boolean operations, see booleanOp()
+namespace boolop {
 
-//------------------------------------------------------------------
-/// Returns index of point in container \c cont that is the nearest to \c pt
-/// \todo add some sfinae and/or checking on type T
-/// \todo perform some speed analysis, and check if usage of squared distance is really better
-/// \todo add other distance computations (Manhattan?)
-/// \todo Would it be better to return an iterator?
-template<typename FPT, typename T>
-size_t
-findNearestPoint( const Point2d_<FPT>& pt, const T& cont )
+enum class EdgeType: uint8_t { Normal, NonContributing, SameTransition, DifferentTransition };
+
+/// Fill rule of Sweeper
+/**
+- EvenOdd: boolean operation between two polygons, using the even-odd rule for each of them
+- Positive: single (self-intersecting) polygon, the result is the region having a positive winding number
+*/
+enum class FillRule: uint8_t { EvenOdd, Positive };
+
+struct SweepEvent;
+
+/// Ordering of the segments in the sweep line (below first)
+struct SegComp
 {
-	return priv::findPoint( pt, cont, priv::F_MIN() );
-}
+	bool operator()( const SweepEvent* le1, const SweepEvent* le2 ) const;
+};
+
+using SweepLine = std::set<SweepEvent*,SegComp>;
+
 //------------------------------------------------------------------
-/// Returns index of point in container \c cont that is the farthest to \c pt
-template<typename FPT, typename T>
-size_t
-findFarthestPoint( const Point2d_<FPT>& pt, const T& cont )
+/// Twice the signed area of triangle (p0,p1,p2), positive if counterclockwise
+inline
+HOMOG2D_INUMTYPE
+signedArea(
+	HOMOG2D_INUMTYPE x0, HOMOG2D_INUMTYPE y0,
+	HOMOG2D_INUMTYPE x1, HOMOG2D_INUMTYPE y1,
+	HOMOG2D_INUMTYPE x2, HOMOG2D_INUMTYPE y2
+)
 {
-	return priv::findPoint( pt, cont, priv::F_MAX() );
+	return (x0 - x2) * (y1 - y2) - (x1 - x2) * (y0 - y2);
 }
+
 //------------------------------------------------------------------
-/// Returns indexes of points in container \c cont that are nearest/farthest
-/**
-- return pair: first is nearest, second is farthest
-*/
-template<typename FPT, typename T>
-auto
-findNearestFarthestPoint( const Point2d_<FPT>& pt, const T& cont )
-{
-	if( cont.size() < 2 )
-		HOMOG2D_THROW_ERROR_1( "container holds " << cont.size() \
-			<< " points, minimum is 2" );
+/// Endpoint of a segment, as processed by the sweep line algorithm
+struct SweepEvent
+{
+	HOMOG2D_INUMTYPE _x, _y;
+	bool        _left;                     ///< is left endpoint of segment
+	SweepEvent* _other;                    ///< other endpoint of segment
+	bool        _isSubject;                ///< belongs to subject polygon (else to clipping polygon)
+	size_t      _id;                       ///< creation order, used as last criterion for ordering
+	size_t      _contourId = 0;
+	EdgeType    _type = EdgeType::Normal;
+	bool        _inOut = false;            ///< segment is an in-out transition for its own polygon (going upwards)
+	bool        _otherInOut = false;       ///< same, for closest segment of the other polygon below
+	SweepEvent* _prevInResult = nullptr;   ///< closest segment below that is in the result
+	int         _resultTransition = 0;     ///< 0: not in result, 1: out-in transition of result (upwards), -1: in-out
+	bool        _inSL = false;             ///< is in sweep line
+	SweepLine::iterator _posSL;
+	size_t      _otherPos = 0;             ///< used when connecting edges
+	size_t      _outputContourId = std::numeric_limits<size_t>::max(); ///< none yet
+	int         _windDelta = 0;            ///< FillRule::Positive only: +1 if source edge goes from left to right, else -1
+	int         _windBelow = 0;            ///< FillRule::Positive only: winding number of the region below the segment
+
+	SweepEvent( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, bool left, SweepEvent* other, bool isSubject, size_t id )
+		: _x(x), _y(y), _left(left), _other(other), _isSubject(isSubject), _id(id)
+	{}
 
-	auto maxDist = priv::sqDist( pt, cont[0] );
-	auto minDist = maxDist;
-	size_t idxMin = 0;
-	size_t idxMax = 0;
-	size_t startIdx = 1;
-	if( pt == cont[0] )
+	bool samePoint( const SweepEvent* e ) const { return _x == e->_x && _y == e->_y; }
+	bool isVertical() const                     { return _x == _other->_x; }
+	bool inResult() const                       { return _resultTransition != 0; }
+
+/// Point (x,y) is above the segment
+	bool isBelow( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y ) const
 	{
-		idxMin++;
-		idxMax++;
-		startIdx++;
-		maxDist = priv::sqDist( pt, cont[1] );
-		minDist = maxDist;
+		return _left
+			? signedArea( _x, _y, _other->_x, _other->_y, x, y ) > 0
+			: signedArea( _other->_x, _other->_y, _x, _y, x, y ) > 0;
 	}
-	for( size_t i=startIdx; i<cont.size(); i++ )
+	bool isBelow( const SweepEvent* e ) const
 	{
-		if( pt != cont[i] )
+		return isBelow( e->_x, e->_y );
+	}
+
+/// Point of event \c e lies on the line of the segment (up to rounding errors, as the segment may come from a split)
+	bool isOnLine( const SweepEvent* e ) const
+	{
+		auto dx = _other->_x - _x;
+		auto dy = _other->_y - _y;
+		auto sa = signedArea( _x, _y, _other->_x, _other->_y, e->_x, e->_y );
+		return sa * sa <= thr::nullDistance() * thr::nullDistance() * ( dx*dx + dy*dy );
+	}
+};
+
+//------------------------------------------------------------------
+/// Event ordering, returns true if \c e1 is to be processed \b after \c e2
+struct EventComp
+{
+	bool operator()( const SweepEvent* e1, const SweepEvent* e2 ) const
+	{
+		if( e1->_x != e2->_x )
+			return e1->_x > e2->_x;
+		if( e1->_y != e2->_y )
+			return e1->_y > e2->_y;
+		if( e1->_left != e2->_left )            // right endpoint processed first
+			return e1->_left;
+		if( signedArea( e1->_x, e1->_y, e1->_other->_x, e1->_other->_y, e2->_other->_x, e2->_other->_y ) != 0 )
+			return !e1->isBelow( e2->_other );   // bottom segment processed first
+		if( e1->_isSubject != e2->_isSubject )
+			return !e1->_isSubject;
+		return e1->_id > e2->_id;
+	}
+};
+
+inline
+bool
+SegComp::operator()( const SweepEvent* le1, const SweepEvent* le2 ) const
+{
+	if( le1 == le2 )
+		return false;
+	if(
+		signedArea( le1->_x, le1->_y, le1->_other->_x, le1->_other->_y, le2->_x, le2->_y ) != 0
+		|| signedArea( le1->_x, le1->_y, le1->_other->_x, le1->_other->_y, le2->_other->_x, le2->_other->_y ) != 0
+	)                                                // segments are not collinear
+	{
+		if( le1->samePoint( le2 ) )                  // same left endpoint: use right endpoint
+			return le1->isBelow( le2->_other );
+		if( le1->_x == le2->_x )
+			return le1->_y < le2->_y;
+		if( EventComp()( le1, le2 ) )                // le1 inserted after le2
 		{
-			auto currentDist = priv::sqDist( pt, cont[i] );
-			if( currentDist > maxDist )
-			{
-				idxMax  = i;
-				maxDist = currentDist;
-			}
-			if( currentDist < minDist )
-			{
-				idxMin  = i;
-				minDist = currentDist;
-			}
+			if( le2->isOnLine( le1 ) )               // left endpoint of le1 lies on le2: use right endpoint
+				return !le2->isBelow( le1->_other );
+			return !le2->isBelow( le1 );
 		}
+		if( le1->isOnLine( le2 ) )
+			return le1->isBelow( le2->_other );
+		return le1->isBelow( le2 );
 	}
-	return std::make_pair(idxMin, idxMax);
+// collinear segments
+	if( le1->_isSubject != le2->_isSubject )
+		return le1->_isSubject;
+	if( le1->samePoint( le2 ) )
+	{
+		if( le1->_contourId != le2->_contourId )
+			return le1->_contourId < le2->_contourId;
+		return le1->_id < le2->_id;
+	}
+	return !EventComp()( le1, le2 );
 }
 
-/// Returns set of points that are inside primitive \c prim
-/**
-Output container will be of same type as input container (vector, list or array
-
-\todo 20250123: maybe replace the bunch of static_asserts with something around trait::HasArea ?
-*/
-template<typename CONT, typename PRIM>
-CONT
-getPtsInside(
-	const CONT& input_set,
-	const PRIM& prim        ///< geometrical primitive (FRect, Circle, ...?)
+//------------------------------------------------------------------
+/// Intersection of segments (a1,a2) and (b1,b2): returns the number of intersection points (0, 1, or 2 if overlapping)
+inline
+int
+intersectSegs(
+	HOMOG2D_INUMTYPE a1x, HOMOG2D_INUMTYPE a1y, HOMOG2D_INUMTYPE a2x, HOMOG2D_INUMTYPE a2y,
+	HOMOG2D_INUMTYPE b1x, HOMOG2D_INUMTYPE b1y, HOMOG2D_INUMTYPE b2x, HOMOG2D_INUMTYPE b2y,
+	std::array<HOMOG2D_INUMTYPE,4>& out
 )
 {
-	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_OPol>,    "Cannot find points inside a Open Polyline" );
-	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Line>,    "Cannot find points inside a Line" );
-	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Point>,   "Cannot find points inside a Point" );
-	static_assert( !std::is_same_v<typename PRIM::SType, typ::T_Segment>, "Cannot find points inside a Segment" );
-	static_assert( !trait::IsArray<CONT>::value, "Cannot use std::array as container" );
+	auto vax = a2x - a1x;
+	auto vay = a2y - a1y;
+	auto vbx = b2x - b1x;
+	auto vby = b2y - b1y;
+	auto ex  = b1x - a1x;
+	auto ey  = b1y - a1y;
 
-	CONT out;
-	out.reserve( input_set.size() );
+	const auto thres = thr::nullDistance() * thr::nullDistance();
+	auto kross = vax * vby - vay * vbx;
+	if( kross != 0 )                             // not parallel
+	{
+		auto s = ( ex * vby - ey * vbx ) / kross;
+		auto t = ( ex * vay - ey * vax ) / kross;
+		if( s < 0 || s > 1 || t < 0 || t > 1 )
+		{
+// no intersection, unless an endpoint lies on the other segment (up to rounding errors)
+			if( sqDistPtSeg( a1x, a1y, b1x, b1y, b2x, b2y ) <= thres )
+				out = { a1x, a1y, 0., 0. };
+			else if( sqDistPtSeg( a2x, a2y, b1x, b1y, b2x, b2y ) <= thres )
+				out = { a2x, a2y, 0., 0. };
+			else if( sqDistPtSeg( b1x, b1y, a1x, a1y, a2x, a2y ) <= thres )
+				out = { b1x, b1y, 0., 0. };
+			else if( sqDistPtSeg( b2x, b2y, a1x, a1y, a2x, a2y ) <= thres )
+				out = { b2x, b2y, 0., 0. };
+			else
+				return 0;
+			return 1;
+		}
+		if( s == 0 || s == 1 || ( t != 0 && t != 1 ) ) // intersection is not an endpoint of b
+		{
+			out[0] = a1x + s * vax;
+			out[1] = a1y + s * vay;
+		}
+		else
+		{
+			out[0] = b1x + t * vbx;
+			out[1] = b1y + t * vby;
+		}
+// snap to an endpoint if close enough, to avoid creating tiny segments because of rounding errors
+		for( auto pt: { std::make_pair(a1x,a1y), std::make_pair(a2x,a2y), std::make_pair(b1x,b1y), std::make_pair(b2x,b2y) } )
+		{
+			auto dx = out[0] - pt.first;
+			auto dy = out[1] - pt.second;
+			if( dx*dx + dy*dy <= thres )
+			{
+				out[0] = pt.first;
+				out[1] = pt.second;
+				break;
+			}
+		}
+		return 1;
+	}
+	if( ex * vay - ey * vax != 0 )               // parallel, not collinear
+		return 0;
 
-	for( auto pt: input_set )
-		if( pt.isInside( prim ) )
-			out.push_back( pt );
-	return out;
+	auto sqLenA = vax * vax + vay * vay;
+	auto sa = ( vax * ex + vay * ey ) / sqLenA;
+	auto sb = sa + ( vax * vbx + vay * vby ) / sqLenA;
+	auto smin = std::min( sa, sb );
+	auto smax = std::max( sa, sb );
+	if( smin > 1 || smax < 0 )
+		return 0;
+	if( smin == 1 || smax == 0 )
+	{
+		auto s = ( smin == 1 ? static_cast<HOMOG2D_INUMTYPE>(1) : static_cast<HOMOG2D_INUMTYPE>(0) );
+		out[0] = a1x + s * vax;
+		out[1] = a1y + s * vay;
+		return 1;
+	}
+	smin = std::max( smin, static_cast<HOMOG2D_INUMTYPE>(0) );
+	smax = std::min( smax, static_cast<HOMOG2D_INUMTYPE>(1) );
+	out[0] = a1x + smin * vax;
+	out[1] = a1y + smin * vay;
+	out[2] = a1x + smax * vax;
+	out[3] = a1y + smax * vay;
+	return 2;
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// SECTION  - GENERIC DRAWING FREE FUNCTIONS (BACK-END INDEPENDENT)
-/////////////////////////////////////////////////////////////////////////////
+//------------------------------------------------------------------
+/// Output contour of Sweeper
+struct Contour
+{
+	std::vector<HOMOG2D_INUMTYPE> _vx, _vy;
+	int    _holeOf = -1;
+	size_t _depth  = 0;
+};
 
 //------------------------------------------------------------------
-/// Free function, draws any of the primitives by calling the relevant member function
+/// Sweep line algorithm for boolean operations between polygons
 /**
-\todo 20240504: see note on the IsDrawable trait class
+Algorithm from F. Martinez, C. Ogayar, J.R. Jimenez, A.J. Rueda,
+"A simple algorithm for Boolean operations on polygons", Advances in Engineering Software, 2013.
+
+- all the segment endpoints are stored in a priority queue (the events), processed from left to right
+- the sweep line holds the segments crossing the current abscissa, ordered from bottom to top
+- when a segment gets inserted, it is checked for intersection with its neighbours, which are then
+subdivided if needed, and it is labeled as being part of the result or not, depending on the closest segment below
+- when all the events are processed, the segments that are part of the result are connected to build the contours.
+
+Complexity: O((n+k).log(n)), with \c k the number of intersections.
 */
-template<
-	typename U,
-	typename Prim,
-	typename std::enable_if<
-		trait::IsDrawable<Prim>::value,
-		Prim
-	>::type* = nullptr
->
-void
-draw( img::Image<U>& img, const Prim& prim, const img::DrawParams& dp=img::DrawParams() )
+class Sweeper
 {
-	prim.draw( img, dp );
-}
+private:
+	std::deque<SweepEvent> _events;
+	std::priority_queue<SweepEvent*,std::vector<SweepEvent*>,EventComp> _queue;
+	BoolOp   _op;
+	FillRule _fillRule;
+	std::array<HOMOG2D_INUMTYPE,2> _maxX;   ///< maximum x value of subject and clipping polygons
+	const SweepEvent* _current = nullptr;   ///< event being processed
+	bool _splitAtCurrent = false;           ///< a segment has been split at the point of current event
 
-/// Free function, draws text \c str at position \c pt
-template<typename U,typename FPT>
-void
-drawText( img::Image<U>& im, std::string str, Point2d_<FPT> pt, img::DrawParams dp=img::DrawParams() )
-{
-	im.drawText( str, pt, dp );
-}
+public:
+/// Constructor. With FillRule::Positive, \c op is not used and only the subject polygon is considered
+	explicit Sweeper( BoolOp op, FillRule fillRule=FillRule::EvenOdd ) : _op(op), _fillRule(fillRule)
+	{
+		_maxX.fill( -std::numeric_limits<HOMOG2D_INUMTYPE>::max() );
+		if( _fillRule == FillRule::Positive )
+			_op = BoolOp::Union;
+	}
 
-namespace priv {
+	template<typename FPT>
+	void addPolygon( const std::vector<Point2d_<FPT>>& pts, bool isSubject, size_t contourId )
+	{
+		const auto n = pts.size();
+		for( size_t i=0; i<n; i++ )
+		{
+			const auto& p1 = pts[i];
+			const auto& p2 = pts[ (i+1)%n ];
+			p_addEdge( p1.getX(), p1.getY(), p2.getX(), p2.getY(), isSubject, contourId );
+		}
+	}
 
-/// Draw indexes for points
-template<typename IMG,typename FPT>
-void
-impl_drawIndexes( img::Image<IMG>& img, size_t c, const img::DrawParams& dp, const Point2d_<FPT>& pt )
-{
-	if( dp._dpValues._showIndex )
-		drawText( img, std::to_string(c), pt, dp );
-}
+/// Add polygon given by its coordinates
+	void addPolygon( const Contour& cont, bool isSubject, size_t contourId )
+	{
+		const auto n = cont._vx.size();
+		for( size_t i=0; i<n; i++ )
+		{
+			auto j = (i+1)%n;
+			p_addEdge( cont._vx[i], cont._vy[i], cont._vx[j], cont._vy[j], isSubject, contourId );
+		}
+	}
 
-/// Draw indexes for segment
-template<typename IMG,typename FPT>
-void
-impl_drawIndexes( img::Image<IMG>& img, size_t c, const img::DrawParams& dp, const Segment_<FPT>& seg )
+	std::vector<Contour> compute()
+	{
+		return p_connectEdges( p_subdivide() );
+	}
+
+private:
+	SweepEvent* p_newEvent( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y, bool left, SweepEvent* other, bool isSubject )
+	{
+		_events.emplace_back( x, y, left, other, isSubject, _events.size() );
+		return &_events.back();
+	}
+
+	void p_addEdge(
+		HOMOG2D_INUMTYPE x1, HOMOG2D_INUMTYPE y1,
+		HOMOG2D_INUMTYPE x2, HOMOG2D_INUMTYPE y2,
+		bool isSubject, size_t contourId
+	)
+	{
+		if( x1 == x2 && y1 == y2 )
+			return;
+		auto e1 = p_newEvent( x1, y1, false, nullptr, isSubject );
+		auto e2 = p_newEvent( x2, y2, false, e1, isSubject );
+		e1->_other = e2;
+		e1->_contourId = e2->_contourId = contourId;
+		if( EventComp()( e1, e2 ) )
+			e2->_left = true;
+		else
+			e1->_left = true;
+		e1->_windDelta = e2->_windDelta = ( e1->_left ? +1 : -1 );
+		_queue.push( e1 );
+		_queue.push( e2 );
+		_maxX[isSubject?0:1] = std::max( _maxX[isSubject?0:1], std::max( x1, x2 ) );
+	}
+
+	std::vector<SweepEvent*> p_subdivide();
+	std::vector<Contour>     p_connectEdges( const std::vector<SweepEvent*>& );
+	void p_computeFields( SweepEvent*, const SweepEvent* ) const;
+	bool p_inResult( const SweepEvent* ) const;
+	int  p_possibleIntersection( SweepEvent*, SweepEvent* );
+	void p_divideSegment( SweepEvent*, HOMOG2D_INUMTYPE, HOMOG2D_INUMTYPE );
+};
+
+//------------------------------------------------------------------
+/// Process all the events, returns them in the processing order
+inline
+std::vector<SweepEvent*>
+Sweeper::p_subdivide()
 {
-	if( dp._dpValues._showIndex )
-		drawText( img, std::to_string(c), seg.getCenter(), dp );
-}
+	std::vector<SweepEvent*> sorted;
+	SweepLine sl;
+	const auto rightBound = std::min( _maxX[0], _maxX[1] );
 
-/// Default signature, will be instanciated if no other fits (and does nothing)
-template<typename IMG,typename DUMMY>
-void
-impl_drawIndexes( img::Image<IMG>&, size_t, const img::DrawParams&, const DUMMY& )
-{}
+	while( !_queue.empty() )
+	{
+		auto ev = _queue.top();
+		_queue.pop();
+		sorted.push_back( ev );
 
-} // namespace priv
+		if(                                     // nothing more can be in the result
+			( _op == BoolOp::Intersection && ev->_x > rightBound )
+			|| ( _op == BoolOp::Difference && ev->_x > _maxX[0] )
+		)
+			break;
 
-/// Free function, draws a set of primitives
-/**
-- Type \c T can be \c std::array<type> or \c std::vector<type>, with \c type being anything drawable.
-- The types inside the container can be either plain \c h2d types (\c FRect, \c Segment, ...) of variant types,
-using the \c CommonType class (requires HOMOG2D_ENABLE_VRTP symbol).
+		if( ev->_left )
+		{
+			_current = ev;
+			_splitAtCurrent = false;
+			auto res = sl.insert( ev );
+			auto it = res.first;
+			ev->_inSL  = res.second;
+			ev->_posSL = it;
+			SweepEvent* prev = ( it == sl.begin() ? nullptr : *std::prev(it) );
+			auto itNext = std::next( it );
+			SweepEvent* next = ( itNext == sl.end() ? nullptr : *itNext );
+
+			p_computeFields( ev, prev );
+			if( next && p_possibleIntersection( ev, next ) == 2 )
+			{
+				p_computeFields( ev, prev );
+				p_computeFields( next, ev );
+			}
+			if( prev && p_possibleIntersection( prev, ev ) == 2 )
+			{
+				auto itPrev = prev->_posSL;
+				SweepEvent* prevprev = ( itPrev == sl.begin() ? nullptr : *std::prev(itPrev) );
+				p_computeFields( prev, prevprev );
+				p_computeFields( ev, prev );
+			}
+			if( _splitAtCurrent && ev->_inSL )
+			{
+// a neighbour segment has been split at the left point of the event, so the fields of the event
+// were computed from a segment that ends here: postpone it after the right event of that segment
+				sl.erase( ev->_posSL );
+				ev->_inSL = false;
+				sorted.pop_back();
+				_queue.push( ev );
+			}
+		}
+		else
+		{
+			auto le = ev->_other;
+			if( le->_inSL )
+			{
+				auto it = le->_posSL;
+				SweepEvent* prev = ( it == sl.begin() ? nullptr : *std::prev(it) );
+				auto itNext = std::next( it );
+				SweepEvent* next = ( itNext == sl.end() ? nullptr : *itNext );
+				sl.erase( it );
+				le->_inSL = false;
+				if( prev && next )
+					p_possibleIntersection( prev, next );
+			}
+		}
+	}
+	return sorted;
+}
 
-\ingroup varff
-*/
-template<
-	typename U,
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
+//------------------------------------------------------------------
+/// Returns true if the segment of left event \c ev is part of the result
+inline
+bool
+Sweeper::p_inResult( const SweepEvent* ev ) const
+{
+	if( _fillRule == FillRule::Positive )
+		return ev->inResult();
+	switch( ev->_type )
+	{
+		case EdgeType::Normal:
+			switch( _op )
+			{
+				case BoolOp::Intersection: return !ev->_otherInOut;
+				case BoolOp::Union:        return ev->_otherInOut;
+				case BoolOp::Difference:   return ev->_isSubject == ev->_otherInOut;
+				case BoolOp::Xor:          return true;
+			}
+		break;
+		case EdgeType::SameTransition:
+			return _op == BoolOp::Intersection || _op == BoolOp::Union;
+		case EdgeType::DifferentTransition:
+			return _op == BoolOp::Difference;
+		case EdgeType::NonContributing:
+			return false;
+	}
+	return false;
+}
+
+//------------------------------------------------------------------
+/// Computes the flags of left event \c ev, given the closest segment below (\c prev, may be null)
+inline
 void
-draw( img::Image<U>& img, const T& cont, const img::DrawParams& dp=img::DrawParams() )
+Sweeper::p_computeFields( SweepEvent* ev, const SweepEvent* prev ) const
 {
-#ifdef HOMOG2D_ENABLE_VRTP
-	if constexpr( trait::IsVariant<typename T::value_type>::value )
+	if( _fillRule == FillRule::Positive )
 	{
-		fct::DrawFunct vde( img, dp ); // functor
-		for( auto& e: cont )
-			std::visit( vde, e );
+		ev->_windBelow = ( prev ? prev->_windBelow + prev->_windDelta : 0 );
+		ev->_prevInResult = nullptr;
+		if( prev )
+			ev->_prevInResult = ( ( !prev->inResult() || prev->isVertical() ) ? prev->_prevInResult : const_cast<SweepEvent*>(prev) );
+		bool inBelow = ev->_windBelow > 0;
+		bool inAbove = ev->_windBelow + ev->_windDelta > 0;
+		ev->_resultTransition = ( inBelow == inAbove ? 0 : ( inAbove ? 1 : -1 ) );
+		return;
+	}
+
+	if( !prev )
+	{
+		ev->_inOut        = false;
+		ev->_otherInOut   = true;
+		ev->_prevInResult = nullptr;
 	}
 	else
-#endif
 	{
-		size_t c=0;
-		for( const auto& elem: cont )
+		if( ev->_isSubject == prev->_isSubject )
 		{
-			elem.draw( img, dp );
-			priv::impl_drawIndexes( img, c++, dp, elem );
+			ev->_inOut      = !prev->_inOut;
+			ev->_otherInOut = prev->_otherInOut;
 		}
+		else
+		{
+			ev->_inOut      = !prev->_otherInOut;
+			ev->_otherInOut = ( prev->isVertical() ? !prev->_inOut : prev->_inOut );
+		}
+		ev->_prevInResult = ( ( !p_inResult( prev ) || prev->isVertical() ) ? prev->_prevInResult : const_cast<SweepEvent*>(prev) );
+	}
+
+	ev->_resultTransition = 0;
+	if( p_inResult( ev ) )
+	{
+		bool thisIn = !ev->_inOut;
+		bool thatIn = !ev->_otherInOut;
+		bool isIn = false;
+		switch( _op )
+		{
+			case BoolOp::Intersection: isIn = thisIn && thatIn; break;
+			case BoolOp::Union:        isIn = thisIn || thatIn; break;
+			case BoolOp::Xor:          isIn = thisIn != thatIn; break;
+			case BoolOp::Difference:
+				isIn = ( ev->_isSubject ? thisIn && !thatIn : thatIn && !thisIn );
+			break;
+		}
+		ev->_resultTransition = ( isIn ? 1 : -1 );
 	}
 }
 
-/// This version holds a \c std::function as 3th parameter. It can be used to pass a function
-/// that will return a different img::DrawParams for a given index of the container.
-/**
-At present, cannot be used with container holding variants...
-*/
-template<
-	typename U,
-	typename T,
-	typename std::enable_if<
-		trait::IsContainer<T>::value,
-		T
-	>::type* = nullptr
->
+//------------------------------------------------------------------
+/// Splits the segment of left event \c se at point (x,y)
+inline
 void
-draw( img::Image<U>& img, const T& cont, std::function<img::DrawParams(int)>& func )
+Sweeper::p_divideSegment( SweepEvent* se, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
 {
-	size_t c=0;
-	for( const auto& elem: cont )
+	if( _current && x == _current->_x && y == _current->_y )
+		_splitAtCurrent = true;
+	auto r = p_newEvent( x, y, false, se, se->_isSubject );
+	auto l = p_newEvent( x, y, true, se->_other, se->_isSubject );
+	r->_contourId = l->_contourId = se->_contourId;
+	r->_windDelta = l->_windDelta = se->_windDelta;
+	if( EventComp()( l, se->_other ) )    // avoid a rounding error: left event would be processed after right one
 	{
-		auto dp = func(c);
-		elem.draw( img, dp );
-		priv::impl_drawIndexes( img, c++, dp, elem );
+		se->_other->_left = true;
+		l->_left = false;
 	}
+	se->_other->_other = l;
+	se->_other = r;
+	_queue.push( l );
+	_queue.push( r );
 }
 
 //------------------------------------------------------------------
-/// Free function, draws a pair of objects
+/// Checks the intersection of the segments of left events \c se1 and \c se2, and subdivides them if needed.
 /**
-Type \c T1 and \c T2 can be anything drawable
+Returns 2 if the segments overlap from the same left endpoint (then the flags need to be recomputed)
 */
-template<typename T1,typename T2,typename U>
-void draw(
-	img::Image<U>&          img,
-	const std::pair<T1,T2>& pa,
-	const img::DrawParams&  dp=img::DrawParams() )
+inline
+int
+Sweeper::p_possibleIntersection( SweepEvent* se1, SweepEvent* se2 )
 {
-	pa.first.draw(  img, dp );
-	pa.second.draw( img, dp );
-}
+	std::array<HOMOG2D_INUMTYPE,4> inter;
+	auto nb = intersectSegs(
+		se1->_x, se1->_y, se1->_other->_x, se1->_other->_y,
+		se2->_x, se2->_y, se2->_other->_x, se2->_other->_y,
+		inter
+	);
+	if( nb == 0 )
+		return 0;
+	if( nb == 1 && ( se1->samePoint( se2 ) || se1->_other->samePoint( se2->_other ) ) )
+		return 0;                                   // intersect at an endpoint of both segments
+	if( nb == 2 && se1->_isSubject == se2->_isSubject && _fillRule == FillRule::EvenOdd )
+		return 0;                                   // overlapping edges of the same polygon
 
-namespace detail {
+	auto isEndpoint = []( const SweepEvent* se, HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )
+	{
+		return ( se->_x == x && se->_y == y ) || ( se->_other->_x == x && se->_other->_y == y );
+	};
+	if( nb == 1 )
+	{
+		if( !isEndpoint( se1, inter[0], inter[1] ) )
+			p_divideSegment( se1, inter[0], inter[1] );
+		if( !isEndpoint( se2, inter[0], inter[1] ) )
+			p_divideSegment( se2, inter[0], inter[1] );
+		return 1;
+	}
 
-/// Private helper function, used by LPBase<IsPoint>::draw(). Draw point on image.
-template<typename T>
-void
-drawPt(
-	img::Image<T>&               img,
-	img::PtStyle                 ps,
-	std::vector<Point2d_<float>> vpt,
-	const img::DrawParams&       dp,
-	bool                         drawDiag=false
-)
-{
-	auto delta  = dp._dpValues._ptDelta;
-	auto delta2 = std::round( 0.7 * delta);
-	switch( ps )
+// the segments overlap
+	std::vector<SweepEvent*> events;
+	bool leftCoincide  = se1->samePoint( se2 );
+	bool rightCoincide = se1->_other->samePoint( se2->_other );
+	if( !leftCoincide )
 	{
-		case img::PtStyle::Times:
-		case img::PtStyle::Squ:
-			vpt[0].translate( -delta2, +delta2 );
-			vpt[1].translate( +delta2, -delta2 );
-			vpt[2].translate( +delta2, +delta2 );
-			vpt[3].translate( -delta2, -delta2 );
-		break;
+		if( EventComp()( se1, se2 ) )
+			events.insert( events.end(), { se2, se1 } );
+		else
+			events.insert( events.end(), { se1, se2 } );
+	}
+	if( !rightCoincide )
+	{
+		if( EventComp()( se1->_other, se2->_other ) )
+			events.insert( events.end(), { se2->_other, se1->_other } );
+		else
+			events.insert( events.end(), { se1->_other, se2->_other } );
+	}
 
-		case img::PtStyle::Plus:
-		case img::PtStyle::Diam:
-			vpt[0].translate( -delta, 0.      );
-			vpt[1].translate( +delta, 0.      );
-			vpt[2].translate( 0.,      -delta );
-			vpt[3].translate( 0.,      +delta );
-		break;
-		default: assert(0);
+	if( leftCoincide )                            // equal segments, or sharing left endpoint
+	{
+		se2->_type = EdgeType::NonContributing;
+		se1->_type = ( se2->_inOut == se1->_inOut ? EdgeType::SameTransition : EdgeType::DifferentTransition );
+		if( !rightCoincide )
+			p_divideSegment( events[1]->_other, events[0]->_x, events[0]->_y );
+		if( _fillRule == FillRule::Positive )   // the first segment now holds the winding of both
+		{
+			se1->_windDelta += se2->_windDelta;
+			se1->_other->_windDelta = se1->_windDelta;
+			se2->_windDelta = se2->_other->_windDelta = 0;
+		}
+		return 2;
 	}
-	auto dp2(dp);          // we need to do this, because this is called by the
-	dp2.showPoints(false); //  segment drawing function. If not, infinite recursion
-	if( !drawDiag )
+	if( rightCoincide )                           // sharing right endpoint
+	{
+		p_divideSegment( events[0], events[1]->_x, events[1]->_y );
+		return 3;
+	}
+	if( events[0] != events[3]->_other )          // no segment includes the other one
+	{
+		p_divideSegment( events[0], events[1]->_x, events[1]->_y );
+		p_divideSegment( events[1], events[2]->_x, events[2]->_y );
+		return 3;
+	}
+	p_divideSegment( events[0], events[1]->_x, events[1]->_y ); // one segment includes the other
+	p_divideSegment( events[3]->_other, events[2]->_x, events[2]->_y );
+	return 3;
+}
+
+//------------------------------------------------------------------
+/// Connects the segments that are part of the result to build the output contours
+inline
+std::vector<Contour>
+Sweeper::p_connectEdges( const std::vector<SweepEvent*>& sorted )
+{
+	std::vector<SweepEvent*> res;
+	for( auto ev: sorted )
+		if( ( ev->_left && ev->inResult() ) || ( !ev->_left && ev->_other->inResult() ) )
+			res.push_back( ev );
+
+// due to overlapping edges, the events can be not wholly sorted
+// (EventComp is a total order, as ties are resolved with the event id)
+	std::sort(
+		res.begin(),
+		res.end(),
+		[]                      // lambda
+		( const SweepEvent* e1, const SweepEvent* e2 )
+		{
+			return EventComp()( e2, e1 );
+		}
+	);
+
+	for( size_t i=0; i<res.size(); i++ )
+		res[i]->_otherPos = i;
+	for( auto ev: res )         // swap positions, so that each event knows the position of its other endpoint
+		if( !ev->_left )
+			std::swap( ev->_otherPos, ev->_other->_otherPos );
+
+	const long nbEv = static_cast<long>( res.size() );
+
+// Returns the position of the next event of the contour, among the unprocessed events at the same point as event \c pos
+// (plus the starting event, to close the contour).
+// If there are several, the first segment counterclockwise from the incoming one is chosen, so that contours never cross.
+	auto nextPos = [&res,nbEv]               // lambda
+		( long pos, const std::vector<bool>& processed, long origPos )
+	{
+		const auto* ev = res[pos];
+		long first = pos;
+		while( first > 0 && res[first-1]->samePoint( ev ) )
+			first--;
+
+		const auto rx = ev->_other->_x - ev->_x;     // reversed incoming direction
+		const auto ry = ev->_other->_y - ev->_y;
+		long best = -1;
+		HOMOG2D_INUMTYPE bestAngle = 0.;
+		for( long j=first; j<nbEv && res[j]->samePoint( ev ); j++ )
+		{
+			if( processed[j] && j != origPos )
+				continue;
+			const auto dx = res[j]->_other->_x - ev->_x;
+			const auto dy = res[j]->_other->_y - ev->_y;
+			auto angle = std::atan2( rx*dy - ry*dx, rx*dx + ry*dy );
+			if( angle <= 0 )
+				angle += 2. * M_PI;
+			if( best == -1 || angle < bestAngle )
+			{
+				best = j;
+				bestAngle = angle;
+			}
+		}
+		return best;
+	};
+
+	std::vector<bool> processed( res.size(), false );
+	std::vector<Contour> contours;
+	for( long i=0; i<nbEv; i++ )
 	{
-		if( ps == img::PtStyle::Squ )
+		if( processed[i] )
+			continue;
+
+		const auto contourId = contours.size();
+		Contour contour;
+		auto prevInRes = res[i]->_prevInResult;
+		if( prevInRes && prevInRes->_outputContourId < contours.size() )  // is the new contour a hole ?
 		{
-			std::vector<Segment_<float>> vseg{
-				{vpt[0], vpt[1]},
-				{vpt[2], vpt[1]},
-				{vpt[2], vpt[3]},
-				{vpt[0], vpt[3]}
-			};
-			for( const auto& s:vseg )
-				s.draw( img, dp2 );
+			const auto& lower = contours[prevInRes->_outputContourId];
+			if( prevInRes->_resultTransition > 0 )          // inside result
+			{
+				if( lower._holeOf != -1 )                 // lower contour is a hole: same parent
+				{
+					contour._holeOf = lower._holeOf;
+					contour._depth  = lower._depth;
+				}
+				else                                        // lower contour is an outer one
+				{
+					contour._holeOf = static_cast<int>( prevInRes->_outputContourId );
+					contour._depth  = lower._depth + 1;
+				}
+			}
+			else
+				contour._depth = lower._depth;
 		}
-		else
+
+		auto markAsProcessed = [&]( long pos )        // lambda
 		{
-			Segment_<float> s1( vpt[0], vpt[1] );
-			Segment_<float> s2( vpt[2], vpt[3] );
-			s1.draw( img, dp2 );
-			s2.draw( img, dp2 );
+			processed[pos] = true;
+			res[pos]->_outputContourId = contourId;
+		};
+
+		long pos = i;
+		contour._vx.push_back( res[i]->_x );
+		contour._vy.push_back( res[i]->_y );
+		for(;;)
+		{
+			markAsProcessed( pos );
+			pos = static_cast<long>( res[pos]->_otherPos );
+			markAsProcessed( pos );
+			contour._vx.push_back( res[pos]->_x );
+			contour._vy.push_back( res[pos]->_y );
+			pos = nextPos( pos, processed, i );
+			if( pos == i || pos < 0 || pos >= nbEv )
+				break;
 		}
+		contours.push_back( std::move(contour) );
 	}
-	else // draw 4 diagonal lines
-	{
-		Segment_<float>( vpt[0], vpt[2] ).draw( img, dp2 );
-		Segment_<float>( vpt[2], vpt[1] ).draw( img, dp2 );
-		Segment_<float>( vpt[1], vpt[3] ).draw( img, dp2 );
-		Segment_<float>( vpt[0], vpt[3] ).draw( img, dp2 );
-	}
+	return contours;
 }
 
-} // namespace detail
-
 //------------------------------------------------------------------
-namespace priv {
-/// Holds convex hull code
-namespace chull {
+/// Removes from a contour the duplicate points, and the points that are aligned with their neighbours
+inline
+void
+cleanContour( Contour& c )
+{
+	auto& vx = c._vx;
+	auto& vy = c._vy;
+	const auto thres = thr::nullDistance() * thr::nullDistance();
+	std::vector<HOMOG2D_INUMTYPE> ox, oy;
+	ox.reserve( vx.size() );
+	oy.reserve( vy.size() );
+	for( size_t i=0; i<vx.size(); i++ )
+	{
+		if( !ox.empty() && ox.back() == vx[i] && oy.back() == vy[i] )
+			continue;
+		while(
+			ox.size() >= 2
+			&& sqDistPtSeg( ox.back(), oy.back(), ox[ox.size()-2], oy[oy.size()-2], vx[i], vy[i] ) <= thres
+		)
+		{
+			ox.pop_back();
+			oy.pop_back();
+		}
+		ox.push_back( vx[i] );
+		oy.push_back( vy[i] );
+	}
+	if( ox.size() > 1 && ox.back() == ox.front() && oy.back() == oy.front() )   // closing point
+	{
+		ox.pop_back();
+		oy.pop_back();
+	}
+	bool done = false;                              // remove aligned points at wrap-around
+	while( !done && ox.size() >= 3 )
+	{
+		done = true;
+		auto n = ox.size();
+		if( sqDistPtSeg( ox[n-1], oy[n-1], ox[n-2], oy[n-2], ox[0], oy[0] ) <= thres )
+		{
+			ox.pop_back();
+			oy.pop_back();
+			done = false;
+		}
+		else if( sqDistPtSeg( ox[0], oy[0], ox[n-1], oy[n-1], ox[1], oy[1] ) <= thres )
+		{
+			ox.erase( ox.begin() );
+			oy.erase( oy.begin() );
+			done = false;
+		}
+	}
+	std::swap( vx, ox );
+	std::swap( vy, oy );
+}
 
 //------------------------------------------------------------------
-/// Used int the convex hull algorithm
+/// Builds a BoolOpResult_ object from the output of Sweeper, removing the contours that get degenerate
+/**
+The holes of a removed outer contour are removed too: they lie inside a contour that has a null area,
+and keeping them would turn them into outer contours, thus reversing their fill.
+(The outer contour of a hole is always built before it, so its new index is known.)
+*/
 template<typename FPT>
-size_t
-getPivotPoint( const std::vector<Point2d_<FPT>>& in )
-{
-	auto pmin = h2d::priv::getBmPoint_helper( in );
-	return static_cast<size_t>( pmin - in.begin() );
-}
+BoolOpResult_<FPT>
+buildResult( std::vector<Contour>&& contours )
+{
+	std::vector<CPolyline_<FPT>> vout;
+	std::vector<int> holeOf;
+	std::vector<int> newIdx( contours.size(), -1 );
+	for( size_t i=0; i<contours.size(); i++ )
+	{
+		auto& c = contours[i];
+		assert( c._holeOf < static_cast<int>( i ) );
+		if( c._holeOf != -1 && newIdx[c._holeOf] == -1 )   // outer contour was removed
+			continue;
+		cleanContour( c );
+		if( c._vx.size() < 3 )
+			continue;
+		std::vector<Point2d_<FPT>> vpts;
+		vpts.reserve( c._vx.size() );
+		for( size_t j=0; j<c._vx.size(); j++ )
+			vpts.emplace_back( c._vx[j], c._vy[j] );
+		newIdx[i] = static_cast<int>( vout.size() );
+		vout.emplace_back( vpts );
+		holeOf.push_back( c._holeOf == -1 ? -1 : newIdx[c._holeOf] );
+	}
+	return BoolOpResult_<FPT>( std::move(vout), std::move(holeOf) );
+}
+
+} // namespace boolop
+} // namespace priv
 
 //------------------------------------------------------------------
-/// Sorts points by angle between the lines with horizontal axis
-template<typename FPT>
-std::vector<size_t>
-sortPoints( const std::vector<Point2d_<FPT>>& in, size_t piv_idx )
-{
-	assert( in.size()>3 );
+/// Boolean operation (union, intersection, difference, exclusive or) between two polygons (free function)
+/**
+- the polygons can be non-convex, and even non-simple (then, the even-odd rule is used)
+- the result can be made of several polygons, with holes, see BoolOpResult_
+- for \c BoolOp::Difference, the result is <code>subject - clip</code>
+- sweep line algorithm by F. Martinez et al., complexity: O((n+k).log(n)), with \c n the total number of points,
+and \c k the number of intersections between segments
 
-// step 1: create new vector holding the indexes of the points, including the pivot point (will be in first position)
-	std::vector<size_t> out( in.size() );
-	std::iota( out.begin(), out.end(), 0 ); // fill vector: [0,1,2,...]
-	std::swap( out[piv_idx], out[0] );
-	auto pt0 = in[piv_idx];
+Points of the output polygons that are aligned with their neighbours are removed.
 
-// step 2: sort points by angle of lines between the current point and pivot point
-	std::sort(
-		out.begin()+1,
-		out.end(),
-		[&]                  // lambda
-		( size_t i1, size_t i2 )
+\warning With non-simple input polygons having overlapping edges (or a vertex lying on another edge of the same polygon),
+the result may be wrong.
+
+\sa FRect_::unionArea()
+\sa FRect_::intersectArea()
+*/
+template<typename FPT1,typename FPT2>
+BoolOpResult_<FPT1>
+booleanOp( const CPolyline_<FPT1>& subject, const CPolyline_<FPT2>& clip, BoolOp op )
+{
+	std::vector<CPolyline_<FPT1>> vout;
+	std::vector<int> holeOf;
+
+	if( subject.size() < 3 || clip.size() < 3 )    // trivial cases
+	{
+		auto add = [&]( const auto& poly )        // lambda
 		{
-			auto pt1 = in[i1];
-			auto pt2 = in[i2];
-			auto dx1 = pt1.getX() - pt0.getX();
-			auto dy1 = pt1.getY() - pt0.getY();
-			auto dx2 = pt2.getX() - pt0.getX();
-			auto dy2 = pt2.getY() - pt0.getY();
-			return ((dx1 * dy2 - dx2 * dy1) > 0);
-		}
-	);
-	return out;
+			if( poly.size() >= 3 )
+			{
+				vout.emplace_back( poly );
+				holeOf.push_back( -1 );
+			}
+		};
+		if( op != BoolOp::Intersection )
+			add( subject );
+		if( op == BoolOp::Union || op == BoolOp::Xor )
+			add( clip );
+		return BoolOpResult_<FPT1>( std::move(vout), std::move(holeOf) );
+	}
+
+	priv::boolop::Sweeper sweeper( op );
+	sweeper.addPolygon( subject.getPts(), true, 0 );
+	sweeper.addPolygon( clip.getPts(), false, 1 );
+	return priv::boolop::buildResult<FPT1>( sweeper.compute() );
 }
 
-//------------------------------------------------------------------
-/// To find orientation of ordered triplet of points (p, q, r).
-/** The function returns following values
-- 0 --> p, q and r are colinear
-- 1 --> Clockwise
-- 2 --> Counterclockwise
+/////////////////////////////////////////////////////////////////////////////
+// SECTION  - POLYGON OFFSET
+/////////////////////////////////////////////////////////////////////////////
 
-\todo 20240326: this is subject to numerical instability, as it is based on differences.
+namespace priv {
+namespace offset {
+
+//------------------------------------------------------------------
+/// Builds the raw offset curve of a polygon, that may self-intersect
+/**
+- input coordinates must be in CCW order, without repeated consecutive points
+- \c dist>0: outside, \c dist<0: inside
 
-\todo 20230212: replace const value HOMOG2D_THR_ZERO_DETER with related static function
+On the corners where the two offsetted edges overlap, the intersection point of the two offsetted edges is used
+if it lies on the first half of both edges.
+Otherwise, if \c params._cleanup is true, the curve goes through the source point, so that the spurious loops
+get a null winding number and are removed by the positive fill rule.
 */
-template<typename T>
-int orientation( Point2d_<T> p, Point2d_<T> q, Point2d_<T> r )
+inline
+boolop::Contour
+buildRawCurve(
+	const std::vector<HOMOG2D_INUMTYPE>& vx,
+	const std::vector<HOMOG2D_INUMTYPE>& vy,
+	HOMOG2D_INUMTYPE                     dist,
+	const OffsetPolyParams&              params
+)
 {
-	HOMOG2D_INUMTYPE px = p.getX();
-	HOMOG2D_INUMTYPE py = p.getY();
-	HOMOG2D_INUMTYPE qx = q.getX();
-	HOMOG2D_INUMTYPE qy = q.getY();
-	HOMOG2D_INUMTYPE rx = r.getX();
-	HOMOG2D_INUMTYPE ry = r.getY();
+	const auto n = vx.size();
+	std::vector<HOMOG2D_INUMTYPE> nx( n ), ny( n );        // unit outward normals of edges
+	std::vector<HOMOG2D_INUMTYPE> len( n );
+	for( size_t i=0; i<n; i++ )
+	{
+		auto j = (i+1)%n;
+		auto dx = vx[j] - vx[i];
+		auto dy = vy[j] - vy[i];
+		len[i] = homog2d_sqrt( dx*dx + dy*dy );
+		nx[i] =  dy / len[i];
+		ny[i] = -dx / len[i];
+	}
+
+	auto join = params._join;
+	if( params._angleSplit && join == OffsetJoin::Miter )
+		join = OffsetJoin::Square;
+	auto arcStep = ( params._arcStep > 0. ? params._arcStep : M_PI/16. );
+
+	boolop::Contour out;
+	auto add = [&out]( HOMOG2D_INUMTYPE x, HOMOG2D_INUMTYPE y )     // lambda
+	{
+		if( out._vx.empty() || x != out._vx.back() || y != out._vy.back() )
+		{
+			out._vx.push_back( x );
+			out._vy.push_back( y );
+		}
+	};
 
-	auto val = (qy - py) * (rx - qx) - (qx - px) * (ry - qy);
+	for( size_t i=0; i<n; i++ )
+	{
+		auto ip = (i+n-1)%n;
+		const auto px = vx[i];
+		const auto py = vy[i];
+		const auto ax = nx[ip] * dist;        // offset vector of previous edge
+		const auto ay = ny[ip] * dist;
+		const auto bx = nx[i] * dist;         // offset vector of next edge
+		const auto by = ny[i] * dist;
+		const auto cross = nx[ip]*ny[i] - ny[ip]*nx[i];    // >0 on convex corners
+		const auto dot   = nx[ip]*nx[i] + ny[ip]*ny[i];
+
+		if( homog2d_abs(cross) < thr::nullDistance() && dot > 0. )  // aligned edges
+		{
+			add( px+ax, py+ay );
+			continue;
+		}
+		if( cross * dist < 0. )                // offsetted edges overlap
+		{
+			if( 1.+dot > thr::nullDistance() )
+			{
+// distance between the intersection point and the offsetted points, along the edges
+				auto trim = homog2d_abs( dist * cross / ( 1.+dot ) );
+				if( !params._cleanup || ( 2.*trim <= len[ip] && 2.*trim <= len[i] ) )
+				{
+					auto k = 1. / ( 1.+dot );
+					add( px + (ax+bx)*k, py + (ay+by)*k );
+					continue;
+				}
+			}
+			add( px+ax, py+ay );
+			add( px, py );
+			add( px+bx, py+by );
+			continue;
+		}
 
-	if( homog2d_abs(val) < HOMOG2D_THR_ZERO_DETER )
-		return 0;  // collinear
-    return (val > 0 ? 1 : -1 ); // clock or counterclock wise
+		auto j = join;                         // offsetted edges do not meet: add a join
+		if( 1.+dot < thr::nullDistance() )     // U-turn
+			j = ( join == OffsetJoin::Round ? OffsetJoin::Round : OffsetJoin::Bevel );
+		if( j == OffsetJoin::Miter && params._miterLimit > 0. )
+			if( homog2d_sqrt( 2./(1.+dot) ) > params._miterLimit )
+				j = OffsetJoin::Bevel;
+		switch( j )
+		{
+			case OffsetJoin::Miter:
+			{
+				auto k = 1. / ( 1.+dot );
+				add( px + (ax+bx)*k, py + (ay+by)*k );
+			}
+			break;
+			case OffsetJoin::Square:
+			{
+				auto ux = ax + bx;                           // bisector direction
+				auto uy = ay + by;
+				auto ulen = homog2d_sqrt( ux*ux + uy*uy );
+				ux /= ulen;
+				uy /= ulen;
+				auto cx = ux * homog2d_abs(dist);           // cut point, relative to source point
+				auto cy = uy * homog2d_abs(dist);
+				for( const auto& nv: { std::make_pair(ax,ay), std::make_pair(bx,by) } )
+				{
+					auto d2 = dist*dist;                     // intersection of cut line with offsetted edge
+					auto s = ( d2 - (cx*nv.first + cy*nv.second) ) / ( -uy*nv.first + ux*nv.second );
+					add( px + cx - uy*s, py + cy + ux*s );
+				}
+			}
+			break;
+			case OffsetJoin::Bevel:
+				add( px+ax, py+ay );
+				add( px+bx, py+by );
+			break;
+			case OffsetJoin::Round:
+			{
+				auto angle = std::atan2( ax*by - ay*bx, ax*bx + ay*by );
+				if( 1.+dot < thr::nullDistance() )      // U-turn: the arc goes around the source point
+					angle = ( dist > 0. ? M_PI : -M_PI );
+				auto nbSteps = std::max( 1, static_cast<int>( std::ceil( homog2d_abs(angle) / arcStep ) ) );
+				for( int k=0; k<=nbSteps; k++ )
+				{
+					auto a = angle * k / nbSteps;
+					auto ca = std::cos( a );
+					auto sa = std::sin( a );
+					add( px + ax*ca - ay*sa, py + ax*sa + ay*ca );
+				}
+			}
+			break;
+		}
+	}
+	if( out._vx.size() > 1 && out._vx.front() == out._vx.back() && out._vy.front() == out._vy.back() )
+	{
+		out._vx.pop_back();
+		out._vy.pop_back();
+	}
+	return out;
 }
+
 //------------------------------------------------------------------
-/// Inherits std::stack<> and adds a member function to fetch the underlying std::vector.
-/// Used in h2d::convexHull()
-struct Mystack : std::stack<size_t,std::vector<size_t>>
+/// Computes the offset of a simple polygon, see getOffsetPolys()
+template<typename FPT>
+BoolOpResult_<FPT>
+offsetPolygon( const std::vector<Point2d_<FPT>>& pts, bool isCCW, HOMOG2D_INUMTYPE dist, const OffsetPolyParams& params )
 {
-	const std::vector<size_t>& getVect() const
+	const auto n = pts.size();
+	std::vector<HOMOG2D_INUMTYPE> vx, vy;
+	vx.reserve( n );
+	vy.reserve( n );
+	for( size_t i=0; i<n; i++ )
 	{
-		return this->c;
+		const auto& pt = pts[ isCCW ? i : n-1-i ];
+		HOMOG2D_INUMTYPE x = pt.getX();
+		HOMOG2D_INUMTYPE y = pt.getY();
+		if( vx.empty() || x != vx.back() || y != vy.back() )
+		{
+			vx.push_back( x );
+			vy.push_back( y );
+		}
 	}
-};
-//------------------------------------------------------------------
-} // namespace chull
+	while( vx.size() > 1 && vx.front() == vx.back() && vy.front() == vy.back() )
+	{
+		vx.pop_back();
+		vy.pop_back();
+	}
+	if( vx.size() < 3 )
+		return BoolOpResult_<FPT>();
+
+	auto raw = buildRawCurve( vx, vy, dist, params );
+	if( !params._cleanup )
+	{
+		std::vector<boolop::Contour> vc( 1, std::move(raw) );
+		return boolop::buildResult<FPT>( std::move(vc) );
+	}
+	boolop::Sweeper sweeper( BoolOp::Union, boolop::FillRule::Positive );
+	sweeper.addPolygon( raw, true, 0 );
+	return boolop::buildResult<FPT>( sweeper.compute() );
+}
+
+} // namespace offset
 } // namespace priv
 
 //------------------------------------------------------------------
-/// Compute Convex Hull of a Polyline (free function)
+/// Returns the "offsetted" polygon of a simple polygon (free function)
 /**
-- type \c T: can be either OPolyline, CPolyline, or std::vector<Point2d>
-- Graham scan algorithm: https://en.wikipedia.org/wiki/Graham_scan
+- If dist>0, returns the region "outside" the source polygon, at a distance \c dist
+- If dist<0, returns the region "inside" the source polygon, at a distance \c -dist
+
+The result can be made of several polygons (for negative values), and can have holes (for positive values),
+so this returns a BoolOpResult_ object (empty if the inside offset "eats" the whole polygon).
+
+The corners are handled according to the \c _join member of \c params (see OffsetJoin).
+
+The raw offset curve is computed in linear time, then its self-intersections are removed with a sweep line
+(same algorithm as booleanOp(), but with the positive fill rule), so complexity is O((n+k).log(n)),
+with \c k the number of self-intersections of the raw curve.
+This can be disabled by setting \c params._cleanup to false: the raw curve is then returned as a single contour.
+
+\sa PolylineBase::getOffsetPoly()
 */
-template<typename CT,typename FPT>
-CPolyline_<FPT>
-convexHull( const base::PolylineBase<CT,FPT>& input )
+template<typename PLT,typename FPT,typename T>
+BoolOpResult_<FPT>
+getOffsetPolys( const base::PolylineBase<PLT,FPT>& poly, T dist, OffsetPolyParams params=OffsetPolyParams{} )
 {
-	return convexHull( input.getPts() );
+	HOMOG2D_CHECK_IS_NUMBER(T);
+	if( homog2d_abs(dist) < thr::nullDistance() )
+		HOMOG2D_THROW_ERROR_1( "distance value is null" );
+	if( poly.size() < 3 )
+		HOMOG2D_THROW_ERROR_1( "computing offsetted polygon requires at least 3 points, has " << poly.size() );
+	if( !poly.isSimple() )
+		HOMOG2D_THROW_ERROR_1( "Polyline is not a simple polygon" );
+
+	HOMOG2D_INUMTYPE area = 0.;
+	const auto& pts = poly.getPts();
+	for( size_t i=0; i<pts.size(); i++ )
+		area += priv::shoelaceTerm( pts[i], pts[ (i+1)%pts.size() ] );
+	return priv::offset::offsetPolygon( pts, area > 0., static_cast<HOMOG2D_INUMTYPE>(dist), params );
 }
 
 namespace base {
+
 //------------------------------------------------------------------
-/// Computes and returns the convex hull of a set of points (free function)
+/// Return an "offsetted" closed polyline, requires simple polygon (CPolyline AND no crossings) as input
 /**
-- Graham scan algorithm: https://en.wikipedia.org/wiki/Graham_scan
+On failure (for whatever reason), will return an empty CPolyline
+
+- If dist>0, returns the polyline "outside" the source one
+- If dist<0, returns the polyline "inside" the source one
 
-\todo 20230728: make this function accept also std::array and std::list (using Sfinae alogn with trait::IsContainer)
+The self-intersections are removed (see getOffsetPolys()). If the offsetted region is made of several polygons,
+this returns the one with the largest area (the holes are ignored).
+If the inside offset "eats" the whole polygon, returns an empty CPolyline.
 */
-template<typename FPT>
-CPolyline_<FPT>
-convexHull( const std::vector<Point2d_<FPT>>& input )
+template<typename PLT,typename FPT>
+template<typename T>
+PolylineBase<typ::IsClosed,FPT>
+PolylineBase<PLT,FPT>::getOffsetPoly( T dist, OffsetPolyParams params ) const
 {
-	if( input.size() < 4 )  // if 3 pts or less, then the hull is equal to input set
-		return CPolyline_<FPT>( input );
-
-// step 1: find pivot (point with smallest Y coord)
-	auto pivot_idx = priv::chull::getPivotPoint( input );
-
-// step 2: sort points by angle of lines between the current point and pivot point
-	auto v2 = priv::chull::sortPoints( input, pivot_idx );
-
-	std::stack<size_t> firstPoint;
-	priv::chull::Mystack hull;
-	hull.push( v2[0] );
-	hull.push( v2[1] );
-	hull.push( v2[2] );
-
-	firstPoint.push( 0 );
-	firstPoint.push( 1 );
+	HOMOG2D_CHECK_IS_NUMBER(T);
 
-// step 3: iterate
-	size_t idx1 = 1;
-	size_t idx2 = 2;
-	size_t idx3 = 3;
-	do
+	bool valid = true;
+	if( homog2d_abs(dist) < thr::nullDistance() )
 	{
-//		HOMOG2D_LOG( "** loop start, idx1=" << idx1 << ", idx2=" << idx2  << ", idx3=" << idx3 << ", hull " << hull.getVect() );
-		auto p = input.at( v2[idx1] );
-		auto q = input.at( v2[idx2] );
-		auto r = input.at( v2[idx3] );
-		auto orient = priv::chull::orientation( p, q, r );
-//		HOMOG2D_LOG( "considering pts: " << v2[idx1] << "," << v2[idx2] << "," << v2[idx3] << ": or = " << orient );
-		if( orient != 1 )
-		{
-			hull.push( v2[idx3] );
-			idx1 = idx2;
-			idx2 = idx3;
-			idx3++;
-			firstPoint.push( idx1 );
-		}
-		else
-		{
-			hull.pop();
-			idx2=idx1; // idx3 stays the same
-			firstPoint.pop();
-			idx1 = firstPoint.top();
-		}
+		HOMOG2D_LOG_WARNING( "Failure, distance value is null, returning empty CPolyline" );
+		valid = false;
+	}
+	if( size()<3 )
+	{
+		HOMOG2D_LOG_WARNING( "Failure, computing offsetted Polyline requires at least 3 points, returning empty CPolyline" );
+		valid = false;
+	}
+	if( !isSimple() )
+	{
+		HOMOG2D_LOG_WARNING( "Failure, Polyline is not a polygon, returning empty CPolyline" );
+		valid = false;
 	}
-	while( idx3 < v2.size() );
+	if( !valid )
+		return PolylineBase<typ::IsClosed,FPT>();
 
-// final step: copy hull indexes to vector of points
-	const auto v = hull.getVect();
-	std::vector<Point2d_<FPT>> vout( v.size() );
-	std::transform(
-		v.begin(),
-		v.end(),
-		vout.begin(),
-		[&input]               // lambda
-		(size_t idx)
-		{
-			return input.at( idx );
-		}
+	auto res = priv::offset::offsetPolygon(
+		_plinevec,
+		p_ComputeSignedArea() > 0.,
+		static_cast<HOMOG2D_INUMTYPE>(dist),
+		params
 	);
+	if( res.empty() )
+		return PolylineBase<typ::IsClosed,FPT>();
 
-	return CPolyline_<FPT>( vout );
+	size_t best = 0;
+	HOMOG2D_INUMTYPE bestArea = -1.;
+	for( size_t i=0; i<res.size(); i++ )
+		if( !res.isHole(i) )
+		{
+			const auto& pts = res.getContour(i).getPts();
+			HOMOG2D_INUMTYPE a = 0.;
+			for( size_t j=0; j<pts.size(); j++ )
+				a += priv::shoelaceTerm( pts[j], pts[ (j+1)%pts.size() ] );
+			if( homog2d_abs(a) > bestArea )
+			{
+				bestArea = homog2d_abs(a);
+				best = i;
+			}
+		}
+	return res.getContour( best );
 }
 
 } // namespace base
 
-/// Return convex hull (member function implementation)
-template<typename CT,typename FPT>
-CPolyline_<FPT>
-base::PolylineBase<CT,FPT>::convexHull() const
-{
-	return h2d::convexHull( *this );
-}
-
 /////////////////////////////////////////////////////////////////////////////
 // SECTION  - OPENCV BINDING - GENERAL
 /////////////////////////////////////////////////////////////////////////////
@@ -11696,6 +19213,9 @@ Hmatrix_<W,FPT>::operator = ( const cv::Mat& mat )
 			break;
 		default: assert(0);
 	}
+	detail::Matrix_<FPT>::_isNormalized = false;
+	p_resetCache();
+	p_unknownKind();
 	return *this;
 }
 #endif // HOMOG2D_USE_OPENCV
@@ -11955,8 +19475,8 @@ PolylineBase<PLT,FPT>::draw( img::Image<cv::Mat>& im, img::DrawParams dp ) const
 	if( size() < 2 ) // nothing to draw
 		return;
 
-	for( size_t i=0; i<nbSegs(); i++ )
-		getSegment(i).draw( im, dp );
+	for( const auto& seg: getSegsView() )
+		seg.draw( im, dp );
 
 	if( dp._dpValues._showPoints )
 	{
@@ -11981,7 +19501,7 @@ PolylineBase<PLT,FPT>::draw( img::Image<cv::Mat>& im, img::DrawParams dp ) const
 
 	if( dp._dpValues._showAngles )
 	{
-		auto osegs = getOSegs();
+		auto osegs = getOSegsView();
 //			std::cout << "osegs size=" << osegs.size() << "\n";
 
 		const auto& pts = getPts();
@@ -12351,7 +19871,7 @@ PolylineBase<PLT,FPT>::draw( img::Image<img::SvgImage>& im, img::DrawParams dp )
 
 	if( dp._dpValues._showAngles )
 	{
-		auto osegs = getOSegs();
+		auto osegs = getOSegsView();
 //			std::cout << "osegs size=" << osegs.size() << "\n";
 
 		const auto& pts = getPts();
@@ -12443,6 +19963,22 @@ using OPolylineF = OPolyline_<float>;
 using OPolylineD = OPolyline_<double>;
 using OPolylineL = OPolyline_<long double>;
 
+/// Default polyline types with columnar storage, see base::PolylineSoA
+using CPolylineSoA = CPolylineSoA_<HOMOG2D_INUMTYPE>;
+using OPolylineSoA = OPolylineSoA_<HOMOG2D_INUMTYPE>;
+
+/// Default streaming polyline builder, see PolylineBuilder_
+using PolylineBuilder = PolylineBuilder_<HOMOG2D_INUMTYPE>;
+
+/// Default online convex hull builder, see ConvexHullBuilder_
+using ConvexHullBuilder = ConvexHullBuilder_<HOMOG2D_INUMTYPE>;
+
+/// Default convex polygon type, see ConvexPolygon_
+using ConvexPolygon = ConvexPolygon_<HOMOG2D_INUMTYPE>;
+
+/// Default type for result of polygon boolean operations, see booleanOp()
+using BoolOpResult = BoolOpResult_<HOMOG2D_INUMTYPE>;
+
 using PointPairF = PointPair_<float>;
 using PointPairD = PointPair_<double>;
 using PointPairL = PointPair_<long double>;
@@ -12767,7 +20303,8 @@ struct SvgValuesBuffer
 		return _values.size();
 	}
 
-	void storeValues( std::vector<Point2d>& out, SvgPathCommand mode )
+	template<typename SINK>
+	void storeValues( SINK& sink, SvgPathCommand mode )
 	{
 		if( _values.size() != (size_t)mode._nbValues )
 			HOMOG2D_THROW_ERROR_1(
@@ -12777,7 +20314,7 @@ struct SvgValuesBuffer
 			);
 		auto pt = generateNewPoint( mode, _previousPt, _values );
 		HOMOG2D_LOG( "new point added: " << pt );
-		out.push_back( pt );
+		sink.addPoint( pt );
 		_previousPt = pt;
 		_values.clear();
 	}
@@ -12787,29 +20324,45 @@ struct SvgValuesBuffer
 	}
 };
 
-/// Parse a SVG "path" string and convert it to a vector holding a set (vector) of points
+/// Default sink for parsePath(), stores the points in a vector of vectors
+struct PathPtsCollector
+{
+	std::vector<std::vector<Point2d>> _vout = std::vector<std::vector<Point2d>>(1);
+
+	void addPoint( const Point2d& pt )
+	{
+		_vout.back().push_back( pt );
+	}
+	void newPolyline()
+	{
+		if( !_vout.back().empty() )
+		{
+			_vout.push_back( std::vector<Point2d>() );
+			HOMOG2D_LOG( "NEW vector idx=" << _vout.size()-1 );
+		}
+	}
+};
+
+/// Parse a SVG "path" string and send the points to \c sink, returns true if closed polyline
 /**
-Input string example:
-\verbatim
-m 261.68497,138.79393 2.57,3.15 -0.72,1.27 2.18,1.94 -0.7,4.93 1.88,0.9
-\endverbatim
-The return value holds as 'second' a bool value, will be true if closed polyline
+\c sink can be of any type providing these two member functions:
+- <code>addPoint( const Point2d& )</code>
+- <code>newPolyline()</code>, called when a new polyline starts ("MoveTo" command)
+
+For example PolylineBuilder_, that will simplify the polylines on the fly, without storing all the points.
 */
-inline
-auto
-parsePath( const char* s )
+template<typename SINK>
+bool
+parsePath( const char* s, SINK& sink )
 {
 	SvgPathCommand mode;
-	std::vector<std::vector<Point2d>> vout(1);
 	SvgValuesBuffer values;
 	std::string str(s);
-	size_t idx = 0;
 	HOMOG2D_LOG( "parsing string -" << str << "- #=" << str.size() );
 	if( str.size() == 0 )
 		HOMOG2D_THROW_ERROR_1( "SVG path string is empty" );
 
 	auto it = str.cbegin();
-	Point2d previousPt;
 	do
 	{
 		auto e = getNextElem( str, it );
@@ -12818,32 +20371,47 @@ parsePath( const char* s )
 		if( e.size() == 1 && !isDigit(e[0]) ) // we have a command !
 		{
 			if( values.size() != 0 )              // if we have some values stored,
-				values.storeValues( vout[idx], mode );  //  first process them and add new point
+				values.storeValues( sink, mode );  //  first process them and add new point
 
 			mode = getCommand( e[0] );
 			HOMOG2D_LOG( "command=" << e[0] );
 			if( !svgPathCommandIsAllowed(mode._command) )
 				HOMOG2D_THROW_ERROR_1( "SVG path command -" << mode._command << "- not handled" );
 
-			if( mode.isNewPolyline() && !vout[idx].empty() )
-			{
-				vout.push_back( std::vector<Point2d>() );
-				idx++;
-				HOMOG2D_LOG( "NEW vector idx=" << idx );
-			}
+			if( mode.isNewPolyline() )
+				sink.newPolyline();
 		}
 		else // not a command, but a value
 		{
 //			HOMOG2D_LOG( "process value, values size=" << values.size() );
 			if( values.size() == (size_t)mode._nbValues ) // already got enough values
-				values.storeValues( vout[idx], mode );
+				values.storeValues( sink, mode );
 			values.addValue( e );
 		}
 	}
 	while( it < str.cend() );
 
 	if( values.size() )                  // process remaining values that have been stored
-		values.storeValues( vout[idx], mode );
+		values.storeValues( sink, mode );
+
+	return mode._command == 'Z';
+}
+
+/// Parse a SVG "path" string and convert it to a vector holding a set (vector) of points
+/**
+Input string example:
+\verbatim
+m 261.68497,138.79393 2.57,3.15 -0.72,1.27 2.18,1.94 -0.7,4.93 1.88,0.9
+\endverbatim
+The return value holds as 'second' a bool value, will be true if closed polyline
+*/
+inline
+auto
+parsePath( const char* s )
+{
+	PathPtsCollector coll;
+	auto isClosed = parsePath( s, coll );
+	auto& vout = coll._vout;
 
 	HOMOG2D_LOG( "Nb vectors=" << vout.size() );
 	for( auto& v: vout )
@@ -12852,10 +20420,7 @@ parsePath( const char* s )
 	if( vout.back().empty() )
 		vout.pop_back();
 
-	return std::make_pair(
-		vout,
-		mode._command == 'Z' ? true : false
-	);
+	return std::make_pair( vout, isClosed );
 }
 
 } // namespace svgp
@@ -1,39 +1,54 @@
 /**
 \file
 \brief Demo of point inside polygon (PIP) algorithm
+
+Shows the horizontal half-line used by the "crossing number" algorithm,
+and the edges that are counted as crossed (see docs/homog2d_algorithms.md)
 */
 #include "fig_src.header"
 
 using namespace h2d;
 
+/// Returns true if edge \c seg is crossed by the horizontal half-line starting at \c pt, going right
+/**
+Edges are "half-open" on the y axis: one point must be strictly above the half-line, and the other one not.
+*/
+bool isCrossed( const Segment& seg, const Point2d& pt )
+{
+	auto pts = seg.getPts();
+	auto x1 = pts.first.getX();
+	auto y1 = pts.first.getY();
+	auto x2 = pts.second.getX();
+	auto y2 = pts.second.getY();
+	if( (y1 > pt.getY()) == (y2 > pt.getY()) )
+		return false;
+	auto x = x1 + ( pt.getY() - y1 ) * ( x2 - x1 ) / ( y2 - y1 );
+	return x > pt.getX();
+}
+
 template<typename IMG>
-void drawFig( const CPolyline& poly, const FRect& bb, const Point2d& pt, const Point2d* pt2, const Segment* source_seg, IMG& im, int n )
+void drawFig( const CPolyline& poly, const FRect& bb, const Point2d* pt, IMG& im, int n )
 {
 	im.clear();
 	poly.draw( im, DrawParams().setColor(250,0,20)  );
 	bb.draw( im, DrawParams().setColor(0,0,250)  );
-	pt.draw( im, DrawParams().setColor(250,0,0)  );
-	auto polypts = poly.getPts();
-	if( pt2 )
+	if( pt )
 	{
-		auto seg = Segment( pt, *pt2 );
-		seg.draw( im, DrawParams().setColor(0,0,250)  );
-		auto inter = seg.intersects( poly );
-		auto color = DrawParams().setColor(0,250,0).setPointStyle(PtStyle::Dot).setThickness(2).setPointSize(11);
-		pt2->draw( im, color );
-		if( inter() )
-		{
-			for( const auto& ptpoly: polypts )
-				if( ptpoly == inter.get()[0] )
-				{
-					color.setColor(250,0,0);
-					break;
-				}
-			inter.get()[0].draw( im, color );
-		}
+		auto hl = Segment( *pt, Point2d( bb.getPts().second.getX(), pt->getY() ) );
+		hl.draw( im, DrawParams().setColor(0,0,250)  );
+		int nbCross = 0;
+		for( const auto& seg: poly.getSegs() )
+			if( isCrossed( seg, *pt ) )
+			{
+				seg.draw( im, DrawParams().setThickness(3).setColor(0,250,0) );
+				nbCross++;
+			}
+		pt->draw( im, DrawParams().setColor(250,0,0).setPointStyle(PtStyle::Dot).setPointSize(7) );
+
+		std::ostringstream oss;
+		oss << nbCross << " crossing(s): " << ( pt->isInside( poly ) ? "inside" : "outside" );
+		im.drawText( oss.str(), Point2d(40,20), DrawParams() );
 	}
-	if( source_seg )
-		source_seg->draw( im, DrawParams().setThickness(2).setColor( 0,255,0) );
 	im.drawText( std::to_string(n), Point2d(10,20), DrawParams() );
 
 	std::ostringstream oss;
@@ -66,42 +81,25 @@ int main()
 	};
 	CPolyline pol( vpts1 );
 
-// considered point is exactly in the center of the polygon
-	Point2d pt(5,5);
+// considered points
+	std::vector<Point2d> vpts2{
+		{ 5, 5 },     // inside, the half-line goes through a vertex where the boundary crosses it: counted once
+		{ 2, 2 },     // inside, the half-line touches the vertex (7,2) without crossing: not counted
+		{ 1, 4 },     // outside, half-line goes through vertex (2,4)
+		{ 9.5, 6 }    // outside, no crossing
+	};
 
 	auto H = Homogr().addTranslation(15,15).addScale(8);
 	auto poly = H*pol;
-	auto pt0 = H * pt;
 	auto bbe = getBB( poly ).getExtended();
 
 	img::Image<img::SvgImage> im( 350,350 );
 
-	drawFig( poly, bbe, pt0, nullptr, nullptr, im, 0 );
-
-	im.write( "demo_pip_0.svg" );
-	auto bbpts = bbe.get4Pts();
-
-// step 1: show that taking segments based on the 4 points
-// of the extended BB does not meet the requirements
-// (the segments will intersect the polygon on one of its points)
-	for( int i=0; i<4; i++ )
-		drawFig( poly, bbe, pt0, &bbpts[i], nullptr, im, i+1 );
-
-// step 2: show that taking segments based on the middle point of the
-// 4 segments of the extended BB does not work either
-	auto segs = bbe.getSegs();
-	for( int i=0; i<4; i++ )
+	drawFig( poly, bbe, nullptr, im, 0 );
+	for( size_t i=0; i<vpts2.size(); i++ )
 	{
-		auto ptmid = segs[i].getCenter();
-		drawFig( poly, bbe, pt0, &ptmid, &segs[i], im, i+5 );
+		auto pt = H * vpts2[i];
+		drawFig( poly, bbe, &pt, im, i+1 );
 	}
-
-// final step: taking the middle point of half the above segments does
-// generate a segment that does not intersect the polygon on one of its points
-	auto seg = segs[0]; // first segment of the extended bounding box
-	auto seg2 = Segment( seg.getCenter(), bbpts[0] );
-	auto mid = seg2.getCenter();
-	drawFig( poly, bbe, pt0, &mid, &seg2, im, 9 );
 }
 
-
@@ -79,6 +79,13 @@ int main( int argc, char* argv[] )
 
 		<< "\n  - HOMOG2D_OPTIMIZE_SPEED: "
 #ifdef HOMOG2D_OPTIMIZE_SPEED
+		<< "YES"
+#else
+		<< "NO"
+#endif
+
+		<< "\n  - HOMOG2D_VECTORIZE: "
+#ifdef HOMOG2D_VECTORIZE
 		<< "YES"
 #else
 		<< "NO"
@@ -1086,7 +1093,271 @@ TEST_CASE( "matrix inversion", "[testH3]" )
 		H.transpose();
 		H2.inverse().transpose();
 		CHECK( H == H2 );
+	}
+}
+
+TEST_CASE( "homography kind", "[testH3]" )
+{
+	Homogr H;
+	CHECK( H.kind() == HKind::Rigid );
+	H.setRotation( 0.3 ).addTranslation( 1., 2. );
+	CHECK( H.kind() == HKind::Rigid );
+	H.addScale( -2 );
+	CHECK( H.kind() == HKind::Similarity );
+	auto H2 = H;
+	H2.addScale( 2, 3 );
+	CHECK( H2.kind() == HKind::Affine );
+	CHECK( (H*H2).kind() == HKind::Affine );
+	CHECK( std::string( getString( H2.kind() ) ) == "Affine" );
+
+	Homogr HP = std::vector<std::vector<double>>{ { 1,2,3 }, { 0,1,2 }, { 0.1,0,1 } };
+	CHECK( HP.kind() == HKind::Projective );
+	CHECK( (H*HP).kind() == HKind::Projective );
+	Homogr HS = std::vector<std::vector<double>>{ { 0,-4,2 }, { 4,0,6 }, { 0,0,2 } };  // normalized by constructor
+	CHECK( HS.kind() == HKind::Similarity );
+	HS.set( 0, 0, 0.5 );
+	CHECK( HS.kind() == HKind::Affine );
+	HS.set( 2, 1, 0.5 );
+	CHECK( HS.kind() == HKind::Projective );
+	HS.set( 2, 1, 0. );
+	CHECK( HS.kind() == HKind::Affine );
+
+	{                                   // inverse and product (closed-form) vs generic ones
+		auto HG = H2;
+		HG.set( 2, 0, 1E-300 );         // numerically identical, but projective
+		CHECK( HG.kind() == HKind::Projective );
+		auto HI  = H2;
+		auto HGI = HG;
+		HI.inverse();
+		HGI.inverse();
+		CHECK( HI.kind() == HKind::Affine );
+		CHECK( HI == HGI );
+		CHECK( HI * H2 == Homogr() );
+		CHECK( H * H2 == H * HG );
+	}
+
+	{                                   // application to points, lines and polylines
+		Point2d pt1( 3, 4 ), pt2( -1, 2 );
+		Line2d li( pt1, pt2 );
+		CHECK( (H2*li).distTo( H2*pt1 ) < 1E-10 );
+		CHECK( (H2*li).distTo( H2*pt2 ) < 1E-10 );
+
+		CPolyline pl( std::vector<Point2d>{ {0,0}, {2,0.1}, {3,2}, {1,3}, {-1,1.5} } );
+		auto len = pl.length();
+		auto area = pl.area();
+		pl.centroid();
+		pl.getBB();
+
+		auto pl1 = H * pl;              // similarity, scale factor 2
+		CHECK( pl1.length() == Approx( 2.*len ) );
+		CHECK( pl1.area()   == Approx( 4.*area ) );
+		CPolyline ref1( pl1.getPts() ); // so that nothing is kept
+		CHECK( pl1.centroid() == ref1.centroid() );
+		CHECK( pl1.getBB()    == ref1.getBB() );
+
+		Homogr HA;
+		HA.setScale( 2, 3 ).addTranslation( 1, 1 );
+		auto pl2 = HA * pl;
+		CPolyline ref2( pl2.getPts() );
+		CHECK( pl2.length()   == Approx( ref2.length() ) );
+		CHECK( pl2.area()     == Approx( 6.*area ) );
+		CHECK( pl2.centroid() == ref2.centroid() );
+		CHECK( pl2.getBB()    == ref2.getBB() );
 	}
+}
+
+TEST_CASE( "homography used from several threads", "[testH3]" )
+{
+	Homogr H;
+	H.setRotation( 0.3 ).addScale( 2, 3 );
+	H.set( 2, 0, 1E-3 );                      // projective
+
+	std::vector<Line2d> vli;
+	for( int i=0; i<100; i++ )
+		vli.emplace_back( Point2d( i, 1 ), Point2d( 2, i+3 ) );
+	std::vector<Line2d> vref;
+	{
+		auto H2 = H;
+		for( const auto& li: vli )
+			vref.push_back( H2 * li );
+	}
+
+	for( int pre=0; pre<2; pre++ )
+	{
+		if( pre )
+			H.precompute();
+		const auto& HC = H;
+		std::vector<int> vres( 4, 0 );
+		std::vector<std::thread> vth;
+		for( size_t t=0; t<vres.size(); t++ )
+			vth.emplace_back(
+				[&HC,&vli,&vref,&vres,t]       // lambda
+				()
+				{
+					Homogr Hcopy( HC );
+					for( size_t i=0; i<vli.size(); i++ )
+					{
+						vres[t] += ( HC * vli[i] == vref[i] );
+						vres[t] += ( Hcopy * vli[i] == vref[i] );
+					}
+				}
+			);
+		for( auto& th: vth )
+			th.join();
+		for( auto r: vres )
+			CHECK( r == 200 );
+	}
+
+	auto H3 = H;                              // copy, keeps the computed values
+	CHECK( H3 * vli[5] == vref[5] );
+	H3.addRotation( 0.1 );                    // cache gets invalidated
+	auto li = H3 * vli[5];
+	CHECK( li.distTo( H3 * Point2d( 5, 1 ) ) < 1E-10 );
+	CHECK( li.distTo( H3 * Point2d( 2, 8 ) ) < 1E-10 );
+}
+
+TEST_CASE( "homography cache invalidation", "[testH3]" )
+{
+	Line2d li( Point2d( 1, 2 ), Point2d( 5, -3 ) );
+	auto check = []( const Homogr& h, const Line2d& l )
+	{
+		Homogr fresh( h.getRaw() );                   // holds no cached value
+		return h * l == fresh * l;
+	};
+
+	Homogr H;
+	H.setRotation( 0.3 ).addScale( 2, 3 );
+	H.set( 2, 0, 1E-3 );                            // projective
+	auto li1 = H * li;                                // fills the cache
+	H.inverse();
+	CHECK( check( H, li ) );
+	CHECK( H * li != li1 );
+
+	H * li;
+	H.transpose();
+	CHECK( check( H, li ) );
+
+	H.precompute();
+	H.inverse();
+	CHECK( check( H, li ) );
+
+	Homogr Ha;
+	Ha.setRotation( 0.3 ).addScale( 2, 3 );           // affine
+	Ha * li;
+	Ha.inverse();
+	CHECK( check( Ha, li ) );
+
+	Ha * li;
+	Ha.set( 0, 2, 5 );
+	CHECK( check( Ha, li ) );
+	Ha * li;
+	Ha.value( 1, 2 ) = -3;
+	CHECK( check( Ha, li ) );
+	Ha * li;
+	Ha.getRaw()[2][1] = 1E-3;
+	CHECK( check( Ha, li ) );
+	Ha * li;
+	Ha.addTranslation( 2, 1 );
+	CHECK( check( Ha, li ) );
+	Ha * li;
+	Ha = H;
+	CHECK( check( Ha, li ) );
+}
+
+TEST_CASE( "homography from points", "[testH3]" )
+{
+	Homogr H0;
+	H0.setRotation( 0.3 ).addTranslation( 20, -5 ).addScale( 1.5 );
+	Homogr P( std::vector<std::vector<double>>{ {1,.1,3}, {.05,1.2,-4}, {1E-3,-2E-3,1} } );
+	H0 = P * H0;
+
+	auto maxDiff = []( const Homogr& h1, const Homogr& h2 )
+	{
+		HOMOG2D_INUMTYPE diff = 0.;
+		for( int i=0; i<3; i++ )
+			for( int j=0; j<3; j++ )
+				diff = std::max( diff, (HOMOG2D_INUMTYPE)homog2d_abs( h1.value(i,j) - h2.value(i,j) ) );
+		return diff;
+	};
+
+	std::vector<Point2d> v1{ {20,20}, {250,20}, {230,170}, {60,190} };
+	std::vector<Point2d> v2 = H0 * v1;
+	{
+		Homogr H;
+		H.buildFromPoints( v1, v2 );
+		CHECK( maxDiff( H, H0 ) < 1E-6 );
+		CHECK( maxDiff( buildFromPoints( v1, v2 ), H0 ) < 1E-6 );
+		CHECK( maxDiff( buildFrom4Points( v1, v2, 2 ), H0 ) < 1E-6 );
+
+		std::array<Point2d,4> a1{ v1[0], v1[1], v1[2], v1[3] };
+		CHECK( maxDiff( buildFromPoints( a1, v2 ), H0 ) < 1E-6 );
+	}
+
+	for( int i=0; i<50; i++ )                  // more points, all exact
+		v1.emplace_back( 3*i - 40, 0.02*i*i + 5 );
+	v2 = H0 * v1;
+	CHECK( maxDiff( buildFromPoints( v1, v2 ), H0 ) < 1E-6 );
+
+	for( size_t i=0; i<v2.size(); i++ )        // noisy points: least squares solution
+		v2[i].set( v2[i].getX() + 0.1*((i%3)-1.), v2[i].getY() + 0.1*((i%5)-2.)/2. );
+	auto Hn = buildFromPoints( v1, v2 );
+	for( size_t i=0; i<v1.size(); i++ )
+		CHECK( (Hn * v1[i]).distTo( v2[i] ) < 0.3 );
+
+	std::vector<Point2d> v3{ {0,0}, {1,0}, {2,0}, {0,1} };    // 3 collinear points, but not their image
+	std::vector<Point2d> v4{ {0,0}, {1,0}, {2,.5}, {0,1} };
+	CHECK_THROWS( buildFromPoints( v3, v4 ) );
+	std::vector<Point2d> v5( 4, Point2d( 1, 2 ) );            // all the same
+	CHECK_THROWS( buildFromPoints( v5, v4 ) );
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( buildFromPoints( v3, v1 ) );                 // different sizes
+	v3.pop_back();
+	v4.pop_back();
+	CHECK_THROWS( buildFromPoints( v3, v4 ) );                 // not enough points
+#endif
+}
+
+TEST_CASE( "homography from points with outliers", "[testH3]" )
+{
+	Homogr H0( std::vector<std::vector<double>>{ {1.1,.1,3}, {.05,1.2,-4}, {5E-4,-2E-4,1} } );
+
+	std::vector<Point2d> v1, v2;
+	std::vector<bool> isInlier;
+	for( int i=0; i<20; i++ )
+		for( int j=0; j<15; j++ )
+		{
+			v1.emplace_back( 30*i + 3*(j%4), 40*j + 2*(i%3) );
+			auto pt = H0 * v1.back();
+			bool inl = ( (i+j) % 3 != 0 );                          // one third of outliers
+			if( !inl )
+				pt.set( pt.getX() + 50 + i, pt.getY() - 20 - 3*j );
+			v2.push_back( pt );
+			isInlier.push_back( inl );
+		}
+
+	for( size_t nbThreads: { 1, 3 } )
+		for( bool lo: { false, true } )
+		{
+			RansacParams params;
+			params._nbThreads  = nbThreads;
+			params._localOptim = lo;
+			auto res = buildFromPointsRansac( v1, v2, params );
+			CHECK( res._inliers == isInlier );
+			CHECK( res._nbInliers == 200 );
+			CHECK( res._nbIter > 0 );
+			CHECK( res._nbIter < params._maxIter );                   // early termination
+			for( size_t i=0; i<v1.size(); i++ )
+				if( isInlier[i] )
+					CHECK( (res._H * v1[i]).distTo( v2[i] ) < 1E-3 );
+		}
+
+	std::vector<Point2d> v3( 10, Point2d( 1, 2 ) );                // degenerate
+	CHECK_THROWS( buildFromPointsRansac( v3, v3 ) );
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( buildFromPointsRansac( v1, v3 ) );               // different sizes
+	v3.resize( 3 );
+	CHECK_THROWS( buildFromPointsRansac( v3, v3 ) );               // not enough points
+#endif
 }
 
 /// Computation of the line passed through H^{-T} and computation of
@@ -1419,6 +1690,45 @@ TEST_CASE( "Point2d IsInside Polyline", "[tptipol]" )
 
 		pt.set( 1,1 );
 		CHECK( pt.isInside( cpol ) );
+	}
+	{   // "L" shape, with a concave vertex
+		CPolyline_<HOMOG2D_INUMTYPE> cpol{ std::vector<Point2d>{ {0,0},{4,0},{4,2},{2,2},{2,4},{0,4} } };
+
+		pt.set( 1,3 );
+		CHECK( pt.isInside( cpol ) );
+		pt.set( 3,3 );
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( 1,2 );                  // on the supporting line of segment (4,2)-(2,2), but not on it
+		CHECK( pt.isInside( cpol ) );
+		pt.set( 3,2 );                  // on edge
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( 2,2 );                  // on concave vertex
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( 2,2.+1E-12 );           // at less than nullDistance() of vertex
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( 1,0 );                  // horizontal ray going through vertices
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( -1,2 );
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( -1,4 );
+		CHECK( !pt.isInside( cpol ) );
+		pt.set( 1,1E-3 );
+		CHECK( pt.isInside( cpol ) );
+	}
+	{   // regular polygon: inside iff on the same side of all the edges
+		CPolyline_<HOMOG2D_INUMTYPE> cpol( 10., 7 );
+		std::srand( 789 );
+		size_t nbErr = 0;
+		for( int i=0; i<2000; i++ )
+		{
+			pt.set( 1.0*rand()/RAND_MAX * 24. - 12., 1.0*rand()/RAND_MAX * 24. - 12. );
+			bool inside = true;
+			for( const auto& oseg: cpol.getOSegs() )
+				if( oseg.getPointSide( pt ) != PointSide::Left )
+					inside = false;
+			nbErr += ( pt.isInside( cpol ) != inside );
+		}
+		CHECK( nbErr == 0 );
 	}
 }
 
@@ -3662,6 +3972,378 @@ TEST_CASE( "Polygon orientation", "[polyline-orient]" )
 }
 
 
+/// Checks that the cached attributes of \c pl are the same as the ones of a freshly built copy
+template<typename PLT>
+size_t
+checkPolylineAttribs( const base::PolylineBase<PLT,NUMTYPE>& pl )
+{
+	base::PolylineBase<PLT,NUMTYPE> ref( pl.getPts() );
+	size_t nbErr = 0;
+	if( pl.length() != Approx( ref.length() ) )
+		nbErr++;
+	if( pl.area() != Approx( ref.area() ).margin(1E-8) )
+		nbErr++;
+	if( pl.getBB() != ref.getBB() )
+		nbErr++;
+	if( pl.isSimple() != ref.isSimple() )
+		nbErr++;
+	if( pl.isSimple() )
+		if( pl.centroid().distTo( ref.centroid() ) > 1E-8 )
+			nbErr++;
+	return nbErr;
+}
+
+TEST_CASE( "Polyline incremental attributes", "[polyline-attribs]" )
+{
+	std::vector<Point2d_<NUMTYPE>> vpts{ {0,0}, {4,0}, {5,2}, {3,5}, {1,3} };
+	CPolyline_<NUMTYPE> cpol( vpts );
+	OPolyline_<NUMTYPE> opol( vpts );
+	size_t nbErr = 0;
+	nbErr += checkPolylineAttribs( cpol ); // compute and store attributes
+	nbErr += checkPolylineAttribs( opol );
+
+	cpol.translate( 3.5, -2 );
+	opol.translate( 3.5, -2 );
+	nbErr += checkPolylineAttribs( cpol );
+	nbErr += checkPolylineAttribs( opol );
+
+	cpol.moveTo( 1, 2 );
+	CHECK( cpol.getPoint(0) == Point2d_<NUMTYPE>( 1, 2 ) );
+	nbErr += checkPolylineAttribs( cpol );
+
+	for( auto rot: { Rotate::CCW, Rotate::CW, Rotate::Full, Rotate::VMirror, Rotate::HMirror } )
+	{
+		cpol.rotate( rot );
+		opol.rotate( rot, Point2d_<NUMTYPE>( 1, 1 ) );
+		nbErr += checkPolylineAttribs( cpol );
+		nbErr += checkPolylineAttribs( opol );
+	}
+
+	auto len = cpol.length();
+	auto area = cpol.area();
+	cpol.scale( 2 );
+	CHECK( cpol.length() == Approx( 2. * len ) );
+	CHECK( cpol.area() == Approx( 4. * area ) );
+	nbErr += checkPolylineAttribs( cpol );
+	cpol.scale( -1.5, 3 );
+	opol.scale( -1.5, 3 );
+	CHECK( cpol.area() == Approx( 4. * 4.5 * area ) );
+	nbErr += checkPolylineAttribs( cpol );
+	nbErr += checkPolylineAttribs( opol );
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( cpol.scale( 0 ) );
+#endif
+
+	cpol.set( vpts );
+	opol.set( vpts );
+	nbErr += checkPolylineAttribs( cpol );
+	nbErr += checkPolylineAttribs( opol );
+	cpol.replacePoint( 2, Point2d_<NUMTYPE>( 4, 2 ) );   // inside the bounding box
+	opol.replacePoint( 2, Point2d_<NUMTYPE>( 4, 2 ) );
+	nbErr += checkPolylineAttribs( cpol );
+	nbErr += checkPolylineAttribs( opol );
+	cpol.replacePoint( 0, Point2d_<NUMTYPE>( -1, 7 ) );  // extends the bounding box
+	opol.replacePoint( 4, Point2d_<NUMTYPE>( 8, 1 ) );   // last point of open polyline
+	nbErr += checkPolylineAttribs( cpol );
+	nbErr += checkPolylineAttribs( opol );
+	cpol.replacePoint( 0, Point2d_<NUMTYPE>( 0, 0 ) );   // was on the border of the bounding box
+	nbErr += checkPolylineAttribs( cpol );
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( cpol.replacePoint( 5, Point2d_<NUMTYPE>( 0, 0 ) ) );
+	CHECK_THROWS( cpol.replacePoint( 1, Point2d_<NUMTYPE>( 0, 0 ) ) ); // same as neighbour
+#endif
+
+	cpol.minimize();  // uses internally the private "add point" function
+	nbErr += checkPolylineAttribs( cpol );
+	CHECK( nbErr == 0 );
+
+	{                      // the "simple" status is updated by replacePoint() if it was true
+		std::vector<Point2d_<NUMTYPE>> vsq{ {0,0}, {3,0}, {6,0}, {6,3}, {6,6}, {3,6}, {0,6}, {0,3} };
+		CPolyline_<NUMTYPE> pol( vsq );
+		std::srand( 42 );
+		size_t nbDiff = 0;
+		for( int i=0; i<500; i++ )
+		{
+			pol.isSimple();             // so that the status is known
+			auto idx = std::rand() % pol.size();
+			Point2d_<NUMTYPE> pt( std::rand()%7, std::rand()%7 );  // on a grid, to get touching segments
+			if( pt == pol.getPoint( idx==0 ? pol.size()-1 : idx-1 ) || pt == pol.getPoint( (idx+1)%pol.size() ) )
+				continue;
+			pol.replacePoint( idx, pt );
+			if( pol.isSimple() != pol.isSimpleBruteForce() )
+				nbDiff++;
+		}
+		CHECK( nbDiff == 0 );
+	}
+}
+
+TEST_CASE( "Polyline simplification", "[polyline-simplify]" )
+{
+	{                             // straight line with small noise
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( int i=0; i<100; i++ )
+			vpts.emplace_back( i, ( i%2 ? 0.01 : -0.01 ) );
+		OPolyline_<NUMTYPE> pl( vpts );
+		auto pl2 = pl;
+		pl.simplify( 0.1 );
+		CHECK( pl.size() == 2 );
+		CHECK( pl.getPoint(0) == vpts.front() );
+		CHECK( pl.getPoint(1) == vpts.back() );
+		pl2.simplify( 0.001 );         // tolerance too small: no change
+		CHECK( pl2.size() == 100 );
+		CHECK_THROWS( pl2.simplify( -1 ) );
+
+		pl2.simplifyToCount( 10 );
+		CHECK( pl2.size() == 10 );
+		CHECK( pl2.getPoint(0) == vpts.front() );
+		CHECK( pl2.getPoint(9) == vpts.back() );
+		CHECK_THROWS( pl2.simplifyToCount( 1 ) );
+	}
+	{                             // square with points on the edges
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( int i=0; i<10; i++ ) vpts.emplace_back( i, 0 );
+		for( int i=0; i<10; i++ ) vpts.emplace_back( 10, i );
+		for( int i=0; i<10; i++ ) vpts.emplace_back( 10-i, 10 );
+		for( int i=0; i<10; i++ ) vpts.emplace_back( 0, 10-i );
+		CPolyline_<NUMTYPE> pl( vpts );
+		auto pl2 = pl;
+		pl.simplify( 0.1 );
+		CHECK( pl == CPolyline_<NUMTYPE>( FRect_<NUMTYPE>( 0, 0, 10, 10 ) ) );
+		pl2.simplifyToCount( 4 );
+		CHECK( pl == pl2 );
+		CHECK_THROWS( pl2.simplifyToCount( 2 ) );
+		pl.simplify( 100. );         // closed polylines keep at least 3 points
+		CHECK( pl.size() == 3 );
+	}
+
+	{   // removing point (5,11) makes the top edge cross the spike
+		std::vector<Point2d_<NUMTYPE>> vpts{ {0,0}, {3,0}, {5,9.5}, {7,0}, {10,0}, {10,9}, {5,11}, {0,9} };
+		CPolyline_<NUMTYPE> pl( vpts );
+		CHECK( pl.isSimple() );
+		auto pl1 = pl;
+		auto pl2 = pl;
+		pl1.simplify( 3 );
+		pl2.simplify( 3, true );
+		CHECK( pl1.size() == 5 );
+		CHECK( !pl1.isSimple() );
+		CHECK( pl2.isSimple() );
+		pl1 = pl;
+		pl2 = pl;
+		pl1.simplifyToCount( 7 );
+		pl2.simplifyToCount( 7, true );
+		CHECK( !pl1.isSimple() );
+		CHECK( pl2.isSimple() );
+		CHECK( pl2.size() == 7 );                  // another point was removed instead of (5,11)
+		const auto& pts2 = pl2.getPts();
+		CHECK( std::find( pts2.begin(), pts2.end(), Point2d_<NUMTYPE>( 5, 11 ) ) != pts2.end() );
+	}
+
+// random star-shaped polygons: check tolerance and simplicity
+	std::srand( 456 );
+	size_t nbErr = 0;
+	for( int n=0; n<20; n++ )
+	{
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( int i=0; i<500; i++ )
+		{
+			auto a = 2. * M_PI * i / 500.;
+			auto r = 100. + std::rand() % 400 / 10.;
+			vpts.emplace_back( r * std::cos(a), r * std::sin(a) );
+		}
+		CPolyline_<NUMTYPE> pl( vpts );
+		auto pl2 = pl;
+		pl.simplify( 5., true );
+		if( !pl.isSimple() )
+			nbErr++;
+		for( const auto& pt: vpts )                  // each original point is
+		{                                            // within tolerance
+			auto dmin = std::numeric_limits<double>::max();
+			for( const auto& seg: pl.getSegsView() )
+				dmin = std::min( dmin, (double)seg.distTo( pt ) );
+			if( dmin > 5.+1E-8 )
+				nbErr++;
+		}
+		pl2.simplifyToCount( 20, true );
+		if( !pl2.isSimple() || pl2.size() < 20 )
+			nbErr++;
+	}
+	CHECK( nbErr == 0 );
+}
+
+TEST_CASE( "Polyline arc-length queries", "[polyline-arclength]" )
+{
+	{                                                  // open polyline, length=7
+		OPolyline pl( std::vector<Point2d>{ {0,0},{4,0},{4,3} } );
+		CHECK( pl.pointAt( 0 )   == Point2d( 0,0 ) );
+		CHECK( pl.pointAt( 2 )   == Point2d( 2,0 ) );
+		CHECK( pl.pointAt( 4 )   == Point2d( 4,0 ) );
+		CHECK( pl.pointAt( 5.5 ) == Point2d( 4,1.5 ) );
+		CHECK( pl.pointAt( 7 )   == Point2d( 4,3 ) );
+#ifndef HOMOG2D_NOCHECKS
+		CHECK_THROWS( pl.pointAt( 7.5 ) );
+		CHECK_THROWS( pl.pointAt( -1 ) );
+#endif
+		CHECK( pl.segmentAt( 3.9 ) == 0 );
+		CHECK( pl.segmentAt( 4 )   == 1 );
+		CHECK( pl.segmentAt( 7 )   == 1 );
+
+		pl.translate( 1, 1 );                          // index is kept
+		CHECK( pl.pointAt( 5.5 ) == Point2d( 5,2.5 ) );
+		pl.scale( 2 );                                 // index is scaled
+		CHECK( pl.pointAt( 11 ) == Point2d( 10,5 ) );
+		pl.set( std::vector<Point2d>{ {0,0},{0,2} } ); // index is rebuilt
+		CHECK( pl.pointAt( 1 ) == Point2d( 0,1 ) );
+
+		OPolyline pl0;
+		CHECK_THROWS( pl0.pointAt( 0 ) );
+	}
+	{                                                  // closed polyline, length=8
+		CPolyline pl( std::vector<Point2d>{ {0,0},{2,0},{2,2},{0,2} } );
+		CHECK( pl.pointAt( 1 )  == Point2d( 1,0 ) );
+		CHECK( pl.pointAt( 9 )  == Point2d( 1,0 ) );
+		CHECK( pl.pointAt( -1 ) == Point2d( 0,1 ) );
+		CHECK( pl.segmentAt( 8 ) == 0 );
+		CHECK( pl.segmentAt( 7 ) == 3 );
+	}
+	{                                                  // resampling, open
+		std::vector<Point2d> vpts{ {0,0},{4,0},{4,3} };
+		OPolyline pl( vpts );
+		pl.resample( 1 );
+		CHECK( pl.size() == 8 );
+		CHECK( pl.length() == Approx( 7. ) );
+		CHECK( pl.getPoint( 5 ) == Point2d( 4,1 ) );
+
+		pl.set( vpts );
+		pl.resample( 3 );
+		CHECK( pl == OPolyline( std::vector<Point2d>{ {0,0},{3,0},{4,2},{4,3} } ) );
+
+		pl.set( vpts );
+		pl.resampleToCount( 3 );
+		CHECK( pl == OPolyline( std::vector<Point2d>{ {0,0},{3.5,0},{4,3} } ) );
+		CHECK_THROWS( pl.resampleToCount( 1 ) );
+		CHECK_THROWS( pl.resample( 0 ) );
+	}
+	{                                                  // resampling, closed
+		std::vector<Point2d> vpts{ {0,0},{2,0},{2,2},{0,2} };
+		CPolyline pl( vpts );
+		pl.resampleToCount( 8 );
+		CHECK( pl.size() == 8 );
+		CHECK( pl.length() == Approx( 8. ) );
+
+		pl.set( vpts );
+		pl.resample( 3 );
+		CHECK( pl == CPolyline( std::vector<Point2d>{ {0,0},{2,1},{0,2} } ) );
+		CHECK_THROWS( pl.resampleToCount( 2 ) );
+	}
+}
+
+TEST_CASE( "Polyline streaming builder", "[polyline-builder]" )
+{
+	CHECK_THROWS( PolylineBuilder_<NUMTYPE>( -1. ) );
+	CHECK_THROWS( PolylineBuilder_<NUMTYPE>( 1., 1 ) );
+	{
+		PolylineBuilder_<NUMTYPE> plb;
+		CHECK( plb.getPolyline().size() == 0 );
+		plb.addPoint( 0, 0 );
+		CHECK( plb.getPolyline().size() == 0 );
+		for( int i=1; i<5; i++ )
+		{
+			plb.addPoint( i, 0 );
+			plb.addPoint( i, 0 );              // duplicates are dropped
+		}
+		plb.addPoint( 4, 1 );
+		CHECK( plb.nbInputPts() == 10 );
+		CHECK( plb.getPolyline() == OPolyline_<NUMTYPE>( std::vector<Point2d_<NUMTYPE>>{ {0,0}, {4,0}, {4,1} } ) );
+
+		plb.newPolyline();
+		plb.newPolyline();                     // no effect if current is empty
+		plb.addPoint( Point2d_<NUMTYPE>( 10, 10 ) );
+		plb.addPoint( Point2d_<NUMTYPE>( 11, 11 ) );
+		auto vpl = plb.getPolylines();
+		CHECK( vpl.size() == 2 );
+		CHECK( vpl[1].size() == 2 );
+		plb.clear();
+		CHECK( plb.getPolylines().size() == 0 );
+	}
+	{                                          // finished polylines moved out
+		PolylineBuilder_<NUMTYPE> plb;
+		for( int j=0; j<3; j++ )
+		{
+			plb.addPoint( 0, j );
+			plb.addPoint( 5, j );
+			plb.newPolyline();
+		}
+		plb.addPoint( 1, 1 );
+		plb.addPoint( 2, 2 );
+		auto vpl = plb.takePolylines();
+		CHECK( vpl.size() == 3 );
+		CHECK( vpl[2].getPoint(0) == Point2d_<NUMTYPE>( 0, 2 ) );
+		CHECK( plb.takePolylines().size() == 0 );
+		CHECK( plb.getPolylines().size() == 1 );               // current one is kept
+		CHECK( plb.getPolyline().size() == 2 );
+	}
+	{                                          // finished polylines given to a callback, not stored
+		PolylineBuilder_<NUMTYPE> plb;
+		size_t nbPl = 0;
+		size_t nbPts = 0;
+		plb.setEmitCallback(
+			[&nbPl,&nbPts]                                      // lambda
+			( OPolyline_<NUMTYPE>&& pl )
+			{
+				nbPl++;
+				nbPts += pl.size();
+			}
+		);
+		for( int j=0; j<1000; j++ )
+		{
+			for( int i=0; i<10; i++ )
+				plb.addPoint( i, (i%2) * 2 );
+			plb.newPolyline();
+		}
+		CHECK( nbPl == 1000 );
+		CHECK( nbPts == 10000 );
+		CHECK( plb.getPolylines().size() == 0 );
+		CHECK( plb.takePolylines().size() == 0 );
+
+		plb.setEmitCallback( nullptr );                       // back to default
+		plb.addPoint( 0, 0 );
+		plb.addPoint( 1, 0 );
+		plb.newPolyline();
+		CHECK( nbPl == 1000 );
+		CHECK( plb.getPolylines().size() == 1 );
+	}
+	{                                          // window size limit
+		PolylineBuilder_<NUMTYPE> plb( 0.1, 10 );
+		for( int i=0; i<=100; i++ )
+			plb.addPoint( i, 0 );
+		CHECK( plb.getPolyline().size() == 11 );
+	}
+	{                                          // noisy curve: each input point is within tolerance
+		std::srand( 789 );
+		PolylineBuilder_<NUMTYPE> plb( 0.5 );
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( int i=0; i<2000; i++ )
+		{
+			vpts.emplace_back( i/10., 20.*std::sin(i/200.) + (std::rand()%100)/500. );
+			plb.addPoint( vpts.back() );
+		}
+		auto pl = plb.getPolyline();
+		CHECK( pl.size() < 200 );
+		CHECK( pl.getPoint(0) == vpts.front() );
+		CHECK( pl.getPoint( pl.size()-1 ) == vpts.back() );
+		size_t nbErr = 0;
+		for( const auto& pt: vpts )
+		{
+			auto dmin = std::numeric_limits<double>::max();
+			for( const auto& seg: pl.getSegsView() )
+				dmin = std::min( dmin, (double)seg.distTo( pt ) );
+			if( dmin > 0.5+1E-8 )
+				nbErr++;
+		}
+		CHECK( nbErr == 0 );
+	}
+}
+
 TEST_CASE( "Polyline basic", "[polyline-basic]" )
 {
 	std::vector<Point2d_<NUMTYPE>> vpts{ {0,0}, {1,0}, {1,1} };
@@ -3701,6 +4383,20 @@ TEST_CASE( "Polyline basic", "[polyline-basic]" )
 	CHECK( cpol.getOSegs() == voseg_c );
 	CHECK( opol.getOSegs() == voseg_o );
 
+	{                                                         // segment views
+		auto sv_c = cpol.getSegsView();
+		auto sv_o = opol.getSegsView();
+		CHECK( sv_c.size() == 3 );
+		CHECK( sv_o.size() == 2 );
+		CHECK( std::vector<Segment_<NUMTYPE>>( sv_c.begin(), sv_c.end() ) == vseg_c );
+		CHECK( std::vector<Segment_<NUMTYPE>>( sv_o.begin(), sv_o.end() ) == vseg_o );
+		CHECK( sv_c.back() == vseg_c.back() );
+		CHECK( cpol.getOSegsView()[2] == os2 );
+		CHECK( opol.getOSegsView().back() == os1 );
+		CHECK( CPolyline_<NUMTYPE>().getSegsView().empty() );
+		CHECK( OPolyline_<NUMTYPE>().getOSegsView().size() == 0 );
+	}
+
 	CHECK( cpol.getOSegment(0) == os0 );
 	CHECK( opol.getOSegment(0) == os0 );
 
@@ -3785,6 +4481,333 @@ TEST_CASE( "Polygon area", "[polyline-area]" )
 	CHECK( plo.area() == 0. );
 }
 
+TEST_CASE( "Polygon area, length and centroid with large coordinates", "[polyline-reductions]" )
+{
+#ifdef HOMOG2D_VECTORIZE
+	double eps = 1E-11;             // compensated sums, relative to first point
+#else
+	double eps = 1E-6;
+#endif
+	CPolyline pl( 1000., 1001 );    // regular polygon, centered on (0,0)
+	auto area = pl.area();
+	auto length = pl.length();
+	auto c0 = pl.centroid();
+	CHECK( c0.distTo( Point2d(0,0) ) < 1E-9 );
+
+	pl.translate( 1E7, -3E7 );
+	CHECK( pl.area()   == Approx( area ).epsilon( eps ) );
+	CHECK( pl.length() == Approx( length ).epsilon( eps ) );
+	CPolyline pl2( pl.getPts() );   // so that nothing is kept from translation
+	CHECK( pl2.area()   == Approx( area ).epsilon( eps ) );
+	CHECK( pl2.length() == Approx( length ).epsilon( eps ) );
+	auto c = pl2.centroid();
+	CHECK( c.getX() - 1E7 == Approx( 0. ).margin( 1E7*eps ) );
+	CHECK( c.getY() + 3E7 == Approx( 0. ).margin( 1E7*eps ) );
+
+	CPolylineSoA_<double> plsoa( pl.getPts() );
+	CHECK( plsoa.area()   == Approx( area ).epsilon( eps ) );
+	CHECK( plsoa.length() == Approx( length ).epsilon( eps ) );
+	CHECK( plsoa.centroid().distTo( c ) < 1E7*eps );
+}
+
+TEST_CASE( "clipping against rectangle", "[clip]" )
+{
+	FRect rect( -3,-2, 4,5 );
+	{                                      // segments
+		auto r1 = Segment( -5,0, 5,0 ).clip( rect );
+		CHECK( r1.first );
+		CHECK( r1.second == Segment( -3,0, 4,0 ) );
+		auto r2 = Segment( 0,0, 1,1 ).clip( rect );   // inside: unchanged
+		CHECK( r2.first );
+		CHECK( r2.second == Segment( 0,0, 1,1 ) );
+		CHECK( !Segment( 10,10, 11,11 ).clip( rect ).first );
+		CHECK( !Segment( -5,-7, -3,-2 ).clip( rect ).first ); // touches a corner
+		auto r5 = Segment( -5,5, 5,5 ).clip( rect );        // on the border: kept
+		CHECK( r5.first );
+		CHECK( r5.second == Segment( -3,5, 4,5 ) );
+		CHECK( !Segment( -5,-5, 5,-5 ).clip( rect ).first );
+
+		auto r3 = OSegment( 5,1, 0,1 ).clip( rect );        // orientation is kept
+		CHECK( r3.first );
+		CHECK( r3.second.getPts().first  == Point2d( 4,1 ) );
+		CHECK( r3.second.getPts().second == Point2d( 0,1 ) );
+
+		auto r4 = clip( Segment( -10,-10, 10,10 ), rect );  // free function
+		CHECK( r4.first );
+		CHECK( r4.second == Segment( -2,-2, 4,4 ) );
+
+		std::vector<Segment> vseg{ Segment( -5,0, 5,0 ), Segment( 10,10, 11,11 ), Segment( 0,0, 1,1 ) };
+		auto vclip = clip( vseg, rect );
+		CHECK( vclip.size() == 2 );
+		CHECK( vclip[0] == Segment( -3,0, 4,0 ) );
+		CHECK( vclip[1] == Segment( 0,0, 1,1 ) );
+		std::list<OSegment> lseg{ OSegment( 10,10, 11,11 ) };
+		CHECK( clip( lseg, rect ).empty() );
+	}
+	{                                      // closed polylines
+		CPolyline sq( std::vector<Point2d>{ {0,0}, {6,0}, {6,6}, {0,6} } );
+		auto c1 = sq.clip( rect );
+		CHECK( c1.size() == 4 );
+		CHECK( c1.area() == Approx( 20. ) );
+		CHECK( c1.getBB() == FRect( 0,0, 4,5 ) );
+
+		CPolyline inside( std::vector<Point2d>{ {0,0}, {1,0}, {1,1} } );
+		CHECK( inside.clip( rect ) == inside );
+		CPolyline outside( std::vector<Point2d>{ {10,0}, {11,0}, {11,1} } );
+		CHECK( outside.clip( rect ).size() == 0 );
+		CPolyline around( FRect( -10,-10, 10,10 ) );
+		CHECK( around.clip( rect ).area() == Approx( rect.area() ) );
+
+		CPolyline conc( std::vector<Point2d>{ {-5,0}, {5,0}, {5,4}, {0,1}, {-5,4} } );
+		auto c2 = clip( conc, rect );
+		CHECK( c2.size() == 5 );
+		CHECK( c2.area() == Approx( 14.5 ) );
+		CHECK( c2.getBB() == FRect( -3,0, 4,3.4 ) );
+		CHECK( CPolyline().clip( rect ).size() == 0 );
+	}
+	{                                      // open polylines
+		OPolyline op( std::vector<Point2d>{ {-5,0}, {0,0}, {0,8}, {2,8}, {2,1}, {3,1}, {10,1} } );
+		auto v = op.clip( rect );
+		CHECK( v.size() == 2 );
+		CHECK( v[0] == OPolyline( std::vector<Point2d>{ {-3,0}, {0,0}, {0,5} } ) );
+		CHECK( v[1] == OPolyline( std::vector<Point2d>{ {2,5}, {2,1}, {3,1}, {4,1} } ) );
+		CHECK( v[0].length() + v[1].length() == Approx( 14. ) );
+
+		OPolyline op2( std::vector<Point2d>{ {10,0}, {11,0}, {11,1} } );
+		CHECK( op2.clip( rect ).empty() );
+		CHECK( OPolyline().clip( rect ).empty() );
+	}
+}
+
+TEST_CASE( "homography applied to sets of points", "[homogr-batch]" )
+{
+	Homogr h;
+	h.set( 0,0, 1.1 ); h.set( 0,1, 0.2 );  h.set( 0,2, 3.  );
+	h.set( 1,0, -0.1); h.set( 1,1, 0.9 );  h.set( 1,2, -2. );
+	h.set( 2,0, 1E-3); h.set( 2,1, -2E-3);
+	std::vector<Point2d> vpts;
+	for( int i=0; i<37; i++ )     // not a multiple of the vector size
+		vpts.emplace_back( i*3.-50., 20.-i*i/7. );
+
+	std::vector<Point2d> vref;
+	for( const auto& pt: vpts )
+		vref.push_back( h * pt );
+
+	auto vout = h * vpts;
+	CHECK( vout.size() == vpts.size() );
+	CHECK( vout == vref );
+	auto vin = vpts;
+	h.applyTo( vin );
+	CHECK( vin == vref );
+
+	std::array<Point2d,3> arr{ vpts[0], vpts[1], vpts[2] };
+	auto arr2 = h * arr;
+	h.applyTo( arr );
+	std::list<Point2d> li{ vpts[0], vpts[1], vpts[2] };
+	auto li2 = h * li;
+	for( size_t i=0; i<3; i++ )
+	{
+		CHECK( arr[i]  == vref[i] );
+		CHECK( arr2[i] == vref[i] );
+		CHECK( *std::next( li2.begin(), i ) == vref[i] );
+	}
+
+	std::vector<double> vx, vy;
+	for( const auto& pt: vpts )
+	{
+		vx.push_back( pt.getX() );
+		vy.push_back( pt.getY() );
+	}
+	std::vector<double> vx2( vx.size() ), vy2( vx.size() );
+	const auto& cvx = vx;
+	const auto& cvy = vy;
+	h.applyTo( cvx.data(), cvy.data(), vx2.data(), vy2.data(), vx.size() );
+	h.applyTo( vx.data(), vy.data(), vx.size() );
+	for( size_t i=0; i<vx.size(); i++ )
+	{
+		CHECK( vx[i]  == Approx( vref[i].getX() ) );
+		CHECK( vy[i]  == Approx( vref[i].getY() ) );
+		CHECK( vx2[i] == vx[i] );
+		CHECK( vy2[i] == vy[i] );
+	}
+
+	CPolylineSoA_<double> pls( vpts );
+	auto pls2 = h * pls;
+	CHECK( pls2.size() == pls.size() );
+	CHECK( pls2.getPolyline() == CPolyline( vref ) );
+
+	Homogr h2;                        // maps points with x=0 to infinity
+	h2.set( 2,0, 1. );
+	h2.set( 2,2, 0. );
+	std::vector<Point2d> v2{ {0,1}, {1,1} };
+	auto v3 = h2 * v2;
+	CHECK( v3[0].isInf() );
+	CHECK( v3[0].get()[1] != 0. );
+	CHECK( v3[1] == Point2d( 1,1 ) );
+	double ax[] = { 0., 1. };
+	double ay[] = { 1., 1. };
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( h2.applyTo( ax, ay, 2 ) );
+#else
+	h2.applyTo( ax, ay, 2 );
+#endif
+	CHECK( ax[1] == 1. );                   // other points are processed anyway
+}
+
+TEST_CASE( "Polyline SoA storage", "[polyline-soa]" )
+{
+	std::vector<Point2d> vpts{ {0,0}, {2,0}, {2,2}, {1,2}, {1,1}, {0,1} };
+	CPolyline_<NUMTYPE>    cpl( vpts );
+	CPolylineSoA_<NUMTYPE> cpls( vpts );
+	OPolyline_<NUMTYPE>    opl( vpts );
+	OPolylineSoA_<NUMTYPE> opls( opl );
+
+	CHECK( cpls.size()   == 6 );
+	CHECK( cpls.nbSegs() == 6 );
+	CHECK( opls.nbSegs() == 5 );
+	CHECK( cpls.isClosed() );
+	CHECK( !opls.isClosed() );
+
+	auto xs = cpls.getXs();
+	auto ys = cpls.getYs();
+	CHECK( xs.size() == 6 );
+	CHECK( xs[2] == 2 );
+	CHECK( ys[3] == 2 );
+	CHECK( std::accumulate( xs.begin(), xs.end(), 0. ) == 6. );
+
+	CHECK( cpls.getPoint(3) == cpl.getPoint(3) );
+	CHECK( cpls.getSegment(5) == cpl.getSegment(5) );
+	CHECK( cpls.getPolyline() == cpl );
+	CHECK( opls.getPolyline() == opl );
+
+	CHECK( cpls.length() == Approx( cpl.length() ) );
+	CHECK( opls.length() == Approx( opl.length() ) );
+	CHECK( cpls.isSimple() );
+	CHECK( !opls.isSimple() );
+	CHECK( cpls.area() == Approx( 3. ) );
+	CHECK( opls.area() == 0. );
+	CHECK( cpls.getBB() == cpl.getBB() );
+	CHECK( cpls.centroid() == cpl.centroid() );
+
+	cpls.translate( 1, 2 );
+	CHECK( cpls.getBB() == FRect( 1,2, 3,4 ) );
+	CHECK( cpls.area() == Approx( 3. ) );
+
+	std::vector<Point2d> vcross{ {0,0}, {2,0}, {0,2}, {2,2} };       // "bow-tie"
+	CPolylineSoA_<NUMTYPE> cross( vcross );
+	CHECK( !cross.isSimple() );
+	CHECK( cross.isSimple() == CPolyline_<NUMTYPE>( vcross ).isSimple() );
+	CHECK( cross.area() == 0. );
+
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( CPolylineSoA_<NUMTYPE>( std::vector<Point2d>{ {0,0}, {0,0}, {1,1} } ) );
+#endif
+	cpls.clear();
+	CHECK( cpls.size() == 0 );
+	CHECK( cpls.length() == 0. );
+}
+
+/// Reference implementation of the polyline intersection, checks all the segments
+template<typename PL,typename T>
+std::vector<Point2d_<NUMTYPE>>
+bruteForceInters( const PL& pl, const T& other )
+{
+	detail::IntersectM<NUMTYPE> out;
+	for( const auto& seg: pl.getSegs() )
+	{
+		auto inters = seg.intersects( other );
+		if( inters() )
+			out.add( inters.get() );
+	}
+	return out.get();
+}
+
+TEST_CASE( "Polyline intersections (segment hierarchy)", "[polyline-inters-bvh]" )
+{
+	std::srand( 123 );
+	std::vector<Point2d_<NUMTYPE>> vpts1, vpts2;
+	for( int i=0; i<300; i++ )  // random zigzags, with lots of crossings
+	{
+		vpts1.emplace_back( i, 1.0*rand()/RAND_MAX * 50. );
+		vpts2.emplace_back( 1.0*rand()/RAND_MAX * 300., 0.5*i - 25. );
+	}
+	CPolyline_<NUMTYPE> cpol( vpts1 );
+	OPolyline_<NUMTYPE> opol( vpts2 );
+
+	Line2d_<NUMTYPE>  li( Point2d(0,10), Point2d(300,40) );
+	Segment_<NUMTYPE> seg( 10,5, 200,45 );
+	Circle_<NUMTYPE>  cir( 150,25, 20 );
+	FRect_<NUMTYPE>   rect( 40,10, 90,30 );
+
+	CHECK( cpol.intersects( li   ).get() == bruteForceInters( cpol, li   ) );
+	CHECK( cpol.intersects( seg  ).get() == bruteForceInters( cpol, seg  ) );
+	CHECK( cpol.intersects( cir  ).get() == bruteForceInters( cpol, cir  ) );
+	CHECK( cpol.intersects( rect ).get() == bruteForceInters( cpol, rect ) );
+	CHECK( cpol.intersects( opol ).get() == bruteForceInters( cpol, opol ) );
+	CHECK( opol.intersects( cpol ).size() == cpol.intersects( opol ).size() );
+	CHECK( cpol.intersects( opol ).size() > 100 );
+
+// hierarchy must be rebuilt after modification
+	auto n1 = cpol.intersects( seg ).size();
+	cpol.translate( 0, 1000 );
+	CHECK( cpol.intersects( seg ).size() == 0 );
+	cpol.translate( 0, -1000 );
+	CHECK( cpol.intersects( seg ).size() == n1 );
+	cpol.moveTo( 0, 1000 );
+	CHECK( cpol.intersects( seg ).size() == 0 );
+
+	CPolyline_<NUMTYPE> empty;
+	CHECK( !empty.intersects( seg )() );
+	CHECK( !empty.intersects( opol )() );
+	CHECK( !opol.intersects( empty )() );
+}
+
+TEST_CASE( "Polygon isSimple(), sweep vs. brute force", "[polyline-issimple]" )
+{
+	std::srand( 456 );
+	size_t nbSimple = 0;
+	for( int k=0; k<400; k++ )
+	{
+		size_t n = 4 + k%20;
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( size_t i=0; i<n; i++ )
+		{
+			if( k%2 )      // random points
+				vpts.emplace_back( 1.0*rand()/RAND_MAX * 100., 1.0*rand()/RAND_MAX * 100. );
+			else           // star-shaped polygon (simple, unless some noise is added)
+			{
+				auto angle = 2. * M_PI * i / n;
+				auto rad = 20. + 1.0*rand()/RAND_MAX * ( k%4 ? 30. : 80. );
+				vpts.emplace_back( 50. + rad*std::cos(angle), 50. + rad*std::sin(angle) + ( k%8==0 ? rand()%40 : 0 ) );
+			}
+		}
+		CPolyline_<NUMTYPE> pol( vpts );
+		CHECK( pol.isSimple() == pol.isSimpleBruteForce() );
+		nbSimple += pol.isSimple();
+	}
+	CHECK( nbSimple > 100 );
+
+// degenerate cases: vertical segments, touching vertices
+	CPolyline_<NUMTYPE> p1( std::vector<Point2d>{ {0,0}, {2,0}, {2,2}, {1,1}, {1,3}, {0,3} } );
+	CHECK( p1.isSimple() == p1.isSimpleBruteForce() );
+	CPolyline_<NUMTYPE> p2( std::vector<Point2d>{ {0,0}, {2,0}, {1,1}, {2,2}, {0,2}, {1,1} } ); // "bow tie"
+	CHECK( p2.isSimple() == false );
+	CHECK( p2.isSimpleBruteForce() == false );
+	CPolyline_<NUMTYPE> p3( std::vector<Point2d>{ {0,0}, {0,2}, {1,2}, {1,1}, {2,1}, {2,0} } );
+	CHECK( p3.isSimple() == true );
+	CHECK( p3.isSimpleBruteForce() == true );
+	CPolyline_<NUMTYPE> p4( std::vector<Point2d>{ {0,0}, {3,0}, {3,3}, {0,3}, {0,1}, {4,1}, {4,2}, {0,2} } );
+	CHECK( p4.isSimple() == p4.isSimpleBruteForce() );
+	CPolyline_<NUMTYPE> p5( std::vector<Point2d>{ {2,2}, {1,3}, {2,0}, {0,4} } ); // "spike"
+	CHECK( p5.isSimple() == p5.isSimpleBruteForce() );
+	CPolyline_<NUMTYPE> p6( std::vector<Point2d>{ {2,0}, {1,3}, {2,3}, {3,3}, {3,0}, {0,0} } ); // spike hiding a crossing
+	CHECK( p6.isSimple() == false );
+	CHECK( p6.isSimpleBruteForce() == false );
+	CPolyline_<NUMTYPE> p7( std::vector<Point2d>{ {1,1}, {0,0}, {3,0}, {2,0}, {1,0} } );       // collinear overlapping segments
+	CHECK( p7.isSimple() == false );
+	CHECK( p7.isSimpleBruteForce() == false );
+}
+
 TEST_CASE( "Polyline comparison 2", "[polyline-comp-2]" )
 {
 	{
@@ -3931,30 +4954,40 @@ TEST_CASE( "drawing (OpenCV)", "[draw_ocv]" )
 
 TEST_CASE( "convex hull", "[conv_hull]" )
 {
-	{
-		CPolyline_<NUMTYPE> pl;
-
-		pl.set( FRect_<NUMTYPE>(1,1,3,3) );
-		CHECK( priv::chull::getPivotPoint(pl.getPts() ) == 0 );
+	{                                          // small sets (behaviour changed from 2.13, see manual)
+		std::vector<Point2d> v2{ {0,0}, {1,1} };
+		CHECK( convexHull( v2 ).size() == 2 );                       // less than 3: as is
+		std::vector<Point2d> v3{ {0,0}, {1,1}, {2,2} };
+		auto ch = convexHull( v3 );
+		CHECK( ch.size() == 2 );                                     // collinear: extreme points
+		CHECK( ch.getPoint(0) == Point2d(0,0) );
+		CHECK( ch.getPoint(1) == Point2d(2,2) );
+		CHECK( convexHullIdx( v3 ) == std::vector<size_t>{ 0, 2 } );
+		std::vector<Point2d> v4{ {0,0}, {4,0}, {2,-1E-9}, {2,2} };       // nearly collinear, but outside: kept
+		CHECK( convexHull( v4 ).size() == 4 );
+		std::vector<Point2d> v5{ {0,0}, {4,0}, {2,0}, {2,2} };           // exactly collinear: removed
+		CHECK( convexHull( v5 ).size() == 3 );
+	}
+	{                                          // first point and orientation of the hull
+		CPolyline_<NUMTYPE> pl( FRect_<NUMTYPE>(1,1,3,3) );
+		CHECK( convexHullIdx( pl ) == std::vector<size_t>{ 0,3,2,1 } );  // rectangle points are clockwise
+		CHECK( convexHull( pl ).getPts()[0] == Point2d(1,1) );
 
 		std::vector<Point2d> v1{ {0,0}, {2,0}, {2,2}, {1,2}, {1,1}, {0,1} };
-		pl.set( v1 );
-		CHECK( priv::chull::getPivotPoint(pl.getPts() ) == 0 );
-
+		CHECK( convexHullIdx( v1 ) == std::vector<size_t>{ 0,1,2,3,5 } );
 		std::rotate( v1.begin(), v1.begin()+1, v1.end() );
-		pl.set( v1 );
-		CHECK( priv::chull::getPivotPoint(pl.getPts() ) == 5 );
-
+		CHECK( convexHullIdx( v1 ) == std::vector<size_t>{ 5,0,1,2,4 } );
 		std::rotate( v1.begin(), v1.begin()+1, v1.end() );
-		pl.set( v1 );
-		CHECK( priv::chull::getPivotPoint(pl.getPts() ) == 4 );
+		CHECK( convexHullIdx( v1 ) == std::vector<size_t>{ 4,5,0,1,3 } );
+		CHECK( convexHull( v1 ).getPts()[0] == Point2d(0,0) );
+
+		std::vector<Point2d> v2{ {1,0}, {2,1}, {1,2}, {0,1} };     // starts from the lowest x, not the lowest y
+		CHECK( convexHullIdx( v2 ) == std::vector<size_t>{ 3,0,1,2 } );
+		CHECK( convexHull( v2 ).getPts()[0] == Point2d(0,1) );
 	}
 	{
 #include "figures_test/polyline_chull_1.code"
-		auto vp = pl.getPts();
-		CHECK( priv::chull::getPivotPoint(pl.getPts() ) == 0 );
-		auto vout = priv::chull::sortPoints( vp, 0 );
-		CHECK( vout == std::vector<size_t>{ 0,1,2,3 } );
+		CHECK( convexHullIdx( pl ) == std::vector<size_t>{ 0,1,3 } );
 		auto ch = convexHull( pl );
 		CHECK( ch == CPolyline(
 				std::vector<Point2d>{
@@ -3977,6 +5010,568 @@ TEST_CASE( "convex hull", "[conv_hull]" )
 		auto ch2 = pl1.convexHull();
 		CHECK( ch2.size() == 2 );
 	}
+	{                                  // collinear and duplicate points are removed
+		std::vector<Point2d> vpt{ {0,0},{1,0},{2,0},{2,2},{2,2},{0,2},{1,1},{0,1} };
+		auto vidx = convexHullIdx( vpt );
+		CHECK( vidx == std::vector<size_t>{ 0,2,3,5 } );
+		CHECK( convexHull( vpt ) == CPolyline( FRect(0,0,2,2) ) );
+
+		std::list<Point2d> lpt( vpt.begin(), vpt.end() );
+		CHECK( convexHullIdx( lpt ) == vidx );
+		CHECK( convexHull( lpt ) == CPolyline( FRect(0,0,2,2) ) );
+
+		std::array<Point2d,4> apt{ Point2d(0,0), Point2d(1,1), Point2d(2,2), Point2d(3,3) };
+		CHECK( convexHullIdx( apt ) == std::vector<size_t>{ 0,3 } );
+		CHECK( convexHull( apt ).size() == 2 );
+	}
+	{                                  // parallel and sequential must give the same result
+		std::srand( 42 );
+		std::vector<Point2d> vpt;
+		for( int i=0; i<2000; i++ )
+			vpt.emplace_back( std::rand()%500, std::rand()%500 );
+		auto vidx = convexHullIdx( vpt );
+		auto ch = convexHull( vpt );
+		CHECK( ch.size() == vidx.size() );
+		CHECK( ch.isSimple() );
+		CHECK( ch.isConvex() );
+		size_t nbOut = 0;                         // no point on the right side of any hull edge
+		for( size_t i=0; i<vidx.size(); i++ )
+		{
+			const auto& p1 = vpt[ vidx[i] ];
+			const auto& p2 = vpt[ vidx[(i+1)%vidx.size()] ];
+			for( const auto& pt: vpt )
+			{
+				auto dx1 = p2.getX() - p1.getX();
+				auto dy1 = p2.getY() - p1.getY();
+				auto dx2 = pt.getX() - p1.getX();
+				auto dy2 = pt.getY() - p1.getY();
+				if( dx1*dy2 - dy1*dx2 < 0 )
+					nbOut++;
+			}
+		}
+		CHECK( nbOut == 0 );
+
+		ConvexHullParams par;
+		par._parallelMinSize = 100;
+		for( size_t nbt: { 2, 3, 7 } )
+		{
+			par._nbThreads = nbt;
+			CHECK( convexHullIdx( vpt, par ) == vidx );
+		}
+		std::list<Point2d> lpt( vpt.begin(), vpt.end() );
+		CHECK( convexHull( lpt, par ) == ch );
+	}
+}
+
+TEST_CASE( "online convex hull", "[conv_hull_builder]" )
+{
+	{
+		ConvexHullBuilder chb;
+		CHECK( chb.size() == 0 );
+		CHECK( chb.getHull().size() == 0 );
+		CHECK( chb.addPoint( 1, 1 ) );
+		CHECK( chb.size() == 1 );
+		CHECK( chb.getHull().size() == 0 );
+		CHECK( !chb.addPoint( 1, 1 ) );
+		CHECK( chb.addPoint( 1, 3 ) );             // vertical segment
+		CHECK( chb.size() == 2 );
+		CHECK( chb.getHull().size() == 2 );
+		CHECK( !chb.addPoint( 1, 2 ) );
+		CHECK( !chb.isInside( Point2d(1,2) ) );
+		CHECK( chb.addPoint( 3, 1 ) );
+		CHECK( chb.size() == 3 );
+		CHECK( chb.getHull() == CPolyline( std::vector<Point2d>{ {1,1},{3,1},{1,3} } ) );
+		CHECK( !chb.addPoint( 2, 2 ) );             // on the hull
+		CHECK( !chb.addPoint( 1.5, 1.5 ) );         // inside
+		CHECK(  chb.isInside( Point2d(1.5,1.5) ) );
+		CHECK( !chb.isInside( Point2d(2,2) ) );
+		CHECK( !chb.isInside( Point2d(1,2) ) );
+		CHECK( !chb.isInside( Point2d(3,3) ) );
+		CHECK( chb.addPoint( 3, 3 ) );
+		CHECK( chb.getHull() == CPolyline( FRect(1,1,3,3) ) );
+		CHECK( chb.isInside( Point2d(2.5,2.5) ) );
+		CHECK( chb.nbInputPts() == 8 );
+		chb.clear();
+		CHECK( chb.size() == 0 );
+		CHECK( chb.nbInputPts() == 0 );
+	}
+	{                                  // collinear points
+		ConvexHullBuilder chb( std::list<Point2d>{ {0,0},{2,2},{1,1},{3,3} } );
+		CHECK( chb.size() == 2 );
+		CHECK( chb.getHull().size() == 2 );
+	}
+	{                                  // compare with convexHull()
+		std::srand( 123 );
+		std::vector<Point2d> vpt;
+		ConvexHullBuilder chb;
+		for( int i=0; i<1000; i++ )
+		{
+			Point2d pt( std::rand()%200, std::rand()%200 );
+			vpt.push_back( pt );
+			chb.addPoint( pt );
+			if( i%50 == 49 )
+			{
+				auto ch = convexHull( vpt );
+				CHECK( chb.getHull() == ch );
+				CHECK( chb.size() == ch.size() );
+
+				auto vidx = convexHullIdx( vpt );
+				size_t nbErr = 0;
+				for( int j=0; j<50; j++ )
+				{
+					Point2d q( std::rand()%210-5, std::rand()%210-5 );
+					bool inside = true;
+					for( size_t k=0; k<vidx.size(); k++ )
+					{
+						const auto& p1 = vpt[ vidx[k] ];
+						const auto& p2 = vpt[ vidx[(k+1)%vidx.size()] ];
+						auto cr = ( p2.getX() - p1.getX() ) * ( q.getY() - p1.getY() )
+							- ( p2.getY() - p1.getY() ) * ( q.getX() - p1.getX() );
+						if( cr <= 0 )
+							inside = false;
+					}
+					if( inside != chb.isInside( q ) )
+						nbErr++;
+				}
+				CHECK( nbErr == 0 );
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////
+/////           POLYGON BOOLEAN OPERATIONS                /////
+//////////////////////////////////////////////////////////////
+
+TEST_CASE( "polygon boolean operations", "[boolop]" )
+{
+	{                                                   // two overlapping squares
+		CPolyline p1( FRect(0,0,4,4) );
+		CPolyline p2( FRect(2,2,6,6) );
+		auto ru = booleanOp( p1, p2, BoolOp::Union );
+		auto ri = booleanOp( p1, p2, BoolOp::Intersection );
+		auto rd = booleanOp( p1, p2, BoolOp::Difference );
+		auto rx = booleanOp( p1, p2, BoolOp::Xor );
+		CHECK( ru.size() == 1 );
+		CHECK( ri.size() == 1 );
+		CHECK( rd.size() == 1 );
+		CHECK( ru.nbHoles() == 0 );
+		CHECK( ru.getContour(0).size() == 8 );
+		CHECK( ri.getContour(0) == CPolyline( FRect(2,2,4,4) ) );
+		CHECK( rd.getContour(0).size() == 6 );
+		CHECK( ru.area() == Approx(28.) );
+		CHECK( ri.area() == Approx( 4.) );
+		CHECK( rd.area() == Approx(12.) );
+		CHECK( rx.area() == Approx(24.) );
+		CHECK( !ru.isHole(0) );
+		CHECK_THROWS( ru.getOuter(0) );
+	}
+	{                                                   // square with a hole
+		CPolyline p1( FRect(0,0,10,10) );
+		CPolyline p2( FRect(3,3,6,6) );
+		auto rd = booleanOp( p1, p2, BoolOp::Difference );
+		CHECK( rd.size() == 2 );
+		CHECK( rd.nbHoles() == 1 );
+		size_t ih = rd.isHole(0) ? 0 : 1;
+		CHECK( rd.getOuter(ih) == 1-ih );
+		CHECK( rd.getContour(ih) == p2 );
+		CHECK( rd.area() == Approx(91.) );
+
+		auto ru = booleanOp( p1, p2, BoolOp::Union );
+		CHECK( ru.size() == 1 );
+		CHECK( ru.getContour(0) == p1 );
+		auto ri = booleanOp( p1, p2, BoolOp::Intersection );
+		CHECK( ri.size() == 1 );
+		CHECK( ri.getContour(0) == p2 );
+		CHECK( booleanOp( p2, p1, BoolOp::Difference ).empty() );
+	}
+	{                                                   // disjoint
+		CPolyline p1( FRect(0,0,1,1) );
+		CPolyline p2( FRect(2,2,3,3) );
+		CHECK( booleanOp( p1, p2, BoolOp::Intersection ).empty() );
+		CHECK( booleanOp( p1, p2, BoolOp::Union ).size() == 2 );
+		CHECK( booleanOp( p1, p2, BoolOp::Difference ).size() == 1 );
+		CHECK( booleanOp( p1, p2, BoolOp::Xor ).area() == Approx(2.) );
+	}
+	{                                                   // empty inputs
+		CPolyline p1( FRect(0,0,1,1) );
+		CPolyline p0;
+		CHECK( booleanOp( p1, p0, BoolOp::Intersection ).empty() );
+		CHECK( booleanOp( p0, p1, BoolOp::Difference ).empty() );
+		CHECK( booleanOp( p1, p0, BoolOp::Difference ).size() == 1 );
+		CHECK( booleanOp( p0, p1, BoolOp::Union ).size() == 1 );
+		CHECK( booleanOp( p0, p0, BoolOp::Xor ).empty() );
+	}
+	{                                                   // non-convex polygons: check area identities
+		CPolyline p1( std::vector<Point2d>{ {0,0},{6,0},{6,5},{4,5},{4,2},{2,2},{2,5},{0,5} } );
+		CPolyline p2( std::vector<Point2d>{ {-1,3},{7,3},{7,4},{-1,4} } );
+		auto ai = booleanOp( p1, p2, BoolOp::Intersection ).area();
+		auto au = booleanOp( p1, p2, BoolOp::Union ).area();
+		auto ad = booleanOp( p1, p2, BoolOp::Difference ).area();
+		auto ax = booleanOp( p1, p2, BoolOp::Xor ).area();
+		CHECK( ai == Approx(4.) );
+		CHECK( booleanOp( p1, p2, BoolOp::Intersection ).size() == 2 );
+		CHECK( au == Approx( p1.area() + p2.area() - ai ) );
+		CHECK( ad == Approx( p1.area() - ai ) );
+		CHECK( ax == Approx( au - ai ) );
+		CHECK( booleanOp( p1, p2, BoolOp::Difference ).size() == 3 );
+	}
+	{                                                   // star polygons: check area identities
+		auto star = []( double cx, double cy, double r1, double r2, int nb, double a0 )   // lambda
+		{
+			std::vector<Point2d> vpts;
+			for( int i=0; i<2*nb; i++ )
+			{
+				auto a = a0 + M_PI * i / nb;
+				auto r = ( i%2 ? r2 : r1 );
+				vpts.emplace_back( cx + r*std::cos(a), cy + r*std::sin(a) );
+			}
+			return CPolyline( vpts );
+		};
+		for( int k=0; k<20; k++ )
+		{
+			auto p1 = star( 0., 0., 10., 4., 5+k%4, 0.1*k );
+			auto p2 = star( 3.+0.5*k, 1.-0.3*k, 9., 3.5, 6+k%3, 0.7*k );
+			auto ai = booleanOp( p1, p2, BoolOp::Intersection ).area();
+			auto au = booleanOp( p1, p2, BoolOp::Union ).area();
+			CHECK( ai > 0. );
+			CHECK( au + ai == Approx( p1.area() + p2.area() ) );
+			CHECK( booleanOp( p1, p2, BoolOp::Difference ).area() == Approx( p1.area() - ai ) );
+			CHECK( booleanOp( p2, p1, BoolOp::Difference ).area() == Approx( p2.area() - ai ) );
+			CHECK( booleanOp( p1, p2, BoolOp::Xor ).area() == Approx( au - ai ) );
+		}
+	}
+	{                                                   // triangles sharing an edge
+		CPolyline p1( std::vector<Point2d>{ {0,0}, {4,1}, {1,3} } );
+		CPolyline p2( std::vector<Point2d>{ {4,1}, {5,5}, {1,3} } );
+		auto ru = booleanOp( p1, p2, BoolOp::Union );
+		CHECK( ru.size() == 1 );
+		CHECK( ru.getContour(0).size() == 4 );
+		CHECK( ru.area() == Approx( p1.area() + p2.area() ) );
+		CHECK( booleanOp( p1, p2, BoolOp::Intersection ).empty() );
+		CHECK( booleanOp( p1, p2, BoolOp::Difference ).area() == Approx( p1.area() ) );
+		CHECK( booleanOp( p1, p2, BoolOp::Xor ).area() == Approx( ru.area() ) );
+
+		CPolyline p3( std::vector<Point2d>{ {2,0.5}, {6,1.5}, {4,-2} } );   // shares a part of an edge
+		CHECK( booleanOp( p1, p3, BoolOp::Union ).area() == Approx( p1.area() + p3.area() ) );
+		CHECK( booleanOp( p1, p3, BoolOp::Intersection ).empty() );
+		CHECK( booleanOp( p3, p1, BoolOp::Difference ).area() == Approx( p3.area() ) );
+
+		CHECK( booleanOp( p1, p1, BoolOp::Union ).area() == Approx( p1.area() ) );          // identical
+		CHECK( booleanOp( p1, p1, BoolOp::Intersection ).area() == Approx( p1.area() ) );
+		CHECK( booleanOp( p1, p1, BoolOp::Difference ).empty() );
+		CHECK( booleanOp( p1, p1, BoolOp::Xor ).empty() );
+	}
+	{                                                   // triangles sharing a vertex
+		CPolyline p1( std::vector<Point2d>{ {0,0}, {4,1}, {1,3} } );
+		CPolyline p2( std::vector<Point2d>{ {4,1}, {7,0}, {6,2} } );
+		CHECK( booleanOp( p1, p2, BoolOp::Union ).area() == Approx( p1.area() + p2.area() ) );
+		CHECK( booleanOp( p1, p2, BoolOp::Intersection ).empty() );
+		CHECK( booleanOp( p1, p2, BoolOp::Difference ).area() == Approx( p1.area() ) );
+		CHECK( booleanOp( p1, p2, BoolOp::Xor ).area() == Approx( p1.area() + p2.area() ) );
+	}
+	{                          // hole of a degenerate outer contour gets removed too
+		std::vector<priv::boolop::Contour> vc(4);
+		vc[0]._vx = { 0, 1, 2 };  vc[0]._vy = { 0, 1, 2 };     // collinear, gets removed
+		vc[1]._vx = { 0, 1, 1 };  vc[1]._vy = { 0, 0, 1 };  vc[1]._holeOf = 0;
+		vc[2]._vx = { 10, 20, 20, 10 };  vc[2]._vy = { 10, 10, 20, 20 };
+		vc[3]._vx = { 12, 14, 14, 12 };  vc[3]._vy = { 12, 12, 14, 14 };  vc[3]._holeOf = 2;
+		auto res = priv::boolop::buildResult<NUMTYPE>( std::move(vc) );
+		CHECK( res.size()    == 2 );
+		CHECK( res.nbHoles() == 1 );
+		CHECK( !res.isHole(0) );
+		CHECK( res.isHole(1) );
+		CHECK( res.getOuter(1) == 0 );
+		CHECK( res.area() == Approx( 96. ) );
+	}
+}
+
+/// Helper function for triangulation test: returns sum of (signed) areas of triangles
+template<typename T>
+double triangleSum( const CPolyline& pl, const T& tri )
+{
+	const auto& pts = pl.getPts();
+	double sum = 0.;
+	for( const auto& t: tri )
+	{
+		const auto& p0 = pts[t[0]];
+		const auto& p1 = pts[t[1]];
+		const auto& p2 = pts[t[2]];
+		sum += ( ( p1.getX() - p0.getX() ) * ( p2.getY() - p0.getY() ) - ( p1.getY() - p0.getY() ) * ( p2.getX() - p0.getX() ) ) / 2.;
+	}
+	return sum;
+}
+
+TEST_CASE( "polygon triangulation", "[triangulate]" )
+{
+	{
+		CPolyline pl( FRect(0,0,3,2) );
+		auto tri = pl.triangulate();
+		CHECK( tri.size() == 2 );
+		CHECK( std::abs( triangleSum( pl, tri ) ) == Approx( 6. ) );
+		CHECK( triangulate( pl ).size() == 2 );    // free function
+	}
+	{                                            // comb shape, with horizontal edges
+		std::vector<Point2d> vpts{
+			{0,0},{7,0},{7,3},{6,3},{6,1},{5,1},{5,4},{4,4},{4,1},{3,1},{3,2},{2,2},{2,1},{1,1},{1,3},{0,3}
+		};
+		CPolyline pl1( vpts );
+		std::reverse( vpts.begin(), vpts.end() );
+		CPolyline pl2;
+		pl2.getPts() = vpts;                     // so that points are not normalized (clockwise)
+		for( const auto& pl: { pl1, pl2 } )
+		{
+			auto tri = pl.triangulate();
+			CHECK( tri.size() == pl.size()-2 );
+			CHECK( std::abs( triangleSum( pl, tri ) ) == Approx( pl.area() ) );
+			for( const auto& t: tri )            // each triangle has same orientation as polygon
+				CHECK( triangleSum( pl, std::vector<std::array<size_t,3>>{ t } ) * triangleSum( pl, tri ) > 0. );
+		}
+	}
+	{                                            // polygon with monotone decomposition needed (split and merge vertices)
+		CPolyline pl( std::vector<Point2d>{ {0,0},{2,2},{4,0},{6,2},{6,6},{4,4},{2,6},{0,4},{1,3} } );
+		auto tri = pl.triangulate();
+		CHECK( tri.size() == 7 );
+		CHECK( std::abs( triangleSum( pl, tri ) ) == Approx( pl.area() ) );
+	}
+	{
+		OPolyline op( std::vector<Point2d>{ {0,0},{2,0},{2,2} } );
+		CHECK_THROWS( op.triangulate() );
+		CPolyline pl( std::vector<Point2d>{ {0,0},{2,2},{2,0},{0,2} } );   // not simple
+		CHECK_THROWS( pl.triangulate() );
+		CPolyline pl0;
+		CHECK_THROWS( pl0.triangulate() );
+	}
+}
+
+TEST_CASE( "convex polygon", "[convex_polygon]" )
+{
+	CPolyline pl( std::vector<Point2d>{ {0,0},{2,0},{4,0},{4,4},{0,4} } );   // point (2,0) is aligned
+	ConvexPolygon cp( pl );
+	CHECK( cp.size() == 4 );
+	CHECK( cp.getPolyline() == CPolyline( FRect(0,0,4,4) ) );
+
+	CHECK( cp.contains( Point2d(1,1) ) );
+	CHECK( cp.contains( Point2d(3.9,0.1) ) );
+	CHECK( !cp.contains( Point2d(2,0) ) );    // on edge
+	CHECK( !cp.contains( Point2d(5,1) ) );
+	CHECK( !cp.contains( Point2d(-1,5) ) );
+	auto vb = cp.contains( std::vector<Point2d>{ {1,1},{5,5} } );
+	CHECK( vb[0] );
+	CHECK( !vb[1] );
+
+	CHECK( cp.getExtremePoint( CardDir::Top )    == pl.getExtremePoint( CardDir::Top ) );
+	CHECK( cp.getExtremePoint( CardDir::Bottom ) == pl.getExtremePoint( CardDir::Bottom ) );
+	CHECK( cp.getExtremePoint( CardDir::Left )   == pl.getExtremePoint( CardDir::Left ) );
+	CHECK( cp.getExtremePoint( CardDir::Right )  == pl.getExtremePoint( CardDir::Right ) );
+	CHECK( cp.getSupportPoint( 1, 1 )   == Point2d(4,4) );
+	CHECK( cp.getSupportPoint( -1, 1 )  == Point2d(0,4) );
+	CHECK( cp.getSupportPoint( -1, -2 ) == Point2d(0,0) );
+
+	CHECK( cp.distTo( Point2d(1,1) ) == 0. );
+	CHECK( cp.distTo( Point2d(6,2) ) == Approx(2.) );
+	CHECK( cp.distTo( Point2d(7,8) ) == Approx(5.) );
+	CHECK( cp.distTo( Point2d(2,-1) ) == Approx(1.) );
+
+	{
+		auto tg = cp.getTangents( Point2d(6,2) );
+		CHECK( cp.getPts()[tg.first]  == Point2d(4,0) );
+		CHECK( cp.getPts()[tg.second] == Point2d(4,4) );
+		tg = cp.getTangents( Point2d(6,6) );
+		CHECK( cp.getPts()[tg.first]  == Point2d(4,0) );
+		CHECK( cp.getPts()[tg.second] == Point2d(0,4) );
+		CHECK_THROWS( cp.getTangents( Point2d(1,1) ) );
+	}
+	{
+		auto r = cp.intersects( Line2d( Point2d(-1,1), Point2d(5,1) ) );
+		CHECK( r.size() == 2 );
+		CHECK( r.get()[0] == Point2d(0,1) );
+		CHECK( r.get()[1] == Point2d(4,1) );
+		CHECK( cp.intersects( Line2d( Point2d(0,8), Point2d(8,0) ) ).size() == 1 );  // touches at (4,4)
+		CHECK( !cp.intersects( Line2d( Point2d(0,9), Point2d(9,0) ) )() );
+		CHECK( cp.intersects( Line2d( Point2d(0,4), Point2d(4,4) ) ).size() == 2 );  // along an edge
+	}
+
+	CHECK_THROWS( ConvexPolygon( CPolyline( std::vector<Point2d>{ {0,0},{4,0},{2,1},{2,4} } ) ) );  // not convex
+	CHECK_THROWS( ConvexPolygon( CPolyline() ) );
+
+	{
+		ConvexPolygon ecp;                                           // empty
+		CHECK( ecp.size() == 0 );
+		CHECK( !ecp.contains( Point2d(1,1) ) );
+		CHECK( !ecp.intersects( Line2d( Point2d(0,0), Point2d(1,1) ) )() );
+		CHECK_THROWS( ecp.getSupportIdx( 1., 0. ) );
+		CHECK_THROWS( ecp.getSupportPoint( 1., 0. ) );
+		CHECK_THROWS( ecp.getExtremePoint( CardDir::Top ) );
+		CHECK_THROWS( ecp.getTangents( Point2d(1,1) ) );
+		CHECK_THROWS( ecp.distTo( Point2d(1,1) ) );
+	}
+}
+
+TEST_CASE( "convex polyline queries", "[convex_polygon]" )
+{
+	CPolyline pl( std::vector<Point2d>{ {0,0},{4,0},{5,2},{4,4},{0,4},{-1,2} } );
+	std::vector<Point2d> vpts;
+	for( int i=0; i<20; i++ )
+		for( int j=0; j<20; j++ )
+			vpts.emplace_back( -2.3 + 0.45*i, -2.1 + 0.4*j );
+	std::vector<Line2d> vlines{
+		Line2d( Point2d(-1,1), Point2d(5,1.5) ),
+		Line2d( Point2d(0,0), Point2d(4,4) ),        // through two vertices
+		Line2d( Point2d(0,8), Point2d(8,0) ),        // touches at (4,4)
+		Line2d( Point2d(0,4), Point2d(4,4) ),        // along an edge
+		Line2d( Point2d(0,9), Point2d(9,0) )         // no intersection
+	};
+
+	auto getResults = [&]         // lambda
+		()
+		{
+			std::vector<HOMOG2D_INUMTYPE> out;
+			for( const auto& pt: vpts )
+			{
+				out.push_back( pt.isInside( pl ) );
+				out.push_back( pl.distTo( pt ) );
+			}
+			for( auto dir: { CardDir::Bottom, CardDir::Top, CardDir::Left, CardDir::Right } )
+			{
+				out.push_back( pl.getExtremePoint( dir ).getX() );
+				out.push_back( pl.getExtremePoint( dir ).getY() );
+			}
+			for( const auto& li: vlines )
+			{
+				auto inters = pl.intersects( li );
+				out.push_back( inters.size() );
+				for( const auto& pt: inters.get() )
+				{
+					out.push_back( pt.getX() );
+					out.push_back( pt.getY() );
+				}
+			}
+			return out;
+		};
+
+	auto r1 = getResults();       // linear algorithms
+	CHECK( pl.isConvex() );
+	auto r2 = getResults();       // O(log n) ones
+	CHECK( r1.size() == r2.size() );
+	if( r1.size() == r2.size() )
+		for( size_t i=0; i<r1.size(); i++ )
+			CHECK( r1[i] == Approx( r2[i] ).margin( 1E-10 ) );
+
+	CHECK( pl.distTo( Point2d(1,1) ) == 0. );
+	CHECK( pl.distTo( Point2d(2,-3) ) == Approx(3.) );
+
+	pl.replacePoint( 3, Point2d(2,1) );                  // not convex any more
+	CHECK( Point2d(0.5,3).isInside( pl ) );
+	CHECK( !Point2d(2,2).isInside( pl ) );
+	CHECK( pl.distTo( Point2d(2,2) ) == Approx( 2. / std::sqrt(13.) ) );
+	CHECK( pl.getExtremePoint( CardDir::Top ) == Point2d(0,4) );
+	CHECK( !pl.isConvex() );
+
+	OPolyline op( std::vector<Point2d>{ {0,0},{4,0},{4,4} } );
+	CHECK( op.distTo( Point2d(1,1) ) == Approx(1.) );
+	CHECK( op.distTo( Point2d(6,5) ) == Approx( std::sqrt(5.) ) );
+#ifndef HOMOG2D_NOCHECKS
+	CHECK_THROWS( CPolyline().distTo( Point2d(1,1) ) );
+#endif
+}
+
+TEST_CASE( "rotating calipers", "[calipers]" )
+{
+	std::vector<Point2d> vpts{ {0,0},{4,4},{3,5},{-1,1},{1,2},{2,2} };   // rotated rectangle, with inner points
+	{
+		auto obb = getMinAreaOBB( vpts );
+		CHECK( obb.size() == 4 );
+		CHECK( obb.area() == Approx( 8. ) );
+		CHECK( obb == CPolyline( std::vector<Point2d>{ {0,0},{4,4},{3,5},{-1,1} } ) );
+		auto obb2 = getMinPerimOBB( vpts );
+		CHECK( obb2.length() == Approx( 10. * std::sqrt(2.) ) );
+		std::list<Point2d> lpts( vpts.begin(), vpts.end() );
+		CHECK( getMinAreaOBB( lpts ).area() == Approx( 8. ) );
+		CHECK( getMinAreaOBB( CPolyline( vpts ) ).area() == Approx( 8. ) );
+	}
+	{
+		auto diam = getDiameter( vpts );
+		CHECK( diam.length() == Approx( std::sqrt(34.) ) );
+		CHECK( getMinWidth( vpts ) == Approx( std::sqrt(2.) ) );
+		CHECK( getMinWidth( OPolyline( vpts ) ) == Approx( std::sqrt(2.) ) );
+	}
+	{                                       // regular polygon
+		CPolyline rcp( 10, 12 );
+		CHECK( getDiameter( rcp ).length() == Approx( 20. ) );
+		CHECK( getMinWidth( rcp ) == Approx( 20. * std::cos( M_PI / 12. ) ) );
+	}
+	{                                       // degenerate cases
+		std::vector<Point2d> v1{ {0,0},{1,1},{2,2} };
+		CHECK( getMinWidth( v1 ) == 0. );
+		CHECK( getDiameter( v1 ) == Segment( 0,0,2,2 ) );
+		CHECK_THROWS( getMinAreaOBB( v1 ) );
+		std::vector<Point2d> v2{ {1,1},{1,1} };
+		CHECK_THROWS( getDiameter( v2 ) );
+	}
+}
+
+TEST_CASE( "polygon offset", "[offset]" )
+{
+	std::vector<Point2d> vsq{ {0,0},{4,0},{4,4},{0,4} };
+	{
+		CPolyline sq( vsq );
+		CPolyline sq2( std::vector<Point2d>( vsq.rbegin(), vsq.rend() ) );  // CW
+		CHECK( sq.getOffsetPoly( 1 ).area() == Approx( 36. ) );
+		CHECK( sq2.getOffsetPoly( 1 ).area() == Approx( 36. ) );
+		CHECK( sq.getOffsetPoly( -1 ) == CPolyline( std::vector<Point2d>{ {1,1},{3,1},{3,3},{1,3} } ) );
+		CHECK( sq2.getOffsetPoly( -1 ) == CPolyline( std::vector<Point2d>{ {1,1},{3,1},{3,3},{1,3} } ) );
+		CHECK( sq.getOffsetPoly( -3 ).size() == 0 );
+		CHECK( getOffsetPolys( sq, -3 ).empty() );
+	}
+	{                                             // joins
+		CPolyline sq( vsq );
+		OffsetPolyParams par;
+		par._join = OffsetJoin::Bevel;
+		CHECK( sq.getOffsetPoly( 1, par ).area() == Approx( 34. ) );
+		par._join = OffsetJoin::Square;
+		CHECK( sq.getOffsetPoly( 1, par ).area() == Approx( 24. + 8.*std::sqrt(2.) ) );
+		par._join = OffsetJoin::Round;
+		par._arcStep = 0.001;
+		CHECK( sq.getOffsetPoly( 1, par ).area() == Approx( 32. + M_PI ).epsilon(1E-5) );
+		par._join = OffsetJoin::Miter;
+		par._miterLimit = 1.2;                    // less than sqrt(2): bevel
+		CHECK( sq.getOffsetPoly( 1, par ).area() == Approx( 34. ) );
+		OffsetPolyParams par2;
+		par2._angleSplit = true;
+		CHECK( sq.getOffsetPoly( 1, par2 ).area() == Approx( 24. + 8.*std::sqrt(2.) ) );
+	}
+	{                                             // inside offset splits the polygon in two parts
+		CPolyline dumbbell( std::vector<Point2d>{
+			{0,0},{4,0},{4,1.5},{6,1.5},{6,0},{10,0},{10,4},{6,4},{6,2.5},{4,2.5},{4,4},{0,4}
+		} );
+		auto res = getOffsetPolys( dumbbell, -1 );
+		CHECK( res.size() == 2 );
+		CHECK( res.nbHoles() == 0 );
+		CHECK( res.area() == Approx( 8. ) );
+		CHECK( dumbbell.getOffsetPoly( -1 ).area() == Approx( 4. ) );
+		CHECK( dumbbell.getOffsetPoly( -1 ).isSimple() );
+
+		OffsetPolyParams par;
+		par._cleanup = false;                     // raw curve
+		CHECK( getOffsetPolys( dumbbell, -1, par ).size() == 1 );
+	}
+	{                                             // outside offset closes a slot, giving a hole
+		CPolyline cshape( std::vector<Point2d>{
+			{0,0},{10,0},{10,10},{5.5,10},{5.5,8},{8,8},{8,2},{2,2},{2,8},{4.5,8},{4.5,10},{0,10}
+		} );
+		auto res = getOffsetPolys( cshape, 1 );
+		CHECK( res.size() == 2 );
+		CHECK( res.nbHoles() == 1 );
+		CHECK( res.area() == Approx( 128. ) );
+		CHECK( cshape.getOffsetPoly( 1 ).area() == Approx( 144. ) );
+	}
+	{                                             // invalid input
+		CPolyline cross( std::vector<Point2d>{ {0,0},{4,0},{0,4},{4,4} } );
+		CHECK_THROWS( getOffsetPolys( cross, 1 ) );
+		CHECK( cross.getOffsetPoly( 1 ).size() == 0 );
+		CHECK_THROWS( getOffsetPolys( CPolyline( vsq ), 0 ) );
+	}
 }
 
 // helper function
@@ -4044,6 +5639,80 @@ TEST_CASE( "nearest/farthest points", "[nfp]" )
 	}
 }
 
+TEST_CASE( "point index (k-d tree)", "[nfp-index]" )
+{
+	{
+		std::vector<Point2d_<NUMTYPE>> vec;
+		PointIndex idx0( vec );
+		CHECK( idx0.size() == 0 );
+		CHECK_THROWS( idx0.nearest( Point2d_<NUMTYPE>() ) );
+		CHECK_THROWS( findNearestPoint( Point2d_<NUMTYPE>(), idx0 ) );
+		vec.emplace_back( 1, 1 );
+		PointIndex idx1( vec );
+		CHECK( idx1.nearest( Point2d_<NUMTYPE>() ) == 0 );
+		CHECK_THROWS( findFarthestPoint( Point2d_<NUMTYPE>(), idx1 ) );
+	}
+	{ //                                      0      1      2      3      4
+		std::vector<Point2d_<NUMTYPE>> vec2{ {0,0}, {3,0}, {4,0}, {5,6}, {7,8} };
+		PointIndex idx( vec2 );
+		Point2d_<NUMTYPE> qpt(4,5);
+		CHECK( findNearestPoint(  qpt, idx ) == 3 );
+		CHECK( findFarthestPoint( qpt, idx ) == 0 );
+		CHECK( findNearestPoint( vec2[1], idx ) == 2 );  // query point is skipped
+		CHECK( idx.nearest( vec2[1] ) == 1 );            // unless requested
+		CHECK( idx.kNearest( qpt, 3 ) == std::vector<size_t>{ 3, 4, 2 } );
+		CHECK( idx.kNearest( qpt, 10 ).size() == 5 );
+		CHECK( idx.inRadius( qpt, 5 ) == std::vector<size_t>{ 2, 3, 4 } );
+	}
+
+// compare with linear search, on random points
+	std::srand( 123 );
+	auto rnd = [](){ return static_cast<NUMTYPE>( std::rand() % 100000 ) / 100.; };
+	std::list<Point2d_<NUMTYPE>> lst;
+	for( int i=0; i<2000; i++ )
+		lst.emplace_back( rnd(), rnd() );
+	std::vector<Point2d_<NUMTYPE>> vec( lst.begin(), lst.end() );
+	PointIndex idx( lst );
+	CHECK( idx.size() == 2000 );
+
+	size_t nbErr = 0;
+	for( int i=0; i<200; i++ )
+	{
+		Point2d_<NUMTYPE> qpt( rnd(), rnd() );
+		if( findNearestFarthestPoint( qpt, idx ) != findNearestFarthestPoint( qpt, vec ) )
+			nbErr++;
+		auto knn = idx.kNearest( qpt, 7 );
+		std::vector<size_t> perm( vec.size() );
+		std::iota( perm.begin(), perm.end(), 0 );
+		std::partial_sort( perm.begin(), perm.begin()+7, perm.end(),
+			[&]( size_t a, size_t b ){ return qpt.distTo( vec[a] ) < qpt.distTo( vec[b] ); } );
+		if( knn != std::vector<size_t>( perm.begin(), perm.begin()+7 ) )
+			nbErr++;
+		std::vector<size_t> inr;
+		for( size_t j=0; j<vec.size(); j++ )
+			if( qpt.distTo( vec[j] ) <= 30. )
+				inr.push_back( j );
+		if( idx.inRadius( qpt, 30. ) != inr )
+			nbErr++;
+	}
+	CHECK( nbErr == 0 );
+
+// closest points between two polylines
+	std::vector<Point2d_<NUMTYPE>> v1, v2;
+	for( int i=0; i<300; i++ )
+	{
+		v1.emplace_back( rnd(), rnd() );
+		v2.emplace_back( rnd()+500., rnd() );
+	}
+	OPolyline_<NUMTYPE> pl1( v1 );
+	OPolyline_<NUMTYPE> pl2( v2 );
+	PointIndex idx2( pl2.getPts() );
+	auto cp1 = getClosestPoints( pl1, pl2 );
+	auto cp2 = getClosestPoints( pl1, pl2, idx2 );
+	CHECK( cp1.getIndexes() == cp2.getIndexes() );
+	CHECK( cp1.getMinDist() == Approx( cp2.getMinDist() ) );
+}
+
 TEST_CASE( "size() function tests", "[size_tests]" )
 {
 	OPolyline opol;
@@ -4081,6 +5750,53 @@ TEST_CASE( "pts_inside", "[ptsins]" )
 
 }
 
+TEST_CASE( "prepared polygon", "[prepared-poly]" )
+{
+	std::srand( 321 );
+	for( int k=0; k<20; k++ )
+	{
+		size_t n = 5 + k*15;
+		std::vector<Point2d_<NUMTYPE>> vpts;
+		for( size_t i=0; i<n; i++ )  // star-shaped polygon
+		{
+			auto angle = 2. * M_PI * i / n;
+			auto rad = 10. + 1.0*rand()/RAND_MAX * 40.;
+			vpts.emplace_back( rad*std::cos(angle), rad*std::sin(angle) );
+		}
+		CPolyline_<NUMTYPE> pol( vpts );
+		PreparedPolygon ppol( pol );
+		CHECK( ppol.nbEdges() == n );
+
+		std::vector<Point2d_<NUMTYPE>> vqpts( 500 );
+		for( auto& pt: vqpts )
+			pt.set( 1.0*rand()/RAND_MAX * 120. - 60., 1.0*rand()/RAND_MAX * 120. - 60. );
+		vqpts.push_back( vpts[0] );                                           // on vertex
+		vqpts.push_back( Segment_<NUMTYPE>( vpts[1], vpts[2] ).getCenter() ); // on edge
+
+		auto res = ppol.contains( vqpts );
+		size_t nbIn = 0, nbErr = 0;
+		for( size_t i=0; i<vqpts.size(); i++ )
+		{
+			nbErr += ( res[i] != vqpts[i].isInside( pol ) );
+			nbIn += res[i];
+		}
+		CHECK( nbErr == 0 );
+		CHECK( !res[500] );
+		CHECK( !res[501] );
+		CHECK( getPtsInside( vqpts, pol ).size() == nbIn );
+
+		CPolylineSoA_<NUMTYPE> soa( vqpts );  // columnar input
+		CHECK( ppol.contains( soa.getXs(), soa.getYs() ) == res );
+	}
+
+	CPolyline_<NUMTYPE> notSimple( std::vector<Point2d>{ {0,0}, {2,0}, {0,2}, {2,2} } );
+	PreparedPolygon ppol2( notSimple );
+	CHECK( ppol2.nbEdges() == 0 );
+	CHECK( !ppol2.contains( Point2d(1,0.5) ) );
+	PreparedPolygon ppol3;
+	CHECK( !ppol3.contains( Point2d(1,0.5) ) );
+}
+
 //////////////////////////////////////////////////////////////
 /////               POLYMORPHISM                       /////
 //////////////////////////////////////////////////////////////
@@ -4246,6 +5962,16 @@ TEST_CASE( "SVG Import path 1", "[svg_import_path_1]" )
 		const char* s1 ="M10 20 C 30"; // C command not handled
 		CHECK_THROWS( svg::svgp::parsePath( s1 ) );
 	}
+	{                                              // streaming builder as sink
+		const char* s1 ="M 0 0 1 0 1 0 2 0 3 1 M 10 10 11 10 12 10";
+		PolylineBuilder plb( 0.01 );
+		auto isClosed = svg::svgp::parsePath( s1, plb );
+		CHECK( !isClosed );
+		auto vpl = plb.getPolylines();
+		CHECK( vpl.size() == 2 );
+		CHECK( vpl[0] == OPolyline( std::vector<Point2d>{ {0,0}, {2,0}, {3,1} } ) );
+		CHECK( vpl[1] == OPolyline( std::vector<Point2d>{ {10,10}, {12,10} } ) );
+	}
 }
 
 #endif // HOMOG2D_USE_SVG_IMPORT